@@ -0,0 +1,80 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+
+/// @brief Chooses the capture device buffer size from measured behaviour
+///
+/// Fed one observation per device callback: when it ran and how many bytes
+/// were queued.  The buffer doubles as soon as a callback finds it full, or
+/// nearly full, and shrinks by a quarter after several windows in a row with
+/// plenty of headroom.  It never shrinks below:
+/// - the longest gap seen between callbacks, with a margin, so a backend that
+///   only signals once the buffer is full isn't starved
+/// - half the typical render time, since delivering audio faster than the view
+///   paints adds wakeups without lowering capture-to-pixel latency
+/// - KMinPeriodNs of audio
+///
+/// Limits are in time rather than bytes, so the same policy works from 8 kHz
+/// mono to 384 kHz with 8 channels.  Qt only applies a new size when the
+/// source restarts, which loses a few milliseconds of audio, so shrinking is
+/// deliberately slow.
+class AdaptiveBlockSizer
+{
+  public:
+    static constexpr int64_t KMinPeriodNs = 1'000'000;      ///< Smallest buffer, 1 ms
+    static constexpr int64_t KInitialPeriodNs = 5'000'000;  ///< Starting buffer, 5 ms
+    static constexpr int64_t KMaxPeriodNs = 200'000'000;    ///< Largest buffer, 200 ms
+    static constexpr int64_t KWindowNs = 500'000'000;       ///< Evaluation window
+    static constexpr size_t KStableWindowsBeforeShrink = 8; ///< Clean windows per shrink
+    static constexpr double KHighFill = 0.75;               ///< Grow above this fill
+    static constexpr double KLowFill = 0.5;                 ///< Shrink only below this fill
+
+    /// @brief Constructor
+    /// @param aSampleRate Capture sample rate in Hz
+    /// @param aBytesPerFrame Bytes per interleaved frame
+    /// @param aRenderTimes Paint times in nanoseconds, or nullptr to ignore rendering
+    /// @throws std::invalid_argument if aSampleRate or aBytesPerFrame is not positive
+    AdaptiveBlockSizer(SampleRate aSampleRate,
+                       size_t aBytesPerFrame,
+                       const Metrics::Histogram* aRenderTimes = nullptr);
+
+    /// @brief Get the chosen buffer size in frames
+    [[nodiscard]] size_t GetBufferFrames() const { return mBufferFrames; }
+
+    /// @brief Get the chosen buffer size in bytes
+    [[nodiscard]] size_t GetBufferBytes() const { return mBufferFrames * mBytesPerFrame; }
+
+    /// @brief Record a device callback
+    /// @param aNowNs Callback time, from a monotonic clock
+    /// @param aQueuedBytes Bytes waiting in the device when the callback ran
+    /// @return true if the buffer size changed and should be applied
+    bool OnCallback(int64_t aNowNs, size_t aQueuedBytes);
+
+  private:
+    /// @brief Convert a duration to frames, clamped to the period limits
+    [[nodiscard]] size_t FramesFor(int64_t aNanoseconds) const;
+
+    /// @brief Set the buffer size, clamped to the period limits
+    /// @return true if it changed
+    bool SetBufferFrames(size_t aFrames);
+
+    /// @brief Start a new evaluation window
+    void ResetWindow(int64_t aNowNs);
+
+    SampleRate mSampleRate;
+    size_t mBytesPerFrame;
+    const Metrics::Histogram* mRenderTimes;
+    size_t mBufferFrames;
+
+    int64_t mLastCallbackNs = -1;
+    int64_t mWindowStartNs = -1;
+    int64_t mMaxGapNs = 0;
+    double mMaxFill = 0.0;
+    size_t mStableWindows = 0;
+};
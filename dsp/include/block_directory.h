@@ -0,0 +1,66 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// @brief Pointers to blocks of storage, indexed by block number, that one
+/// writer thread extends while any thread reads
+///
+/// Readers reach blocks through the current directory.  It is replaced by a
+/// larger copy when it fills, and old copies are kept until the BlockDirectory
+/// is destroyed, so a reader that loaded one can still use it.  A reader may
+/// only look up blocks the writer has published, by a release store of some
+/// count that the reader loads with acquire before calling Get().
+///
+/// Blocks themselves are owned by the caller.
+template<typename T>
+class BlockDirectory
+{
+  public:
+    /// @brief Blocks the first directory has room for
+    static constexpr size_t KInitialCapacity = 16;
+
+    /// @brief Look up a published block.  Safe from any thread.
+    /// @param aIndex Block number
+    [[nodiscard]] const T* Get(size_t aIndex) const
+    {
+        return (*mCurrent.load(std::memory_order_acquire))[aIndex];
+    }
+
+    /// @brief Set a block, growing the directory if needed.  Writer thread only.
+    /// @param aIndex Block number
+    /// @param aBlock Block storage, which must outlive the directory's use of it
+    /// @return Bytes allocated for a larger directory, or 0
+    [[nodiscard]] size_t Set(size_t aIndex, const T* aBlock)
+    {
+        size_t allocated = 0;
+        const Directory* const kCurrent = mCurrent.load(std::memory_order_relaxed);
+        if (kCurrent == nullptr || aIndex >= kCurrent->size()) {
+            const size_t kCapacity = std::max(
+              { KInitialCapacity, kCurrent == nullptr ? 0 : 2 * kCurrent->size(), aIndex + 1 });
+            auto directory = std::make_unique<Directory>(kCapacity, nullptr);
+            if (kCurrent != nullptr) {
+                std::ranges::copy(*kCurrent, directory->begin());
+            }
+            mCurrent.store(directory.get(), std::memory_order_release);
+            mGenerations.push_back(std::move(directory));
+            allocated = kCapacity * sizeof(const T*);
+        }
+
+        // Readers don't look this entry up until its block is published
+        (*mGenerations.back())[aIndex] = aBlock;
+        return allocated;
+    }
+
+  private:
+    using Directory = std::vector<const T*>;
+
+    std::atomic<const Directory*> mCurrent{ nullptr };
+    std::vector<std::unique_ptr<Directory>> mGenerations; // Writer thread only; last is current
+};
@@ -0,0 +1,137 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <array>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <mutex>
+#include <sample_source.h>
+#include <stop_token>
+#include <vector>
+
+/// @brief Compact per-block levels of a recording, for searching it
+///
+/// Summarizes each block of KDefaultBlockFrames frames as it completes: RMS,
+/// peak, and the power in each third-octave band from 20 Hz to 20 kHz, from a
+/// Hann-windowed FFT of the block.  Levels are relative to full scale, so a
+/// full-scale sine has an RMS of -3 dB, and are stored as whole decibels in a
+/// byte each: a day at 48 kHz takes about 17 MB.
+///
+/// Update() only reads blocks it hasn't summarized yet, so the index is built
+/// incrementally as audio arrives, with no second pass.  Queries then scan the
+/// summaries instead of the samples.
+///
+/// One thread at a time may call Update(), such as a worker, while any thread
+/// queries: each summary is published under a lock once it is complete, and
+/// the lock is not held while a block is transformed.  Reset() must not
+/// overlap Update().
+class BlockSummaryIndex
+{
+  public:
+    static constexpr FFTSize KDefaultBlockFrames = 8192;
+    static constexpr size_t KBandCount = 31; ///< Third-octave bands, 20 Hz to 20 kHz
+    static constexpr int8_t KFloorDecibels = -128; ///< Stored for silence
+
+    /// @brief One block's levels, in decibels relative to full scale
+    ///
+    /// Channels are averaged: power over all channels, peak of any channel.
+    struct Summary
+    {
+        int8_t rms{ KFloorDecibels };
+        int8_t peak{ KFloorDecibels };
+        std::array<int8_t, KBandCount> bands{};
+    };
+
+    /// @brief A span of the recording, in milliseconds from its start
+    struct TimeRange
+    {
+        int64_t first_ms{};
+        int64_t end_ms{}; ///< Exclusive
+
+        bool operator==(const TimeRange&) const = default;
+    };
+
+    /// @brief Constructor
+    /// @param aBlockFrames Frames per block; also the FFT size
+    /// @param aFFTProcessorFactory Factory for the FFT processor (optional)
+    /// @throws std::invalid_argument if aBlockFrames is larger than a source
+    /// guarantees to return in one span
+    explicit BlockSummaryIndex(FFTSize aBlockFrames = KDefaultBlockFrames,
+                               const IFFTProcessor::Factory& aFFTProcessorFactory = nullptr);
+
+    /// @brief Forget every summary, for a new recording
+    void Reset();
+
+    /// @brief Summarize the blocks completed since the last call
+    /// @param aSource Source to read; must be the same recording until Reset()
+    /// @param aStopToken Checked between blocks, to return early (optional)
+    void Update(const ISampleSource& aSource, const std::stop_token& aStopToken = {});
+
+    /// @brief Get the number of blocks summarized
+    [[nodiscard]] size_t GetBlockCount() const;
+
+    /// @brief Get frames per block
+    [[nodiscard]] FFTSize GetBlockFrames() const { return mBlockFrames; }
+
+    /// @brief Get a copy of a block's summary
+    /// @throws std::out_of_range if aBlock >= GetBlockCount()
+    [[nodiscard]] Summary GetSummary(size_t aBlock) const;
+
+    /// @brief Get the nominal centre of a band
+    /// @param aBand Band index, 0 for 20 Hz
+    /// @return Centre frequency in Hz: 1 kHz times a power of 2^(1/3)
+    [[nodiscard]] static float GetBandCenterHz(size_t aBand);
+
+    /// @brief Find when the power in a frequency range reached a level
+    /// @param aLowHz Lowest band centre to include
+    /// @param aHighHz Highest band centre to include
+    /// @param aThresholdDecibels Level the summed band power must reach
+    /// @return Time ranges of consecutive matching blocks, in order
+    /// @throws std::invalid_argument if no band centre lies in [aLowHz, aHighHz]
+    [[nodiscard]] std::vector<TimeRange> FindBandPowerAbove(float aLowHz,
+                                                            float aHighHz,
+                                                            float aThresholdDecibels) const;
+
+    /// @brief Find when the RMS level reached a level
+    /// @param aThresholdDecibels Level the block RMS must reach
+    /// @return Time ranges of consecutive matching blocks, in order
+    [[nodiscard]] std::vector<TimeRange> FindRmsAbove(float aThresholdDecibels) const;
+
+    /// @brief Get the bytes held by the summaries and scratch buffers
+    [[nodiscard]] size_t GetMemoryBytes() const;
+
+  private:
+    /// @brief Summarize one block
+    /// @param aSource Source to read
+    /// @param aFirstFrame First frame of the block
+    [[nodiscard]] Summary Summarize(const ISampleSource& aSource, FrameIndex aFirstFrame);
+
+    /// @brief Map FFT bins to bands for a sample rate
+    void MapBins(SampleRate aSampleRate);
+
+    /// @brief Merge the blocks a predicate accepts into time ranges.  Call
+    /// with mMutex held.
+    template<typename Predicate>
+    [[nodiscard]] std::vector<TimeRange> FindBlocks(Predicate aPredicate) const;
+
+    FFTSize mBlockFrames;
+    std::unique_ptr<IFFTProcessor> mFFTProcessor;
+    FFTWindow mWindow;
+    float mPowerScale; // From |X|^2 of a one-sided bin to mean-square power
+
+    // Only Update() uses these
+    SampleRate mBinSampleRate = 0; // mBinBands is mapped for this rate
+    std::vector<int8_t> mBinBands; // Band of each FFT bin, or -1
+    std::vector<float> mWindowed;  // Scratch: one channel of a block, windowed
+    std::vector<float> mPowers;    // Scratch: its spectrum, as |X|^2
+
+    mutable std::mutex mMutex; // Guards the members below
+    SampleRate mSampleRate = 0;
+    std::vector<Summary> mSummaries;
+};
@@ -0,0 +1,131 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+/// @brief Measures the distortion and noise of a sine tone, block by block
+///
+/// Works as a notch-filter analyzer does.  A Blackman-Harris FFT of the block
+/// finds the loudest bin in the bandwidth, which seeds a least-squares fit of
+/// the fundamental's amplitude, phase and frequency (IEEE 1057).  The fitted
+/// sine is subtracted, and the residual windowed and transformed again: power
+/// within KLobeBins of each harmonic is distortion, and every other bin in the
+/// bandwidth, apart from the DC lobe, is noise.  Removing the fundamental
+/// before the FFT keeps its window leakage out of the noise, so the noise
+/// floor is set by float precision rather than by the window's side lobes.
+/// Then:
+///
+/// - THD: harmonics / fundamental
+/// - THD+N: (harmonics + noise) / fundamental
+/// - SNR: fundamental / noise
+/// - SINAD: fundamental / (harmonics + noise), the inverse of THD+N
+///
+/// Harmonics above the bandwidth are left out; those that alias back into it
+/// count as noise.
+///
+/// Not thread safe: Measure() reuses its scratch buffers.  MeasureBlocks()
+/// runs one meter per thread.
+class DistortionMeter
+{
+  public:
+    static constexpr FFTSize KDefaultBlockFrames = 8192;
+    static constexpr size_t KDefaultMaxHarmonic = 10;
+    static constexpr float KDefaultBandwidthHz = 20000.0f;
+
+    /// @brief Bins either side of a harmonic that belong to it: the half-width
+    /// of the window's main lobe, and one more for a harmonic between bins
+    static constexpr size_t KLobeBins = 5;
+
+    /// @brief Tuning
+    struct Config
+    {
+        FFTSize block_frames = KDefaultBlockFrames; ///< Frames per measurement; the FFT size
+        size_t max_harmonic = KDefaultMaxHarmonic;  ///< Highest harmonic counted, from 2
+        float bandwidth_hz = KDefaultBandwidthHz;   ///< Clamped to Nyquist
+    };
+
+    /// @brief One block's results
+    ///
+    /// Levels are relative to full scale, as in BlockSummaryIndex: a
+    /// full-scale sine is -3 dB.  Ratios are power ratios in decibels, so a
+    /// THD of -60 dB is 0.1%.  A block with no signal in the bandwidth gives
+    /// NaN for every level and ratio.
+    struct Measurement
+    {
+        float fundamental_hz{};
+        float fundamental_decibels{}; ///< RMS level of the fundamental
+        float thd_decibels{};
+        float thd_n_decibels{};
+        float snr_decibels{};
+        float sinad_decibels{};
+        size_t harmonic_count{}; ///< Harmonics that fell within the bandwidth
+    };
+
+    /// @brief Constructor, with the default tuning
+    /// @param aSampleRate Sample rate of the audio to measure
+    /// @throws std::invalid_argument if aSampleRate is not positive
+    explicit DistortionMeter(SampleRate aSampleRate);
+
+    /// @brief Constructor
+    /// @param aSampleRate Sample rate of the audio to measure
+    /// @param aConfig Tuning
+    /// @param aFFTProcessorFactory Factory for the FFT processor (optional)
+    /// @throws std::invalid_argument if aSampleRate or aConfig.bandwidth_hz is
+    /// not positive, or aConfig.block_frames is too small to tell a tone's
+    /// lobe from DC
+    DistortionMeter(SampleRate aSampleRate,
+                    const Config& aConfig,
+                    const IFFTProcessor::Factory& aFFTProcessorFactory = nullptr);
+
+    /// @brief Measure one block
+    /// @param aBlock Config::block_frames samples of one channel
+    /// @return The block's measurement
+    /// @throws std::invalid_argument if aBlock is the wrong size
+    /// @note Does not allocate
+    [[nodiscard]] Measurement Measure(std::span<const float> aBlock);
+
+    /// @brief Measure consecutive blocks of a channel, in parallel
+    /// @param aSamples Samples of one channel.  A partial block at the end is ignored.
+    /// @param aSampleRate Sample rate of aSamples
+    /// @param aConfig Tuning
+    /// @param aThreadCount Number of threads.  0 selects
+    /// std::thread::hardware_concurrency().
+    /// @return One measurement per whole block, in order
+    /// @throws std::invalid_argument as the constructor
+    [[nodiscard]] static std::vector<Measurement> MeasureBlocks(std::span<const float> aSamples,
+                                                                SampleRate aSampleRate,
+                                                                const Config& aConfig,
+                                                                size_t aThreadCount = 0);
+
+    /// @brief Get the tuning
+    [[nodiscard]] const Config& GetConfig() const { return mConfig; }
+
+  private:
+    /// @brief Add up the power of a harmonic's lobe, claiming its bins
+    /// @param aCentre Bin nearest the harmonic
+    /// @return Power of the bins not already claimed
+    double ClaimLobe(size_t aCentre);
+
+    Config mConfig;
+    SampleRate mSampleRate;
+    std::unique_ptr<IFFTProcessor> mFFTProcessor;
+    FFTWindow mWindow;
+    float mPowerScale; // Bin power to mean square of the unwindowed signal
+    size_t mFirstBin;  // First bin above the DC lobe
+    size_t mEndBin;    // One past the last bin in the bandwidth
+
+    // Scratch for Measure()
+    std::vector<float> mWindowed; // The block, then its residual, windowed
+    std::vector<float> mDecibels;
+    std::vector<double> mPowers;
+    std::vector<uint8_t> mClaimed; // One flag per bin
+};
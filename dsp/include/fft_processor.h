@@ -4,6 +4,7 @@
 
 #pragma once
 #include <audio_types.h>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <span>
@@ -64,9 +65,33 @@ class IFFTProcessor
     /// @note Zero magnitudes will produce -inf dB values.
     [[nodiscard]] virtual std::vector<float> ComputeDecibels(
       const std::span<const float>& aSamples) const = 0;
+
+    /// @brief Compute the frequency magnitudes in decibels into a caller buffer
+    /// @param aSamples Input audio samples (size must be equal to transform_size)
+    /// @param aDecibels Output buffer (size must be transform_size / 2 + 1)
+    /// @throws std::invalid_argument if either size is wrong
+    /// @note Does not allocate, for use in hot paths.
+    virtual void ComputeDecibels(const std::span<const float>& aSamples,
+                                 std::span<float> aDecibels) const = 0;
+
+    /// @brief Compute the squared frequency magnitudes into a caller buffer
+    /// @param aSamples Input audio samples (size must be equal to transform_size)
+    /// @param aPowers Output buffer (size must be transform_size / 2 + 1)
+    /// @throws std::invalid_argument if either size is wrong
+    /// @note Does not allocate.  For summing power over bins, where decibels
+    /// would only be converted back.
+    virtual void ComputePowers(const std::span<const float>& aSamples,
+                               std::span<float> aPowers) const = 0;
+
+    /// @brief Get the bytes held by the processor's working buffers
+    [[nodiscard]] virtual size_t GetMemoryBytes() const noexcept = 0;
 };
 
 /// @brief Processes audio samples using FFT to produce frequency spectrum
+///
+/// FFTW's planner is not thread safe, so making and destroying plans take one
+/// process-wide lock: processors may be constructed and destroyed on any
+/// thread.  Computing with distinct processors concurrently needs no lock.
 class FFTProcessor : public IFFTProcessor
 {
   public:
@@ -82,6 +107,11 @@ class FFTProcessor : public IFFTProcessor
       const std::span<const float>& aSamples) const override;
     [[nodiscard]] std::vector<float> ComputeDecibels(
       const std::span<const float>& aSamples) const override;
+    void ComputeDecibels(const std::span<const float>& aSamples,
+                         std::span<float> aDecibels) const override;
+    void ComputePowers(const std::span<const float>& aSamples,
+                       std::span<float> aPowers) const override;
+    [[nodiscard]] size_t GetMemoryBytes() const noexcept override;
 
   private:
     // Custom deleter for FFTW resources (implementation in .cpp)
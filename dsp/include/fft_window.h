@@ -3,11 +3,15 @@
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
 #pragma once
+#include <array>
 #include <audio_types.h>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <span>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 class FFTWindow
@@ -24,6 +28,16 @@ class FFTWindow
                         // signals near strong ones
     };
 
+    /// @brief Mapping of Type to string names
+    /// Used for command line options and exported metadata.
+    static constexpr std::array<std::pair<Type, std::string_view>, 5> TypeNames = { {
+      { Type::Rectangular, "rectangular" },
+      { Type::Hann, "hann" },
+      { Type::Hamming, "hamming" },
+      { Type::Blackman, "blackman" },
+      { Type::BlackmanHarris, "blackman-harris" },
+    } };
+
     /// @brief Constructor
     /// @param aSize Number of samples in the window (must be > 0)
     /// @param aType Window function type
@@ -38,6 +52,13 @@ class FFTWindow
     /// @throws std::invalid_argument if aInput.size() != window size
     [[nodiscard]] std::vector<float> Apply(std::span<const float> aInput) const;
 
+    /// @brief Apply window to samples, writing windowed data to a caller buffer
+    /// @param aInput Input samples.  Size must match window size
+    /// @param aOutput Output buffer.  Size must match window size.  May be aInput.
+    /// @throws std::invalid_argument if either size != window size
+    /// @note Does not allocate, for use in hot paths.
+    void Apply(std::span<const float> aInput, std::span<float> aOutput) const;
+
     /// @brief Get the size of the window
     /// @return Window size in samples
     [[nodiscard]] FFTSize GetSize() const noexcept { return mSize; }
@@ -46,6 +67,12 @@ class FFTWindow
     /// @return Window type
     [[nodiscard]] Type GetType() const noexcept { return mType; }
 
+    /// @brief Get the bytes held by the precomputed coefficients
+    [[nodiscard]] size_t GetMemoryBytes() const noexcept
+    {
+        return mWindowCoefficients.capacity() * sizeof(float);
+    }
+
   private:
     FFTSize mSize;                          // Window size in samples
     Type mType;                             // Window type
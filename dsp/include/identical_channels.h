@@ -0,0 +1,57 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <atomic>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Tracks which channels of an append-only stream duplicate another
+///
+/// Dual-mono files and mono sources recorded as stereo carry the same samples
+/// in several channels.  Fed each appended block, this keeps one run per
+/// channel: the lowest-numbered channel whose samples have matched it bit for
+/// bit since some frame.  A spectrogram can then compute those rows once.
+///
+/// One writer, any number of readers.  Each run is a single atomic word, so
+/// readers never block the writer.  Only the current run is kept: once a
+/// channel diverges, earlier matching ranges are reported as distinct.  That
+/// costs redundant work, never wrong results.
+class IdenticalChannels
+{
+  public:
+    /// @brief Constructor.  Every channel starts distinct.
+    /// @param aChannelCount Number of channels
+    explicit IdenticalChannels(ChannelCount aChannelCount);
+
+    /// @brief Record a block appended to every channel.  Writer thread only.
+    /// @param aFirstFrame Index of the block's first frame
+    /// @param aPlanar The block, one channel after another, aFrames samples each
+    /// @param aFrames Frames in the block
+    /// @throws std::invalid_argument if aPlanar doesn't hold aFrames per channel
+    /// @note Call before publishing the frames, so readers never see frames
+    /// the runs don't cover yet.  Does not allocate.
+    void AddBlock(FrameIndex aFirstFrame, std::span<const float> aPlanar, size_t aFrames);
+
+    /// @brief Find the channel a range of another channel duplicates.  Safe from any thread.
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame of a range of published frames
+    /// @return The lowest channel whose samples match aChannel's throughout the
+    /// range, or aChannel if none is known to
+    /// @throws std::out_of_range if aChannel is invalid
+    [[nodiscard]] ChannelCount Find(ChannelCount aChannel, FrameIndex aFirstFrame) const;
+
+  private:
+    /// @brief Bits of a run word holding the first frame; the channel is above them
+    static constexpr unsigned KFrameBits = 56;
+
+    /// @brief Pack a run into one word
+    [[nodiscard]] static uint64_t Pack(ChannelCount aChannel, FrameIndex aSince);
+
+    // One run per channel: the channel it matches, and the frame it has since
+    std::vector<std::atomic<uint64_t>> mRuns;
+};
@@ -0,0 +1,87 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <atomic>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <metrics.h>
+#include <mutex>
+
+/// @brief Measures capture-to-pixel latency
+///
+/// The capture path tags each ingested block with the frame count the buffer
+/// will hold once the block is added, and the time it was captured.  The view
+/// reports the newest frame it has composited after each paint.  Every tag up
+/// to that frame is then resolved, and the time since its capture recorded in
+/// a histogram.  The result is the latency from the audio callback to the
+/// first paint showing a row that contains the block.
+///
+/// Off by default.  While disabled, tagging and marking cost one relaxed
+/// atomic load.  Tags and marks may come from different threads.
+class LatencyProbe
+{
+  public:
+    /// @brief Tags kept waiting for a paint.  When full, the oldest is dropped,
+    /// e.g. while the window is minimized.
+    static constexpr size_t KMaxPending = 1024;
+
+    /// @brief Constructor
+    /// @param aHistogram Histogram to record latencies into, in nanoseconds
+    explicit LatencyProbe(Metrics::Histogram& aHistogram);
+
+    /// @brief Get the process-wide probe, which records into the
+    /// Metrics::KCaptureToPixel histogram
+    [[nodiscard]] static LatencyProbe& Get();
+
+    /// @brief Start or stop measuring
+    /// @note Stopping discards pending tags.
+    void SetEnabled(bool aEnabled);
+
+    /// @brief Check whether latency is being measured
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return mEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Tag a captured block
+    /// @param aEndFrame Buffer frame count once the block is added
+    /// @param aCaptureNs Capture time, from Now()
+    void TagBlock(FrameCount aEndFrame, int64_t aCaptureNs = Now());
+
+    /// @brief Report that frames have been composited to the screen
+    /// @param aEndFrame One past the newest frame in a composited row
+    /// @param aNowNs Composite time, from Now()
+    void MarkComposited(FrameCount aEndFrame, int64_t aNowNs = Now());
+
+    /// @brief Discard pending tags
+    /// @note Call when the buffer is reset, since frame counts restart at zero.
+    void Clear();
+
+    /// @brief Get the number of tags waiting for a paint
+    [[nodiscard]] size_t GetPendingCount() const;
+
+    /// @brief Summarize the latencies recorded so far, in nanoseconds
+    [[nodiscard]] Metrics::Histogram::Summary Summarize() const
+    {
+        return mHistogram.Summarize();
+    }
+
+    /// @brief Get the probe clock, in nanoseconds
+    [[nodiscard]] static int64_t Now() noexcept;
+
+  private:
+    struct Tag
+    {
+        FrameCount end_frame;
+        int64_t capture_ns{};
+    };
+
+    Metrics::Histogram& mHistogram;
+    std::atomic<bool> mEnabled{ false };
+    mutable std::mutex mMutex;
+    std::deque<Tag> mPending; // Ordered by end_frame
+};
@@ -0,0 +1,84 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <span>
+#include <vector>
+
+/// @brief Running quantiles of a stream of decibel levels
+///
+/// A fixed-size histogram: levels are counted in bins of resolution_decibels
+/// between min_decibels and max_decibels, and levels outside are counted in the
+/// end bins.  Adding a level is one increment, and a quantile is one pass over
+/// the bins, interpolated within the bin it falls in, so nothing is sorted and
+/// the memory doesn't grow with the stream.  Quantiles are exact to within a
+/// bin.
+///
+/// Older levels can be forgotten exponentially: each Age() call, once per row,
+/// makes every level counted before it weigh 2^(-1 / half_life_rows) as much.
+/// The weights are scaled up instead of the counts down, so a call costs one
+/// multiply; the counts are renormalized, in one pass, only when the weight
+/// grows large.  Storage is sized by the constructor, so nothing allocates
+/// after it.
+///
+/// Not thread safe.
+class LevelHistogram
+{
+  public:
+    /// @brief Range and forgetting
+    struct Config
+    {
+        float min_decibels = -100.0f;      ///< Lower edge of the first bin
+        float max_decibels = 140.0f;       ///< Upper edge of the last bin
+        float resolution_decibels = 0.25f; ///< Bin width
+        float half_life_rows = 0.0f;       ///< Age() calls to halve a weight; 0 never forgets
+    };
+
+    /// @brief Constructor, with the default range, never forgetting
+    LevelHistogram();
+
+    /// @brief Constructor
+    /// @param aConfig Range and forgetting
+    /// @throws std::invalid_argument if the range is empty, the resolution
+    /// isn't positive, or half_life_rows is negative
+    explicit LevelHistogram(const Config& aConfig);
+
+    /// @brief Forget every level
+    void Reset();
+
+    /// @brief Count one level
+    /// @param aDecibels Level; -inf counts in the first bin.  Must not be NaN.
+    /// @param aWeight How many levels this counts as
+    void Add(float aDecibels, double aWeight = 1.0);
+
+    /// @brief Count every level of a row, such as a spectrogram row
+    /// @param aDecibels Levels; -inf counts in the first bin.  Must not be NaN.
+    void Add(std::span<const float> aDecibels);
+
+    /// @brief Age the levels counted so far by one row
+    void Age();
+
+    /// @brief Get a quantile of the levels counted
+    /// @param aFraction Fraction of the weight at or below the quantile
+    /// @return Level in decibels, or NaN if nothing has been counted
+    /// @throws std::invalid_argument if aFraction is outside [0, 1]
+    [[nodiscard]] float GetQuantile(double aFraction) const;
+
+    /// @brief Get the weight counted, after forgetting
+    [[nodiscard]] double GetWeight() const { return mTotal / mIncrement; }
+
+    /// @brief Get the range and forgetting
+    [[nodiscard]] const Config& GetConfig() const { return mConfig; }
+
+  private:
+    /// @brief Scale the counts by the current weight, and the weight back to 1
+    void Renormalize();
+
+    Config mConfig;
+    float mBinsPerDecibel;
+    double mGrowth = 1.0;        // Of mIncrement per Age()
+    double mIncrement = 1.0;     // Count added by a level of weight 1
+    double mTotal = 0.0;         // Of mCounts
+    std::vector<double> mCounts; // Of each bin
+};
@@ -0,0 +1,108 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Something whose memory the MemoryBudget accounts for
+class IMemoryConsumer
+{
+  public:
+    /// @brief What releasing memory costs
+    enum class Kind
+    {
+        Cache,   ///< Derived data, recomputed on demand.  Released first.
+        History, ///< Source data.  Can only be spilled, never dropped.
+    };
+
+    virtual ~IMemoryConsumer() = default;
+
+    /// @brief Get the bytes currently held
+    [[nodiscard]] virtual size_t GetMemoryBytes() const = 0;
+
+    /// @brief Release memory
+    /// @param aBytes Bytes the budget would like freed
+    /// @return Bytes actually freed, which may be more or less than asked
+    virtual size_t ReleaseMemory(size_t aBytes) = 0;
+};
+
+/// @brief Caps the memory held by registered consumers
+///
+/// Consumers (the sample history, the row cache, render caches) register with
+/// a name and a Kind.  Enforce() compares their total with the limit and, when
+/// over, asks caches to release memory in registration order, then history.
+/// The totals are published as Metrics gauges, one per consumer plus the total
+/// and limit, for the statistics panel.
+///
+/// Registration and queries may come from any thread.  Enforce() calls into
+/// the consumers, so it must run on the thread that owns them, between uses.
+class MemoryBudget
+{
+  public:
+    /// @brief One consumer's share, from GetUsage()
+    struct Usage
+    {
+        std::string name;
+        IMemoryConsumer::Kind kind{};
+        size_t bytes{};
+    };
+
+    /// @brief Constructor.  Starts with no limit.
+    MemoryBudget() = default;
+
+    /// @brief Get the process-wide budget
+    [[nodiscard]] static MemoryBudget& Get();
+
+    /// @brief Register a consumer
+    /// @param aName Short name, used in the memory.<name>_bytes gauge
+    /// @param aKind Whether the consumer is a cache or history
+    /// @param aConsumer Consumer; must stay alive until unregistered
+    void Register(std::string_view aName, IMemoryConsumer::Kind aKind, IMemoryConsumer& aConsumer);
+
+    /// @brief Unregister a consumer.  No-op if it isn't registered.
+    void Unregister(const IMemoryConsumer& aConsumer);
+
+    /// @brief Set the ceiling
+    /// @param aBytes Limit in bytes, or 0 for no limit
+    void SetLimit(size_t aBytes);
+
+    /// @brief Get the ceiling, or 0 if there is none
+    [[nodiscard]] size_t GetLimit() const;
+
+    /// @brief Get the bytes held by every registered consumer
+    [[nodiscard]] size_t GetTotalBytes() const;
+
+    /// @brief Get each registered consumer's share, in registration order
+    [[nodiscard]] std::vector<Usage> GetUsage() const;
+
+    /// @brief Release memory until the total is within the limit, if possible
+    /// @return Bytes released
+    ///
+    /// Also publishes the totals to Metrics, so call it periodically even when
+    /// there is no limit.
+    size_t Enforce();
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        IMemoryConsumer::Kind kind{};
+        IMemoryConsumer* consumer{};
+        Metrics::Gauge* gauge{};
+    };
+
+    /// @brief Publish per-consumer and total gauges
+    /// @return Total bytes
+    size_t Publish() const;
+
+    mutable std::mutex mMutex;
+    std::vector<Entry> mEntries;
+    size_t mLimit = 0;
+};
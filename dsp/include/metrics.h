@@ -0,0 +1,180 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// @brief Process-wide registry of performance counters, gauges and histograms
+///
+/// Metrics are created on first use by name and live for the whole process, so
+/// a reference can be cached in a function-local static and updated from any
+/// thread without locking:
+///
+///     static Metrics::Counter& rows = Metrics::GetCounter(Metrics::KRowsComputed);
+///     rows.Add();
+///
+/// Only lookup by name takes a lock.  Updates are relaxed atomics.  Readers
+/// such as the statistics panel take a Snapshot() and derive rates from the
+/// difference between two snapshots.
+class Metrics
+{
+  public:
+    // Well-known metric names.  Times are in nanoseconds.
+    static constexpr std::string_view KRowsComputed = "engine.rows_computed";
+    static constexpr std::string_view KCacheHits = "engine.cache_hits";
+    static constexpr std::string_view KCacheMisses = "engine.cache_misses";
+    static constexpr std::string_view KCacheRows = "engine.cache_rows";
+    static constexpr std::string_view KCacheEvictions = "engine.cache_evictions";
+    static constexpr std::string_view KSilentRows = "engine.silent_rows";
+    static constexpr std::string_view KAliasedRows = "engine.aliased_rows";
+    static constexpr std::string_view KFFTTime = "engine.fft_ns";
+    static constexpr std::string_view KPaintTime = "view.paint_ns";
+    static constexpr std::string_view KFramesPainted = "view.frames_painted";
+    static constexpr std::string_view KFramesIngested = "audio.frames_ingested";
+    static constexpr std::string_view KCaptureQueueFrames = "capture.queue_frames";
+    static constexpr std::string_view KCaptureOverruns = "capture.overruns";
+    static constexpr std::string_view KCaptureUnderruns = "capture.underruns";
+    static constexpr std::string_view KCaptureBufferFrames = "capture.buffer_frames";
+    static constexpr std::string_view KCapturePaddedFrames = "capture.padded_frames";
+    static constexpr std::string_view KStreamQueueFrames = "stream.queue_frames";
+    static constexpr std::string_view KDroppedFrames = "stream.dropped_frames";
+    static constexpr std::string_view KCaptureToPixel = "latency.capture_to_pixel_ns";
+    static constexpr std::string_view KSeekToAudio = "latency.seek_to_audio_ns";
+    static constexpr std::string_view KMemoryTotal = "memory.total_bytes";
+    static constexpr std::string_view KMemoryLimit = "memory.limit_bytes";
+    static constexpr std::string_view KMemoryReleased = "memory.released_bytes";
+
+    /// @brief Monotonically increasing count
+    class Counter
+    {
+      public:
+        void Add(uint64_t aCount = 1) noexcept
+        {
+            mValue.fetch_add(aCount, std::memory_order_relaxed);
+        }
+        [[nodiscard]] uint64_t Get() const noexcept
+        {
+            return mValue.load(std::memory_order_relaxed);
+        }
+
+      private:
+        std::atomic<uint64_t> mValue{ 0 };
+    };
+
+    /// @brief Current level of something, such as a queue depth
+    class Gauge
+    {
+      public:
+        void Set(int64_t aValue) noexcept { mValue.store(aValue, std::memory_order_relaxed); }
+        void Add(int64_t aDelta) noexcept { mValue.fetch_add(aDelta, std::memory_order_relaxed); }
+        [[nodiscard]] int64_t Get() const noexcept
+        {
+            return mValue.load(std::memory_order_relaxed);
+        }
+
+      private:
+        std::atomic<int64_t> mValue{ 0 };
+    };
+
+    /// @brief Distribution of non-negative values, such as durations
+    ///
+    /// Values are counted in log-linear buckets: four per power of two, so
+    /// percentiles are accurate to within about 12%.  Recording is wait-free.
+    class Histogram
+    {
+      public:
+        /// @brief Four buckets per octave for 63 octaves
+        static constexpr size_t KBucketCount = 252;
+
+        /// @brief Summary statistics
+        struct Summary
+        {
+            uint64_t count{};
+            double mean{};
+            uint64_t p50{};
+            uint64_t p90{};
+            uint64_t p99{};
+            uint64_t max{};
+        };
+
+        /// @brief Record one value
+        void Record(uint64_t aValue) noexcept;
+
+        /// @brief Summarize the values recorded so far
+        [[nodiscard]] Summary Summarize() const;
+
+        /// @brief Get the bucket a value is counted in
+        [[nodiscard]] static size_t BucketIndex(uint64_t aValue) noexcept;
+
+        /// @brief Get the smallest value counted in a bucket
+        [[nodiscard]] static uint64_t BucketLowerBound(size_t aIndex) noexcept;
+
+      private:
+        std::array<std::atomic<uint64_t>, KBucketCount> mBuckets{};
+        std::atomic<uint64_t> mCount{ 0 };
+        std::atomic<uint64_t> mSum{ 0 };
+        std::atomic<uint64_t> mMax{ 0 };
+    };
+
+    /// @brief Records the lifetime of a scope into a histogram, in nanoseconds
+    class ScopedTimer
+    {
+      public:
+        explicit ScopedTimer(Histogram& aHistogram) noexcept;
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+        ScopedTimer(ScopedTimer&&) = delete;
+        ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+      private:
+        Histogram& mHistogram;
+        int64_t mStartNs;
+    };
+
+    /// @brief Point-in-time copy of every metric, keyed by name
+    struct Snapshot
+    {
+        std::map<std::string, uint64_t, std::less<>> counters;
+        std::map<std::string, int64_t, std::less<>> gauges;
+        std::map<std::string, Histogram::Summary, std::less<>> histograms;
+    };
+
+    /// @brief Get or create a counter
+    /// @param aName Metric name
+    /// @return Counter that lives for the rest of the process
+    [[nodiscard]] static Counter& GetCounter(std::string_view aName);
+
+    /// @brief Get or create a gauge
+    /// @param aName Metric name
+    /// @return Gauge that lives for the rest of the process
+    [[nodiscard]] static Gauge& GetGauge(std::string_view aName);
+
+    /// @brief Get or create a histogram
+    /// @param aName Metric name
+    /// @return Histogram that lives for the rest of the process
+    [[nodiscard]] static Histogram& GetHistogram(std::string_view aName);
+
+    /// @brief Copy the current value of every metric
+    [[nodiscard]] static Snapshot TakeSnapshot();
+
+    /// @brief Write every metric as a JSON document
+    /// @param aStream Output stream
+    static void WriteJson(std::ostream& aStream);
+
+    /// @brief Write every metric to a JSON file
+    /// @param aPath Output file path
+    /// @return Error message on failure
+    [[nodiscard]] static std::expected<void, std::string> WriteJsonFile(const std::string& aPath);
+};
@@ -0,0 +1,96 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Estimates the noise floor of each bin from a stream of rows
+///
+/// Minimum statistics (Martin, 2001): each bin's level is smoothed over a few
+/// rows, and the floor is the smallest smoothed level of the last
+/// subwindow_rows * subwindow_count rows, raised by a fixed bias.  Tones and
+/// transients come and go above the noise, but the minimum settles on the
+/// noise between them, so no voice activity or tone detection is needed.
+///
+/// The window's minimum is kept as the minimum of each subwindow, in a ring:
+/// a row updates the smoothed level, the current subwindow's minimum and the
+/// floor of every bin in one pass, and only the end of a subwindow scans the
+/// ring.  With no more subwindows than rows in each, that is under two passes
+/// over the bins per row, and the passes vectorize.  Levels are smoothed in
+/// decibels, so a row needs no exp or log.  Storage is sized on the first
+/// row, so later updates allocate nothing.
+///
+/// Not thread safe.  Use one estimator per channel.
+class NoiseFloorEstimator
+{
+  public:
+    /// @brief Levels are clamped to this, so silent bins don't stick at -inf
+    static constexpr float KMinDecibels = -200.0f;
+
+    /// @brief Default bias: with the default tuning, the mean power of a bin
+    /// of white noise is this far above the minimum of its smoothed level
+    static constexpr float KDefaultBiasDecibels = 5.3f;
+
+    /// @brief Tuning
+    struct Config
+    {
+        float smoothing = 0.9f;     ///< Weight of the previous smoothed level, in [0, 1)
+        size_t subwindow_rows = 12; ///< Rows per subwindow
+        size_t subwindow_count = 8; ///< Subwindows searched for the minimum
+        float bias_decibels = KDefaultBiasDecibels; ///< Added to the minimum
+    };
+
+    /// @brief Constructor, with the default tuning
+    NoiseFloorEstimator();
+
+    /// @brief Constructor
+    /// @param aConfig Tuning
+    /// @throws std::invalid_argument if aConfig.smoothing is outside [0, 1) or
+    /// either subwindow size is 0
+    explicit NoiseFloorEstimator(const Config& aConfig);
+
+    /// @brief Forget every row.  The next row may have a different bin count.
+    void Reset();
+
+    /// @brief Add the next row
+    /// @param aDecibels One row of decibel magnitudes, by bin
+    /// @throws std::invalid_argument if the bin count differs from the first
+    /// row's since Reset()
+    void Update(std::span<const float> aDecibels);
+
+    /// @brief Add a block of rows, such as RowPipeline output
+    /// @param aRows Row-major decibel rows
+    /// @param aBinCount Bins per row
+    /// @throws std::invalid_argument if aBinCount is 0 or doesn't divide aRows,
+    /// or as Update()
+    void Update(std::span<const float> aRows, size_t aBinCount);
+
+    /// @brief Get the estimated floor of each bin, in decibels
+    /// @return One level per bin, or empty before the first row
+    [[nodiscard]] std::span<const float> GetFloor() const { return mFloor; }
+
+    /// @brief Get the number of rows added since Reset()
+    [[nodiscard]] uint64_t GetRowCount() const { return mRowCount; }
+
+    /// @brief Get the tuning
+    [[nodiscard]] const Config& GetConfig() const { return mConfig; }
+
+  private:
+    /// @brief Start a new subwindow, recomputing the minimum of the finished ones
+    void EndSubwindow();
+
+    Config mConfig;
+    size_t mBinCount = 0;
+    std::vector<float> mSmoothed;         // Smoothed level of each bin
+    std::vector<float> mSubwindowMinimum; // Of the current subwindow
+    std::vector<float> mSubwindowMinima;  // subwindow_count rows of bins, a ring
+    std::vector<float> mFinishedMinimum;  // Of the ring
+    std::vector<float> mFloor;
+    size_t mSubwindowRows = 0; // Rows in the current subwindow
+    size_t mNextSubwindow = 0; // Ring slot the current subwindow goes to
+    uint64_t mRowCount = 0;
+};
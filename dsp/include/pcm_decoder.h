@@ -0,0 +1,47 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+
+/// @brief Converts raw little-endian PCM bytes to float samples
+///
+/// Used for audio piped in from other processes (arecord, sox, SDR
+/// demodulators).  Integer formats are scaled to [-1.0, 1.0).
+class PcmDecoder
+{
+  public:
+    /// @brief Raw sample encodings
+    enum class Format : uint8_t
+    {
+        S16, ///< Signed 16 bit integer, little-endian
+        S32, ///< Signed 32 bit integer, little-endian
+        F32, ///< IEEE 754 float, little-endian
+    };
+
+    /// @brief Format names, used for command line options
+    static constexpr std::array<std::pair<Format, std::string_view>, 3> TypeNames{ {
+      { Format::S16, "s16" },
+      { Format::S32, "s32" },
+      { Format::F32, "f32" },
+    } };
+
+    /// @brief Get the size of one encoded sample
+    /// @param aFormat Sample format
+    /// @return Bytes per sample
+    [[nodiscard]] static size_t BytesPerSample(Format aFormat);
+
+    /// @brief Decode raw samples to floats
+    /// @param aFormat Encoding of aInput
+    /// @param aInput Encoded samples
+    /// @param aOutput Destination, one float per encoded sample
+    /// @throws std::invalid_argument if aInput.size() is not
+    /// aOutput.size() * BytesPerSample(aFormat)
+    static void Decode(Format aFormat, std::span<const std::byte> aInput, std::span<float> aOutput);
+};
@@ -0,0 +1,119 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Finds the strongest spectral peaks of each row and links them into tracks
+///
+/// Update() takes one decibel row at a time, in order.  It finds the local
+/// maxima above a threshold, keeps the loudest few, and refines each to a
+/// fractional bin and level by fitting a parabola through it and its two
+/// neighbours.  Each peak then extends the nearest live track within a few
+/// bins, loudest tracks choosing first, or starts a new one.  A track that
+/// finds no peak for more than a couple of rows is finished.
+///
+/// The local-maximum scan is a branch-free pass over the row that the
+/// compiler vectorizes; the few peaks it finds are handled one by one.  All
+/// scratch is sized up front, so a steady-state Update() allocates nothing.
+/// Finished tracks are appended to a list the caller drains.
+///
+/// Not thread safe.  Use one tracker per channel.
+class PeakTracker
+{
+  public:
+    static constexpr size_t KDefaultMaxPeaks = 16;
+
+    /// @brief A peak in one row
+    struct Peak
+    {
+        float bin{};      ///< Position in fractional bins
+        float decibels{}; ///< Interpolated level
+    };
+
+    /// @brief A peak followed across rows
+    struct Track
+    {
+        uint64_t id{};        ///< Unique for the life of the tracker, from 0
+        float bin{};          ///< Latest position, in fractional bins
+        float decibels{};     ///< Latest level
+        uint64_t first_row{}; ///< Row the track started on, counted from Reset()
+        uint64_t last_row{};  ///< Last row a peak extended it
+        uint64_t rows{};      ///< Rows with a peak; fewer than the span if it had gaps
+    };
+
+    /// @brief Tuning
+    struct Config
+    {
+        size_t max_peaks = KDefaultMaxPeaks; ///< Loudest peaks kept per row
+        float threshold_decibels = -90.0f;   ///< Quieter maxima are ignored
+        float max_bin_jump = 2.0f;           ///< Furthest a track may move in a row
+        size_t max_gap_rows = 2;             ///< Rows a track may go without a peak
+        size_t min_track_rows = 3; ///< Shorter tracks are dropped when they finish
+    };
+
+    /// @brief Constructor, with the default tuning
+    PeakTracker();
+
+    /// @brief Constructor
+    /// @param aConfig Tuning
+    /// @throws std::invalid_argument if aConfig.max_peaks is 0 or
+    /// aConfig.max_bin_jump is negative
+    explicit PeakTracker(const Config& aConfig);
+
+    /// @brief Forget every track, finished or not, and restart the row count
+    void Reset();
+
+    /// @brief Find the loudest peaks of a row, without tracking
+    /// @param aDecibels One row of decibel magnitudes, by bin
+    /// @return Up to Config::max_peaks peaks, loudest first, valid until the
+    /// next call to FindPeaks() or Update()
+    /// @note The first and last bins are never peaks.
+    std::span<const Peak> FindPeaks(std::span<const float> aDecibels);
+
+    /// @brief Track the next row
+    /// @param aDecibels One row of decibel magnitudes, by bin
+    void Update(std::span<const float> aDecibels);
+
+    /// @brief Track a block of rows, such as RowPipeline output
+    /// @param aRows Row-major decibel rows
+    /// @param aBinCount Bins per row
+    /// @throws std::invalid_argument if aBinCount is 0 or doesn't divide aRows
+    void Update(std::span<const float> aRows, size_t aBinCount);
+
+    /// @brief Get the live tracks, including ones in a gap
+    [[nodiscard]] std::span<const Track> GetTracks() const { return mTracks; }
+
+    /// @brief Get the tracks finished since the last ClearFinishedTracks()
+    /// @return Tracks of at least Config::min_track_rows rows, in the order they finished
+    [[nodiscard]] std::span<const Track> GetFinishedTracks() const { return mFinished; }
+
+    /// @brief Drop the finished tracks, keeping their storage
+    void ClearFinishedTracks() { mFinished.clear(); }
+
+    /// @brief Get the number of rows tracked since Reset()
+    [[nodiscard]] uint64_t GetRowCount() const { return mRowCount; }
+
+    /// @brief Get the tuning
+    [[nodiscard]] const Config& GetConfig() const { return mConfig; }
+
+  private:
+    Config mConfig;
+
+    // Scratch for FindPeaks()
+    std::vector<uint8_t> mIsMaximum; // One flag per bin
+    std::vector<size_t> mCandidates; // Bins of the loudest maxima, loudest first
+    std::vector<Peak> mPeaks;
+
+    // Scratch for Update()
+    std::vector<uint8_t> mClaimed; // One flag per peak
+
+    std::vector<Track> mTracks;
+    std::vector<Track> mFinished;
+    uint64_t mNextId = 0;
+    uint64_t mRowCount = 0;
+};
@@ -0,0 +1,127 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <audio_types.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+/// @brief Computes batches of spectrogram rows in parallel
+///
+/// Owns a fixed pool of worker threads.  Each worker has its own IFFTProcessor
+/// and FFTWindow, because FFTProcessor reuses internal FFTW buffers and is not
+/// safe to share between threads.  A batch of rows is split into contiguous
+/// ranges, one per worker, and ComputeRows() blocks until all ranges are done.
+///
+/// This is the shared row engine for offline consumers (batch rendering, data
+/// export), which process whole files and care about throughput rather than
+/// latency.
+class RowPipeline
+{
+  public:
+    /// @brief Constructor
+    /// @param aTransformSize FFT transform size
+    /// @param aWindowType Window function type
+    /// @param aThreadCount Number of worker threads.  0 selects
+    /// std::thread::hardware_concurrency().
+    /// @param aFFTProcessorFactory Factory for FFT processors (optional)
+    /// @param aFFTWindowFactory Factory for FFT windows (optional)
+    ///
+    /// The factories are used for dependency injection in tests.  They are
+    /// called on the constructing thread, once per worker.
+    RowPipeline(FFTSize aTransformSize,
+                FFTWindow::Type aWindowType,
+                size_t aThreadCount = 0,
+                const IFFTProcessor::Factory& aFFTProcessorFactory = nullptr,
+                const FFTWindowFactory& aFFTWindowFactory = nullptr);
+
+    /// @brief Destructor.  Stops and joins the worker threads.
+    ~RowPipeline();
+
+    RowPipeline(const RowPipeline&) = delete;
+    RowPipeline& operator=(const RowPipeline&) = delete;
+    RowPipeline(RowPipeline&&) = delete;
+    RowPipeline& operator=(RowPipeline&&) = delete;
+
+    /// @brief Get the FFT transform size
+    /// @return Transform size in samples
+    [[nodiscard]] FFTSize GetTransformSize() const noexcept { return mTransformSize; }
+
+    /// @brief Get the number of frequency bins in each row
+    /// @return Bin count (transform size / 2 + 1)
+    [[nodiscard]] size_t GetBinCount() const noexcept { return (mTransformSize / 2) + 1; }
+
+    /// @brief Get the number of worker threads
+    /// @return Worker thread count
+    [[nodiscard]] size_t GetThreadCount() const noexcept { return mWorkers.size(); }
+
+    /// @brief Compute decibel rows from a contiguous block of single-channel samples
+    /// @param aSamples Input samples.  Row r is computed from the window
+    /// starting at aSamples[r * aStride].
+    /// @param aStride Number of samples between the starts of successive rows
+    /// @param aRowCount Number of rows to compute
+    /// @param aOutput Row-major output, aRowCount * GetBinCount() floats
+    /// @throws std::invalid_argument if aSamples is too short for aRowCount
+    /// rows, or if aOutput has the wrong size
+    /// @throws Any exception thrown by a worker's FFT processor or window
+    ///
+    /// Blocks until all rows are computed.  Not reentrant: only one thread may
+    /// call ComputeRows at a time.
+    void ComputeRows(std::span<const float> aSamples,
+                     FFTSize aStride,
+                     size_t aRowCount,
+                     std::span<float> aOutput);
+
+  private:
+    /// @brief Per-thread DSP state
+    struct Worker
+    {
+        std::unique_ptr<IFFTProcessor> fft_processor;
+        std::unique_ptr<FFTWindow> fft_window;
+        std::vector<float> windowed; // Scratch, reused for every row
+        std::jthread thread;
+    };
+
+    /// @brief The batch currently being processed
+    struct Batch
+    {
+        std::span<const float> samples;
+        size_t stride{};
+        size_t row_count{};
+        std::span<float> output;
+    };
+
+    /// @brief Worker thread main loop
+    /// @param aWorkerIndex Index of this worker in mWorkers
+    void WorkerLoop(size_t aWorkerIndex);
+
+    /// @brief Compute this worker's share of the current batch
+    /// @param aWorkerIndex Index of this worker in mWorkers
+    void ComputeShare(size_t aWorkerIndex);
+
+    FFTSize mTransformSize;
+    std::vector<Worker> mWorkers;
+
+    // Dispatch state, guarded by mMutex.  mGeneration is bumped for each new
+    // batch; workers wake when it changes.  mPendingWorkers counts down as
+    // workers finish their share.  mError holds the first exception thrown by
+    // a worker during the current batch.
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkDone;
+    Batch mBatch;
+    uint64_t mGeneration{ 0 };
+    size_t mPendingWorkers{ 0 };
+    std::exception_ptr mError;
+    bool mStopping{ false };
+};
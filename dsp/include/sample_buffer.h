@@ -4,15 +4,39 @@
 
 #pragma once
 #include "audio_types.h"
+#include <atomic>
+#include <block_directory.h>
+#include <cstddef>
+#include <memory>
 #include <span>
 #include <vector>
+#include <waveform_pyramid.h>
 
 /// @brief Audio sample storage.
 ///
 /// Stores single-channel audio.  Supports random access for scrubbing.
+///
+/// Append-only, with one writer and any number of concurrent readers.  Samples
+/// live in fixed-size pages that never move once allocated, so spans returned
+/// by GetSamples() stay valid for the lifetime of the buffer, however much is
+/// appended afterwards.  The writer publishes the sample count with release
+/// semantics after the samples are stored; readers never block the writer.
+///
+/// Each page starts with a copy of the last KMaxSpanSamples samples of the
+/// previous page, so any range of up to KMaxSpanSamples samples is contiguous
+/// even when it straddles a page boundary.
+///
+/// AddSamples() also keeps a WaveformPyramid of the samples, so Summarize()
+/// can report the min, max and RMS of any range without reading it all.
 class SampleBuffer
 {
   public:
+    /// @brief Samples appended to each page
+    static constexpr size_t KPageSamples = size_t{ 1 } << 20;
+
+    /// @brief Longest range that is always available as one span
+    static constexpr size_t KMaxSpanSamples = size_t{ 1 } << 16;
+
     /// @brief Construct a SampleBuffer.
     /// @param aSampleRate Sample rate in Hz.
     explicit SampleBuffer(SampleRate aSampleRate)
@@ -21,27 +45,82 @@ class SampleBuffer
     {
     }
 
+    SampleBuffer(const SampleBuffer&) = delete;
+    SampleBuffer& operator=(const SampleBuffer&) = delete;
+    SampleBuffer(SampleBuffer&&) = delete;
+    SampleBuffer& operator=(SampleBuffer&&) = delete;
+    ~SampleBuffer() = default;
+
     /// @brief Get the sample rate.
     /// @return Sample rate in Hz.
     [[nodiscard]] SampleRate GetSampleRate() const { return mSampleRate; }
 
     /// @brief Get the total number of samples stored.
-    /// @return Number of samples.
+    /// @return Number of samples published so far.  Safe from any thread.
     [[nodiscard]] SampleCount GetSampleCount() const;
 
-    /// @brief Add audio samples to buffer.
-    /// @param samples Vector of samples to append.
-    void AddSamples(const std::vector<float>& aSamples);
+    /// @brief Add audio samples to buffer.  Writer thread only.
+    /// @param aSamples Samples to append.
+    /// @note Does not allocate while the total stays within the reserved capacity.
+    /// Otherwise allocates once per page, and once per pyramid chunk.
+    void AddSamples(std::span<const float> aSamples);
+
+    /// @brief Reserve storage for samples.  Writer thread only.
+    /// @param aSampleCount Total number of samples to make room for.
+    void Reserve(SampleCount aSampleCount);
 
-    /// @brief Get samples from the buffer.
+    /// @brief Get the bytes held, including reserved but unused pages.
+    /// @return Size of the sample storage in bytes.  Safe from any thread.
+    [[nodiscard]] size_t GetMemoryBytes() const
+    {
+        return mMemoryBytes.load(std::memory_order_relaxed) + mPyramid.GetMemoryBytes();
+    }
+
+    /// @brief Release reserved pages that hold no samples yet.  Writer thread only.
+    /// @return Bytes freed.
+    size_t ShrinkToFit();
+
+    /// @brief Get samples from the buffer.  Safe from any thread.
     /// @param aStartSample Starting sample index
     /// @param aSampleCount Number of samples to retrieve.
-    /// @return Read-only span of samples.
+    /// @return Read-only span of samples, valid for the lifetime of the buffer.
     /// @throws std::out_of_range if there aren't enough samples to fill the request.
+    /// @throws std::length_error if the range is longer than KMaxSpanSamples and
+    /// crosses a page boundary, so it isn't contiguous.
     [[nodiscard]] std::span<const float> GetSamples(SampleIndex aStartSample,
                                                     SampleCount aSampleCount) const;
 
+    /// @brief Get the min, max and RMS of a range.  Safe from any thread.
+    /// @param aStartSample Starting sample index
+    /// @param aSampleCount Number of samples; clipped to those published
+    /// @return Levels of the range, or zeros if it is empty
+    ///
+    /// Reads the coarsest pyramid level whose groups fit in the range, then
+    /// finer levels and finally samples for the end the pyramid hasn't
+    /// summarized yet: a few entries and at most a base group of samples.
+    /// Groups are read whole, so the result may include up to a group of
+    /// samples on either side of the range.
+    [[nodiscard]] WaveformPyramid::Entry Summarize(SampleIndex aStartSample,
+                                                   SampleCount aSampleCount) const;
+
+    /// @brief Get the pyramid of levels.  Safe from any thread.
+    [[nodiscard]] const WaveformPyramid& GetPyramid() const { return mPyramid; }
+
   private:
+    /// @brief Floats per page: the overlap with the previous page, then its own samples
+    static constexpr size_t KPageStride = KMaxSpanSamples + KPageSamples;
+
+    /// @brief Get a page for writing, allocating it if needed.  Writer thread only.
+    /// @param aPage Page number
+    /// @return The page's storage
+    std::span<float> GetWritablePage(size_t aPage);
+
     SampleRate mSampleRate;
-    std::vector<float> mData;
+    std::atomic<size_t> mSampleCount{ 0 };
+    BlockDirectory<float> mDirectory; // Page pointers, indexed by page number
+    std::atomic<size_t> mMemoryBytes{ 0 };
+    WaveformPyramid mPyramid;
+
+    // Writer thread only
+    std::vector<std::unique_ptr<float[]>> mPages;
 };
@@ -0,0 +1,55 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <audio_types.h>
+#include <span>
+
+/// @brief Interface for read-only, random access multi-channel sample storage
+///
+/// This is what SpectrogramEngine computes rows from.  The GUI's AudioBuffer
+/// implements it; headless services can implement it over their own storage.
+class ISampleSource
+{
+  public:
+    virtual ~ISampleSource() = default;
+
+    /// @brief Get the number of channels
+    /// @return Channel count
+    [[nodiscard]] virtual ChannelCount GetChannelCount() const = 0;
+
+    /// @brief Get the sample rate
+    /// @return Sample rate in Hz
+    [[nodiscard]] virtual SampleRate GetSampleRate() const = 0;
+
+    /// @brief Get the number of frames available in every channel
+    /// @return Frame count
+    [[nodiscard]] virtual FrameCount GetFrameCount() const = 0;
+
+    /// @brief Get samples from a specific channel
+    /// @param aChannelIndex Channel index (0-based)
+    /// @param aStartSample Starting sample index
+    /// @param aSampleCount Number of samples to retrieve
+    /// @return Read-only span of samples, valid until the source is modified
+    /// @throws std::out_of_range if aChannelIndex >= channel count, or if there
+    /// aren't enough samples to fill the request.
+    [[nodiscard]] virtual std::span<const float> GetSamples(ChannelCount aChannelIndex,
+                                                            SampleIndex aStartSample,
+                                                            SampleCount aSampleCount) const = 0;
+
+    /// @brief Find a channel whose samples duplicate another's over a range
+    /// @param aChannelIndex Channel index (0-based)
+    /// @param aStartSample Starting sample index
+    /// @param aSampleCount Number of samples in the range
+    /// @return A lower-numbered channel with bit-identical samples throughout
+    /// the range, or aChannelIndex if none is known to have them
+    /// @note Lets SpectrogramEngine transform duplicated channels once.  The
+    /// default knows of none.
+    [[nodiscard]] virtual ChannelCount FindIdenticalChannel(ChannelCount aChannelIndex,
+                                                            SampleIndex /*aStartSample*/,
+                                                            SampleCount /*aSampleCount*/) const
+    {
+        return aChannelIndex;
+    }
+};
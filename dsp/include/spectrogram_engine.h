@@ -0,0 +1,405 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <audio_types.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_budget.h>
+#include <mutex>
+#include <sample_source.h>
+#include <span>
+#include <thread>
+#include <vector>
+
+/// @brief Computes and caches spectrogram rows from an ISampleSource
+///
+/// The framework-free core of the spectrogram: per-channel FFT processing, the
+/// row cache, stride alignment and range queries.  SpectrogramController is a
+/// thin Qt adapter over this class; headless services can embed it directly.
+///
+/// Each channel has its own IFFTProcessor, FFTWindow and row cache, so
+/// different channels may be computed concurrently.  GetChannelRows() does so
+/// on a pool of workers, one fewer than the channels, that Configure() starts:
+/// the calling thread takes the last channel with rows to compute.  Calls for
+/// the same channel must not overlap, and the source must not be modified
+/// during a call.
+///
+/// Once a range is cached, the view getters (GetRowView(), GetChannelRowViews())
+/// do not allocate: they return spans into the cache, or into a shared row of
+/// zeros for unavailable rows.  Computing a range allocates only the cache
+/// entries of its new rows.
+///
+/// Windows too quiet for any bin to reach the silence floor are silent: their
+/// FFT is skipped and they share one floor row, computed by Configure().  By
+/// default only windows of zero or subnormal samples are silent; a view can
+/// raise the floor to the lowest level it displays (SetSilenceFloor()).  The
+/// cache records silence as stretches of frames, one map entry per stretch
+/// however many rows fall inside it.
+///
+/// A channel the source reports as a duplicate of a lower channel over the
+/// requested range (ISampleSource::FindIdenticalChannel()) is served from that
+/// channel's rows: it is neither transformed nor cached.
+///
+/// The row cache is an IMemoryConsumer.  ReleaseMemory() evicts the rows
+/// farthest from the range most recently requested, so the rows on screen are
+/// the last to go.
+class SpectrogramEngine : public IMemoryConsumer
+{
+  public:
+    /// @brief Row views for every channel: [channel][row] -> frequency bins
+    using RowViews = std::vector<std::vector<std::span<const float>>>;
+
+    /// @brief Constructor
+    /// @param aSource Sample source to compute rows from
+    /// @param aTransformSize FFT transform size
+    /// @param aWindowType Window function type
+    /// @param aFFTProcessorFactory Factory for FFT processors (optional)
+    /// @param aFFTWindowFactory Factory for FFT windows (optional)
+    ///
+    /// The factories are used for dependency injection in tests.  By default,
+    /// FFTProcessor and FFTWindow instances are created.
+    SpectrogramEngine(const ISampleSource& aSource,
+                      FFTSize aTransformSize,
+                      FFTWindow::Type aWindowType,
+                      IFFTProcessor::Factory aFFTProcessorFactory = nullptr,
+                      FFTWindowFactory aFFTWindowFactory = nullptr);
+    ~SpectrogramEngine() override;
+
+    SpectrogramEngine(const SpectrogramEngine&) = delete;
+    SpectrogramEngine& operator=(const SpectrogramEngine&) = delete;
+    SpectrogramEngine(SpectrogramEngine&&) = delete;
+    SpectrogramEngine& operator=(SpectrogramEngine&&) = delete;
+
+    /// @brief Recreate the FFT processors and windows and clear the row cache
+    /// @param aTransformSize FFT transform size
+    /// @param aWindowType Window function type
+    ///
+    /// Must be called whenever the transform settings change or the source is
+    /// reset, including a change of channel count.
+    void Configure(FFTSize aTransformSize, FFTWindow::Type aWindowType);
+
+    /// @brief Set the level below which windows are treated as silent
+    /// @param aDecibels Windows whose every bin is bounded below this are
+    /// silent.  -inf, the default, limits silence to zero or subnormal samples.
+    ///
+    /// A window's bins are bounded by its peak sample times the sum of the
+    /// window coefficients, so silence is decided without a transform.
+    /// Forgets the cached stretches of silence; cached rows are kept.
+    void SetSilenceFloor(float aDecibels);
+
+    /// @brief Get the FFT transform size
+    /// @return Transform size in samples
+    [[nodiscard]] FFTSize GetTransformSize() const noexcept { return mTransformSize; }
+
+    /// @brief Get the number of frequency bins in each row
+    /// @return Bin count (transform size / 2 + 1)
+    [[nodiscard]] size_t GetBinCount() const noexcept { return (mTransformSize / 2) + 1; }
+
+    /// @brief Get spectrogram rows for a channel
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aRowCount Number of rows to compute
+    /// @param aStride Number of frames between the starts of successive rows
+    /// @return 2D vector [aRowCount][frequency_bins] containing frequency magnitudes
+    /// @throws std::out_of_range if aChannel is invalid
+    [[nodiscard]] std::vector<std::vector<float>> GetRows(ChannelCount aChannel,
+                                                          FramePosition aFirstFrame,
+                                                          size_t aRowCount,
+                                                          FFTSize aStride) const;
+
+    /// @brief Get the same range of spectrogram rows for every channel
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aRowCount Number of rows to compute
+    /// @param aStride Number of frames between the starts of successive rows
+    /// @return 3D vector [channel][aRowCount][frequency_bins]
+    ///
+    /// Channels with uncached rows are computed in parallel.
+    [[nodiscard]] std::vector<std::vector<std::vector<float>>> GetChannelRows(
+      FramePosition aFirstFrame,
+      size_t aRowCount,
+      FFTSize aStride) const;
+
+    /// @brief Get views of the same range of spectrogram rows for every channel
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aRowCount Number of rows to compute
+    /// @param aStride Number of frames between the starts of successive rows
+    /// @param aViews Resized to [channel][aRowCount] and filled with row views
+    ///
+    /// Like GetChannelRows(), but without copying.  The views stay valid until
+    /// Configure() or ReleaseMemory() is called.  Reusing aViews across calls
+    /// with the same shape and a cached range allocates nothing.
+    void GetChannelRowViews(FramePosition aFirstFrame,
+                            size_t aRowCount,
+                            FFTSize aStride,
+                            RowViews& aViews) const;
+
+    /// @brief Get a single spectrogram row for a channel
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @return Vector of frequency magnitudes for the specified row
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @note Uses internal caching to avoid redundant computations
+    /// @note If ANY samples in the requested window are not available, returns a
+    /// vector of zeros.
+    /// @note Silent windows return the floor row
+    [[nodiscard]] std::vector<float> GetRow(ChannelCount aChannel, FramePosition aFirstFrame) const;
+
+    /// @brief Get a view of a single spectrogram row for a channel
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @return Frequency magnitudes, valid until Configure() or ReleaseMemory()
+    /// is called
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @note Like GetRow(), but without copying.  Allocates only on a cache miss.
+    [[nodiscard]] std::span<const float> GetRowView(ChannelCount aChannel,
+                                                    FramePosition aFirstFrame) const;
+
+    /// @brief Compute FFT for a channel at a specific frame position
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @return Vector of frequency magnitudes
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @throws std::out_of_range if requested samples are not available
+    /// @note Does not use caching; called internally by GetRow
+    [[nodiscard]] std::vector<float> ComputeFFT(ChannelCount aChannel,
+                                                FrameIndex aFirstFrame) const;
+
+    /// @brief Compute FFT for a channel at a specific frame position, in place
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aDecibels Output, GetBinCount() values
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @throws std::out_of_range if requested samples are not available
+    /// @throws std::invalid_argument if aDecibels is the wrong size
+    /// @note Does not allocate
+    void ComputeFFT(ChannelCount aChannel,
+                    FrameIndex aFirstFrame,
+                    std::span<float> aDecibels) const;
+
+    /// @brief Get the number of available frames
+    /// @return Number of frames currently available in the source
+    [[nodiscard]] FrameCount GetAvailableFrameCount() const { return mSource.GetFrameCount(); }
+
+    /// @brief Get the number of available channels
+    /// @return Number of audio channels in the source
+    [[nodiscard]] ChannelCount GetChannelCount() const { return mSource.GetChannelCount(); }
+
+    /// @brief Get frequency resolution in Hz per FFT bin
+    /// @return Frequency resolution in Hz
+    [[nodiscard]] float GetHzPerBin() const;
+
+    /// @brief Calculate the first frame in the stride-aligned window containing aCursorFrame
+    /// @param aCursorFrame Cursor frame index
+    /// @param aStride Row stride in frames
+    /// @return First frame index of the stride-aligned window containing aCursorFrame
+    /// @note Returns a negative value if aCursorFrame is less than one transform window
+    [[nodiscard]] FramePosition CalculateTopOfWindow(FramePosition aCursorFrame,
+                                                     FFTSize aStride) const;
+
+    /// @brief Get the number of rows in the cache, across all channels
+    [[nodiscard]] size_t GetCachedRowCount() const;
+
+    /// @brief Get the number of stretches of silence in the cache, across all
+    /// channels
+    [[nodiscard]] size_t GetSilentRunCount() const;
+
+    /// @brief Check whether a window is silent: every sample's magnitude below
+    /// aPeakLimit
+    /// @param aSamples Window samples
+    /// @param aPeakLimit Non-negative limit.  The default accepts only zero or
+    /// subnormal samples.
+    /// @return true if the window's spectrum is the floor row
+    [[nodiscard]] static bool IsSilent(
+      std::span<const float> aSamples,
+      float aPeakLimit = std::numeric_limits<float>::min()) noexcept;
+
+    /// @brief Get the bytes held by the row cache, scratch buffers, FFT
+    /// processors and windows
+    [[nodiscard]] size_t GetMemoryBytes() const override;
+
+    /// @brief Evict cached rows, farthest from the last requested range first
+    /// @param aBytes Bytes to free
+    /// @return Bytes freed.  Less than asked once the cache is empty, since
+    /// the other buffers are in use.
+    size_t ReleaseMemory(size_t aBytes) override;
+
+    /// @brief round a frame index down to nearest window stride
+    /// @param aFrame Frame index
+    /// @param aStride Row stride in frames
+    /// @return Frame index rounded down to nearest window stride
+    [[nodiscard]] static FramePosition RoundToStride(FramePosition aFrame, FFTSize aStride);
+
+  private:
+    /// @brief A ComputeChannels() call, as the workers see it
+    struct Batch
+    {
+        std::span<const ChannelCount> channels;
+        FramePosition first_frame{ 0 };
+        FFTSize stride{ 1 };
+        RowViews* views = nullptr;
+    };
+
+    /// @brief A pool thread, and what its share of the batch threw
+    struct Worker
+    {
+        std::jthread thread;
+        std::exception_ptr error;
+    };
+
+    /// @brief Per-channel DSP state.  Only touched by one thread at a time.
+    struct Channel
+    {
+        std::unique_ptr<IFFTProcessor> fft_processor;
+        std::unique_ptr<FFTWindow> fft_window;
+
+        // Windowed samples, reused by every ComputeFFT() call
+        std::vector<float> windowed;
+
+        // Row cache.  Key: first frame.  Stores a single row of spectrogram
+        // data for reuse.
+        std::map<FrameIndex, std::vector<float>> row_cache;
+
+        // Stretches of frames known to be silent, disjoint and not touching.
+        // Key: first frame, value: end frame.  A window inside one is silent.
+        std::map<FrameIndex, FrameIndex> silent_runs;
+    };
+
+    /// @brief Check whether any row in a range would need computing
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position
+    /// @param aRowCount Number of rows
+    /// @param aStride Row stride in frames
+    /// @return true if at least one available row is not cached
+    [[nodiscard]] bool HasUncachedRows(ChannelCount aChannel,
+                                       FramePosition aFirstFrame,
+                                       size_t aRowCount,
+                                       FFTSize aStride) const;
+
+    /// @brief Compute rows for several channels, one worker each
+    /// @param aChannels Channels with rows to compute
+    /// @param aFirstFrame First frame position
+    /// @param aStride Row stride in frames
+    /// @param aViews Row views for every channel; the computed channels' are filled
+    ///
+    /// Workers take all but the last channel; this thread takes the last.
+    /// Blocks until every channel is done.
+    void ComputeChannels(std::span<const ChannelCount> aChannels,
+                         FramePosition aFirstFrame,
+                         FFTSize aStride,
+                         RowViews& aViews) const;
+
+    /// @brief Start a worker for every channel but one
+    void StartWorkers();
+
+    /// @brief Stop and join the workers
+    void StopWorkers();
+
+    /// @brief Worker thread main loop
+    /// @param aWorkerIndex Index of this worker in mWorkers, and of the
+    /// channel it takes in each batch
+    void WorkerLoop(size_t aWorkerIndex);
+
+    /// @brief Find the channel whose rows serve a range of another's
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position
+    /// @param aRowCount Number of rows
+    /// @param aStride Row stride in frames
+    /// @return A lower channel with identical samples over every available
+    /// row in the range, or aChannel
+    [[nodiscard]] ChannelCount FindRowSource(ChannelCount aChannel,
+                                             FramePosition aFirstFrame,
+                                             size_t aRowCount,
+                                             FFTSize aStride) const;
+
+    /// @brief Get a view of a channel's own row, ignoring duplicate channels
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position
+    /// @return Frequency magnitudes, computed into the channel's cache if needed
+    [[nodiscard]] std::span<const float> GetOwnRowView(ChannelCount aChannel,
+                                                       FramePosition aFirstFrame) const;
+
+    /// @brief Fill views of a range of rows for a channel
+    /// @param aChannel Channel index (0-based)
+    /// @param aFirstFrame First frame position
+    /// @param aStride Row stride in frames
+    /// @param aViews One view per row
+    void GetRowViews(ChannelCount aChannel,
+                     FramePosition aFirstFrame,
+                     FFTSize aStride,
+                     std::span<std::span<const float>> aViews) const;
+
+    /// @brief Check whether a window lies inside a channel's silent runs
+    /// @param aChannel Channel state
+    /// @param aFirstFrame First frame of the window
+    [[nodiscard]] bool IsInSilentRun(const Channel& aChannel, FrameIndex aFirstFrame) const;
+
+    /// @brief Record a silent window, merging it with the runs it touches
+    /// @param aChannel Channel state
+    /// @param aFirstFrame First frame of the window
+    void AddSilentRun(Channel& aChannel, FrameIndex aFirstFrame) const;
+
+    /// @brief Get the bytes held by one cached row
+    [[nodiscard]] size_t GetRowBytes() const;
+
+    /// @brief Work out mSilentPeak from the silence floor and the window
+    void UpdateSilentPeak();
+
+    /// @brief Remove the cached rows from the engine.cache_rows metric
+    void ReleaseCachedRows();
+
+    /// @brief Get a channel's state
+    /// @throws std::out_of_range if aChannel is invalid
+    [[nodiscard]] Channel& GetChannel(ChannelCount aChannel) const;
+
+    const ISampleSource& mSource;
+    FFTSize mTransformSize;
+
+    IFFTProcessor::Factory mFFTProcessorFactory;
+    FFTWindowFactory mFFTWindowFactory;
+
+    // Mutable because the row cache is filled by const getters
+    mutable std::vector<Channel> mChannels;
+
+    // Scratch for GetChannelRowViews(): the channel serving each channel's rows
+    mutable std::vector<ChannelCount> mRowSources;
+
+    // Scratch for GetChannelRowViews(): the channels with rows to compute
+    mutable std::vector<ChannelCount> mToCompute;
+
+    // Returned for rows that are not available
+    std::vector<float> mZeroRow;
+
+    // Returned for silent rows: the spectrum of a window of zeros
+    std::vector<float> mFloorRow;
+
+    // See SetSilenceFloor()
+    float mSilenceFloorDecibels = -std::numeric_limits<float>::infinity();
+
+    // Windows whose samples all lie below this are silent
+    float mSilentPeak = std::numeric_limits<float>::min();
+
+    // First frame of the range most recently requested; eviction keeps the
+    // rows nearest to it
+    mutable FramePosition mFocusFrame{ 0 };
+
+    // Dispatch state, guarded by mWorkMutex.  mGeneration is bumped for each
+    // batch; workers wake when it changes, and those with a channel in it
+    // count mPendingWorkers down as they finish.
+    mutable std::vector<Worker> mWorkers;
+    mutable std::mutex mWorkMutex;
+    mutable std::condition_variable mWorkAvailable;
+    mutable std::condition_variable mWorkDone;
+    mutable Batch mBatch;
+    mutable uint64_t mGeneration{ 0 };
+    mutable size_t mPendingWorkers{ 0 };
+    bool mStopping{ false };
+};
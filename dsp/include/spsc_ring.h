@@ -0,0 +1,106 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/// @brief Lock-free single-producer, single-consumer ring buffer
+///
+/// Hands samples from a reader thread to a consumer thread without locks or
+/// allocation.  Exactly one thread may call Write() and exactly one thread may
+/// call Read(); the Get*Available() methods may be called from either.
+///
+/// Storage is allocated once at construction.  The capacity is rounded up to a
+/// power of two so indices wrap with a mask.
+template<typename T>
+class SpscRing
+{
+  public:
+    /// @brief Constructor
+    /// @param aMinCapacity Minimum number of elements the ring can hold
+    /// @throws std::invalid_argument if aMinCapacity is zero
+    explicit SpscRing(size_t aMinCapacity)
+      : mData(CheckedCapacity(aMinCapacity))
+      , mMask(mData.size() - 1)
+    {
+    }
+
+    /// @brief Get the number of elements the ring can hold
+    [[nodiscard]] size_t GetCapacity() const { return mData.size(); }
+
+    /// @brief Get the number of elements ready to read
+    [[nodiscard]] size_t GetReadAvailable() const
+    {
+        return mWriteIndex.load(std::memory_order_acquire) -
+               mReadIndex.load(std::memory_order_acquire);
+    }
+
+    /// @brief Get the number of elements that can be written without overrun
+    [[nodiscard]] size_t GetWriteAvailable() const { return GetCapacity() - GetReadAvailable(); }
+
+    /// @brief Write elements.  Producer thread only.
+    /// @param aItems Elements to write
+    /// @return Number of elements written, less than aItems.size() if the ring
+    /// is full
+    size_t Write(std::span<const T> aItems)
+    {
+        const size_t kWriteIndex = mWriteIndex.load(std::memory_order_relaxed);
+        const size_t kReadIndex = mReadIndex.load(std::memory_order_acquire);
+        const size_t kCount = std::min(aItems.size(), GetCapacity() - (kWriteIndex - kReadIndex));
+
+        const size_t kOffset = kWriteIndex & mMask;
+        const size_t kFirstPart = std::min(kCount, GetCapacity() - kOffset);
+        const auto kData = std::span<T>(mData);
+        std::ranges::copy(aItems.first(kFirstPart), kData.subspan(kOffset).begin());
+        std::ranges::copy(aItems.subspan(kFirstPart, kCount - kFirstPart), kData.begin());
+
+        mWriteIndex.store(kWriteIndex + kCount, std::memory_order_release);
+        return kCount;
+    }
+
+    /// @brief Read elements.  Consumer thread only.
+    /// @param aItems Destination
+    /// @return Number of elements read, less than aItems.size() if the ring
+    /// runs empty
+    size_t Read(std::span<T> aItems)
+    {
+        const size_t kReadIndex = mReadIndex.load(std::memory_order_relaxed);
+        const size_t kWriteIndex = mWriteIndex.load(std::memory_order_acquire);
+        const size_t kCount = std::min(aItems.size(), kWriteIndex - kReadIndex);
+
+        const size_t kOffset = kReadIndex & mMask;
+        const size_t kFirstPart = std::min(kCount, GetCapacity() - kOffset);
+        const auto kData = std::span<const T>(mData);
+        std::ranges::copy(kData.subspan(kOffset, kFirstPart), aItems.begin());
+        std::ranges::copy(kData.first(kCount - kFirstPart),
+                          aItems.begin() + static_cast<std::ptrdiff_t>(kFirstPart));
+
+        mReadIndex.store(kReadIndex + kCount, std::memory_order_release);
+        return kCount;
+    }
+
+  private:
+    static size_t CheckedCapacity(size_t aMinCapacity)
+    {
+        if (aMinCapacity == 0) {
+            throw std::invalid_argument("SpscRing capacity must be positive");
+        }
+        return std::bit_ceil(aMinCapacity);
+    }
+
+    // Keep the indices on separate cache lines so the producer and consumer
+    // don't contend for the same line.
+    static constexpr size_t KCacheLineSize = 64;
+
+    std::vector<T> mData;
+    size_t mMask;
+    alignas(KCacheLineSize) std::atomic<size_t> mWriteIndex{ 0 };
+    alignas(KCacheLineSize) std::atomic<size_t> mReadIndex{ 0 };
+};
@@ -0,0 +1,121 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef SPECTRO_TRACING
+#define SPECTRO_TRACING 0
+#endif
+
+#define SPECTRO_TRACE_CONCAT_INNER(a, b) a##b
+#define SPECTRO_TRACE_CONCAT(a, b) SPECTRO_TRACE_CONCAT_INNER(a, b)
+
+/// @brief Time the enclosing scope as a trace zone
+/// @param aName String literal naming the zone, e.g. "AudioBuffer::AddSamples"
+///
+/// Expands to nothing unless the build is configured with
+/// -DSPECTRO_TRACING=ON, so release builds pay nothing for instrumentation.
+#if SPECTRO_TRACING
+#define SPECTRO_TRACE_ZONE(aName)                                                                 \
+    const Trace::Zone SPECTRO_TRACE_CONCAT(spectroTraceZone, __LINE__)(aName)
+#else
+#define SPECTRO_TRACE_ZONE(aName) static_cast<void>(0)
+#endif
+
+/// @brief Low-overhead scoped tracing with Chrome trace export
+///
+/// Each thread records completed zones into its own fixed-size ring buffer.
+/// Recording takes no locks and never allocates: the only shared state a zone
+/// touches is the enabled flag.  When a buffer is full the oldest events are
+/// overwritten.  Buffers are registered (under a mutex) the first time a
+/// thread records, and handed to the next new thread when their thread exits,
+/// so short-lived workers don't grow memory without bound.  An event's thread
+/// id therefore names a buffer: threads that ran one after another may share
+/// a track in the trace viewer.
+///
+/// Recording is off until SetEnabled(true).  A disabled zone costs one relaxed
+/// atomic load; an enabled one two steady_clock reads and four stores, roughly
+/// 40 ns on current x86.  See the Tracing section of docs/architecture.md for
+/// the overhead budget.
+class Trace
+{
+  public:
+    /// @brief Whether SPECTRO_TRACE_ZONE is compiled in
+    static constexpr bool KCompiledIn = SPECTRO_TRACING != 0;
+
+    /// @brief Capacity of each thread's ring buffer, in events
+    static constexpr size_t KEventsPerThread = size_t{ 1 } << 16;
+
+    /// @brief One completed zone
+    struct Event
+    {
+        const char* name{};
+        uint32_t thread_id{};
+        uint64_t start_ns{};
+        uint64_t duration_ns{};
+    };
+
+    /// @brief RAII zone.  Use SPECTRO_TRACE_ZONE rather than constructing
+    /// directly, so the zone compiles away in untraced builds.
+    class Zone
+    {
+      public:
+        /// @brief Start the zone
+        /// @param aName Zone name.  Must outlive the trace: use a string literal.
+        explicit Zone(const char* aName) noexcept;
+
+        /// @brief End the zone and record it
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+        Zone(Zone&&) = delete;
+        Zone& operator=(Zone&&) = delete;
+
+      private:
+        const char* mName;
+        uint64_t mStartNs{};
+        bool mActive;
+    };
+
+    /// @brief Start or stop recording
+    static void SetEnabled(bool aEnabled);
+
+    /// @brief Check whether zones are being recorded
+    [[nodiscard]] static bool IsEnabled();
+
+    /// @brief Discard everything recorded so far
+    ///
+    /// Safe to call while other threads record: events are hidden by start
+    /// time rather than erased.
+    static void Clear();
+
+    /// @brief Copy the recorded events
+    /// @return Events from all threads, ordered by start time
+    ///
+    /// May be called while other threads record.  Events overwritten during
+    /// the copy are dropped rather than returned torn.
+    [[nodiscard]] static std::vector<Event> Snapshot();
+
+    /// @brief Write the recorded events as a Chrome trace event JSON document
+    /// @param aStream Output stream
+    ///
+    /// The output loads in chrome://tracing and ui.perfetto.dev.
+    static void WriteChromeJson(std::ostream& aStream);
+
+    /// @brief Write the recorded events to a Chrome trace file
+    /// @param aPath Output file path
+    /// @return Error message on failure
+    [[nodiscard]] static std::expected<void, std::string> WriteChromeJsonFile(
+      const std::string& aPath);
+
+    /// @brief Get the trace clock, in nanoseconds since the first call
+    [[nodiscard]] static uint64_t Now() noexcept;
+};
@@ -0,0 +1,110 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <block_directory.h>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+/// @brief Min, max and RMS of a single-channel recording at every power-of-two zoom
+///
+/// Level L holds one entry per group of GetGroupSamples(L) samples: 256 for
+/// level 0, doubling with each level.  Add() summarizes each base group as it
+/// completes and merges pairs upward, so keeping the pyramid costs a few
+/// operations per sample and a little over 2% of the samples' memory.
+/// Drawing any span of the recording at any width then reads a few entries
+/// per pixel.
+///
+/// Same threading as SampleBuffer: one writer, any number of concurrent
+/// readers.  Entries live in chunks that never move, reached through a
+/// BlockDirectory that is replaced by a larger copy when it fills.  Each level's
+/// entry count is published with release semantics after the entry is stored.
+class WaveformPyramid
+{
+  public:
+    static constexpr size_t KBaseGroupSamples = 256; ///< Samples per level 0 entry
+    static constexpr size_t KLevelCount = 32;        ///< Top level spans 2^39 samples
+    static constexpr size_t KChunkEntries = 1024;    ///< Entries allocated at a time
+
+    /// @brief Levels of one group of samples
+    struct Entry
+    {
+        float min;
+        float max;
+        float mean_square;
+    };
+
+    WaveformPyramid() = default;
+    WaveformPyramid(const WaveformPyramid&) = delete;
+    WaveformPyramid& operator=(const WaveformPyramid&) = delete;
+    WaveformPyramid(WaveformPyramid&&) = delete;
+    WaveformPyramid& operator=(WaveformPyramid&&) = delete;
+    ~WaveformPyramid() = default;
+
+    /// @brief Get the samples each entry of a level covers
+    [[nodiscard]] static constexpr size_t GetGroupSamples(size_t aLevel)
+    {
+        return KBaseGroupSamples << aLevel;
+    }
+
+    /// @brief Get the coarsest level whose groups are no longer than a range
+    /// @param aSampleCount Samples in the range, e.g. per pixel
+    /// @return Level index, or KLevelCount if aSampleCount < KBaseGroupSamples
+    [[nodiscard]] static size_t GetLevelFor(size_t aSampleCount);
+
+    /// @brief Summarize appended samples.  Writer thread only.
+    /// @param aSamples Samples following those already added
+    /// @note Does not allocate while the total stays within the reserved capacity.
+    void Add(std::span<const float> aSamples);
+
+    /// @brief Reserve entries for a number of samples at every level.  Writer thread only.
+    /// @param aSampleCount Total number of samples to make room for
+    void Reserve(size_t aSampleCount);
+
+    /// @brief Get the number of published entries in a level.  Safe from any thread.
+    [[nodiscard]] size_t GetEntryCount(size_t aLevel) const
+    {
+        return mLevels[aLevel].count.load(std::memory_order_acquire);
+    }
+
+    /// @brief Get an entry.  Safe from any thread.
+    /// @param aLevel Level index
+    /// @param aIndex Entry index; must be below a GetEntryCount() already loaded
+    [[nodiscard]] const Entry& GetEntry(size_t aLevel, size_t aIndex) const;
+
+    /// @brief Get the bytes held, including reserved but unused entries.  Safe from any thread.
+    [[nodiscard]] size_t GetMemoryBytes() const
+    {
+        return mMemoryBytes.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Level
+    {
+        std::atomic<size_t> count{ 0 };
+        BlockDirectory<Entry> directory; // Chunk pointers, indexed by chunk number
+
+        // Writer thread only
+        std::vector<std::unique_ptr<Entry[]>> chunks;
+    };
+
+    /// @brief Append an entry to a level, and merge the last pair into the next level up
+    void Push(size_t aLevel, const Entry& aEntry);
+
+    /// @brief Get a chunk for writing, allocating it if needed.  Writer thread only.
+    Entry* GetWritableChunk(Level& aLevel, size_t aChunk);
+
+    std::array<Level, KLevelCount> mLevels;
+    std::atomic<size_t> mMemoryBytes{ 0 };
+
+    // The base group being filled.  Writer thread only.
+    size_t mPartialCount = 0;
+    float mPartialMin = 0.0f;
+    float mPartialMax = 0.0f;
+    double mPartialSumOfSquares = 0.0;
+};
@@ -0,0 +1,105 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <adaptive_block_sizer.h>
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <stdexcept>
+
+namespace {
+constexpr double KNanosecondsPerSecond = 1e9;
+
+/// @brief Margin over the longest callback gap that the buffer must cover
+constexpr double KGapMargin = 1.25;
+} // namespace
+
+AdaptiveBlockSizer::AdaptiveBlockSizer(SampleRate aSampleRate,
+                                       size_t aBytesPerFrame,
+                                       const Metrics::Histogram* aRenderTimes)
+  : mSampleRate(aSampleRate)
+  , mBytesPerFrame(aBytesPerFrame)
+  , mRenderTimes(aRenderTimes)
+  , mBufferFrames(0)
+{
+    if (aSampleRate <= 0 || aBytesPerFrame == 0) {
+        throw std::invalid_argument("AdaptiveBlockSizer: sample rate and frame size must be > 0");
+    }
+    mBufferFrames = FramesFor(KInitialPeriodNs);
+}
+
+bool
+AdaptiveBlockSizer::OnCallback(int64_t aNowNs, size_t aQueuedBytes)
+{
+    if (mWindowStartNs < 0) {
+        ResetWindow(aNowNs);
+    }
+    if (mLastCallbackNs >= 0) {
+        mMaxGapNs = std::max(mMaxGapNs, aNowNs - mLastCallbackNs);
+    }
+    mLastCallbackNs = aNowNs;
+
+    // Full or nearly full: audio is being lost, or soon will be.  Don't wait
+    // for the window to end.
+    const double kFill =
+      static_cast<double>(aQueuedBytes) / static_cast<double>(GetBufferBytes());
+    mMaxFill = std::max(mMaxFill, kFill);
+    if (kFill >= KHighFill) {
+        mStableWindows = 0;
+        ResetWindow(aNowNs);
+        return SetBufferFrames(mBufferFrames * 2);
+    }
+
+    if (aNowNs - mWindowStartNs < KWindowNs) {
+        return false;
+    }
+    const bool kPlentyOfHeadroom = mMaxFill < KLowFill;
+    const int64_t kMaxGapNs = mMaxGapNs;
+    ResetWindow(aNowNs);
+    if (!kPlentyOfHeadroom) {
+        mStableWindows = 0;
+        return false;
+    }
+    if (++mStableWindows < KStableWindowsBeforeShrink) {
+        return false;
+    }
+    mStableWindows = 0;
+
+    const int64_t kRenderNs =
+      mRenderTimes != nullptr ? static_cast<int64_t>(mRenderTimes->Summarize().p50) : 0;
+    const auto kGapNs = static_cast<int64_t>(static_cast<double>(kMaxGapNs) * KGapMargin);
+    const size_t kFloor = FramesFor(std::max(kGapNs, kRenderNs / 2));
+    const size_t kTarget = std::max(mBufferFrames - (mBufferFrames / 4), kFloor);
+    return kTarget < mBufferFrames && SetBufferFrames(kTarget);
+}
+
+size_t
+AdaptiveBlockSizer::FramesFor(int64_t aNanoseconds) const
+{
+    const int64_t kClamped = std::clamp(aNanoseconds, KMinPeriodNs, KMaxPeriodNs);
+    const double kFrames =
+      static_cast<double>(kClamped) * static_cast<double>(mSampleRate) / KNanosecondsPerSecond;
+    return std::max<size_t>(1, static_cast<size_t>(kFrames));
+}
+
+bool
+AdaptiveBlockSizer::SetBufferFrames(size_t aFrames)
+{
+    const size_t kFrames = std::clamp(aFrames, FramesFor(KMinPeriodNs), FramesFor(KMaxPeriodNs));
+    if (kFrames == mBufferFrames) {
+        return false;
+    }
+    mBufferFrames = kFrames;
+    return true;
+}
+
+void
+AdaptiveBlockSizer::ResetWindow(int64_t aNowNs)
+{
+    mWindowStartNs = aNowNs;
+    mMaxGapNs = 0;
+    mMaxFill = 0.0;
+}
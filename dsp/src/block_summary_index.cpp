@@ -0,0 +1,276 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <algorithm>
+#include <array>
+#include <audio_types.h>
+#include <block_summary_index.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <mutex>
+#include <sample_buffer.h>
+#include <sample_source.h>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <trace.h>
+#include <vector>
+
+namespace {
+
+/// @brief Index of the 1 kHz band; the others are a third of an octave apart
+constexpr int KReferenceBand = 17;
+constexpr double KReferenceHz = 1000.0;
+constexpr double KBandsPerOctave = 3.0;
+constexpr int64_t KMillisecondsPerSecond = 1000;
+
+/// @brief Quantize a power to whole decibels
+int8_t
+PowerToDecibels(double aPower)
+{
+    if (aPower <= 0.0) {
+        return BlockSummaryIndex::KFloorDecibels;
+    }
+    const double kDecibels = std::round(10.0 * std::log10(aPower));
+    return static_cast<int8_t>(std::clamp(kDecibels, -128.0, 127.0));
+}
+
+/// @brief Power of a stored level, with the floor read as silence
+const std::array<double, 256>&
+GetDecibelPowers()
+{
+    static const std::array<double, 256> kPowers = [] {
+        std::array<double, 256> powers{};
+        for (size_t i = 1; i < powers.size(); i++) {
+            powers[i] = std::pow(10.0, (static_cast<double>(i) - 128.0) / 10.0);
+        }
+        return powers;
+    }();
+    return kPowers;
+}
+
+double
+DecibelsToPower(int8_t aDecibels)
+{
+    return GetDecibelPowers()[static_cast<size_t>(int{ aDecibels } + 128)];
+}
+
+} // namespace
+
+BlockSummaryIndex::BlockSummaryIndex(FFTSize aBlockFrames,
+                                     const IFFTProcessor::Factory& aFFTProcessorFactory)
+  : mBlockFrames(aBlockFrames)
+  , mFFTProcessor(aFFTProcessorFactory ? aFFTProcessorFactory(aBlockFrames)
+                                       : std::make_unique<FFTProcessor>(aBlockFrames))
+  , mWindow(aBlockFrames, FFTWindow::Type::Hann)
+  , mPowerScale(0.0f)
+  , mWindowed(aBlockFrames)
+  , mPowers((aBlockFrames / 2) + 1)
+{
+    if (aBlockFrames > SampleBuffer::KMaxSpanSamples) {
+        throw std::invalid_argument("BlockSummaryIndex: block is longer than a sample span");
+    }
+
+    // Parseval: the windowed block's energy is the sum of |X|^2 over every
+    // bin, divided by N.  Normalizing by the window's energy gives the mean
+    // square of the unwindowed signal.
+    std::vector<float> window(aBlockFrames, 1.0f);
+    mWindow.Apply(window, window);
+    double windowEnergy = 0.0;
+    for (const float kWeight : window) {
+        windowEnergy += static_cast<double>(kWeight) * kWeight;
+    }
+    mPowerScale = static_cast<float>(1.0 / (static_cast<double>(aBlockFrames) * windowEnergy));
+}
+
+void
+BlockSummaryIndex::Reset()
+{
+    const std::scoped_lock kLock(mMutex);
+    mSummaries.clear();
+    mSampleRate = 0;
+}
+
+size_t
+BlockSummaryIndex::GetBlockCount() const
+{
+    const std::scoped_lock kLock(mMutex);
+    return mSummaries.size();
+}
+
+BlockSummaryIndex::Summary
+BlockSummaryIndex::GetSummary(size_t aBlock) const
+{
+    const std::scoped_lock kLock(mMutex);
+    return mSummaries.at(aBlock);
+}
+
+float
+BlockSummaryIndex::GetBandCenterHz(size_t aBand)
+{
+    const double kExponent = (static_cast<double>(aBand) - KReferenceBand) / KBandsPerOctave;
+    return static_cast<float>(KReferenceHz * std::exp2(kExponent));
+}
+
+void
+BlockSummaryIndex::MapBins(SampleRate aSampleRate)
+{
+    mBinSampleRate = aSampleRate;
+    mBinBands.assign(mPowers.size(), -1);
+    for (size_t bin = 1; bin < mBinBands.size(); bin++) {
+        // Nearest centre on a log scale, so each band runs a sixth of an
+        // octave either side of it
+        const double kHz = static_cast<double>(bin) * aSampleRate / mBlockFrames;
+        const double kBand =
+          std::round(KBandsPerOctave * std::log2(kHz / KReferenceHz)) + KReferenceBand;
+        if (kBand >= 0 && kBand < static_cast<double>(KBandCount)) {
+            mBinBands[bin] = static_cast<int8_t>(kBand);
+        }
+    }
+}
+
+void
+BlockSummaryIndex::Update(const ISampleSource& aSource, const std::stop_token& aStopToken)
+{
+    SPECTRO_TRACE_ZONE("BlockSummaryIndex::Update");
+    const SampleRate kSampleRate = aSource.GetSampleRate();
+    if (kSampleRate != mBinSampleRate) {
+        MapBins(kSampleRate);
+    }
+    {
+        const std::scoped_lock kLock(mMutex);
+        mSampleRate = kSampleRate;
+    }
+
+    // Only this thread appends, so the count can't change under us
+    const size_t kCompleteBlocks = aSource.GetFrameCount().Get() / mBlockFrames;
+    for (size_t block = GetBlockCount(); block < kCompleteBlocks; block++) {
+        if (aStopToken.stop_requested()) {
+            return;
+        }
+        const Summary kSummary = Summarize(aSource, FrameIndex{ block * mBlockFrames });
+        const std::scoped_lock kLock(mMutex);
+        mSummaries.push_back(kSummary);
+    }
+}
+
+BlockSummaryIndex::Summary
+BlockSummaryIndex::Summarize(const ISampleSource& aSource, FrameIndex aFirstFrame)
+{
+    Summary summary;
+    summary.bands.fill(KFloorDecibels);
+    const ChannelCount kChannels = aSource.GetChannelCount();
+    if (kChannels == 0) {
+        return summary;
+    }
+
+    double sumOfSquares = 0.0;
+    float peak = 0.0f;
+    std::array<double, KBandCount> bandPowers{};
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        const std::span<const float> kSamples =
+          aSource.GetSamples(ch, SampleIndex(aFirstFrame.Get()), SampleCount(mBlockFrames));
+        for (const float kSample : kSamples) {
+            sumOfSquares += static_cast<double>(kSample) * kSample;
+            peak = std::max(peak, std::abs(kSample));
+        }
+
+        mWindow.Apply(kSamples, mWindowed);
+        mFFTProcessor->ComputePowers(mWindowed, mPowers);
+        for (size_t bin = 0; bin < mPowers.size(); bin++) {
+            if (mBinBands[bin] < 0) {
+                continue;
+            }
+            // Bins other than DC and Nyquist stand for their negative
+            // frequency twin too
+            const bool kOneSided = bin != 0 && bin + 1 != mPowers.size();
+            const double kPower = mPowers[bin];
+            bandPowers[static_cast<size_t>(mBinBands[bin])] += kOneSided ? 2.0 * kPower : kPower;
+        }
+    }
+
+    const double kSamples = static_cast<double>(mBlockFrames) * kChannels;
+    summary.rms = PowerToDecibels(sumOfSquares / kSamples);
+    summary.peak = PowerToDecibels(static_cast<double>(peak) * peak);
+    for (size_t band = 0; band < KBandCount; band++) {
+        summary.bands[band] = PowerToDecibels(bandPowers[band] * mPowerScale / kChannels);
+    }
+    return summary;
+}
+
+template<typename Predicate>
+std::vector<BlockSummaryIndex::TimeRange>
+BlockSummaryIndex::FindBlocks(Predicate aPredicate) const
+{
+    const auto kToMs = [this](size_t aBlock, bool aRoundUp) {
+        const auto kFrameMs = static_cast<int64_t>(aBlock * mBlockFrames) * KMillisecondsPerSecond;
+        return (kFrameMs + (aRoundUp ? mSampleRate - 1 : 0)) / mSampleRate;
+    };
+
+    std::vector<TimeRange> ranges;
+    size_t block = 0;
+    while (block < mSummaries.size()) {
+        if (!aPredicate(mSummaries[block])) {
+            block++;
+            continue;
+        }
+        const size_t kFirst = block;
+        while (block < mSummaries.size() && aPredicate(mSummaries[block])) {
+            block++;
+        }
+        ranges.push_back({ .first_ms = kToMs(kFirst, false), .end_ms = kToMs(block, true) });
+    }
+    return ranges;
+}
+
+std::vector<BlockSummaryIndex::TimeRange>
+BlockSummaryIndex::FindBandPowerAbove(float aLowHz, float aHighHz, float aThresholdDecibels) const
+{
+    size_t firstBand = KBandCount;
+    size_t endBand = 0;
+    for (size_t band = 0; band < KBandCount; band++) {
+        const float kCenter = GetBandCenterHz(band);
+        if (kCenter >= aLowHz && kCenter <= aHighHz) {
+            firstBand = std::min(firstBand, band);
+            endBand = band + 1;
+        }
+    }
+    if (firstBand >= endBand) {
+        throw std::invalid_argument("BlockSummaryIndex: no band centre in the frequency range");
+    }
+
+    const double kThreshold = std::pow(10.0, aThresholdDecibels / 10.0);
+    const std::scoped_lock kLock(mMutex);
+    return FindBlocks([&](const Summary& aSummary) {
+        double power = 0.0;
+        for (size_t band = firstBand; band < endBand; band++) {
+            power += DecibelsToPower(aSummary.bands[band]);
+        }
+        return power >= kThreshold;
+    });
+}
+
+std::vector<BlockSummaryIndex::TimeRange>
+BlockSummaryIndex::FindRmsAbove(float aThresholdDecibels) const
+{
+    const double kThreshold = std::pow(10.0, aThresholdDecibels / 10.0);
+    const std::scoped_lock kLock(mMutex);
+    return FindBlocks(
+      [&](const Summary& aSummary) { return DecibelsToPower(aSummary.rms) >= kThreshold; });
+}
+
+size_t
+BlockSummaryIndex::GetMemoryBytes() const
+{
+    // mBinBands is a byte per bin, counted from mPowers because Update() may
+    // be resizing it
+    const std::scoped_lock kLock(mMutex);
+    return (mSummaries.capacity() * sizeof(Summary)) + mFFTProcessor->GetMemoryBytes() +
+           mWindow.GetMemoryBytes() + mPowers.size() +
+           ((mWindowed.capacity() + mPowers.capacity()) * sizeof(float));
+}
@@ -0,0 +1,385 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "distortion_meter.h"
+#include <algorithm>
+#include <array>
+#include <audio_types.h>
+#include <cmath>
+#include <cstddef>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief 10^(dB/10) == exp(dB * this), and exp is much cheaper than pow
+constexpr float KDecibelsToPowerExponent = std::numbers::ln10_v<float> / 10.0f;
+
+/// @brief Most refinements of the frequency in FitSine()
+constexpr size_t KMaxFitIterations = 4;
+
+/// @brief A frequency step too small to matter: the phase it moves across a
+/// block, in radians.  Small enough that the residual of a pure tone is below
+/// float precision.
+constexpr double KFitTolerance = 1e-7;
+
+float
+PowerRatioToDecibels(double aNumerator, double aDenominator)
+{
+    return static_cast<float>(10.0 * std::log10(aNumerator / aDenominator));
+}
+
+/// @brief cos(omega * t) and sin(omega * t) for successive t, by rotation
+class Oscillator
+{
+  public:
+    Oscillator(double aOmega, double aFirstT)
+      : mCos(std::cos(aOmega * aFirstT))
+      , mSin(std::sin(aOmega * aFirstT))
+      , mStepCos(std::cos(aOmega))
+      , mStepSin(std::sin(aOmega))
+    {
+    }
+
+    [[nodiscard]] double Cos() const { return mCos; }
+    [[nodiscard]] double Sin() const { return mSin; }
+
+    void Step()
+    {
+        const double kCos = (mCos * mStepCos) - (mSin * mStepSin);
+        mSin = (mSin * mStepCos) + (mCos * mStepSin);
+        mCos = kCos;
+    }
+
+  private:
+    double mCos;
+    double mSin;
+    double mStepCos;
+    double mStepSin;
+};
+
+/// @brief Solve a small linear system by Gaussian elimination
+/// @param aMatrix Rows of the system, each ending with its right hand side.
+/// Overwritten.
+/// @param aSize Unknowns used, from the first
+/// @param aSolution Receives the unknowns
+/// @return false if the system is singular
+template<size_t N>
+bool
+Solve(std::array<std::array<double, N + 1>, N>& aMatrix,
+      size_t aSize,
+      std::array<double, N>& aSolution)
+{
+    for (size_t col = 0; col < aSize; col++) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < aSize; row++) {
+            if (std::abs(aMatrix[row][col]) > std::abs(aMatrix[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (!(std::abs(aMatrix[pivot][col]) > 0.0)) {
+            return false;
+        }
+        std::swap(aMatrix[col], aMatrix[pivot]);
+        for (size_t row = col + 1; row < aSize; row++) {
+            const double kFactor = aMatrix[row][col] / aMatrix[col][col];
+            for (size_t i = col; i < N + 1; i++) {
+                aMatrix[row][i] -= kFactor * aMatrix[col][i];
+            }
+        }
+    }
+    for (size_t col = aSize; col-- > 0;) {
+        double sum = aMatrix[col][N];
+        for (size_t i = col + 1; i < aSize; i++) {
+            sum -= aMatrix[col][i] * aSolution[i];
+        }
+        aSolution[col] = sum / aMatrix[col][col];
+    }
+    return true;
+}
+
+/// @brief offset + cosine * cos(omega * t) + sine * sin(omega * t), with t
+/// counted from the middle of the block
+struct SineFit
+{
+    double cosine{};
+    double sine{};
+    double offset{};
+    double omega{}; // Radians per sample
+};
+
+/// @brief Add a block to the normal equations of a sine fit
+/// @tparam Unknowns 3 for the amplitudes and offset, 4 to fit the frequency too
+/// @param aSamples Block to fit
+/// @param aFit Current fit; its amplitudes linearize the frequency term
+/// @param aSystem Receives the lower triangle and right hand side
+template<size_t Unknowns>
+void
+AccumulateNormalEquations(std::span<const float> aSamples,
+                          const SineFit& aFit,
+                          std::array<std::array<double, 5>, 4>& aSystem)
+{
+    const double kFirstT = -static_cast<double>(aSamples.size()) / 2.0;
+    Oscillator oscillator(aFit.omega, kFirstT);
+    double t = kFirstT;
+    for (const float kSample : aSamples) {
+        const double kCos = oscillator.Cos();
+        const double kSin = oscillator.Sin();
+        const std::array<double, 4> kBasis = {
+            kCos, kSin, 1.0, t * ((aFit.sine * kCos) - (aFit.cosine * kSin))
+        };
+        for (size_t row = 0; row < Unknowns; row++) {
+            for (size_t col = 0; col <= row; col++) {
+                aSystem[row][col] += kBasis[row] * kBasis[col];
+            }
+            aSystem[row][4] += kBasis[row] * kSample;
+        }
+        oscillator.Step();
+        t += 1.0;
+    }
+}
+
+/// @brief Least-squares fit of a sine to a block, as in IEEE 1057
+/// @param aSamples Block to fit
+/// @param aOmega Estimated frequency, in radians per sample
+/// @return The amplitudes fitted at aOmega, and then with the frequency too,
+/// refined until it settles
+SineFit
+FitSine(std::span<const float> aSamples, double aOmega)
+{
+    SineFit fit{ .omega = aOmega };
+    const auto kBlockFrames = static_cast<double>(aSamples.size());
+    for (size_t iteration = 0; iteration <= KMaxFitIterations; iteration++) {
+        // The first pass holds the frequency.  Later ones linearize the model
+        // in it too, which needs the amplitudes from the pass before.
+        const bool kFitOmega = iteration > 0;
+        const size_t kUnknowns = kFitOmega ? 4 : 3;
+        std::array<std::array<double, 5>, 4> system{};
+        if (kFitOmega) {
+            AccumulateNormalEquations<4>(aSamples, fit, system);
+        } else {
+            AccumulateNormalEquations<3>(aSamples, fit, system);
+        }
+        for (size_t row = 0; row < kUnknowns; row++) {
+            for (size_t col = row + 1; col < kUnknowns; col++) {
+                system[row][col] = system[col][row];
+            }
+        }
+
+        std::array<double, 4> solution{};
+        if (!Solve(system, kUnknowns, solution)) {
+            break;
+        }
+        fit.cosine = solution[0];
+        fit.sine = solution[1];
+        fit.offset = solution[2];
+        if (kFitOmega) {
+            fit.omega += solution[3];
+            if (std::abs(solution[3]) * kBlockFrames < KFitTolerance) {
+                break;
+            }
+        }
+    }
+    return fit;
+}
+
+} // namespace
+
+DistortionMeter::DistortionMeter(SampleRate aSampleRate)
+  : DistortionMeter(aSampleRate, Config{})
+{
+}
+
+DistortionMeter::DistortionMeter(SampleRate aSampleRate,
+                                 const Config& aConfig,
+                                 const IFFTProcessor::Factory& aFFTProcessorFactory)
+  : mConfig(aConfig)
+  , mSampleRate(aSampleRate)
+  , mFFTProcessor(aFFTProcessorFactory ? aFFTProcessorFactory(aConfig.block_frames)
+                                       : std::make_unique<FFTProcessor>(aConfig.block_frames))
+  , mWindow(aConfig.block_frames, FFTWindow::Type::BlackmanHarris)
+  , mPowerScale(0.0f)
+  , mFirstBin(KLobeBins + 1)
+  , mEndBin(0)
+  , mWindowed(aConfig.block_frames)
+  , mDecibels((aConfig.block_frames / 2) + 1)
+  , mPowers(mDecibels.size())
+  , mClaimed(mDecibels.size())
+{
+    if (aSampleRate <= 0) {
+        throw std::invalid_argument("DistortionMeter sample rate must be > 0");
+    }
+    if (!(aConfig.bandwidth_hz > 0.0f)) {
+        throw std::invalid_argument("DistortionMeter bandwidth must be > 0");
+    }
+
+    const double kHzPerBin = static_cast<double>(aSampleRate) / aConfig.block_frames;
+    const auto kBandwidthBins = static_cast<size_t>(aConfig.bandwidth_hz / kHzPerBin);
+    mEndBin = std::min(kBandwidthBins + 1, mDecibels.size());
+    if (mEndBin <= mFirstBin) {
+        throw std::invalid_argument("DistortionMeter block is too short for its bandwidth");
+    }
+
+    // As BlockSummaryIndex: dividing by N and the window's energy turns the
+    // power of the bins into the mean square of the unwindowed signal
+    std::vector<float> window(aConfig.block_frames, 1.0f);
+    mWindow.Apply(window, window);
+    double windowEnergy = 0.0;
+    for (const float kWeight : window) {
+        windowEnergy += static_cast<double>(kWeight) * kWeight;
+    }
+    mPowerScale =
+      static_cast<float>(1.0 / (static_cast<double>(aConfig.block_frames) * windowEnergy));
+}
+
+DistortionMeter::Measurement
+DistortionMeter::Measure(std::span<const float> aBlock)
+{
+    if (aBlock.size() != mConfig.block_frames) {
+        throw std::invalid_argument("DistortionMeter block must be block_frames samples");
+    }
+    mWindow.Apply(aBlock, mWindowed);
+    mFFTProcessor->ComputeDecibels(mWindowed, mDecibels);
+    const auto kBand = std::span(mDecibels).subspan(mFirstBin, mEndBin - mFirstBin);
+    const size_t kPeak = mFirstBin + static_cast<size_t>(std::ranges::max_element(kBand) -
+                                                          kBand.begin());
+
+    Measurement measurement;
+    if (!std::isfinite(mDecibels[kPeak])) {
+        constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+        measurement.fundamental_decibels = kNaN;
+        measurement.thd_decibels = kNaN;
+        measurement.thd_n_decibels = kNaN;
+        measurement.snr_decibels = kNaN;
+        measurement.sinad_decibels = kNaN;
+        return measurement;
+    }
+
+    // Estimate the frequency with a parabola through the peak's decibels, as
+    // PeakTracker does, then fit the sine itself
+    double peakBin = static_cast<double>(kPeak);
+    if (kPeak + 1 < mDecibels.size()) {
+        const double kLeft = mDecibels[kPeak - 1];
+        const double kCentre = mDecibels[kPeak];
+        const double kRight = mDecibels[kPeak + 1];
+        const double kCurvature = kLeft - (2.0 * kCentre) + kRight;
+        if (std::isfinite(kCurvature) && kCurvature < 0.0) {
+            peakBin += 0.5 * (kLeft - kRight) / kCurvature;
+        }
+    }
+    const double kBlockFrames = static_cast<double>(aBlock.size());
+    const SineFit kFit = FitSine(aBlock, 2.0 * std::numbers::pi * peakBin / kBlockFrames);
+
+    // Take out the fitted sine, as an analyzer's notch filter would, so the
+    // window's leakage from it can't hide the noise
+    Oscillator oscillator(kFit.omega, -kBlockFrames / 2.0);
+    for (size_t i = 0; i < aBlock.size(); i++) {
+        const double kFitted =
+          kFit.offset + (kFit.cosine * oscillator.Cos()) + (kFit.sine * oscillator.Sin());
+        mWindowed[i] = static_cast<float>(aBlock[i] - kFitted);
+        oscillator.Step();
+    }
+    mWindow.Apply(mWindowed, mWindowed);
+    mFFTProcessor->ComputeDecibels(mWindowed, mDecibels);
+
+    // Bins other than Nyquist stand for their negative frequency twin too
+    for (size_t bin = mFirstBin; bin < mEndBin; bin++) {
+        const float kOneSided = bin + 1 == mDecibels.size() ? 1.0f : 2.0f;
+        mPowers[bin] =
+          kOneSided * mPowerScale * std::exp(mDecibels[bin] * KDecibelsToPowerExponent);
+    }
+
+    const double kFundamentalBin = kFit.omega * kBlockFrames / (2.0 * std::numbers::pi);
+    std::ranges::fill(mClaimed, 0);
+    double harmonicPower = 0.0;
+    for (size_t harmonic = 2; harmonic <= mConfig.max_harmonic; harmonic++) {
+        const double kCentre = std::round(kFundamentalBin * static_cast<double>(harmonic));
+        if (!(kCentre < static_cast<double>(mEndBin))) {
+            break;
+        }
+        harmonicPower += ClaimLobe(static_cast<size_t>(kCentre));
+        measurement.harmonic_count++;
+    }
+    double noisePower = 0.0;
+    for (size_t bin = mFirstBin; bin < mEndBin; bin++) {
+        if (mClaimed[bin] == 0) {
+            noisePower += mPowers[bin];
+        }
+    }
+
+    const double kFundamentalPower = ((kFit.cosine * kFit.cosine) + (kFit.sine * kFit.sine)) / 2.0;
+    measurement.fundamental_hz =
+      static_cast<float>(kFit.omega * mSampleRate / (2.0 * std::numbers::pi));
+    measurement.fundamental_decibels = PowerRatioToDecibels(kFundamentalPower, 1.0);
+    measurement.thd_decibels = PowerRatioToDecibels(harmonicPower, kFundamentalPower);
+    measurement.thd_n_decibels =
+      PowerRatioToDecibels(harmonicPower + noisePower, kFundamentalPower);
+    measurement.snr_decibels = PowerRatioToDecibels(kFundamentalPower, noisePower);
+    measurement.sinad_decibels = -measurement.thd_n_decibels;
+    return measurement;
+}
+
+double
+DistortionMeter::ClaimLobe(size_t aCentre)
+{
+    const size_t kFirst = aCentre > mFirstBin + KLobeBins ? aCentre - KLobeBins : mFirstBin;
+    const size_t kEnd = std::min(aCentre + KLobeBins + 1, mEndBin);
+    double power = 0.0;
+    for (size_t bin = kFirst; bin < kEnd; bin++) {
+        if (mClaimed[bin] == 0) {
+            mClaimed[bin] = 1;
+            power += mPowers[bin];
+        }
+    }
+    return power;
+}
+
+std::vector<DistortionMeter::Measurement>
+DistortionMeter::MeasureBlocks(std::span<const float> aSamples,
+                               SampleRate aSampleRate,
+                               const Config& aConfig,
+                               size_t aThreadCount)
+{
+    const size_t kBlockFrames = aConfig.block_frames;
+    const size_t kBlocks = aSamples.size() / kBlockFrames;
+    size_t threadCount = aThreadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::clamp<size_t>(threadCount, 1, std::max<size_t>(kBlocks, 1));
+
+    // One meter per thread, each with its own plan
+    std::vector<DistortionMeter> meters;
+    meters.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        meters.emplace_back(aSampleRate, aConfig);
+    }
+
+    // Contiguous ranges of blocks, one per thread
+    std::vector<Measurement> measurements(kBlocks);
+    const auto kMeasureShare = [&](size_t aThread) {
+        const size_t kFirst = kBlocks * aThread / threadCount;
+        const size_t kEnd = kBlocks * (aThread + 1) / threadCount;
+        for (size_t block = kFirst; block < kEnd; block++) {
+            measurements[block] =
+              meters[aThread].Measure(aSamples.subspan(block * kBlockFrames, kBlockFrames));
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back(kMeasureShare, i);
+        }
+        kMeasureShare(0);
+    }
+    return measurements;
+}
@@ -5,13 +5,27 @@
 #include "audio_types.h"
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <fft_processor.h>
 #include <fftw3.h>
+#include <mutex>
 #include <span>
 #include <stdexcept>
 #include <vector>
 
+namespace {
+
+/// @brief Serializes the FFTW planner, which every plan shares
+std::mutex&
+PlannerMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+} // namespace
+
 FFTProcessor::FFTProcessor(FFTSize aTransformSize)
   : mTransformSize(aTransformSize)
   , mFFTPlan(nullptr)
@@ -25,8 +39,11 @@ FFTProcessor::FFTProcessor(FFTSize aTransformSize)
         throw std::runtime_error("Failed to allocate FFTW buffers");
     }
 
-    mFFTPlan = FFTWPlanPtr(fftwf_plan_dft_r2c_1d(
-      mTransformSize.AsInt(), mFFTInput.get(), mFFTOutput.get(), FFTW_ESTIMATE));
+    {
+        const std::scoped_lock kLock(PlannerMutex());
+        mFFTPlan = FFTWPlanPtr(fftwf_plan_dft_r2c_1d(
+          mTransformSize.AsInt(), mFFTInput.get(), mFFTOutput.get(), FFTW_ESTIMATE));
+    }
 
     if (!mFFTPlan) {
         throw std::runtime_error("Failed to create FFTW plan");
@@ -72,22 +89,59 @@ FFTProcessor::ComputeMagnitudes(const std::span<const float>& aSamples) const
 std::vector<float>
 FFTProcessor::ComputeDecibels(const std::span<const float>& aSamples) const
 {
-    const std::vector<float> magnitudes = ComputeMagnitudes(aSamples);
-    std::vector<float> decibels(magnitudes.size());
-    for (size_t i = 0; i < magnitudes.size(); ++i) {
+    std::vector<float> decibels((mTransformSize / 2) + 1);
+    ComputeDecibels(aSamples, decibels);
+    return decibels;
+}
+
+void
+FFTProcessor::ComputeDecibels(const std::span<const float>& aSamples,
+                              std::span<float> aDecibels) const
+{
+    if (aDecibels.size() != (mTransformSize / 2) + 1) {
+        throw std::invalid_argument("Output size must be transform_size / 2 + 1");
+    }
+    Compute(aSamples);
+
+    for (size_t i = 0; i < aDecibels.size(); ++i) {
+        float const real = mFFTOutput.get()[i][0];
+        float const imag = mFFTOutput.get()[i][1];
+        const float kMagnitude = std::sqrt((real * real) + (imag * imag));
         // Standard conversion: dB = 20 * log10(magnitude)
         constexpr float kDecibelScaleFactor = 20.0F;
         // Note that zero magnitudes will produce -inf dB.  This is correct
         // floating-point behavior.
-        decibels[i] = kDecibelScaleFactor * std::log10(magnitudes[i]);
+        aDecibels[i] = kDecibelScaleFactor * std::log10(kMagnitude);
     }
-    return decibels;
+}
+
+void
+FFTProcessor::ComputePowers(const std::span<const float>& aSamples, std::span<float> aPowers) const
+{
+    if (aPowers.size() != (mTransformSize / 2) + 1) {
+        throw std::invalid_argument("Output size must be transform_size / 2 + 1");
+    }
+    Compute(aSamples);
+
+    for (size_t i = 0; i < aPowers.size(); ++i) {
+        float const real = mFFTOutput.get()[i][0];
+        float const imag = mFFTOutput.get()[i][1];
+        aPowers[i] = (real * real) + (imag * imag);
+    }
+}
+
+size_t
+FFTProcessor::GetMemoryBytes() const noexcept
+{
+    // The FFTW input and output buffers.  The plan's own state is opaque.
+    return (mTransformSize * sizeof(float)) + (((mTransformSize / 2) + 1) * sizeof(FftwfComplex));
 }
 
 void
 FFTProcessor::FFTWDeleter::operator()(FftwfPlan aPlan) const
 {
     if (aPlan) {
+        const std::scoped_lock kLock(PlannerMutex());
         fftwf_destroy_plan(aPlan);
     }
 }
@@ -27,16 +27,27 @@ FFTWindow::FFTWindow(FFTSize aSize, FFTWindow::Type aType)
 std::vector<float>
 FFTWindow::Apply(std::span<const float> aInputSamples) const
 {
-    if (aInputSamples.size() != mSize) {
-        throw std::invalid_argument("Input size must match window size " + std::to_string(mSize) +
-                                    ", got: " + std::to_string(aInputSamples.size()));
+    std::vector<float> output(mSize);
+    Apply(aInputSamples, output);
+    return output;
+}
+
+/// @brief Apply the window to the input samples, into a caller-provided buffer.
+/// @param aInputSamples Input samples.  Size must match window size.
+/// @param aOutput Output buffer.  Size must match window size.
+void
+FFTWindow::Apply(std::span<const float> aInputSamples, std::span<float> aOutput) const
+{
+    if (aInputSamples.size() != mSize || aOutput.size() != mSize) {
+        throw std::invalid_argument("Input and output sizes must match window size " +
+                                    std::to_string(mSize) + ", got: " +
+                                    std::to_string(aInputSamples.size()) + " and " +
+                                    std::to_string(aOutput.size()));
     }
 
-    std::vector<float> output(mSize);
     for (size_t i = 0; i < mSize; ++i) {
-        output[i] = aInputSamples[i] * mWindowCoefficients[i];
+        aOutput[i] = aInputSamples[i] * mWindowCoefficients[i];
     }
-    return output;
 }
 
 /// @brief Compute the window coefficients based on the selected type and size
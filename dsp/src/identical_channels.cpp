@@ -0,0 +1,68 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <atomic>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <identical_channels.h>
+#include <span>
+#include <stdexcept>
+
+IdenticalChannels::IdenticalChannels(ChannelCount aChannelCount)
+  : mRuns(aChannelCount)
+{
+    for (ChannelCount ch = 0; ch < aChannelCount; ch++) {
+        mRuns[ch].store(Pack(ch, FrameIndex{ 0 }), std::memory_order_relaxed);
+    }
+}
+
+uint64_t
+IdenticalChannels::Pack(ChannelCount aChannel, FrameIndex aSince)
+{
+    return (uint64_t{ aChannel } << KFrameBits) | aSince.Get();
+}
+
+void
+IdenticalChannels::AddBlock(FrameIndex aFirstFrame, std::span<const float> aPlanar, size_t aFrames)
+{
+    if (aPlanar.size() != aFrames * mRuns.size()) {
+        throw std::invalid_argument("IdenticalChannels::AddBlock: block size mismatch");
+    }
+    if (aFrames == 0) {
+        return;
+    }
+
+    // memcmp compares bit patterns, so -0 and +0 differ and NaNs match
+    // themselves: exactly the cases where the transforms would agree
+    const size_t kBytes = aFrames * sizeof(float);
+    auto channelData = [&](size_t aChannel) { return aPlanar.data() + (aChannel * aFrames); };
+
+    // Channel 0 never matches a lower channel
+    for (size_t ch = 1; ch < mRuns.size(); ch++) {
+        size_t match = 0;
+        while (match < ch && std::memcmp(channelData(ch), channelData(match), kBytes) != 0) {
+            match++;
+        }
+
+        const uint64_t kRun = mRuns[ch].load(std::memory_order_relaxed);
+        if ((kRun >> KFrameBits) == match && match != ch) {
+            continue; // The run goes on
+        }
+        const FrameIndex kSince = match != ch ? aFirstFrame : FrameIndex{ 0 };
+        mRuns[ch].store(Pack(static_cast<ChannelCount>(match), kSince), std::memory_order_release);
+    }
+}
+
+ChannelCount
+IdenticalChannels::Find(ChannelCount aChannel, FrameIndex aFirstFrame) const
+{
+    if (aChannel >= mRuns.size()) {
+        throw std::out_of_range("IdenticalChannels::Find: Channel index out of range");
+    }
+    const uint64_t kRun = mRuns[aChannel].load(std::memory_order_acquire);
+    const FrameIndex kSince{ kRun & ((uint64_t{ 1 } << KFrameBits) - 1) };
+    return aFirstFrame >= kSince ? static_cast<ChannelCount>(kRun >> KFrameBits) : aChannel;
+}
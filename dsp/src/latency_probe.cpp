@@ -0,0 +1,87 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "latency_probe.h"
+#include <algorithm>
+#include <atomic>
+#include <audio_types.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <mutex>
+
+LatencyProbe::LatencyProbe(Metrics::Histogram& aHistogram)
+  : mHistogram(aHistogram)
+{
+}
+
+LatencyProbe&
+LatencyProbe::Get()
+{
+    static LatencyProbe probe(Metrics::GetHistogram(Metrics::KCaptureToPixel));
+    return probe;
+}
+
+void
+LatencyProbe::SetEnabled(bool aEnabled)
+{
+    mEnabled.store(aEnabled, std::memory_order_relaxed);
+    if (!aEnabled) {
+        Clear();
+    }
+}
+
+void
+LatencyProbe::TagBlock(FrameCount aEndFrame, int64_t aCaptureNs)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    const std::scoped_lock kLock(mMutex);
+    // A block that doesn't extend the buffer can't be waited for
+    if (!mPending.empty() && aEndFrame <= mPending.back().end_frame) {
+        return;
+    }
+    if (mPending.size() >= KMaxPending) {
+        mPending.pop_front();
+    }
+    mPending.push_back({ .end_frame = aEndFrame, .capture_ns = aCaptureNs });
+}
+
+void
+LatencyProbe::MarkComposited(FrameCount aEndFrame, int64_t aNowNs)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    const std::scoped_lock kLock(mMutex);
+    while (!mPending.empty() && mPending.front().end_frame <= aEndFrame) {
+        const int64_t kLatency = std::max<int64_t>(aNowNs - mPending.front().capture_ns, 0);
+        mHistogram.Record(static_cast<uint64_t>(kLatency));
+        mPending.pop_front();
+    }
+}
+
+void
+LatencyProbe::Clear()
+{
+    const std::scoped_lock kLock(mMutex);
+    mPending.clear();
+}
+
+size_t
+LatencyProbe::GetPendingCount() const
+{
+    const std::scoped_lock kLock(mMutex);
+    return mPending.size();
+}
+
+int64_t
+LatencyProbe::Now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
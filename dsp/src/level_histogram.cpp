@@ -0,0 +1,128 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "level_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace {
+
+/// @brief Weight at which the counts are renormalized, far from overflow
+constexpr double KMaxIncrement = 1e100;
+
+} // namespace
+
+LevelHistogram::LevelHistogram()
+  : LevelHistogram(Config{})
+{
+}
+
+LevelHistogram::LevelHistogram(const Config& aConfig)
+  : mConfig(aConfig)
+  , mBinsPerDecibel(1.0f / aConfig.resolution_decibels)
+{
+    if (!(aConfig.resolution_decibels > 0.0f)) {
+        throw std::invalid_argument("LevelHistogram resolution must be positive");
+    }
+    if (!(aConfig.max_decibels > aConfig.min_decibels)) {
+        throw std::invalid_argument("LevelHistogram range must not be empty");
+    }
+    if (!(aConfig.half_life_rows >= 0.0f)) {
+        throw std::invalid_argument("LevelHistogram half life must not be negative");
+    }
+    if (aConfig.half_life_rows > 0.0f) {
+        mGrowth = std::exp2(1.0 / aConfig.half_life_rows);
+    }
+    const float kBins =
+      std::ceil((aConfig.max_decibels - aConfig.min_decibels) * mBinsPerDecibel);
+    mCounts.assign(static_cast<size_t>(kBins), 0.0);
+}
+
+void
+LevelHistogram::Reset()
+{
+    std::ranges::fill(mCounts, 0.0);
+    mIncrement = 1.0;
+    mTotal = 0.0;
+}
+
+void
+LevelHistogram::Add(float aDecibels, double aWeight)
+{
+    const float kLastBin = static_cast<float>(mCounts.size() - 1);
+    const float kBin =
+      std::clamp((aDecibels - mConfig.min_decibels) * mBinsPerDecibel, 0.0f, kLastBin);
+    const double kCount = aWeight * mIncrement;
+    mCounts[static_cast<size_t>(kBin)] += kCount;
+    mTotal += kCount;
+}
+
+void
+LevelHistogram::Add(std::span<const float> aDecibels)
+{
+    const float kLastBin = static_cast<float>(mCounts.size() - 1);
+    for (const float kDecibels : aDecibels) {
+        const float kBin =
+          std::clamp((kDecibels - mConfig.min_decibels) * mBinsPerDecibel, 0.0f, kLastBin);
+        mCounts[static_cast<size_t>(kBin)] += mIncrement;
+    }
+    mTotal += mIncrement * static_cast<double>(aDecibels.size());
+}
+
+void
+LevelHistogram::Age()
+{
+    mIncrement *= mGrowth;
+    if (mIncrement > KMaxIncrement) {
+        Renormalize();
+    }
+}
+
+void
+LevelHistogram::Renormalize()
+{
+    for (double& count : mCounts) {
+        count /= mIncrement;
+    }
+    mTotal /= mIncrement;
+    mIncrement = 1.0;
+}
+
+float
+LevelHistogram::GetQuantile(double aFraction) const
+{
+    if (!(aFraction >= 0.0 && aFraction <= 1.0)) {
+        throw std::invalid_argument("LevelHistogram quantile must be in [0, 1]");
+    }
+    if (mTotal <= 0.0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // The quantile lies in the first nonempty bin whose running count reaches
+    // it, spread evenly over that bin
+    const double kTarget = aFraction * mTotal;
+    double below = 0.0;
+    size_t lastNonempty = 0;
+    for (size_t bin = 0; bin < mCounts.size(); bin++) {
+        const double kCount = mCounts[bin];
+        if (kCount <= 0.0) {
+            continue;
+        }
+        if (below + kCount >= kTarget) {
+            const double kWithin = std::clamp((kTarget - below) / kCount, 0.0, 1.0);
+            return mConfig.min_decibels +
+                   (static_cast<float>(static_cast<double>(bin) + kWithin) /
+                    mBinsPerDecibel);
+        }
+        below += kCount;
+        lastNonempty = bin;
+    }
+
+    // Rounding left the target just above the running count
+    return mConfig.min_decibels + (static_cast<float>(lastNonempty + 1) / mBinsPerDecibel);
+}
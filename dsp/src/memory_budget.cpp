@@ -0,0 +1,129 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "memory_budget.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <metrics.h>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+MemoryBudget&
+MemoryBudget::Get()
+{
+    static MemoryBudget budget;
+    return budget;
+}
+
+void
+MemoryBudget::Register(std::string_view aName,
+                       IMemoryConsumer::Kind aKind,
+                       IMemoryConsumer& aConsumer)
+{
+    Metrics::Gauge& gauge = Metrics::GetGauge(std::format("memory.{}_bytes", aName));
+    const std::scoped_lock kLock(mMutex);
+    mEntries.push_back(
+      { .name = std::string(aName), .kind = aKind, .consumer = &aConsumer, .gauge = &gauge });
+}
+
+void
+MemoryBudget::Unregister(const IMemoryConsumer& aConsumer)
+{
+    const std::scoped_lock kLock(mMutex);
+    const auto kIt = std::ranges::find_if(
+      mEntries, [&aConsumer](const Entry& aEntry) { return aEntry.consumer == &aConsumer; });
+    if (kIt != mEntries.end()) {
+        kIt->gauge->Set(0);
+        mEntries.erase(kIt);
+    }
+}
+
+void
+MemoryBudget::SetLimit(size_t aBytes)
+{
+    static Metrics::Gauge& limit = Metrics::GetGauge(Metrics::KMemoryLimit);
+    const std::scoped_lock kLock(mMutex);
+    mLimit = aBytes;
+    limit.Set(static_cast<int64_t>(aBytes));
+}
+
+size_t
+MemoryBudget::GetLimit() const
+{
+    const std::scoped_lock kLock(mMutex);
+    return mLimit;
+}
+
+size_t
+MemoryBudget::GetTotalBytes() const
+{
+    const std::scoped_lock kLock(mMutex);
+    size_t total = 0;
+    for (const Entry& kEntry : mEntries) {
+        total += kEntry.consumer->GetMemoryBytes();
+    }
+    return total;
+}
+
+std::vector<MemoryBudget::Usage>
+MemoryBudget::GetUsage() const
+{
+    const std::scoped_lock kLock(mMutex);
+    std::vector<Usage> usage;
+    usage.reserve(mEntries.size());
+    for (const Entry& kEntry : mEntries) {
+        usage.push_back(
+          { .name = kEntry.name, .kind = kEntry.kind, .bytes = kEntry.consumer->GetMemoryBytes() });
+    }
+    return usage;
+}
+
+size_t
+MemoryBudget::Enforce()
+{
+    static Metrics::Counter& releasedBytes = Metrics::GetCounter(Metrics::KMemoryReleased);
+    const std::scoped_lock kLock(mMutex);
+    size_t total = Publish();
+    if (mLimit == 0 || total <= mLimit) {
+        return 0;
+    }
+
+    // Caches are cheap to rebuild, so they go first.  History is a last resort.
+    size_t released = 0;
+    for (const IMemoryConsumer::Kind kKind :
+         { IMemoryConsumer::Kind::Cache, IMemoryConsumer::Kind::History }) {
+        for (const Entry& kEntry : mEntries) {
+            if (total <= mLimit) {
+                break;
+            }
+            if (kEntry.kind != kKind) {
+                continue;
+            }
+            const size_t kFreed = kEntry.consumer->ReleaseMemory(total - mLimit);
+            released += kFreed;
+            total -= std::min(kFreed, total);
+        }
+    }
+    releasedBytes.Add(released);
+    Publish();
+    return released;
+}
+
+size_t
+MemoryBudget::Publish() const
+{
+    static Metrics::Gauge& totalBytes = Metrics::GetGauge(Metrics::KMemoryTotal);
+    size_t total = 0;
+    for (const Entry& kEntry : mEntries) {
+        const size_t kBytes = kEntry.consumer->GetMemoryBytes();
+        kEntry.gauge->Set(static_cast<int64_t>(kBytes));
+        total += kBytes;
+    }
+    totalBytes.Set(static_cast<int64_t>(total));
+    return total;
+}
@@ -0,0 +1,242 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "metrics.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/// @brief Owns every metric.  Metrics are never removed, so references
+/// handed out stay valid.
+struct Registry
+{
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Metrics::Counter>, std::less<>> counters;
+    std::map<std::string, std::unique_ptr<Metrics::Gauge>, std::less<>> gauges;
+    std::map<std::string, std::unique_ptr<Metrics::Histogram>, std::less<>> histograms;
+};
+
+Registry&
+GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+template<typename T>
+T&
+GetOrCreate(std::map<std::string, std::unique_ptr<T>, std::less<>>& aMap, std::string_view aName)
+{
+    const std::scoped_lock kLock(GetRegistry().mutex);
+    auto it = aMap.find(aName);
+    if (it == aMap.end()) {
+        it = aMap.emplace(std::string(aName), std::make_unique<T>()).first;
+    }
+    return *it->second;
+}
+
+int64_t
+NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+size_t
+Metrics::Histogram::BucketIndex(uint64_t aValue) noexcept
+{
+    // 0..3 map to themselves.  Above that, the exponent picks the octave and
+    // the two bits below the leading one pick the quarter within it.
+    constexpr uint64_t kLinearLimit = 4;
+    if (aValue < kLinearLimit) {
+        return static_cast<size_t>(aValue);
+    }
+    const int kExponent = std::bit_width(aValue) - 1;
+    const uint64_t kQuarter = (aValue >> (kExponent - 2)) & 3U;
+    return (static_cast<size_t>(kExponent - 1) * 4) + static_cast<size_t>(kQuarter);
+}
+
+uint64_t
+Metrics::Histogram::BucketLowerBound(size_t aIndex) noexcept
+{
+    if (aIndex < 4) {
+        return aIndex;
+    }
+    const size_t kExponent = (aIndex / 4) + 1;
+    const uint64_t kQuarter = aIndex % 4;
+    return (uint64_t{ 4 } + kQuarter) << (kExponent - 2);
+}
+
+void
+Metrics::Histogram::Record(uint64_t aValue) noexcept
+{
+    mBuckets[BucketIndex(aValue)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(aValue, std::memory_order_relaxed);
+    uint64_t max = mMax.load(std::memory_order_relaxed);
+    while (aValue > max && !mMax.compare_exchange_weak(max, aValue, std::memory_order_relaxed)) {
+    }
+}
+
+Metrics::Histogram::Summary
+Metrics::Histogram::Summarize() const
+{
+    // Copy the buckets first so the percentiles agree with each other, even
+    // if values are recorded meanwhile
+    std::array<uint64_t, KBucketCount> buckets{};
+    uint64_t count = 0;
+    for (size_t i = 0; i < KBucketCount; i++) {
+        buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    Summary summary{ .count = count, .max = mMax.load(std::memory_order_relaxed) };
+    if (count == 0) {
+        return summary;
+    }
+    summary.mean = static_cast<double>(mSum.load(std::memory_order_relaxed)) /
+                   static_cast<double>(mCount.load(std::memory_order_relaxed));
+
+    // Each percentile is reported as the midpoint of its bucket, capped at the
+    // largest value seen
+    auto percentile = [&](uint64_t aPercent) {
+        const uint64_t kRank = ((count * aPercent) + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < KBucketCount; i++) {
+            seen += buckets[i];
+            if (seen >= kRank) {
+                const uint64_t kLow = BucketLowerBound(i);
+                const uint64_t kHigh =
+                  i + 1 < KBucketCount ? BucketLowerBound(i + 1) : summary.max + 1;
+                return std::min(kLow + ((kHigh - kLow) / 2), summary.max);
+            }
+        }
+        return summary.max;
+    };
+    constexpr uint64_t kP50 = 50;
+    constexpr uint64_t kP90 = 90;
+    constexpr uint64_t kP99 = 99;
+    summary.p50 = percentile(kP50);
+    summary.p90 = percentile(kP90);
+    summary.p99 = percentile(kP99);
+    return summary;
+}
+
+Metrics::ScopedTimer::ScopedTimer(Histogram& aHistogram) noexcept
+  : mHistogram(aHistogram)
+  , mStartNs(NowNs())
+{
+}
+
+Metrics::ScopedTimer::~ScopedTimer()
+{
+    mHistogram.Record(static_cast<uint64_t>(NowNs() - mStartNs));
+}
+
+Metrics::Counter&
+Metrics::GetCounter(std::string_view aName)
+{
+    return GetOrCreate(GetRegistry().counters, aName);
+}
+
+Metrics::Gauge&
+Metrics::GetGauge(std::string_view aName)
+{
+    return GetOrCreate(GetRegistry().gauges, aName);
+}
+
+Metrics::Histogram&
+Metrics::GetHistogram(std::string_view aName)
+{
+    return GetOrCreate(GetRegistry().histograms, aName);
+}
+
+Metrics::Snapshot
+Metrics::TakeSnapshot()
+{
+    Registry& registry = GetRegistry();
+    const std::scoped_lock kLock(registry.mutex);
+    Snapshot snapshot;
+    for (const auto& [kName, kCounter] : registry.counters) {
+        snapshot.counters.emplace(kName, kCounter->Get());
+    }
+    for (const auto& [kName, kGauge] : registry.gauges) {
+        snapshot.gauges.emplace(kName, kGauge->Get());
+    }
+    for (const auto& [kName, kHistogram] : registry.histograms) {
+        snapshot.histograms.emplace(kName, kHistogram->Summarize());
+    }
+    return snapshot;
+}
+
+void
+Metrics::WriteJson(std::ostream& aStream)
+{
+    // Metric names are plain identifiers, so need no escaping
+    const Snapshot kSnapshot = TakeSnapshot();
+    auto writeSection = [&aStream](std::string_view aSection,
+                                   const auto& aValues,
+                                   auto aFormatValue,
+                                   bool aLast) {
+        aStream << std::format("  \"{}\": {{", aSection);
+        bool first = true;
+        for (const auto& [kName, kValue] : aValues) {
+            aStream << (first ? "\n" : ",\n");
+            first = false;
+            aStream << std::format("    \"{}\": {}", kName, aFormatValue(kValue));
+        }
+        aStream << (first ? "}" : "\n  }") << (aLast ? "\n" : ",\n");
+    };
+    auto formatNumber = [](auto aValue) { return std::format("{}", aValue); };
+    auto formatSummary = [](const Histogram::Summary& aSummary) {
+        return std::format(
+          R"({{"count": {}, "mean": {:.1f}, "p50": {}, "p90": {}, "p99": {}, "max": {}}})",
+          aSummary.count,
+          aSummary.mean,
+          aSummary.p50,
+          aSummary.p90,
+          aSummary.p99,
+          aSummary.max);
+    };
+
+    aStream << "{\n";
+    writeSection("counters", kSnapshot.counters, formatNumber, false);
+    writeSection("gauges", kSnapshot.gauges, formatNumber, false);
+    writeSection("histograms", kSnapshot.histograms, formatSummary, true);
+    aStream << "}\n";
+}
+
+std::expected<void, std::string>
+Metrics::WriteJsonFile(const std::string& aPath)
+{
+    std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return std::unexpected(std::format("Failed to open {}", aPath));
+    }
+    WriteJson(file);
+    file.close();
+    if (!file) {
+        return std::unexpected(std::format("Failed to write {}", aPath));
+    }
+    return {};
+}
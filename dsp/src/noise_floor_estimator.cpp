@@ -0,0 +1,115 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "noise_floor_estimator.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr float KInfinity = std::numeric_limits<float>::infinity();
+
+} // namespace
+
+NoiseFloorEstimator::NoiseFloorEstimator()
+  : NoiseFloorEstimator(Config{})
+{
+}
+
+NoiseFloorEstimator::NoiseFloorEstimator(const Config& aConfig)
+  : mConfig(aConfig)
+{
+    if (!(aConfig.smoothing >= 0.0f && aConfig.smoothing < 1.0f)) {
+        throw std::invalid_argument("NoiseFloorEstimator smoothing must be in [0, 1)");
+    }
+    if (aConfig.subwindow_rows == 0 || aConfig.subwindow_count == 0) {
+        throw std::invalid_argument("NoiseFloorEstimator subwindows must be nonempty");
+    }
+}
+
+void
+NoiseFloorEstimator::Reset()
+{
+    mBinCount = 0;
+    mFloor.clear();
+    mSubwindowRows = 0;
+    mNextSubwindow = 0;
+    mRowCount = 0;
+}
+
+void
+NoiseFloorEstimator::Update(std::span<const float> aDecibels)
+{
+    const size_t kBins = aDecibels.size();
+    if (mRowCount == 0) {
+        mBinCount = kBins;
+        mSmoothed.resize(kBins);
+        mSubwindowMinimum.assign(kBins, KInfinity);
+        mSubwindowMinima.assign(kBins * mConfig.subwindow_count, KInfinity);
+        mFinishedMinimum.assign(kBins, KInfinity);
+        mFloor.resize(kBins);
+    } else if (kBins != mBinCount) {
+        throw std::invalid_argument("NoiseFloorEstimator rows must keep their bin count");
+    }
+
+    // One pass over the bins, with no branches, so it vectorizes
+    const float kSmoothing = mRowCount == 0 ? 0.0f : mConfig.smoothing;
+    const float kNewWeight = 1.0f - kSmoothing;
+    const float kBias = mConfig.bias_decibels;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const float* const kLevels = aDecibels.data();
+    const float* const kFinishedMinimum = mFinishedMinimum.data();
+    float* const smoothed = mSmoothed.data();
+    float* const subwindowMinimum = mSubwindowMinimum.data();
+    float* const floor = mFloor.data();
+    for (size_t bin = 0; bin < kBins; bin++) {
+        const float kLevel = std::max(kLevels[bin], KMinDecibels);
+        const float kSmoothed = (kSmoothing * smoothed[bin]) + (kNewWeight * kLevel);
+        smoothed[bin] = kSmoothed;
+        subwindowMinimum[bin] = std::min(subwindowMinimum[bin], kSmoothed);
+        floor[bin] = std::min(kFinishedMinimum[bin], subwindowMinimum[bin]) + kBias;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    mRowCount++;
+    if (++mSubwindowRows == mConfig.subwindow_rows) {
+        EndSubwindow();
+    }
+}
+
+void
+NoiseFloorEstimator::Update(std::span<const float> aRows, size_t aBinCount)
+{
+    if (aBinCount == 0 || aRows.size() % aBinCount != 0) {
+        throw std::invalid_argument(
+          "NoiseFloorEstimator rows must be whole rows of a nonzero bin count");
+    }
+    for (size_t first = 0; first < aRows.size(); first += aBinCount) {
+        Update(aRows.subspan(first, aBinCount));
+    }
+}
+
+void
+NoiseFloorEstimator::EndSubwindow()
+{
+    // The finished subwindow replaces the oldest in the ring
+    const auto kSlot = std::span(mSubwindowMinima).subspan(mNextSubwindow * mBinCount, mBinCount);
+    std::ranges::copy(mSubwindowMinimum, kSlot.begin());
+    std::ranges::fill(mSubwindowMinimum, KInfinity);
+    mNextSubwindow = (mNextSubwindow + 1) % mConfig.subwindow_count;
+    mSubwindowRows = 0;
+
+    std::ranges::fill(mFinishedMinimum, KInfinity);
+    for (size_t slot = 0; slot < mConfig.subwindow_count; slot++) {
+        const auto kMinima = std::span(mSubwindowMinima).subspan(slot * mBinCount, mBinCount);
+        std::ranges::transform(mFinishedMinimum,
+                               kMinima,
+                               mFinishedMinimum.begin(),
+                               [](float aLHS, float aRHS) { return std::min(aLHS, aRHS); });
+    }
+}
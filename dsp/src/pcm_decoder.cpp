@@ -0,0 +1,89 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "pcm_decoder.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace {
+
+/// @brief Load a little-endian value from unaligned bytes
+template<typename T>
+T
+LoadLittleEndian(const std::byte* aBytes)
+{
+    T value{};
+    std::memcpy(&value, aBytes, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+/// @brief Decode integer samples, scaling by 1 / aFullScale
+template<typename T>
+void
+DecodeInteger(std::span<const std::byte> aInput, std::span<float> aOutput, float aFullScale)
+{
+    const float kScale = 1.0f / aFullScale;
+    const std::byte* in = aInput.data();
+    for (float& out : aOutput) {
+        out = static_cast<float>(LoadLittleEndian<T>(in)) * kScale;
+        in += sizeof(T); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+} // namespace
+
+size_t
+PcmDecoder::BytesPerSample(Format aFormat)
+{
+    switch (aFormat) {
+        case Format::S16:
+            return sizeof(int16_t);
+        case Format::S32:
+            return sizeof(int32_t);
+        case Format::F32:
+            return sizeof(float);
+    }
+    throw std::invalid_argument("Unknown PCM format");
+}
+
+void
+PcmDecoder::Decode(Format aFormat, std::span<const std::byte> aInput, std::span<float> aOutput)
+{
+    if (aInput.size() != aOutput.size() * BytesPerSample(aFormat)) {
+        throw std::invalid_argument(std::format(
+          "PcmDecoder::Decode: {} input bytes for {} samples", aInput.size(), aOutput.size()));
+    }
+
+    // Full scale of the integer formats: 2^15 and 2^31
+    constexpr float kS16FullScale = 32768.0f;
+    constexpr float kS32FullScale = 2147483648.0f;
+
+    switch (aFormat) {
+        case Format::S16:
+            DecodeInteger<int16_t>(aInput, aOutput, kS16FullScale);
+            break;
+        case Format::S32:
+            DecodeInteger<int32_t>(aInput, aOutput, kS32FullScale);
+            break;
+        case Format::F32:
+            if constexpr (std::endian::native == std::endian::little) {
+                std::memcpy(aOutput.data(), aInput.data(), aInput.size());
+            } else {
+                const std::byte* in = aInput.data();
+                for (float& out : aOutput) {
+                    out = std::bit_cast<float>(LoadLittleEndian<uint32_t>(in));
+                    in += sizeof(float); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                }
+            }
+            break;
+    }
+}
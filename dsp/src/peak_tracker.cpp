@@ -0,0 +1,169 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "peak_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+PeakTracker::PeakTracker()
+  : PeakTracker(Config{})
+{
+}
+
+PeakTracker::PeakTracker(const Config& aConfig)
+  : mConfig(aConfig)
+{
+    if (aConfig.max_peaks == 0) {
+        throw std::invalid_argument("PeakTracker max_peaks must be > 0");
+    }
+    if (!(aConfig.max_bin_jump >= 0.0f)) {
+        throw std::invalid_argument("PeakTracker max_bin_jump must be >= 0");
+    }
+
+    mCandidates.reserve(aConfig.max_peaks);
+    mPeaks.reserve(aConfig.max_peaks);
+    mClaimed.reserve(aConfig.max_peaks);
+
+    // Each row adds at most max_peaks tracks, which live at most
+    // max_gap_rows + 1 rows without a peak
+    mTracks.reserve(aConfig.max_peaks * (aConfig.max_gap_rows + 2));
+}
+
+void
+PeakTracker::Reset()
+{
+    mTracks.clear();
+    mFinished.clear();
+    mNextId = 0;
+    mRowCount = 0;
+}
+
+std::span<const PeakTracker::Peak>
+PeakTracker::FindPeaks(std::span<const float> aDecibels)
+{
+    mCandidates.clear();
+    mPeaks.clear();
+    const size_t kBins = aDecibels.size();
+    if (kBins < 3) {
+        return {};
+    }
+
+    // Flag every local maximum above the threshold.  Plain compares combined
+    // with & rather than &&, so there are no branches and the loop vectorizes.
+    // The left edge of a plateau counts as its maximum.
+    mIsMaximum.resize(kBins);
+    const float* const kLevels = aDecibels.data();
+    uint8_t* const isMaximum = mIsMaximum.data();
+    const float kThreshold = mConfig.threshold_decibels;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (size_t bin = 1; bin < kBins - 1; bin++) {
+        const float kLevel = kLevels[bin];
+        isMaximum[bin] = static_cast<uint8_t>(static_cast<int>(kLevel > kLevels[bin - 1]) &
+                                              static_cast<int>(kLevel >= kLevels[bin + 1]) &
+                                              static_cast<int>(kLevel > kThreshold));
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    // Maxima are sparse.  Keep the loudest, sorted by insertion.
+    const size_t kMaxPeaks = mConfig.max_peaks;
+    for (size_t bin = 1; bin < kBins - 1; bin++) {
+        if (mIsMaximum[bin] == 0) {
+            continue;
+        }
+        const float kLevel = aDecibels[bin];
+        if (mCandidates.size() == kMaxPeaks) {
+            if (kLevel <= aDecibels[mCandidates.back()]) {
+                continue;
+            }
+            mCandidates.pop_back();
+        }
+        const auto kPosition =
+          std::ranges::find_if(mCandidates, [&](size_t aBin) { return aDecibels[aBin] < kLevel; });
+        mCandidates.insert(kPosition, bin);
+    }
+
+    // Fit a parabola through each maximum and its neighbours.  The vertex is
+    // within half a bin, since the maximum is at least as loud as both.
+    for (const size_t kBin : mCandidates) {
+        const float kLeft = aDecibels[kBin - 1];
+        const float kCentre = aDecibels[kBin];
+        const float kRight = aDecibels[kBin + 1];
+        const float kCurvature = kLeft - (2.0f * kCentre) + kRight;
+        const float kOffset = kCurvature < 0.0f ? 0.5f * (kLeft - kRight) / kCurvature : 0.0f;
+        mPeaks.push_back({ .bin = static_cast<float>(kBin) + kOffset,
+                           .decibels = kCentre - (0.25f * (kLeft - kRight) * kOffset) });
+    }
+    return mPeaks;
+}
+
+void
+PeakTracker::Update(std::span<const float> aDecibels)
+{
+    const std::span<const Peak> kPeaks = FindPeaks(aDecibels);
+    mClaimed.assign(kPeaks.size(), 0);
+
+    // Loudest tracks choose first, each taking the nearest unclaimed peak
+    std::ranges::sort(mTracks, [](const Track& aLHS, const Track& aRHS) {
+        return aLHS.decibels > aRHS.decibels;
+    });
+    for (Track& track : mTracks) {
+        size_t nearest = kPeaks.size();
+        float nearestDistance = mConfig.max_bin_jump;
+        for (size_t i = 0; i < kPeaks.size(); i++) {
+            const float kDistance = std::abs(kPeaks[i].bin - track.bin);
+            if (mClaimed[i] == 0 && kDistance <= nearestDistance) {
+                nearest = i;
+                nearestDistance = kDistance;
+            }
+        }
+        if (nearest < kPeaks.size()) {
+            mClaimed[nearest] = 1;
+            track.bin = kPeaks[nearest].bin;
+            track.decibels = kPeaks[nearest].decibels;
+            track.last_row = mRowCount;
+            track.rows++;
+        }
+    }
+
+    // Finish tracks whose gap is too long
+    const auto kRemoved = std::ranges::remove_if(mTracks, [&](const Track& aTrack) {
+        if (mRowCount - aTrack.last_row <= mConfig.max_gap_rows) {
+            return false;
+        }
+        if (aTrack.rows >= mConfig.min_track_rows) {
+            mFinished.push_back(aTrack);
+        }
+        return true;
+    });
+    mTracks.erase(kRemoved.begin(), kRemoved.end());
+
+    // Unclaimed peaks start tracks
+    for (size_t i = 0; i < kPeaks.size(); i++) {
+        if (mClaimed[i] == 0) {
+            mTracks.push_back({ .id = mNextId++,
+                                .bin = kPeaks[i].bin,
+                                .decibels = kPeaks[i].decibels,
+                                .first_row = mRowCount,
+                                .last_row = mRowCount,
+                                .rows = 1 });
+        }
+    }
+    mRowCount++;
+}
+
+void
+PeakTracker::Update(std::span<const float> aRows, size_t aBinCount)
+{
+    if (aBinCount == 0 || aRows.size() % aBinCount != 0) {
+        throw std::invalid_argument("PeakTracker rows must be whole rows of a nonzero bin count");
+    }
+    for (size_t first = 0; first < aRows.size(); first += aBinCount) {
+        Update(aRows.subspan(first, aBinCount));
+    }
+}
@@ -0,0 +1,156 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <mutex>
+#include <row_pipeline.h>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+RowPipeline::RowPipeline(FFTSize aTransformSize,
+                         FFTWindow::Type aWindowType,
+                         size_t aThreadCount,
+                         const IFFTProcessor::Factory& aFFTProcessorFactory,
+                         const FFTWindowFactory& aFFTWindowFactory)
+  : mTransformSize(aTransformSize)
+{
+    size_t threadCount = aThreadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Construct all DSP objects up front, before any worker runs
+    mWorkers.resize(threadCount);
+    for (auto& worker : mWorkers) {
+        worker.fft_processor = aFFTProcessorFactory
+                                 ? aFFTProcessorFactory(aTransformSize)
+                                 : std::make_unique<FFTProcessor>(aTransformSize);
+        worker.fft_window = aFFTWindowFactory
+                              ? aFFTWindowFactory(aTransformSize, aWindowType)
+                              : std::make_unique<FFTWindow>(aTransformSize, aWindowType);
+        worker.windowed.resize(aTransformSize);
+    }
+
+    // Start the threads only once mWorkers has its final size, so the vector
+    // is never reallocated under a running worker.
+    for (size_t i = 0; i < mWorkers.size(); i++) {
+        mWorkers[i].thread = std::jthread([this, i] { WorkerLoop(i); });
+    }
+}
+
+RowPipeline::~RowPipeline()
+{
+    {
+        const std::scoped_lock kLock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+
+    // Join explicitly, before the DSP objects and sync primitives are destroyed
+    for (auto& worker : mWorkers) {
+        worker.thread.join();
+    }
+}
+
+void
+RowPipeline::ComputeRows(std::span<const float> aSamples,
+                         FFTSize aStride,
+                         size_t aRowCount,
+                         std::span<float> aOutput)
+{
+    if (aOutput.size() != aRowCount * GetBinCount()) {
+        throw std::invalid_argument("Output size must be row count * bin count");
+    }
+    if (aRowCount == 0) {
+        return;
+    }
+    const size_t kSamplesNeeded = ((aRowCount - 1) * aStride) + mTransformSize;
+    if (aSamples.size() < kSamplesNeeded) {
+        throw std::invalid_argument("Not enough samples for requested row count");
+    }
+
+    std::unique_lock lock(mMutex);
+    mBatch = Batch{
+        .samples = aSamples,
+        .stride = aStride,
+        .row_count = aRowCount,
+        .output = aOutput,
+    };
+    mError = nullptr;
+    mPendingWorkers = mWorkers.size();
+    mGeneration++;
+    lock.unlock();
+    mWorkAvailable.notify_all();
+
+    lock.lock();
+    mWorkDone.wait(lock, [this] { return mPendingWorkers == 0; });
+
+    if (mError) {
+        std::rethrow_exception(mError);
+    }
+}
+
+void
+RowPipeline::WorkerLoop(size_t aWorkerIndex)
+{
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mMutex);
+            mWorkAvailable.wait(lock,
+                                [&] { return mStopping || mGeneration != seenGeneration; });
+            if (mStopping) {
+                return;
+            }
+            seenGeneration = mGeneration;
+        }
+
+        std::exception_ptr error;
+        try {
+            ComputeShare(aWorkerIndex);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            const std::scoped_lock kLock(mMutex);
+            if (error && !mError) {
+                mError = error;
+            }
+            mPendingWorkers--;
+            if (mPendingWorkers != 0) {
+                continue;
+            }
+        }
+        mWorkDone.notify_one();
+    }
+}
+
+void
+RowPipeline::ComputeShare(size_t aWorkerIndex)
+{
+    // mBatch is only written by ComputeRows while every worker is idle, so it
+    // can be read here without holding the lock.
+    const Batch& kBatch = mBatch;
+    const size_t kWorkerCount = mWorkers.size();
+    const size_t kFirstRow = kBatch.row_count * aWorkerIndex / kWorkerCount;
+    const size_t kEndRow = kBatch.row_count * (aWorkerIndex + 1) / kWorkerCount;
+    const size_t kBinCount = GetBinCount();
+
+    Worker& worker = mWorkers[aWorkerIndex];
+    for (size_t row = kFirstRow; row < kEndRow; row++) {
+        const auto kWindowSamples = kBatch.samples.subspan(row * kBatch.stride, mTransformSize);
+        worker.fft_window->Apply(kWindowSamples, worker.windowed);
+        worker.fft_processor->ComputeDecibels(worker.windowed,
+                                              kBatch.output.subspan(row * kBinCount, kBinCount));
+    }
+}
@@ -3,37 +3,183 @@
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
 #include "audio_types.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <format>
+#include <memory>
 #include <sample_buffer.h>
 #include <span>
 #include <stdexcept>
 #include <vector>
+#include <waveform_pyramid.h>
 
 SampleCount
 SampleBuffer::GetSampleCount() const
 {
-    return SampleCount{ mData.size() };
+    return SampleCount{ mSampleCount.load(std::memory_order_acquire) };
 }
 
 void
-SampleBuffer::AddSamples(const std::vector<float>& aSamples)
+SampleBuffer::AddSamples(std::span<const float> aSamples)
 {
-    mData.insert(mData.end(), aSamples.begin(), aSamples.end());
+    // Summarized before the count is published, so the pyramid never lags a
+    // reader by more than the partial base group
+    mPyramid.Add(aSamples);
+
+    size_t count = mSampleCount.load(std::memory_order_relaxed);
+    while (!aSamples.empty()) {
+        const size_t kPage = count / KPageSamples;
+        const size_t kOffset = count % KPageSamples;
+        const std::span<float> kPageData = GetWritablePage(kPage);
+
+        // Starting a page: copy the tail of the previous, full, page in front
+        // of it, so short ranges across the boundary stay contiguous
+        if (kOffset == 0 && kPage > 0) {
+            const std::span<float> kPrevious(mPages[kPage - 1].get(), KPageStride);
+            std::ranges::copy(kPrevious.last(KMaxSpanSamples), kPageData.begin());
+        }
+
+        const size_t kCount = std::min(aSamples.size(), KPageSamples - kOffset);
+        std::ranges::copy(aSamples.first(kCount),
+                          kPageData.subspan(KMaxSpanSamples + kOffset).begin());
+        aSamples = aSamples.subspan(kCount);
+        count += kCount;
+    }
+
+    // Publish: readers that see the new count also see the samples
+    mSampleCount.store(count, std::memory_order_release);
+}
+
+void
+SampleBuffer::Reserve(SampleCount aSampleCount)
+{
+    const size_t kPages = (aSampleCount.Get() + KPageSamples - 1) / KPageSamples;
+    for (size_t page = 0; page < kPages; page++) {
+        (void)GetWritablePage(page);
+    }
+    mPyramid.Reserve(aSampleCount.Get());
+}
+
+size_t
+SampleBuffer::ShrinkToFit()
+{
+    // Readers can't reach pages past the published count, so these are safe to free
+    const size_t kUsedPages =
+      (mSampleCount.load(std::memory_order_relaxed) + KPageSamples - 1) / KPageSamples;
+    size_t freed = 0;
+    while (mPages.size() > kUsedPages) {
+        if (mPages.back() != nullptr) {
+            freed += KPageStride * sizeof(float);
+        }
+        mPages.pop_back();
+    }
+    mMemoryBytes.fetch_sub(freed, std::memory_order_relaxed);
+    return freed;
+}
+
+std::span<float>
+SampleBuffer::GetWritablePage(size_t aPage)
+{
+    if (aPage < mPages.size() && mPages[aPage] != nullptr) {
+        return { mPages[aPage].get(), KPageStride };
+    }
+
+    if (mPages.size() <= aPage) {
+        mPages.resize(aPage + 1);
+    }
+    // Not zeroed: only the part below the published count is ever read
+    mPages[aPage] = std::make_unique_for_overwrite<float[]>(KPageStride);
+    const size_t kDirectoryBytes = mDirectory.Set(aPage, mPages[aPage].get());
+    mMemoryBytes.fetch_add(kDirectoryBytes + (KPageStride * sizeof(float)),
+                           std::memory_order_relaxed);
+    return { mPages[aPage].get(), KPageStride };
 }
 
 std::span<const float>
 SampleBuffer::GetSamples(SampleIndex aStartSample, SampleCount aSampleCount) const
 {
-    if (aStartSample.Get() > mData.size() ||
-        aSampleCount.Get() > mData.size() - aStartSample.Get()) {
+    const size_t kAvailable = mSampleCount.load(std::memory_order_acquire);
+    if (aStartSample.Get() > kAvailable || aSampleCount.Get() > kAvailable - aStartSample.Get()) {
         throw std::out_of_range(
           std::format("SampleBuffer::GetSamples: Not enough samples to fulfill request: "
                       "requested start {}, count {}, available {}",
                       aStartSample.Get(),
                       aSampleCount.Get(),
-                      mData.size()));
+                      kAvailable));
+    }
+    if (aSampleCount.Get() == 0) {
+        return {};
     }
 
-    // The check above guarantees the range is valid.
-    return std::span<const float>(mData).subspan(aStartSample.Get(), aSampleCount.Get());
-}
\ No newline at end of file
+    // Serve the range from the page holding its last sample.  The overlap in
+    // front of that page covers up to KMaxSpanSamples before it.
+    const size_t kPage = (aStartSample.Get() + aSampleCount.Get() - 1) / KPageSamples;
+    const size_t kPageStart = kPage * KPageSamples;
+    if (aStartSample.Get() + KMaxSpanSamples < kPageStart) {
+        throw std::length_error(
+          std::format("SampleBuffer::GetSamples: {} samples from {} cross a page boundary; "
+                      "at most {} are contiguous",
+                      aSampleCount.Get(),
+                      aStartSample.Get(),
+                      KMaxSpanSamples));
+    }
+
+    // The acquire load of the count above published the page
+    const std::span<const float> kPageData(mDirectory.Get(kPage), KPageStride);
+    return kPageData.subspan(KMaxSpanSamples + aStartSample.Get() - kPageStart,
+                             aSampleCount.Get());
+}
+
+WaveformPyramid::Entry
+SampleBuffer::Summarize(SampleIndex aStartSample, SampleCount aSampleCount) const
+{
+    const size_t kAvailable = mSampleCount.load(std::memory_order_acquire);
+    const size_t kEnd = std::min(aStartSample.Get() + aSampleCount.Get(), kAvailable);
+    size_t position = aStartSample.Get();
+    if (position >= kEnd) {
+        return { .min = 0.0f, .max = 0.0f, .mean_square = 0.0f };
+    }
+
+    float low = 0.0f;
+    float high = 0.0f;
+    double sumOfSquares = 0.0;
+    size_t summarized = 0;
+    const auto kInclude = [&](float aMin, float aMax, double aSumOfSquares, size_t aCount) {
+        low = summarized == 0 ? aMin : std::min(low, aMin);
+        high = summarized == 0 ? aMax : std::max(high, aMax);
+        sumOfSquares += aSumOfSquares;
+        summarized += aCount;
+    };
+
+    // Coarse to fine: each level covers what it can of the rest of the range.
+    // The level wraps past zero, and a range shorter than a base group starts
+    // at KLevelCount, so both end the loop.
+    for (size_t level = WaveformPyramid::GetLevelFor(kEnd - position);
+         level < WaveformPyramid::KLevelCount && position < kEnd;
+         level--) {
+        const size_t kGroup = WaveformPyramid::GetGroupSamples(level);
+        const size_t kEntryEnd =
+          std::min((kEnd + kGroup - 1) / kGroup, mPyramid.GetEntryCount(level));
+        for (size_t entry = position / kGroup; entry < kEntryEnd; entry++) {
+            const WaveformPyramid::Entry& kEntry = mPyramid.GetEntry(level, entry);
+            kInclude(kEntry.min,
+                     kEntry.max,
+                     static_cast<double>(kEntry.mean_square) * static_cast<double>(kGroup),
+                     kGroup);
+            position = (entry + 1) * kGroup;
+        }
+    }
+
+    // The pyramid covers every complete base group, so at most one is left
+    if (position < kEnd) {
+        const std::span<const float> kTail =
+          GetSamples(SampleIndex{ position }, SampleCount{ kEnd - position });
+        for (const float kSample : kTail) {
+            kInclude(kSample, kSample, static_cast<double>(kSample) * kSample, 1);
+        }
+    }
+    return { .min = low,
+             .max = high,
+             .mean_square = static_cast<float>(sumOfSquares / static_cast<double>(summarized)) };
+}
@@ -0,0 +1,699 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "spectrogram_engine.h"
+#include <audio_types.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_budget.h>
+#include <metrics.h>
+#include <mutex>
+#include <sample_source.h>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <trace.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief Estimated bookkeeping per cached row: the key, the vector header and
+/// a red-black tree node's links and colour
+constexpr size_t KRowEntryOverheadBytes =
+  sizeof(FrameIndex) + sizeof(std::vector<float>) + (4 * sizeof(void*));
+
+/// @brief Estimated bytes per silent run: its two frames and a tree node
+constexpr size_t KSilentRunBytes = (2 * sizeof(FrameIndex)) + (4 * sizeof(void*));
+
+static_assert(std::numeric_limits<float>::is_iec559, "IsSilent() assumes IEEE 754 floats");
+
+/// @brief Everything but the sign bit of an IEEE 754 float
+constexpr uint32_t KFloatMagnitudeMask = 0x7fffffffU;
+
+/// @brief Engine metrics, looked up once
+struct EngineMetrics
+{
+    Metrics::Counter& rows_computed = Metrics::GetCounter(Metrics::KRowsComputed);
+    Metrics::Counter& cache_hits = Metrics::GetCounter(Metrics::KCacheHits);
+    Metrics::Counter& cache_misses = Metrics::GetCounter(Metrics::KCacheMisses);
+    Metrics::Gauge& cache_rows = Metrics::GetGauge(Metrics::KCacheRows);
+    Metrics::Counter& cache_evictions = Metrics::GetCounter(Metrics::KCacheEvictions);
+    Metrics::Counter& silent_rows = Metrics::GetCounter(Metrics::KSilentRows);
+    Metrics::Counter& aliased_rows = Metrics::GetCounter(Metrics::KAliasedRows);
+    Metrics::Histogram& fft_time = Metrics::GetHistogram(Metrics::KFFTTime);
+};
+
+EngineMetrics&
+GetMetrics()
+{
+    static EngineMetrics metrics;
+    return metrics;
+}
+
+} // namespace
+
+SpectrogramEngine::SpectrogramEngine(const ISampleSource& aSource,
+                                     FFTSize aTransformSize,
+                                     FFTWindow::Type aWindowType,
+                                     IFFTProcessor::Factory aFFTProcessorFactory,
+                                     FFTWindowFactory aFFTWindowFactory)
+  : mSource(aSource)
+  , mTransformSize(aTransformSize)
+  , mFFTProcessorFactory(std::move(aFFTProcessorFactory))
+  , mFFTWindowFactory(std::move(aFFTWindowFactory))
+{
+    // Provide default factories if none supplied
+    if (!mFFTProcessorFactory) {
+        mFFTProcessorFactory = [](FFTSize size) { return std::make_unique<FFTProcessor>(size); };
+    }
+
+    if (!mFFTWindowFactory) {
+        mFFTWindowFactory = [](FFTSize size, FFTWindow::Type type) {
+            return std::make_unique<FFTWindow>(size, type);
+        };
+    }
+
+    Configure(aTransformSize, aWindowType);
+}
+
+SpectrogramEngine::~SpectrogramEngine()
+{
+    StopWorkers();
+    ReleaseCachedRows();
+}
+
+void
+SpectrogramEngine::Configure(FFTSize aTransformSize, FFTWindow::Type aWindowType)
+{
+    // Clear out the old workers, DSP objects and cached rows
+    StopWorkers();
+    ReleaseCachedRows();
+    mChannels.clear();
+    mTransformSize = aTransformSize;
+
+    // Create FFT and window instances for each channel
+    for (size_t i = 0; i < mSource.GetChannelCount(); i++) {
+        mChannels.push_back({ .fft_processor = mFFTProcessorFactory(aTransformSize),
+                              .fft_window = mFFTWindowFactory(aTransformSize, aWindowType),
+                              .windowed = std::vector<float>(aTransformSize),
+                              .row_cache = {},
+                              .silent_runs = {} });
+    }
+    mRowSources.assign(mChannels.size(), 0);
+    mToCompute.clear();
+    mToCompute.reserve(mChannels.size());
+    mZeroRow.assign(GetBinCount(), 0.0f);
+
+    // Ask the processor for the floor rather than assuming -inf, so silent rows
+    // match what ComputeFFT() would have produced
+    if (mChannels.empty()) {
+        mFloorRow = mZeroRow;
+    } else {
+        const std::vector<float> kZeros(aTransformSize, 0.0f);
+        mFloorRow = mChannels.front().fft_processor->ComputeDecibels(kZeros);
+    }
+    UpdateSilentPeak();
+    StartWorkers();
+}
+
+void
+SpectrogramEngine::StartWorkers()
+{
+    mStopping = false;
+    mWorkers.resize(mChannels.empty() ? 0 : mChannels.size() - 1);
+
+    // Start the threads only once mWorkers has its final size, so the vector
+    // is never reallocated under a running worker
+    for (size_t i = 0; i < mWorkers.size(); i++) {
+        mWorkers[i].thread = std::jthread([this, i] { WorkerLoop(i); });
+    }
+}
+
+void
+SpectrogramEngine::StopWorkers()
+{
+    {
+        const std::scoped_lock kLock(mWorkMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+
+    // Join explicitly, before the channels they compute are destroyed
+    for (Worker& worker : mWorkers) {
+        worker.thread.join();
+    }
+    mWorkers.clear();
+}
+
+void
+SpectrogramEngine::WorkerLoop(size_t aWorkerIndex)
+{
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mWorkMutex);
+            mWorkAvailable.wait(lock,
+                                [&] { return mStopping || mGeneration != seenGeneration; });
+            if (mStopping) {
+                return;
+            }
+            seenGeneration = mGeneration;
+
+            // The last channel is the caller's; workers past it sit this out
+            if (aWorkerIndex + 1 >= mBatch.channels.size()) {
+                continue;
+            }
+        }
+
+        // mBatch is only written while every worker with a channel is idle
+        Worker& worker = mWorkers[aWorkerIndex];
+        try {
+            const ChannelCount kChannel = mBatch.channels[aWorkerIndex];
+            GetRowViews(kChannel, mBatch.first_frame, mBatch.stride, (*mBatch.views)[kChannel]);
+        } catch (...) {
+            worker.error = std::current_exception();
+        }
+
+        {
+            const std::scoped_lock kLock(mWorkMutex);
+            mPendingWorkers--;
+            if (mPendingWorkers != 0) {
+                continue;
+            }
+        }
+        mWorkDone.notify_one();
+    }
+}
+
+void
+SpectrogramEngine::SetSilenceFloor(float aDecibels)
+{
+    mSilenceFloorDecibels = aDecibels;
+    for (Channel& channel : mChannels) {
+        channel.silent_runs.clear();
+    }
+    UpdateSilentPeak();
+}
+
+void
+SpectrogramEngine::UpdateSilentPeak()
+{
+    mSilentPeak = std::numeric_limits<float>::min();
+    if (mChannels.empty()) {
+        return;
+    }
+
+    // |X[k]| <= sum |w[n] x[n]| <= peak * sum |w[n]|, so a peak below
+    // floor / sum |w[n]| keeps every bin below the floor
+    std::vector<float> coefficients(mTransformSize, 1.0f);
+    mChannels.front().fft_window->Apply(coefficients, coefficients);
+    float windowSum = 0.0f;
+    for (const float kCoefficient : coefficients) {
+        windowSum += std::abs(kCoefficient);
+    }
+    const float kFloor = std::pow(10.0f, mSilenceFloorDecibels / 20.0f);
+    if (windowSum > 0.0f) {
+        mSilentPeak = std::max(mSilentPeak, kFloor / windowSum);
+    }
+}
+
+SpectrogramEngine::Channel&
+SpectrogramEngine::GetChannel(ChannelCount aChannel) const
+{
+    if (aChannel >= mSource.GetChannelCount() || aChannel >= mChannels.size()) {
+        throw std::out_of_range("Channel index out of range");
+    }
+    return mChannels[aChannel];
+}
+
+std::vector<std::vector<float>>
+SpectrogramEngine::GetRows(ChannelCount aChannel,
+                           FramePosition aFirstFrame,
+                           size_t aRowCount,
+                           FFTSize aStride) const
+{
+    mFocusFrame = aFirstFrame;
+    (void)GetChannel(aChannel);
+    const ChannelCount kSource = FindRowSource(aChannel, aFirstFrame, aRowCount, aStride);
+    if (kSource != aChannel) {
+        GetMetrics().aliased_rows.Add(aRowCount);
+    }
+    std::vector<std::span<const float>> views(aRowCount);
+    GetRowViews(kSource, aFirstFrame, aStride, views);
+
+    std::vector<std::vector<float>> spectrogram;
+    spectrogram.reserve(aRowCount);
+    for (const auto& kRow : views) {
+        spectrogram.emplace_back(kRow.begin(), kRow.end());
+    }
+    return spectrogram;
+}
+
+void
+SpectrogramEngine::GetRowViews(ChannelCount aChannel,
+                               FramePosition aFirstFrame,
+                               FFTSize aStride,
+                               std::span<std::span<const float>> aViews) const
+{
+    SPECTRO_TRACE_ZONE("SpectrogramEngine::GetRows");
+    (void)GetChannel(aChannel);
+
+    for (size_t row = 0; row < aViews.size(); row++) {
+        const FramePosition kWindowFirstSample = aFirstFrame + FrameCount{ row * aStride };
+        aViews[row] = GetOwnRowView(aChannel, kWindowFirstSample);
+    }
+}
+
+std::vector<std::vector<std::vector<float>>>
+SpectrogramEngine::GetChannelRows(FramePosition aFirstFrame,
+                                  size_t aRowCount,
+                                  FFTSize aStride) const
+{
+    RowViews views;
+    GetChannelRowViews(aFirstFrame, aRowCount, aStride, views);
+
+    std::vector<std::vector<std::vector<float>>> channelRows;
+    channelRows.reserve(views.size());
+    for (const auto& kRows : views) {
+        auto& rows = channelRows.emplace_back();
+        rows.reserve(kRows.size());
+        for (const auto& kRow : kRows) {
+            rows.emplace_back(kRow.begin(), kRow.end());
+        }
+    }
+    return channelRows;
+}
+
+void
+SpectrogramEngine::GetChannelRowViews(FramePosition aFirstFrame,
+                                      size_t aRowCount,
+                                      FFTSize aStride,
+                                      RowViews& aViews) const
+{
+    mFocusFrame = aFirstFrame;
+    const ChannelCount kChannels = GetChannelCount();
+    aViews.resize(kChannels);
+    for (auto& rows : aViews) {
+        rows.resize(aRowCount);
+    }
+
+    // Duplicates of a lower channel are copied from its views at the end.
+    // Channels with nothing to compute are cheap cache lookups; do them here.
+    // The rest each go to a worker, except the last, which runs on this one.
+    // Nothing is allocated but the cache entries of new rows.
+    std::vector<ChannelCount>& toCompute = mToCompute;
+    toCompute.clear();
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        mRowSources[ch] = FindRowSource(ch, aFirstFrame, aRowCount, aStride);
+        if (mRowSources[ch] != ch) {
+            continue;
+        }
+        if (HasUncachedRows(ch, aFirstFrame, aRowCount, aStride)) {
+            toCompute.push_back(ch);
+        } else {
+            GetRowViews(ch, aFirstFrame, aStride, aViews[ch]);
+        }
+    }
+    if (!toCompute.empty()) {
+        ComputeChannels(toCompute, aFirstFrame, aStride, aViews);
+    }
+
+    // Sources are lower channels, so they are filled first even when they
+    // are duplicates themselves
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        if (mRowSources[ch] != ch) {
+            aViews[ch] = aViews[mRowSources[ch]];
+            GetMetrics().aliased_rows.Add(aRowCount);
+        }
+    }
+}
+
+void
+SpectrogramEngine::ComputeChannels(std::span<const ChannelCount> aChannels,
+                                   FramePosition aFirstFrame,
+                                   FFTSize aStride,
+                                   RowViews& aViews) const
+{
+    const size_t kJobs = aChannels.size() - 1;
+    if (kJobs > 0) {
+        {
+            const std::scoped_lock kLock(mWorkMutex);
+            mBatch = Batch{
+                .channels = aChannels,
+                .first_frame = aFirstFrame,
+                .stride = aStride,
+                .views = &aViews,
+            };
+            mPendingWorkers = kJobs;
+            mGeneration++;
+        }
+        mWorkAvailable.notify_all();
+    }
+
+    std::exception_ptr error;
+    try {
+        const ChannelCount kChannel = aChannels.back();
+        GetRowViews(kChannel, aFirstFrame, aStride, aViews[kChannel]);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    if (kJobs > 0) {
+        std::unique_lock lock(mWorkMutex);
+        mWorkDone.wait(lock, [this] { return mPendingWorkers == 0; });
+    }
+    for (size_t i = 0; i < kJobs; i++) {
+        if (!error) {
+            error = mWorkers[i].error;
+        }
+        mWorkers[i].error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool
+SpectrogramEngine::HasUncachedRows(ChannelCount aChannel,
+                                   FramePosition aFirstFrame,
+                                   size_t aRowCount,
+                                   FFTSize aStride) const
+{
+    const Channel& kChannel = GetChannel(aChannel);
+    const FramePosition kAvailableEnd = GetAvailableFrameCount().AsPosition();
+
+    for (size_t row = 0; row < aRowCount; row++) {
+        const FramePosition kFirst = aFirstFrame + FrameCount{ row * aStride };
+        // Unavailable rows are zero-filled, not computed
+        if (kFirst < FramePosition{ 0 } || kFirst + mTransformSize > kAvailableEnd) {
+            continue;
+        }
+        const FrameIndex kFirstIndex(kFirst.Get());
+        if (!kChannel.row_cache.contains(kFirstIndex) && !IsInSilentRun(kChannel, kFirstIndex)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<float>
+SpectrogramEngine::GetRow(ChannelCount aChannel, FramePosition aFirstFrame) const
+{
+    const std::span<const float> kRow = GetRowView(aChannel, aFirstFrame);
+    return { kRow.begin(), kRow.end() };
+}
+
+std::span<const float>
+SpectrogramEngine::GetRowView(ChannelCount aChannel, FramePosition aFirstFrame) const
+{
+    (void)GetChannel(aChannel);
+    const ChannelCount kSource = FindRowSource(aChannel, aFirstFrame, 1, mTransformSize);
+    if (kSource != aChannel) {
+        GetMetrics().aliased_rows.Add();
+    }
+    return GetOwnRowView(kSource, aFirstFrame);
+}
+
+ChannelCount
+SpectrogramEngine::FindRowSource(ChannelCount aChannel,
+                                 FramePosition aFirstFrame,
+                                 size_t aRowCount,
+                                 FFTSize aStride) const
+{
+    if (aRowCount == 0) {
+        return aChannel;
+    }
+
+    // Every window of an available row lies within [kFirst, kEnd)
+    const FramePosition kLastRowEnd =
+      aFirstFrame + FrameCount{ (aRowCount - 1) * aStride } + mTransformSize;
+    const int64_t kFirst = std::max<int64_t>(aFirstFrame.Get(), 0);
+    const int64_t kEnd =
+      std::min(kLastRowEnd.Get(), GetAvailableFrameCount().AsPosition().Get());
+    if (kEnd - kFirst < static_cast<int64_t>(mTransformSize)) {
+        return aChannel; // No row is available
+    }
+    return mSource.FindIdenticalChannel(aChannel,
+                                        SampleIndex(static_cast<size_t>(kFirst)),
+                                        SampleCount(static_cast<size_t>(kEnd - kFirst)));
+}
+
+std::span<const float>
+SpectrogramEngine::GetOwnRowView(ChannelCount aChannel, FramePosition aFirstFrame) const
+{
+    Channel& channel = GetChannel(aChannel);
+
+    // We want the number of samples in single channel
+    const FrameCount kAvailableFrames = GetAvailableFrameCount();
+    const FramePosition kLastNeededSample = aFirstFrame + mTransformSize;
+    // Check if the requested window is within available data, else return zeroed row
+    if (aFirstFrame < FramePosition{ 0 } || kLastNeededSample > kAvailableFrames.AsPosition()) {
+        return mZeroRow;
+    }
+
+    // The aFirstFrame < 0 check above ensures this cast is safe
+    const FrameIndex kFirstFrameIndex(aFirstFrame.Get());
+
+    // Check cache first
+    EngineMetrics& metrics = GetMetrics();
+    const auto kCacheIt = channel.row_cache.find(kFirstFrameIndex);
+    if (kCacheIt != channel.row_cache.end()) {
+        metrics.cache_hits.Add();
+        return kCacheIt->second;
+    }
+    if (IsInSilentRun(channel, kFirstFrameIndex)) {
+        metrics.cache_hits.Add();
+        return mFloorRow;
+    }
+
+    // Not in cache.  Silent windows skip the FFT and store no bins.
+    metrics.cache_misses.Add();
+    const auto kSamples = mSource.GetSamples(
+      aChannel, SampleIndex(kFirstFrameIndex.Get()), SampleCount(mTransformSize));
+    if (IsSilent(kSamples, mSilentPeak)) {
+        AddSilentRun(channel, kFirstFrameIndex);
+        metrics.silent_rows.Add();
+        return mFloorRow;
+    }
+
+    // Compute it straight into a new cache entry
+    std::vector<float> spectrum(GetBinCount());
+    ComputeFFT(aChannel, kFirstFrameIndex, spectrum);
+    const auto kIt = channel.row_cache.emplace(kFirstFrameIndex, std::move(spectrum)).first;
+    metrics.cache_rows.Add(1);
+    return kIt->second;
+}
+
+std::vector<float>
+SpectrogramEngine::ComputeFFT(ChannelCount aChannel, FrameIndex aFirstFrame) const
+{
+    std::vector<float> decibels(GetBinCount());
+    ComputeFFT(aChannel, aFirstFrame, decibels);
+    return decibels;
+}
+
+void
+SpectrogramEngine::ComputeFFT(ChannelCount aChannel,
+                              FrameIndex aFirstFrame,
+                              std::span<float> aDecibels) const
+{
+    SPECTRO_TRACE_ZONE("SpectrogramEngine::ComputeFFT");
+    EngineMetrics& metrics = GetMetrics();
+    const Metrics::ScopedTimer kTimer(metrics.fft_time);
+    metrics.rows_computed.Add();
+    Channel& channel = GetChannel(aChannel);
+    // We need to convert FrameIndex to SampleIndex for source access
+    const SampleIndex kFirstSample(aFirstFrame.Get());
+    const auto kSamples =
+      mSource.GetSamples(aChannel, kFirstSample, SampleCount(channel.fft_window->GetSize()));
+    channel.fft_window->Apply(kSamples, channel.windowed);
+    channel.fft_processor->ComputeDecibels(channel.windowed, aDecibels);
+}
+
+float
+SpectrogramEngine::GetHzPerBin() const
+{
+    const SampleRate kSampleRate = mSource.GetSampleRate();
+    return static_cast<float>(kSampleRate) / static_cast<float>(mTransformSize);
+}
+
+FramePosition
+SpectrogramEngine::CalculateTopOfWindow(FramePosition aCursorFrame, FFTSize aStride) const
+{
+    const FramePosition kUnalignedFrame = aCursorFrame - mTransformSize;
+    return RoundToStride(kUnalignedFrame, aStride);
+}
+
+FramePosition
+SpectrogramEngine::RoundToStride(FramePosition aFrame, FFTSize aStride)
+{
+    const int64_t kStride = static_cast<int64_t>(aStride);
+
+    // Calculate floor(aFrame / kStride) for both positive and negative values.
+    // For positive values, this is just integer division.
+    // For negative values, division truncates toward zero, so we use:
+    //      ceil(n / d) == ( n + d - 1) / d
+    //     ceil(-n / d) == (-n + d - 1) / d
+    //     floor(n / d) == -ceil(-n / d)
+    //                  == -((-n + d - 1) / d)
+    const int64_t kStrideIndex =
+      aFrame.Get() >= 0 ? aFrame.Get() / kStride : -((-aFrame.Get() + kStride - 1) / kStride);
+    return FramePosition{ kStrideIndex * kStride };
+}
+
+size_t
+SpectrogramEngine::GetCachedRowCount() const
+{
+    size_t rows = 0;
+    for (const Channel& kChannel : mChannels) {
+        rows += kChannel.row_cache.size();
+    }
+    return rows;
+}
+
+size_t
+SpectrogramEngine::GetSilentRunCount() const
+{
+    size_t runs = 0;
+    for (const Channel& kChannel : mChannels) {
+        runs += kChannel.silent_runs.size();
+    }
+    return runs;
+}
+
+bool
+SpectrogramEngine::IsSilent(std::span<const float> aSamples, float aPeakLimit) noexcept
+{
+    // With the sign cleared, IEEE 754 bit patterns order like their values, so
+    // the peak is an integer max.  No branches, so the loop vectorizes.  NaN
+    // sorts above infinity, so is never silent.
+    uint32_t peak = 0;
+    for (const float kSample : aSamples) {
+        peak = std::max(peak, std::bit_cast<uint32_t>(kSample) & KFloatMagnitudeMask);
+    }
+    return peak < std::bit_cast<uint32_t>(aPeakLimit);
+}
+
+bool
+SpectrogramEngine::IsInSilentRun(const Channel& aChannel, FrameIndex aFirstFrame) const
+{
+    auto it = aChannel.silent_runs.upper_bound(aFirstFrame);
+    if (it == aChannel.silent_runs.begin()) {
+        return false;
+    }
+    --it;
+    return aFirstFrame.Get() + mTransformSize <= it->second.Get();
+}
+
+void
+SpectrogramEngine::AddSilentRun(Channel& aChannel, FrameIndex aFirstFrame) const
+{
+    auto& runs = aChannel.silent_runs;
+    const FrameIndex kEnd(aFirstFrame.Get() + mTransformSize);
+
+    // Extend the run this window touches, if any, rather than adding one
+    auto next = runs.upper_bound(aFirstFrame);
+    auto run = next;
+    if (next != runs.begin() && std::prev(next)->second >= aFirstFrame) {
+        run = std::prev(next);
+        run->second = std::max(run->second, kEnd);
+    } else {
+        run = runs.emplace_hint(next, aFirstFrame, kEnd);
+    }
+
+    // Absorb the runs that now touch it
+    while (next != runs.end() && next->first <= run->second) {
+        run->second = std::max(run->second, next->second);
+        next = runs.erase(next);
+    }
+}
+
+size_t
+SpectrogramEngine::GetRowBytes() const
+{
+    return (GetBinCount() * sizeof(float)) + KRowEntryOverheadBytes;
+}
+
+size_t
+SpectrogramEngine::GetMemoryBytes() const
+{
+    size_t bytes = (GetCachedRowCount() * GetRowBytes()) + (GetSilentRunCount() * KSilentRunBytes) +
+                   ((mZeroRow.capacity() + mFloorRow.capacity()) * sizeof(float));
+    for (const Channel& kChannel : mChannels) {
+        bytes += kChannel.fft_processor->GetMemoryBytes() + kChannel.fft_window->GetMemoryBytes() +
+                 (kChannel.windowed.capacity() * sizeof(float));
+    }
+    return bytes;
+}
+
+size_t
+SpectrogramEngine::ReleaseMemory(size_t aBytes)
+{
+    const int64_t kFocus = mFocusFrame.Get();
+    auto distance = [kFocus](FrameIndex aFrame) {
+        const auto kFrame = static_cast<int64_t>(aFrame.Get());
+        return kFrame > kFocus ? kFrame - kFocus : kFocus - kFrame;
+    };
+
+    // Each cache is ordered by frame, so the farthest row is at one end of
+    // one of them.  Evict that frame from every channel, so channels stay in
+    // step, and repeat.
+    size_t freed = 0;
+    size_t evicted = 0;
+    while (freed < aBytes) {
+        bool found = false;
+        FrameIndex victim{ 0 };
+        for (const Channel& kChannel : mChannels) {
+            if (kChannel.row_cache.empty()) {
+                continue;
+            }
+            for (const FrameIndex kCandidate :
+                 { kChannel.row_cache.begin()->first, kChannel.row_cache.rbegin()->first }) {
+                if (!found || distance(kCandidate) > distance(victim)) {
+                    victim = kCandidate;
+                    found = true;
+                }
+            }
+        }
+        if (!found) {
+            // Only the silent runs are left
+            for (Channel& channel : mChannels) {
+                freed += channel.silent_runs.size() * KSilentRunBytes;
+                channel.silent_runs.clear();
+            }
+            break;
+        }
+        for (Channel& channel : mChannels) {
+            const auto kIt = channel.row_cache.find(victim);
+            if (kIt == channel.row_cache.end()) {
+                continue;
+            }
+            freed += GetRowBytes();
+            channel.row_cache.erase(kIt);
+            evicted++;
+        }
+    }
+
+    EngineMetrics& metrics = GetMetrics();
+    metrics.cache_rows.Add(-static_cast<int64_t>(evicted));
+    metrics.cache_evictions.Add(evicted);
+    return freed;
+}
+
+void
+SpectrogramEngine::ReleaseCachedRows()
+{
+    GetMetrics().cache_rows.Add(-static_cast<int64_t>(GetCachedRowCount()));
+}
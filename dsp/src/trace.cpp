@@ -0,0 +1,252 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// @brief One thread's ring of events
+///
+/// Single writer.  Slots are atomics so Snapshot() can read them while the
+/// owner writes; the write count is published after each event and re-read
+/// after copying to detect overwritten slots.
+struct ThreadBuffer
+{
+    struct Slot
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> start_ns{ 0 };
+        std::atomic<uint64_t> duration_ns{ 0 };
+    };
+
+    explicit ThreadBuffer(uint32_t aThreadId)
+      : thread_id(aThreadId)
+      , slots(Trace::KEventsPerThread)
+    {
+    }
+
+    const uint32_t thread_id;
+    std::vector<Slot> slots;
+    std::atomic<uint64_t> write_count{ 0 };
+};
+
+/// @brief All buffers ever created, and those whose thread has exited
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> free_buffers;
+};
+
+Registry&
+GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<bool> gEnabled{ false };
+// Events starting before this were cleared
+std::atomic<uint64_t> gClearedBeforeNs{ 0 };
+
+/// @brief Claims a buffer for the current thread and returns it on exit
+class BufferLease
+{
+  public:
+    BufferLease()
+    {
+        Registry& registry = GetRegistry();
+        const std::scoped_lock kLock(registry.mutex);
+        if (!registry.free_buffers.empty()) {
+            mBuffer = registry.free_buffers.back();
+            registry.free_buffers.pop_back();
+        } else {
+            const auto kThreadId = static_cast<uint32_t>(registry.buffers.size() + 1);
+            registry.buffers.push_back(std::make_unique<ThreadBuffer>(kThreadId));
+            mBuffer = registry.buffers.back().get();
+        }
+    }
+
+    ~BufferLease()
+    {
+        Registry& registry = GetRegistry();
+        const std::scoped_lock kLock(registry.mutex);
+        registry.free_buffers.push_back(mBuffer);
+    }
+
+    BufferLease(const BufferLease&) = delete;
+    BufferLease& operator=(const BufferLease&) = delete;
+    BufferLease(BufferLease&&) = delete;
+    BufferLease& operator=(BufferLease&&) = delete;
+
+    [[nodiscard]] ThreadBuffer& Get() const { return *mBuffer; }
+
+  private:
+    ThreadBuffer* mBuffer;
+};
+
+void
+Record(const char* aName, uint64_t aStartNs, uint64_t aDurationNs)
+{
+    thread_local const BufferLease kLease;
+    ThreadBuffer& buffer = kLease.Get();
+    const uint64_t kCount = buffer.write_count.load(std::memory_order_relaxed);
+    ThreadBuffer::Slot& slot = buffer.slots[kCount % Trace::KEventsPerThread];
+    // Release pairs with Snapshot's acquire loads: a reader that sees this
+    // event also sees the count that marks the slot's old event as overwritten
+    slot.name.store(aName, std::memory_order_release);
+    slot.start_ns.store(aStartNs, std::memory_order_release);
+    slot.duration_ns.store(aDurationNs, std::memory_order_release);
+    buffer.write_count.store(kCount + 1, std::memory_order_release);
+}
+
+/// @brief Write a string as a JSON string literal
+void
+WriteJsonString(std::ostream& aStream, const char* aText)
+{
+    aStream << '"';
+    for (const char* c = aText; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            aStream << '\\';
+        }
+        aStream << *c;
+    }
+    aStream << '"';
+}
+
+} // namespace
+
+Trace::Zone::Zone(const char* aName) noexcept
+  : mName(aName)
+  , mActive(gEnabled.load(std::memory_order_relaxed))
+{
+    if (mActive) {
+        mStartNs = Now();
+    }
+}
+
+Trace::Zone::~Zone()
+{
+    if (mActive) {
+        Record(mName, mStartNs, Now() - mStartNs);
+    }
+}
+
+void
+Trace::SetEnabled(bool aEnabled)
+{
+    gEnabled.store(aEnabled, std::memory_order_relaxed);
+}
+
+bool
+Trace::IsEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void
+Trace::Clear()
+{
+    gClearedBeforeNs.store(Now(), std::memory_order_relaxed);
+}
+
+std::vector<Trace::Event>
+Trace::Snapshot()
+{
+    const uint64_t kClearedBeforeNs = gClearedBeforeNs.load(std::memory_order_relaxed);
+    std::vector<Event> events;
+
+    Registry& registry = GetRegistry();
+    const std::scoped_lock kLock(registry.mutex);
+    for (const auto& kBuffer : registry.buffers) {
+        const uint64_t kCount = kBuffer->write_count.load(std::memory_order_acquire);
+        const uint64_t kFirst = kCount > KEventsPerThread ? kCount - KEventsPerThread : 0;
+
+        // Acquire loads keep the slot reads ahead of the second count read
+        std::vector<Event> copied;
+        copied.reserve(kCount - kFirst);
+        for (uint64_t i = kFirst; i < kCount; i++) {
+            const ThreadBuffer::Slot& kSlot = kBuffer->slots[i % KEventsPerThread];
+            copied.push_back({ .name = kSlot.name.load(std::memory_order_acquire),
+                               .thread_id = kBuffer->thread_id,
+                               .start_ns = kSlot.start_ns.load(std::memory_order_acquire),
+                               .duration_ns = kSlot.duration_ns.load(std::memory_order_acquire) });
+        }
+
+        // The writer may have lapped us while copying.  Slots it has started
+        // to reuse hold index kCountAfter - capacity and below.
+        const uint64_t kCountAfter = kBuffer->write_count.load(std::memory_order_relaxed);
+        const uint64_t kFirstValid =
+          kCountAfter >= KEventsPerThread ? kCountAfter - KEventsPerThread + 1 : 0;
+        for (uint64_t i = std::max(kFirst, kFirstValid); i < kCount; i++) {
+            const Event& kEvent = copied[i - kFirst];
+            if (kEvent.start_ns >= kClearedBeforeNs) {
+                events.push_back(kEvent);
+            }
+        }
+    }
+
+    std::ranges::sort(events, {}, &Event::start_ns);
+    return events;
+}
+
+void
+Trace::WriteChromeJson(std::ostream& aStream)
+{
+    const std::vector<Event> kEvents = Snapshot();
+
+    // Complete ("X") events; timestamps are in microseconds
+    aStream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const Event& kEvent : kEvents) {
+        aStream << (first ? "\n" : ",\n");
+        first = false;
+        aStream << "{\"name\":";
+        WriteJsonString(aStream, kEvent.name);
+        aStream << std::format(",\"cat\":\"spectro\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+                               "\"pid\":1,\"tid\":{}}}",
+                               static_cast<double>(kEvent.start_ns) / 1e3,
+                               static_cast<double>(kEvent.duration_ns) / 1e3,
+                               kEvent.thread_id);
+    }
+    aStream << "\n]}\n";
+}
+
+std::expected<void, std::string>
+Trace::WriteChromeJsonFile(const std::string& aPath)
+{
+    std::ofstream file(aPath, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return std::unexpected(std::format("Failed to open {}", aPath));
+    }
+    WriteChromeJson(file);
+    file.close();
+    if (!file) {
+        return std::unexpected(std::format("Failed to write {}", aPath));
+    }
+    return {};
+}
+
+uint64_t
+Trace::Now() noexcept
+{
+    static const auto kEpoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                           kEpoch)
+        .count());
+}
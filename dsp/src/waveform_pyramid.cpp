@@ -0,0 +1,115 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+#include <waveform_pyramid.h>
+
+namespace {
+/// @brief Merge two adjacent entries of the same level
+WaveformPyramid::Entry
+Merge(const WaveformPyramid::Entry& aFirst, const WaveformPyramid::Entry& aSecond)
+{
+    return { .min = std::min(aFirst.min, aSecond.min),
+             .max = std::max(aFirst.max, aSecond.max),
+             .mean_square = 0.5f * (aFirst.mean_square + aSecond.mean_square) };
+}
+} // namespace
+
+size_t
+WaveformPyramid::GetLevelFor(size_t aSampleCount)
+{
+    if (aSampleCount < KBaseGroupSamples) {
+        return KLevelCount;
+    }
+    const auto kLevel = static_cast<size_t>(std::bit_width(aSampleCount / KBaseGroupSamples)) - 1;
+    return std::min(kLevel, KLevelCount - 1);
+}
+
+void
+WaveformPyramid::Add(std::span<const float> aSamples)
+{
+    while (!aSamples.empty()) {
+        const size_t kCount = std::min(aSamples.size(), KBaseGroupSamples - mPartialCount);
+        float low = mPartialCount == 0 ? aSamples.front() : mPartialMin;
+        float high = mPartialCount == 0 ? aSamples.front() : mPartialMax;
+        double sumOfSquares = 0.0;
+        for (const float kSample : aSamples.first(kCount)) {
+            low = std::min(low, kSample);
+            high = std::max(high, kSample);
+            sumOfSquares += static_cast<double>(kSample) * kSample;
+        }
+        aSamples = aSamples.subspan(kCount);
+
+        mPartialMin = low;
+        mPartialMax = high;
+        mPartialSumOfSquares += sumOfSquares;
+        mPartialCount += kCount;
+        if (mPartialCount == KBaseGroupSamples) {
+            Push(0,
+                 { .min = low,
+                   .max = high,
+                   .mean_square = static_cast<float>(mPartialSumOfSquares / KBaseGroupSamples) });
+            mPartialCount = 0;
+            mPartialSumOfSquares = 0.0;
+        }
+    }
+}
+
+void
+WaveformPyramid::Push(size_t aLevel, const Entry& aEntry)
+{
+    Level& level = mLevels[aLevel];
+    const size_t kIndex = level.count.load(std::memory_order_relaxed);
+    Entry* const kChunk = GetWritableChunk(level, kIndex / KChunkEntries);
+    kChunk[kIndex % KChunkEntries] = aEntry;
+
+    // Publish: readers that see the new count also see the entry
+    level.count.store(kIndex + 1, std::memory_order_release);
+
+    if (kIndex % 2 == 1 && aLevel + 1 < KLevelCount) {
+        Push(aLevel + 1, Merge(kChunk[(kIndex - 1) % KChunkEntries], aEntry));
+    }
+}
+
+void
+WaveformPyramid::Reserve(size_t aSampleCount)
+{
+    for (size_t level = 0; level < KLevelCount; level++) {
+        const size_t kEntries = aSampleCount / GetGroupSamples(level);
+        const size_t kChunks = (kEntries + KChunkEntries - 1) / KChunkEntries;
+        for (size_t chunk = 0; chunk < kChunks; chunk++) {
+            (void)GetWritableChunk(mLevels[level], chunk);
+        }
+    }
+}
+
+WaveformPyramid::Entry*
+WaveformPyramid::GetWritableChunk(Level& aLevel, size_t aChunk)
+{
+    if (aChunk < aLevel.chunks.size() && aLevel.chunks[aChunk] != nullptr) {
+        return aLevel.chunks[aChunk].get();
+    }
+
+    if (aLevel.chunks.size() <= aChunk) {
+        aLevel.chunks.resize(aChunk + 1);
+    }
+    aLevel.chunks[aChunk] = std::make_unique_for_overwrite<Entry[]>(KChunkEntries);
+    const size_t kDirectoryBytes = aLevel.directory.Set(aChunk, aLevel.chunks[aChunk].get());
+    mMemoryBytes.fetch_add(kDirectoryBytes + (KChunkEntries * sizeof(Entry)),
+                           std::memory_order_relaxed);
+    return aLevel.chunks[aChunk].get();
+}
+
+const WaveformPyramid::Entry&
+WaveformPyramid::GetEntry(size_t aLevel, size_t aIndex) const
+{
+    // The caller's acquire load of the count published the chunk
+    return mLevels[aLevel].directory.Get(aIndex / KChunkEntries)[aIndex % KChunkEntries];
+}
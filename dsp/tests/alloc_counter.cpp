@@ -0,0 +1,219 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+
+namespace {
+
+std::atomic<size_t> gActiveCounters{ 0 };
+std::atomic<size_t> gAllocationCount{ 0 };
+std::atomic<size_t> gAllocationBytes{ 0 };
+
+void
+Count(size_t aSize) noexcept
+{
+    if (gActiveCounters.load(std::memory_order_relaxed) != 0) {
+        gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        gAllocationBytes.fetch_add(aSize, std::memory_order_relaxed);
+    }
+}
+
+void*
+Allocate(size_t aSize) noexcept
+{
+    Count(aSize);
+    // malloc(0) may return nullptr, but operator new must not
+    return std::malloc(aSize == 0 ? 1 : aSize);
+}
+
+void*
+AllocateAligned(size_t aSize, std::align_val_t aAlignment) noexcept
+{
+    Count(aSize);
+    const auto kAlignment = static_cast<size_t>(aAlignment);
+    // aligned_alloc needs the size to be a multiple of the alignment
+    const size_t kRounded = ((aSize + kAlignment - 1) / kAlignment) * kAlignment;
+    return std::aligned_alloc(kAlignment, kRounded == 0 ? kAlignment : kRounded);
+}
+
+void*
+AllocateOrThrow(size_t aSize)
+{
+    void* ptr = Allocate(aSize);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void*
+AllocateAlignedOrThrow(size_t aSize, std::align_val_t aAlignment)
+{
+    void* ptr = AllocateAligned(aSize, aAlignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace
+
+AllocCounter::AllocCounter() noexcept
+  : mStartCount(gAllocationCount.load(std::memory_order_relaxed))
+  , mStartBytes(gAllocationBytes.load(std::memory_order_relaxed))
+{
+    gActiveCounters.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocCounter::~AllocCounter()
+{
+    gActiveCounters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t
+AllocCounter::GetCount() const noexcept
+{
+    return gAllocationCount.load(std::memory_order_relaxed) - mStartCount;
+}
+
+size_t
+AllocCounter::GetBytes() const noexcept
+{
+    return gAllocationBytes.load(std::memory_order_relaxed) - mStartBytes;
+}
+
+// Replacements for every form of the global allocation functions.  All of
+// them have to be replaced together so that each delete matches its new.
+
+void*
+operator new(size_t aSize)
+{
+    return AllocateOrThrow(aSize);
+}
+
+void*
+operator new[](size_t aSize)
+{
+    return AllocateOrThrow(aSize);
+}
+
+void*
+operator new(size_t aSize, const std::nothrow_t& /*aTag*/) noexcept
+{
+    return Allocate(aSize);
+}
+
+void*
+operator new[](size_t aSize, const std::nothrow_t& /*aTag*/) noexcept
+{
+    return Allocate(aSize);
+}
+
+void*
+operator new(size_t aSize, std::align_val_t aAlignment)
+{
+    return AllocateAlignedOrThrow(aSize, aAlignment);
+}
+
+void*
+operator new[](size_t aSize, std::align_val_t aAlignment)
+{
+    return AllocateAlignedOrThrow(aSize, aAlignment);
+}
+
+void*
+operator new(size_t aSize, std::align_val_t aAlignment, const std::nothrow_t& /*aTag*/) noexcept
+{
+    return AllocateAligned(aSize, aAlignment);
+}
+
+void*
+operator new[](size_t aSize, std::align_val_t aAlignment, const std::nothrow_t& /*aTag*/) noexcept
+{
+    return AllocateAligned(aSize, aAlignment);
+}
+
+void
+operator delete(void* aPtr) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete(void* aPtr, size_t /*aSize*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr, size_t /*aSize*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete(void* aPtr, const std::nothrow_t& /*aTag*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr, const std::nothrow_t& /*aTag*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete(void* aPtr, std::align_val_t /*aAlignment*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr, std::align_val_t /*aAlignment*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete(void* aPtr, size_t /*aSize*/, std::align_val_t /*aAlignment*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr, size_t /*aSize*/, std::align_val_t /*aAlignment*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete(void* aPtr,
+                std::align_val_t /*aAlignment*/,
+                const std::nothrow_t& /*aTag*/) noexcept
+{
+    std::free(aPtr);
+}
+
+void
+operator delete[](void* aPtr,
+                  std::align_val_t /*aAlignment*/,
+                  const std::nothrow_t& /*aTag*/) noexcept
+{
+    std::free(aPtr);
+}
+
+// NOLINTEND(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
@@ -0,0 +1,43 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+
+/// @brief Counts heap allocations while in scope
+///
+/// alloc_counter.cpp replaces the global operator new and delete with versions
+/// that count calls while any AllocCounter is alive, so linking it into a test
+/// executable is what enables counting.  Allocations on every thread are
+/// counted, including workers started by the code under test.  Use it to pin
+/// down hot paths that must not allocate once warmed up:
+///
+///     Warm();
+///     const AllocCounter kCounter;
+///     HotPath();
+///     REQUIRE(kCounter.GetCount() == 0);
+///
+/// Only operator new is counted.  Direct malloc calls, such as fftwf_malloc,
+/// are not.
+class AllocCounter
+{
+  public:
+    AllocCounter() noexcept;
+    ~AllocCounter();
+
+    AllocCounter(const AllocCounter&) = delete;
+    AllocCounter& operator=(const AllocCounter&) = delete;
+    AllocCounter(AllocCounter&&) = delete;
+    AllocCounter& operator=(AllocCounter&&) = delete;
+
+    /// @brief Get the number of allocations since construction
+    [[nodiscard]] size_t GetCount() const noexcept;
+
+    /// @brief Get the number of bytes allocated since construction
+    [[nodiscard]] size_t GetBytes() const noexcept;
+
+  private:
+    size_t mStartCount;
+    size_t mStartBytes;
+};
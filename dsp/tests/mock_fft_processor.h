@@ -72,6 +72,24 @@ class MockFFTProcessor : public IFFTProcessor
         return ComputeMagnitudes(aInputSamples);
     }
 
+    void ComputeDecibels(const std::span<const float>& aInputSamples,
+                         std::span<float> aDecibels) const override
+    {
+        if (aInputSamples.size() != mTransformSize ||
+            aDecibels.size() != (mTransformSize / 2) + 1) {
+            throw std::invalid_argument("Input or output size does not match transform size");
+        }
+        std::copy_n(aInputSamples.begin(), aDecibels.size(), aDecibels.begin());
+    }
+
+    void ComputePowers(const std::span<const float>& aInputSamples,
+                       std::span<float> aPowers) const override
+    {
+        ComputeDecibels(aInputSamples, aPowers);
+    }
+
+    [[nodiscard]] size_t GetMemoryBytes() const noexcept override { return 0; }
+
     /// @brief Get factory function for creating IFFTProcessor instances
     /// @return Factory function
     [[nodiscard]] static IFFTProcessor::Factory GetFactory()
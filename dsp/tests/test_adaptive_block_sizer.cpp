@@ -0,0 +1,121 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <adaptive_block_sizer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <stdexcept>
+
+namespace {
+
+/// @brief Feed callbacks at a fixed cadence with a fixed fill
+/// @return Whether any callback changed the size
+bool
+Run(AdaptiveBlockSizer& aSizer,
+    int64_t& aNowNs,
+    int64_t aDurationNs,
+    int64_t aPeriodNs,
+    double aFill)
+{
+    bool changed = false;
+    for (const int64_t kEnd = aNowNs + aDurationNs; aNowNs < kEnd; aNowNs += aPeriodNs) {
+        const auto kQueued =
+          static_cast<size_t>(aFill * static_cast<double>(aSizer.GetBufferBytes()));
+        changed = aSizer.OnCallback(aNowNs, kQueued) || changed;
+    }
+    return changed;
+}
+
+} // namespace
+
+TEST_CASE("AdaptiveBlockSizer", "[adaptive_block_sizer]")
+{
+    constexpr int64_t kMillisecond = 1'000'000;
+    int64_t now = 0;
+
+    SECTION("Starting size scales with the format")
+    {
+        const AdaptiveBlockSizer kLow(8000, 4);
+        const AdaptiveBlockSizer kHigh(384000, 32);
+        REQUIRE(kLow.GetBufferFrames() == 40);  // 5 ms
+        REQUIRE(kHigh.GetBufferFrames() == 1920);
+        REQUIRE(kHigh.GetBufferBytes() == 1920 * 32);
+        REQUIRE_THROWS_AS(AdaptiveBlockSizer(0, 4), std::invalid_argument);
+        REQUIRE_THROWS_AS(AdaptiveBlockSizer(48000, 0), std::invalid_argument);
+    }
+
+    SECTION("A full buffer doubles the size at once")
+    {
+        AdaptiveBlockSizer sizer(48000, 8);
+        const size_t kBefore = sizer.GetBufferFrames();
+        REQUIRE(sizer.OnCallback(0, sizer.GetBufferBytes()));
+        REQUIRE(sizer.GetBufferFrames() == 2 * kBefore);
+    }
+
+    SECTION("Growth stops at the largest period")
+    {
+        AdaptiveBlockSizer sizer(48000, 8);
+        for (int i = 0; i < 20; i++) {
+            (void)sizer.OnCallback(i, sizer.GetBufferBytes());
+        }
+        REQUIRE(sizer.GetBufferFrames() == 48000 / 5); // 200 ms
+    }
+
+    SECTION("Plenty of headroom shrinks slowly, down to the callback gap")
+    {
+        AdaptiveBlockSizer sizer(48000, 8);
+        const size_t kBefore = sizer.GetBufferFrames();
+
+        // Not before enough clean windows have passed
+        const int64_t kStable =
+          AdaptiveBlockSizer::KWindowNs * (AdaptiveBlockSizer::KStableWindowsBeforeShrink - 1);
+        REQUIRE_FALSE(Run(sizer, now, kStable, kMillisecond, 0.25));
+        REQUIRE(sizer.GetBufferFrames() == kBefore);
+
+        REQUIRE(Run(sizer, now, 2 * AdaptiveBlockSizer::KWindowNs, kMillisecond, 0.25));
+        REQUIRE(sizer.GetBufferFrames() == kBefore - (kBefore / 4));
+
+        // Callbacks every 4 ms hold it at 5 ms: 1.25 times the gap
+        AdaptiveBlockSizer gapped(48000, 8);
+        REQUIRE_FALSE(
+          Run(gapped, now, 100 * AdaptiveBlockSizer::KWindowNs, 4 * kMillisecond, 0.25));
+        REQUIRE(gapped.GetBufferFrames() == 240);
+    }
+
+    SECTION("Moderate fill neither grows nor shrinks")
+    {
+        AdaptiveBlockSizer sizer(48000, 8);
+        const size_t kBefore = sizer.GetBufferFrames();
+        REQUIRE_FALSE(Run(sizer, now, 20 * AdaptiveBlockSizer::KWindowNs, kMillisecond, 0.6));
+        REQUIRE(sizer.GetBufferFrames() == kBefore);
+    }
+
+    SECTION("Shrinking stops at half the render time")
+    {
+        Metrics::Histogram renderTimes;
+        for (int i = 0; i < 100; i++) {
+            renderTimes.Record(16 * kMillisecond);
+        }
+        AdaptiveBlockSizer sizer(48000, 8, &renderTimes);
+        // Grow to 20 ms, then let it settle
+        (void)sizer.OnCallback(now, sizer.GetBufferBytes());
+        (void)sizer.OnCallback(now + 1, sizer.GetBufferBytes());
+        REQUIRE(sizer.GetBufferFrames() == 960);
+        now += 2;
+        (void)Run(sizer, now, 100 * AdaptiveBlockSizer::KWindowNs, kMillisecond, 0.1);
+
+        // About 8 ms, within the histogram's bucket accuracy
+        REQUIRE(sizer.GetBufferFrames() >= 300);
+        REQUIRE(sizer.GetBufferFrames() <= 480);
+    }
+
+    SECTION("Never below the smallest period")
+    {
+        AdaptiveBlockSizer sizer(48000, 8);
+        (void)Run(sizer, now, 200 * AdaptiveBlockSizer::KWindowNs, kMillisecond / 4, 0.1);
+        REQUIRE(sizer.GetBufferFrames() == 48); // 1 ms
+    }
+}
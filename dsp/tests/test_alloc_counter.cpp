@@ -0,0 +1,80 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+TEST_CASE("AllocCounter", "[alloc_counter]")
+{
+    SECTION("Counts allocations made while in scope")
+    {
+        // Read the counts before REQUIRE, which may allocate itself
+        const AllocCounter kCounter;
+        const auto kInts = std::make_unique<int[]>(100); // NOLINT(modernize-avoid-c-arrays)
+        const size_t kCount = kCounter.GetCount();
+        const size_t kBytes = kCounter.GetBytes();
+        REQUIRE(kCount == 1);
+        REQUIRE(kBytes >= 100 * sizeof(int));
+    }
+
+    SECTION("Does not count allocations made before construction")
+    {
+        std::vector<int> values(100);
+        const AllocCounter kCounter;
+        values.assign(50, 1); // Fits in the existing capacity
+        const size_t kCount = kCounter.GetCount();
+        REQUIRE(kCount == 0);
+    }
+
+    SECTION("Counts every form of operator new")
+    {
+        // Call the allocation functions directly: new-expressions whose
+        // result is unused may be optimized away
+        constexpr size_t kSize = 64;
+        constexpr std::align_val_t kAlignment{ 64 };
+        const AllocCounter kCounter;
+        ::operator delete(::operator new(kSize));
+        ::operator delete[](::operator new[](kSize));
+        ::operator delete(::operator new(kSize, std::nothrow), std::nothrow);
+        void* aligned = ::operator new(kSize, kAlignment);
+        const auto kAddress = reinterpret_cast<uintptr_t>(aligned);
+        ::operator delete(aligned, kAlignment);
+        const size_t kCount = kCounter.GetCount();
+        REQUIRE(kCount == 4);
+        REQUIRE(kAddress % kSize == 0);
+    }
+
+    SECTION("Counts allocations on other threads")
+    {
+        std::thread thread;
+        {
+            const AllocCounter kCounter;
+            thread = std::thread([] { ::operator delete(::operator new(1)); });
+            thread.join();
+            // Starting a thread allocates its state, too
+            const size_t kCount = kCounter.GetCount();
+            REQUIRE(kCount >= 2);
+        }
+    }
+
+    SECTION("Nested counters count independently")
+    {
+        const AllocCounter kOuter;
+        ::operator delete(::operator new(1));
+        {
+            const AllocCounter kInner;
+            ::operator delete(::operator new(1));
+            const size_t kInnerCount = kInner.GetCount();
+            REQUIRE(kInnerCount == 1);
+        }
+        const size_t kOuterCount = kOuter.GetCount();
+        REQUIRE(kOuterCount >= 2);
+    }
+}
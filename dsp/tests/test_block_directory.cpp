@@ -0,0 +1,64 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "block_directory.h"
+#include <array>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+TEST_CASE("BlockDirectory set and get", "[block_directory]")
+{
+    constexpr size_t kCapacity = BlockDirectory<int>::KInitialCapacity;
+    std::vector<int> blocks(100);
+    BlockDirectory<int> directory;
+
+    SECTION("The first block allocates the initial directory")
+    {
+        REQUIRE(directory.Set(0, &blocks[0]) == kCapacity * sizeof(const int*));
+        REQUIRE(directory.Get(0) == &blocks[0]);
+        REQUIRE(directory.Set(kCapacity - 1, &blocks[1]) == 0);
+        REQUIRE(directory.Get(kCapacity - 1) == &blocks[1]);
+    }
+
+    SECTION("Growing doubles the directory and keeps its blocks")
+    {
+        (void)directory.Set(0, &blocks[0]);
+        REQUIRE(directory.Set(kCapacity, &blocks[1]) == 2 * kCapacity * sizeof(const int*));
+        REQUIRE(directory.Get(0) == &blocks[0]);
+        REQUIRE(directory.Get(kCapacity) == &blocks[1]);
+    }
+
+    SECTION("Growing past double fits the block")
+    {
+        REQUIRE(directory.Set(99, &blocks[99]) == 100 * sizeof(const int*));
+        REQUIRE(directory.Get(99) == &blocks[99]);
+    }
+}
+
+TEST_CASE("BlockDirectory readers see published blocks while it grows", "[block_directory]")
+{
+    constexpr size_t kBlocks = 4096;
+    std::vector<std::array<size_t, 1>> blocks(kBlocks);
+    BlockDirectory<std::array<size_t, 1>> directory;
+    std::atomic<size_t> published{ 0 };
+
+    std::jthread reader([&] {
+        size_t checked = 0;
+        while (checked < kBlocks) {
+            const size_t kPublished = published.load(std::memory_order_acquire);
+            for (; checked < kPublished; checked++) {
+                REQUIRE((*directory.Get(checked))[0] == checked);
+            }
+        }
+    });
+
+    for (size_t i = 0; i < kBlocks; i++) {
+        blocks[i][0] = i;
+        (void)directory.Set(i, &blocks[i]);
+        published.store(i + 1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,121 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <audio_types.h>
+#include <block_summary_index.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <sample_source.h>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr FFTSize KBlockFrames = 256;
+constexpr SampleRate KSampleRate = 8000;
+
+/// @brief Growable mono ISampleSource
+class GrowingSampleSource : public ISampleSource
+{
+  public:
+    [[nodiscard]] ChannelCount GetChannelCount() const override { return 1; }
+    [[nodiscard]] SampleRate GetSampleRate() const override { return KSampleRate; }
+    [[nodiscard]] FrameCount GetFrameCount() const override
+    {
+        return FrameCount{ mSamples.size() };
+    }
+    [[nodiscard]] std::span<const float> GetSamples(ChannelCount /*aChannelIndex*/,
+                                                    SampleIndex aStartSample,
+                                                    SampleCount aSampleCount) const override
+    {
+        mReads += aSampleCount.Get();
+        return std::span(mSamples).subspan(aStartSample.Get(), aSampleCount.Get());
+    }
+
+    /// @brief Append aFrames of a sine, or of silence if aAmplitude is 0
+    void AddSine(size_t aFrames, double aHz, double aAmplitude)
+    {
+        for (size_t i = 0; i < aFrames; i++) {
+            const double kPhase =
+              2.0 * std::numbers::pi * aHz * static_cast<double>(i) / KSampleRate;
+            mSamples.push_back(static_cast<float>(aAmplitude * std::sin(kPhase)));
+        }
+    }
+
+    [[nodiscard]] size_t GetReads() const { return mReads; }
+
+  private:
+    std::vector<float> mSamples;
+    mutable size_t mReads = 0;
+};
+
+} // namespace
+
+TEST_CASE("BlockSummaryIndex", "[block_summary_index]")
+{
+    GrowingSampleSource source;
+    BlockSummaryIndex index(KBlockFrames);
+
+    SECTION("Band centres are a third of an octave apart from 1 kHz")
+    {
+        REQUIRE(std::abs(BlockSummaryIndex::GetBandCenterHz(0) - 19.69f) < 0.01f);
+        REQUIRE(BlockSummaryIndex::GetBandCenterHz(17) == 1000.0f);
+        REQUIRE(std::abs(BlockSummaryIndex::GetBandCenterHz(20) - 2000.0f) < 0.01f);
+    }
+
+    SECTION("Levels are relative to full scale")
+    {
+        // 1 kHz falls exactly on bin 32
+        source.AddSine(KBlockFrames, 1000.0, 1.0);
+        index.Update(source);
+        REQUIRE(index.GetBlockCount() == 1);
+        const BlockSummaryIndex::Summary& kSummary = index.GetSummary(0);
+        REQUIRE(kSummary.rms == -3);
+        REQUIRE(kSummary.peak == 0);
+        REQUIRE(kSummary.bands[17] == -3);
+        REQUIRE(kSummary.bands[11] < -60);
+        REQUIRE(kSummary.bands[30] == BlockSummaryIndex::KFloorDecibels); // Above Nyquist
+    }
+
+    SECTION("Blocks are summarized once, as they complete")
+    {
+        source.AddSine(KBlockFrames + 10, 1000.0, 0.5);
+        index.Update(source);
+        REQUIRE(index.GetBlockCount() == 1);
+        REQUIRE(source.GetReads() == KBlockFrames);
+
+        source.AddSine(KBlockFrames - 10, 1000.0, 0.5);
+        index.Update(source);
+        index.Update(source);
+        REQUIRE(index.GetBlockCount() == 2);
+        REQUIRE(source.GetReads() == 2 * KBlockFrames);
+
+        index.Reset();
+        REQUIRE(index.GetBlockCount() == 0);
+    }
+
+    SECTION("Queries return the matching stretches in milliseconds")
+    {
+        // Blocks are 32 ms: quiet, two loud at 2.5 kHz, quiet, loud at 250 Hz
+        source.AddSine(KBlockFrames, 2500.0, 0.001);
+        source.AddSine(2 * KBlockFrames, 2500.0, 0.5);
+        source.AddSine(KBlockFrames, 0.0, 0.0);
+        source.AddSine(KBlockFrames, 250.0, 0.5);
+        index.Update(source);
+        REQUIRE(index.GetBlockCount() == 5);
+
+        using Ranges = std::vector<BlockSummaryIndex::TimeRange>;
+        REQUIRE(index.FindBandPowerAbove(2000.0f, 4000.0f, -20.0f) == Ranges{ { 32, 96 } });
+        REQUIRE(index.FindBandPowerAbove(200.0f, 300.0f, -20.0f) == Ranges{ { 128, 160 } });
+        REQUIRE(index.FindRmsAbove(-20.0f) == Ranges{ { 32, 96 }, { 128, 160 } });
+        REQUIRE(index.FindRmsAbove(10.0f).empty());
+        REQUIRE(index.GetSummary(3).rms == BlockSummaryIndex::KFloorDecibels);
+        REQUIRE_THROWS_AS((void)index.FindBandPowerAbove(1010.0f, 1020.0f, 0.0f),
+                          std::invalid_argument);
+    }
+}
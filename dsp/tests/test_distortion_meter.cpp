@@ -0,0 +1,175 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <distortion_meter.h>
+#include <initializer_list>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinAbs;
+
+constexpr int KSampleRate = 48000;
+constexpr size_t KBlockFrames = DistortionMeter::KDefaultBlockFrames;
+
+/// @brief Add a sine and its harmonics to a signal
+/// @param aSignal Samples to add to
+/// @param aHz Fundamental frequency
+/// @param aAmplitude Fundamental amplitude
+/// @param aHarmonics Harmonic number and level relative to the fundamental, in dB
+void
+AddTone(std::vector<float>& aSignal,
+        double aHz,
+        double aAmplitude,
+        std::initializer_list<std::pair<int, double>> aHarmonics = {})
+{
+    for (size_t i = 0; i < aSignal.size(); i++) {
+        const double kPhase = 2.0 * std::numbers::pi * aHz * static_cast<double>(i) / KSampleRate;
+        double sample = aAmplitude * std::sin(kPhase);
+        for (const auto& [kHarmonic, kDecibels] : aHarmonics) {
+            sample += aAmplitude * std::pow(10.0, kDecibels / 20.0) * std::sin(kHarmonic * kPhase);
+        }
+        aSignal[i] += static_cast<float>(sample);
+    }
+}
+
+/// @brief Add white Gaussian noise to a signal
+void
+AddNoise(std::vector<float>& aSignal, double aRms)
+{
+    std::mt19937 generator(1234);
+    std::normal_distribution<double> distribution(0.0, aRms);
+    for (float& sample : aSignal) {
+        sample += static_cast<float>(distribution(generator));
+    }
+}
+
+} // namespace
+
+TEST_CASE("DistortionMeter::Measure", "[distortion_meter]")
+{
+    DistortionMeter meter(KSampleRate);
+    std::vector<float> signal(KBlockFrames, 0.0f);
+
+    SECTION("a pure tone between bins")
+    {
+        AddTone(signal, 997.0, 1.0);
+        const DistortionMeter::Measurement kResult = meter.Measure(signal);
+        CHECK_THAT(kResult.fundamental_hz, WithinAbs(997.0, 0.5));
+        CHECK_THAT(kResult.fundamental_decibels, WithinAbs(-3.01, 0.01));
+        CHECK(kResult.harmonic_count == 9);
+        CHECK(kResult.thd_decibels < -110.0f);
+        CHECK(kResult.snr_decibels > 110.0f);
+    }
+
+    SECTION("harmonic distortion")
+    {
+        // 0.1% second and 0.0316% third harmonic: THD -59.59 dB
+        AddTone(signal, 1000.0, 0.5, { { 2, -60.0 }, { 3, -70.0 } });
+        const DistortionMeter::Measurement kResult = meter.Measure(signal);
+        CHECK_THAT(kResult.fundamental_decibels, WithinAbs(-9.03, 0.01));
+        CHECK_THAT(kResult.thd_decibels, WithinAbs(-59.59, 0.05));
+        CHECK_THAT(kResult.thd_n_decibels, WithinAbs(-59.59, 0.05));
+        CHECK_THAT(kResult.sinad_decibels, WithinAbs(59.59, 0.05));
+        CHECK(kResult.snr_decibels > 110.0f);
+    }
+
+    SECTION("noise")
+    {
+        // Over the full band, 60 dB below the fundamental's -3 dB
+        DistortionMeter fullBand(KSampleRate, { .bandwidth_hz = KSampleRate / 2.0f });
+        AddTone(signal, 1000.0, 1.0, { { 3, -50.0 } });
+        AddNoise(signal, std::pow(10.0, -63.0 / 20.0));
+        const DistortionMeter::Measurement kResult = fullBand.Measure(signal);
+        CHECK_THAT(kResult.snr_decibels, WithinAbs(60.0, 0.5));
+        CHECK_THAT(kResult.thd_decibels, WithinAbs(-50.0, 0.5));
+        // -50 dB and -60 dB together
+        CHECK_THAT(kResult.thd_n_decibels, WithinAbs(-49.59, 0.5));
+        CHECK(kResult.sinad_decibels == -kResult.thd_n_decibels);
+    }
+
+    SECTION("harmonics above the bandwidth are left out")
+    {
+        AddTone(signal, 8000.0, 1.0, { { 2, -40.0 }, { 3, -20.0 } });
+        const DistortionMeter::Measurement kResult = meter.Measure(signal);
+        CHECK(kResult.harmonic_count == 1);
+        CHECK_THAT(kResult.thd_decibels, WithinAbs(-40.0, 0.05));
+    }
+
+    SECTION("silence")
+    {
+        const DistortionMeter::Measurement kResult = meter.Measure(signal);
+        CHECK(kResult.fundamental_hz == 0.0f);
+        CHECK(std::isnan(kResult.fundamental_decibels));
+        CHECK(std::isnan(kResult.thd_n_decibels));
+    }
+
+    SECTION("blocks of the wrong size")
+    {
+        signal.pop_back();
+        CHECK_THROWS_AS(meter.Measure(signal), std::invalid_argument);
+    }
+}
+
+TEST_CASE("DistortionMeter::MeasureBlocks", "[distortion_meter]")
+{
+    // A stepped sweep, one tone per block, and part of a block
+    const std::vector<double> kTones = { 100.0, 440.0, 1000.0, 2500.0, 6000.0, 12000.0 };
+    std::vector<float> signal;
+    for (const double kHz : kTones) {
+        std::vector<float> block(KBlockFrames, 0.0f);
+        AddTone(block, kHz, 0.5, { { 2, -80.0 } });
+        signal.insert(signal.end(), block.begin(), block.end());
+    }
+    signal.resize(signal.size() + (KBlockFrames / 2), 0.0f);
+
+    const std::vector<DistortionMeter::Measurement> kResults =
+      DistortionMeter::MeasureBlocks(signal, KSampleRate, {}, 4);
+    REQUIRE(kResults.size() == kTones.size());
+    for (size_t i = 0; i < kTones.size(); i++) {
+        CAPTURE(kTones[i]);
+        CHECK_THAT(kResults[i].fundamental_hz, WithinAbs(kTones[i], 0.5));
+        if (kResults[i].harmonic_count > 0) {
+            CHECK_THAT(kResults[i].thd_decibels, WithinAbs(-80.0, 0.2));
+        }
+    }
+    // 24 kHz is past the bandwidth
+    CHECK(kResults.back().harmonic_count == 0);
+
+    // Same as one meter, one block at a time
+    DistortionMeter meter(KSampleRate);
+    const auto kLast = meter.Measure(std::span(signal).subspan(5 * KBlockFrames, KBlockFrames));
+    CHECK(kResults.back().thd_n_decibels == kLast.thd_n_decibels);
+
+    CHECK(DistortionMeter::MeasureBlocks({}, KSampleRate, {}).empty());
+}
+
+TEST_CASE("DistortionMeter config", "[distortion_meter]")
+{
+    CHECK_THROWS_AS(DistortionMeter(0), std::invalid_argument);
+    CHECK_THROWS_AS(DistortionMeter(KSampleRate, { .bandwidth_hz = 0.0f }), std::invalid_argument);
+    CHECK_THROWS_AS(DistortionMeter(KSampleRate, { .block_frames = 8, .bandwidth_hz = 100.0f }),
+                    std::invalid_argument);
+}
+
+TEST_CASE("DistortionMeter zero allocation", "[distortion_meter]")
+{
+    std::vector<float> signal(KBlockFrames, 0.0f);
+    AddTone(signal, 1000.0, 0.5, { { 2, -60.0 } });
+    DistortionMeter meter(KSampleRate);
+    (void)meter.Measure(signal);
+
+    const AllocCounter kCounter;
+    (void)meter.Measure(signal);
+    CHECK(kCounter.GetCount() == 0);
+}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
+#include "alloc_counter.h"
 #include <audio_types.h>
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -13,6 +14,7 @@
 #include <limits>
 #include <numbers>
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -48,6 +50,36 @@ TEST_CASE("FFTProcessor move/copy semantics", "[fft]")
     static_assert(std::is_move_assignable_v<FFTProcessor>);
 }
 
+TEST_CASE("FFTProcessor on several threads", "[fft]")
+{
+    // Planning and destroying plans share FFTW's planner, so processors made
+    // and dropped on concurrent threads must still each give the same result
+    constexpr size_t kThreads = 8;
+    constexpr size_t kRounds = 20;
+    std::vector<float> samples(1024);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<float>(std::sin(0.1 * static_cast<double>(i)));
+    }
+    const std::vector<float> kExpected = FFTProcessor(1024).ComputeDecibels(samples);
+
+    std::vector<int> matches(kThreads);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < kThreads; t++) {
+            threads.emplace_back([&, t] {
+                for (size_t round = 0; round < kRounds; round++) {
+                    const FFTProcessor kProcessor(FFTSize{ 256U << (round % 4) });
+                    const FFTProcessor kSame(1024);
+                    matches[t] += kSame.ComputeDecibels(samples) == kExpected ? 1 : 0;
+                }
+            });
+        }
+    }
+    for (const int kMatches : matches) {
+        CHECK(kMatches == static_cast<int>(kRounds));
+    }
+}
+
 TEST_CASE("FFTProcessor#ComputeComplex", "[fft]")
 {
     const FFTSize kTransformSize = 8; // Small for testing
@@ -165,4 +197,48 @@ TEST_CASE("FFTProcessor#ComputeDecibels", "[fft]")
         REQUIRE(spectrum[3] < -100.0f); // No bin 3 component
         REQUIRE(spectrum[4] < -100.0f); // No Nyquist component
     }
-}
\ No newline at end of file
+
+    SECTION("Writing to a caller buffer matches and does not allocate", "[fft]")
+    {
+        std::vector<float> samples(kTransformSize);
+        for (size_t i = 0; i < kTransformSize; ++i) {
+            samples[i] = static_cast<float>(i % 3);
+        }
+        std::vector<float> decibels((kTransformSize / 2) + 1);
+
+        const AllocCounter kCounter;
+        kProcessor.ComputeDecibels(samples, decibels);
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 0);
+        REQUIRE(decibels == kProcessor.ComputeDecibels(samples));
+
+        std::vector<float> shortOutput(kTransformSize / 2);
+        REQUIRE_THROWS_AS(kProcessor.ComputeDecibels(samples, shortOutput),
+                          std::invalid_argument);
+    }
+}
+
+TEST_CASE("FFTProcessor#ComputePowers", "[fft]")
+{
+    const FFTSize kTransformSize = 8;
+    FFTProcessor const kProcessor(kTransformSize);
+    std::vector<float> samples(kTransformSize);
+    for (size_t i = 0; i < kTransformSize; ++i) {
+        samples[i] = static_cast<float>(i % 3);
+    }
+    std::vector<float> powers((kTransformSize / 2) + 1);
+
+    const AllocCounter kCounter;
+    kProcessor.ComputePowers(samples, powers);
+    const size_t kAllocations = kCounter.GetCount();
+    REQUIRE(kAllocations == 0);
+
+    // The squares of the magnitudes
+    const std::vector<float> kMagnitudes = kProcessor.ComputeMagnitudes(samples);
+    for (size_t i = 0; i < powers.size(); ++i) {
+        REQUIRE_THAT(powers[i], Catch::Matchers::WithinAbs(kMagnitudes[i] * kMagnitudes[i], 1e-3));
+    }
+
+    std::vector<float> shortOutput(kTransformSize / 2);
+    REQUIRE_THROWS_AS(kProcessor.ComputePowers(samples, shortOutput), std::invalid_argument);
+}
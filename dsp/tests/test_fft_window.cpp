@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
+#include "alloc_counter.h"
 #include <audio_types.h>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
@@ -207,6 +208,22 @@ TEST_CASE("FFTWindow#Apply", "[fft_window]")
 
         REQUIRE_THROWS_AS(kWindow.Apply(input), std::invalid_argument);
     }
+
+    SECTION("Writing to a caller buffer matches and does not allocate")
+    {
+        FFTWindow const kWindow(8, FFTWindow::Type::Hann);
+        const std::vector<float> kInput(8, 2.0f);
+        std::vector<float> output(8);
+
+        const AllocCounter kCounter;
+        kWindow.Apply(kInput, output);
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 0);
+        REQUIRE(output == kWindow.Apply(kInput));
+
+        std::vector<float> shortOutput(4);
+        REQUIRE_THROWS_AS(kWindow.Apply(kInput, shortOutput), std::invalid_argument);
+    }
 }
 
 TEST_CASE("FFTWindow reduces spectral leakage", "[fft_window]")
@@ -0,0 +1,81 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <identical_channels.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// @brief Planar block from per-channel values, aFrames copies of each
+std::vector<float>
+Block(const std::vector<float>& aValues, size_t aFrames)
+{
+    std::vector<float> block;
+    for (const float kValue : aValues) {
+        block.insert(block.end(), aFrames, kValue);
+    }
+    return block;
+}
+
+} // namespace
+
+TEST_CASE("IdenticalChannels", "[identical_channels]")
+{
+    IdenticalChannels channels(3);
+
+    SECTION("Channels start distinct")
+    {
+        for (ChannelCount ch = 0; ch < 3; ch++) {
+            REQUIRE(channels.Find(ch, FrameIndex{ 0 }) == ch);
+        }
+        REQUIRE_THROWS_AS((void)channels.Find(3, FrameIndex{ 0 }), std::out_of_range);
+        REQUIRE_THROWS_AS(channels.AddBlock(FrameIndex{ 0 }, Block({ 1, 2 }, 4), 4),
+                          std::invalid_argument);
+    }
+
+    SECTION("Duplicates map to the lowest matching channel")
+    {
+        channels.AddBlock(FrameIndex{ 0 }, Block({ 1, 1, 1 }, 4), 4);
+        REQUIRE(channels.Find(0, FrameIndex{ 0 }) == 0);
+        REQUIRE(channels.Find(1, FrameIndex{ 0 }) == 0);
+        REQUIRE(channels.Find(2, FrameIndex{ 0 }) == 0);
+
+        // The run continues through later matching blocks
+        channels.AddBlock(FrameIndex{ 4 }, Block({ 2, 2, 3 }, 4), 4);
+        REQUIRE(channels.Find(1, FrameIndex{ 0 }) == 0);
+        REQUIRE(channels.Find(2, FrameIndex{ 0 }) == 2);
+    }
+
+    SECTION("A new run covers only the frames since it began")
+    {
+        channels.AddBlock(FrameIndex{ 0 }, Block({ 1, 2, 3 }, 4), 4);
+        channels.AddBlock(FrameIndex{ 4 }, Block({ 1, 2, 2 }, 4), 4);
+        REQUIRE(channels.Find(2, FrameIndex{ 0 }) == 2);
+        REQUIRE(channels.Find(2, FrameIndex{ 3 }) == 2);
+        REQUIRE(channels.Find(2, FrameIndex{ 4 }) == 1);
+
+        // Matching channel 0 as well starts another run
+        channels.AddBlock(FrameIndex{ 8 }, Block({ 5, 5, 5 }, 4), 4);
+        REQUIRE(channels.Find(2, FrameIndex{ 4 }) == 2);
+        REQUIRE(channels.Find(2, FrameIndex{ 8 }) == 0);
+    }
+
+    SECTION("Matches are bit for bit")
+    {
+        channels.AddBlock(FrameIndex{ 0 }, Block({ 0.0f, -0.0f, 0.0f }, 4), 4);
+        REQUIRE(channels.Find(1, FrameIndex{ 0 }) == 1);
+        REQUIRE(channels.Find(2, FrameIndex{ 0 }) == 0);
+    }
+
+    SECTION("Empty blocks change nothing")
+    {
+        channels.AddBlock(FrameIndex{ 0 }, Block({ 1, 1, 1 }, 4), 4);
+        channels.AddBlock(FrameIndex{ 4 }, {}, 0);
+        REQUIRE(channels.Find(2, FrameIndex{ 0 }) == 0);
+    }
+}
@@ -0,0 +1,92 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "latency_probe.h"
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+
+TEST_CASE("LatencyProbe", "[latency_probe]")
+{
+    Metrics::Histogram histogram;
+    LatencyProbe probe(histogram);
+
+    SECTION("Disabled probe records nothing")
+    {
+        probe.TagBlock(FrameCount{ 100 }, 0);
+        probe.MarkComposited(FrameCount{ 100 }, 1000);
+        REQUIRE(probe.GetPendingCount() == 0);
+        REQUIRE(probe.Summarize().count == 0);
+    }
+
+    SECTION("Tags resolve when a paint covers their last frame")
+    {
+        probe.SetEnabled(true);
+        probe.TagBlock(FrameCount{ 100 }, 1000);
+        probe.TagBlock(FrameCount{ 200 }, 2000);
+        probe.TagBlock(FrameCount{ 300 }, 3000);
+
+        // Frame 150 covers only the first block
+        probe.MarkComposited(FrameCount{ 150 }, 5000);
+        REQUIRE(probe.GetPendingCount() == 2);
+        REQUIRE(probe.Summarize().count == 1);
+        REQUIRE(probe.Summarize().max == 4000);
+
+        // A later paint covers the rest
+        probe.MarkComposited(FrameCount{ 300 }, 6000);
+        REQUIRE(probe.GetPendingCount() == 0);
+        const auto kSummary = probe.Summarize();
+        REQUIRE(kSummary.count == 3);
+        REQUIRE(kSummary.max == 4000);
+    }
+
+    SECTION("Only the first paint showing a block counts")
+    {
+        probe.SetEnabled(true);
+        probe.TagBlock(FrameCount{ 100 }, 0);
+        probe.MarkComposited(FrameCount{ 100 }, 10);
+        probe.MarkComposited(FrameCount{ 100 }, 20);
+        REQUIRE(probe.Summarize().count == 1);
+        REQUIRE(probe.Summarize().max == 10);
+    }
+
+    SECTION("Blocks that don't extend the buffer are ignored")
+    {
+        probe.SetEnabled(true);
+        probe.TagBlock(FrameCount{ 100 }, 0);
+        probe.TagBlock(FrameCount{ 100 }, 10);
+        probe.TagBlock(FrameCount{ 50 }, 20);
+        REQUIRE(probe.GetPendingCount() == 1);
+    }
+
+    SECTION("Pending tags are bounded")
+    {
+        probe.SetEnabled(true);
+        for (size_t i = 1; i <= LatencyProbe::KMaxPending + 10; i++) {
+            probe.TagBlock(FrameCount{ i }, static_cast<int64_t>(i));
+        }
+        REQUIRE(probe.GetPendingCount() == LatencyProbe::KMaxPending);
+
+        // The oldest were dropped, so the first resolved tag is number 11
+        probe.MarkComposited(FrameCount{ 11 }, 100);
+        REQUIRE(probe.Summarize().count == 1);
+        REQUIRE(probe.Summarize().max == 89);
+    }
+
+    SECTION("Clear and disable discard pending tags")
+    {
+        probe.SetEnabled(true);
+        probe.TagBlock(FrameCount{ 100 }, 0);
+        probe.Clear();
+        REQUIRE(probe.GetPendingCount() == 0);
+
+        probe.TagBlock(FrameCount{ 100 }, 0);
+        probe.SetEnabled(false);
+        REQUIRE(probe.GetPendingCount() == 0);
+        probe.MarkComposited(FrameCount{ 100 }, 10);
+        REQUIRE(probe.Summarize().count == 0);
+    }
+}
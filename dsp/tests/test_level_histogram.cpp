@@ -0,0 +1,182 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <level_histogram.h>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinAbs;
+
+constexpr float KResolution = LevelHistogram::Config{}.resolution_decibels;
+
+/// @brief A row of levels spread evenly over [aLowest, aLowest + 100)
+std::vector<float>
+MakeRamp(float aLowest)
+{
+    std::vector<float> levels(1000);
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i] = aLowest + (0.1f * static_cast<float>(i));
+    }
+    return levels;
+}
+
+} // namespace
+
+TEST_CASE("LevelHistogram::GetQuantile", "[level_histogram]")
+{
+    LevelHistogram histogram;
+    CHECK(std::isnan(histogram.GetQuantile(0.5)));
+    CHECK_THROWS_AS(histogram.GetQuantile(-0.1), std::invalid_argument);
+    CHECK_THROWS_AS(histogram.GetQuantile(1.1), std::invalid_argument);
+
+    SECTION("levels spread evenly")
+    {
+        histogram.Add(MakeRamp(-50.0f));
+        CHECK(histogram.GetWeight() == 1000.0);
+        CHECK_THAT(histogram.GetQuantile(0.05), WithinAbs(-45.0, KResolution));
+        CHECK_THAT(histogram.GetQuantile(0.5), WithinAbs(0.0, KResolution));
+        CHECK_THAT(histogram.GetQuantile(0.999), WithinAbs(49.9, KResolution));
+        CHECK_THAT(histogram.GetQuantile(0.0), WithinAbs(-50.0, KResolution));
+        CHECK_THAT(histogram.GetQuantile(1.0), WithinAbs(50.0, KResolution));
+    }
+
+    SECTION("a row counts as its levels do")
+    {
+        LevelHistogram byLevel;
+        const std::vector<float> kRamp = MakeRamp(-50.0f);
+        histogram.Add(kRamp);
+        for (const float kLevel : kRamp) {
+            byLevel.Add(kLevel);
+        }
+        for (const double kFraction : { 0.01, 0.3, 0.77, 0.999 }) {
+            CHECK(histogram.GetQuantile(kFraction) == byLevel.GetQuantile(kFraction));
+        }
+    }
+
+    SECTION("weights")
+    {
+        histogram.Add(-60.0f, 3.0);
+        histogram.Add(-20.0f);
+        CHECK(histogram.GetWeight() == 4.0);
+        CHECK_THAT(histogram.GetQuantile(0.7), WithinAbs(-60.0, KResolution));
+        CHECK_THAT(histogram.GetQuantile(0.8), WithinAbs(-20.0, KResolution));
+    }
+
+    SECTION("levels out of range count in the end bins")
+    {
+        const LevelHistogram::Config& kConfig = histogram.GetConfig();
+        histogram.Add(-std::numeric_limits<float>::infinity());
+        histogram.Add(-1000.0f);
+        histogram.Add(1000.0f);
+        histogram.Add(std::numeric_limits<float>::infinity());
+        CHECK(histogram.GetQuantile(0.0) == kConfig.min_decibels);
+        CHECK_THAT(histogram.GetQuantile(0.25), WithinAbs(kConfig.min_decibels, KResolution));
+        CHECK_THAT(histogram.GetQuantile(1.0), WithinAbs(kConfig.max_decibels, KResolution));
+    }
+
+    SECTION("Reset")
+    {
+        histogram.Add(MakeRamp(-50.0f));
+        histogram.Reset();
+        CHECK(histogram.GetWeight() == 0.0);
+        CHECK(std::isnan(histogram.GetQuantile(0.5)));
+        histogram.Add(10.0f);
+        CHECK_THAT(histogram.GetQuantile(0.5), WithinAbs(10.0, KResolution));
+    }
+}
+
+TEST_CASE("LevelHistogram::Age", "[level_histogram]")
+{
+    SECTION("weights halve every half life")
+    {
+        LevelHistogram histogram({ .half_life_rows = 10.0f });
+        histogram.Add(-60.0f);
+        for (size_t row = 0; row < 10; row++) {
+            histogram.Age();
+        }
+        histogram.Add(-20.0f);
+        CHECK_THAT(histogram.GetWeight(), WithinAbs(1.5, 1e-9));
+        CHECK_THAT(histogram.GetQuantile(0.3), WithinAbs(-60.0, KResolution));
+        CHECK_THAT(histogram.GetQuantile(0.4), WithinAbs(-20.0, KResolution));
+    }
+
+    SECTION("never forgetting")
+    {
+        LevelHistogram histogram;
+        histogram.Add(-60.0f);
+        histogram.Age();
+        histogram.Add(-20.0f);
+        CHECK(histogram.GetWeight() == 2.0);
+    }
+
+    SECTION("follows a change of level")
+    {
+        LevelHistogram histogram({ .half_life_rows = 50.0f });
+        std::mt19937 generator(1);
+        std::normal_distribution<float> noise(-60.0f, 5.0f);
+        std::vector<float> row(256);
+        const auto kAddRows = [&](size_t aRows) {
+            for (size_t i = 0; i < aRows; i++) {
+                for (float& level : row) {
+                    level = noise(generator);
+                }
+                histogram.Add(row);
+                histogram.Age();
+            }
+        };
+
+        kAddRows(500);
+        CHECK_THAT(histogram.GetQuantile(0.5), WithinAbs(-60.0, 0.5));
+
+        // Seven half lives leave under 1% of the old weight, too little to
+        // move the new 5th percentile, about -28 dB, much
+        noise = std::normal_distribution<float>(-20.0f, 5.0f);
+        kAddRows(350);
+        CHECK_THAT(histogram.GetQuantile(0.5), WithinAbs(-20.0, 0.5));
+        CHECK(histogram.GetQuantile(0.05) > -30.0f);
+    }
+
+    SECTION("renormalizing keeps the quantiles")
+    {
+        LevelHistogram histogram({ .half_life_rows = 1.0f });
+        for (size_t row = 0; row < 1000; row++) {
+            histogram.Add(MakeRamp(-50.0f));
+            histogram.Age();
+        }
+        // Each row weighs half the one after it, and the last has aged once
+        CHECK_THAT(histogram.GetWeight(), WithinAbs(1000.0, 1e-6));
+        CHECK_THAT(histogram.GetQuantile(0.5), WithinAbs(0.0, KResolution));
+    }
+}
+
+TEST_CASE("LevelHistogram config", "[level_histogram]")
+{
+    CHECK_THROWS_AS(LevelHistogram({ .resolution_decibels = 0.0f }), std::invalid_argument);
+    CHECK_THROWS_AS(LevelHistogram({ .min_decibels = 10.0f, .max_decibels = 10.0f }),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(LevelHistogram({ .half_life_rows = -1.0f }), std::invalid_argument);
+}
+
+TEST_CASE("LevelHistogram zero allocation", "[level_histogram]")
+{
+    LevelHistogram histogram({ .half_life_rows = 100.0f });
+    const std::vector<float> kRamp = MakeRamp(-50.0f);
+
+    const AllocCounter kCounter;
+    for (size_t row = 0; row < 100; row++) {
+        histogram.Add(kRamp);
+        histogram.Age();
+        static_cast<void>(histogram.GetQuantile(0.05));
+    }
+    CHECK(kCounter.GetCount() == 0);
+}
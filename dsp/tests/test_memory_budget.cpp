@@ -0,0 +1,102 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "memory_budget.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <metrics.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief Consumer holding a settable number of bytes, logging releases
+class FakeConsumer : public IMemoryConsumer
+{
+  public:
+    FakeConsumer(std::string aName, size_t aBytes, std::vector<std::string>& aLog)
+      : mName(std::move(aName))
+      , mBytes(aBytes)
+      , mLog(aLog)
+    {
+    }
+
+    [[nodiscard]] size_t GetMemoryBytes() const override { return mBytes; }
+
+    size_t ReleaseMemory(size_t aBytes) override
+    {
+        mLog.push_back(mName);
+        const size_t kFreed = std::min(aBytes, mBytes);
+        mBytes -= kFreed;
+        return kFreed;
+    }
+
+  private:
+    std::string mName;
+    size_t mBytes;
+    std::vector<std::string>& mLog;
+};
+
+} // namespace
+
+TEST_CASE("MemoryBudget", "[memory_budget]")
+{
+    std::vector<std::string> log;
+    FakeConsumer history("history", 1000, log);
+    FakeConsumer rows("rows", 500, log);
+    FakeConsumer image("image", 200, log);
+    MemoryBudget budget;
+    budget.Register("test_history", IMemoryConsumer::Kind::History, history);
+    budget.Register("test_rows", IMemoryConsumer::Kind::Cache, rows);
+    budget.Register("test_image", IMemoryConsumer::Kind::Cache, image);
+
+    SECTION("Totals and usage")
+    {
+        REQUIRE(budget.GetTotalBytes() == 1700);
+        const auto kUsage = budget.GetUsage();
+        REQUIRE(kUsage.size() == 3);
+        REQUIRE(kUsage[0].name == "test_history");
+        REQUIRE(kUsage[0].kind == IMemoryConsumer::Kind::History);
+        REQUIRE(kUsage[1].bytes == 500);
+    }
+
+    SECTION("No limit releases nothing but publishes the totals")
+    {
+        REQUIRE(budget.Enforce() == 0);
+        REQUIRE(log.empty());
+        REQUIRE(Metrics::GetGauge(Metrics::KMemoryTotal).Get() == 1700);
+        REQUIRE(Metrics::GetGauge("memory.test_rows_bytes").Get() == 500);
+    }
+
+    SECTION("Within the limit releases nothing")
+    {
+        budget.SetLimit(2000);
+        REQUIRE(budget.Enforce() == 0);
+        REQUIRE(log.empty());
+    }
+
+    SECTION("Caches are released in order before history")
+    {
+        budget.SetLimit(1100);
+        REQUIRE(budget.Enforce() == 600);
+        REQUIRE(log == std::vector<std::string>{ "rows", "image" });
+        REQUIRE(budget.GetTotalBytes() == 1100);
+
+        budget.SetLimit(800);
+        REQUIRE(budget.Enforce() == 300);
+        REQUIRE(log ==
+                std::vector<std::string>{ "rows", "image", "rows", "image", "history" });
+        REQUIRE(budget.GetTotalBytes() == 800);
+    }
+
+    SECTION("Unregistered consumers are not counted")
+    {
+        budget.Unregister(rows);
+        REQUIRE(budget.GetTotalBytes() == 1200);
+        REQUIRE(Metrics::GetGauge("memory.test_rows_bytes").Get() == 0);
+        budget.Unregister(rows); // No-op
+    }
+}
@@ -0,0 +1,137 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "metrics.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Metrics registry", "[metrics]")
+{
+    SECTION("Lookup by name returns the same metric")
+    {
+        Metrics::Counter& counter = Metrics::GetCounter("test.registry_counter");
+        REQUIRE(&counter == &Metrics::GetCounter("test.registry_counter"));
+        REQUIRE(&Metrics::GetGauge("test.registry_gauge") ==
+                &Metrics::GetGauge("test.registry_gauge"));
+        REQUIRE(&Metrics::GetHistogram("test.registry_histogram") ==
+                &Metrics::GetHistogram("test.registry_histogram"));
+    }
+
+    SECTION("Snapshot copies current values")
+    {
+        Metrics::Counter& counter = Metrics::GetCounter("test.snapshot_counter");
+        Metrics::Gauge& gauge = Metrics::GetGauge("test.snapshot_gauge");
+        const uint64_t kBefore = counter.Get();
+        counter.Add(3);
+        gauge.Set(7);
+        gauge.Add(-2);
+
+        const Metrics::Snapshot kSnapshot = Metrics::TakeSnapshot();
+        REQUIRE(kSnapshot.counters.at("test.snapshot_counter") == kBefore + 3);
+        REQUIRE(kSnapshot.gauges.at("test.snapshot_gauge") == 5);
+    }
+
+    SECTION("Counters are thread safe")
+    {
+        Metrics::Counter& counter = Metrics::GetCounter("test.threaded_counter");
+        const uint64_t kBefore = counter.Get();
+        constexpr size_t kThreads = 4;
+        constexpr size_t kAddsPerThread = 10000;
+        {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0; i < kThreads; i++) {
+                threads.emplace_back([&counter] {
+                    for (size_t j = 0; j < kAddsPerThread; j++) {
+                        counter.Add();
+                    }
+                });
+            }
+        }
+        REQUIRE(counter.Get() == kBefore + (kThreads * kAddsPerThread));
+    }
+}
+
+TEST_CASE("Metrics::Histogram buckets", "[metrics]")
+{
+    using Histogram = Metrics::Histogram;
+
+    // Small values are exact; above that four buckets per power of two
+    REQUIRE(Histogram::BucketIndex(0) == 0);
+    REQUIRE(Histogram::BucketIndex(3) == 3);
+    REQUIRE(Histogram::BucketIndex(4) == 4);
+    REQUIRE(Histogram::BucketIndex(7) == 7);
+    REQUIRE(Histogram::BucketIndex(8) == 8);
+    REQUIRE(Histogram::BucketIndex(9) == 8);
+    REQUIRE(Histogram::BucketIndex(10) == 9);
+    REQUIRE(Histogram::BucketIndex(UINT64_MAX) == Histogram::KBucketCount - 1);
+
+    // Every bucket's lower bound maps back to that bucket, and bounds increase
+    for (size_t i = 0; i < Histogram::KBucketCount; i++) {
+        CAPTURE(i);
+        REQUIRE(Histogram::BucketIndex(Histogram::BucketLowerBound(i)) == i);
+        if (i > 0) {
+            REQUIRE(Histogram::BucketLowerBound(i) > Histogram::BucketLowerBound(i - 1));
+            REQUIRE(Histogram::BucketIndex(Histogram::BucketLowerBound(i) - 1) == i - 1);
+        }
+    }
+}
+
+TEST_CASE("Metrics::Histogram::Summarize", "[metrics]")
+{
+    SECTION("Empty")
+    {
+        const Metrics::Histogram kHistogram;
+        const auto kSummary = kHistogram.Summarize();
+        REQUIRE(kSummary.count == 0);
+        REQUIRE(kSummary.p50 == 0);
+        REQUIRE(kSummary.max == 0);
+    }
+
+    SECTION("Percentiles are within a bucket of the true value")
+    {
+        Metrics::Histogram histogram;
+        for (uint64_t value = 1; value <= 1000; value++) {
+            histogram.Record(value);
+        }
+        const auto kSummary = histogram.Summarize();
+        REQUIRE(kSummary.count == 1000);
+        REQUIRE(kSummary.mean == 500.5);
+        REQUIRE(kSummary.max == 1000);
+        // Buckets are at most 1/4 octave wide, so midpoints are within 12.5%
+        auto near = [](uint64_t aValue, uint64_t aWant) {
+            return aValue * 8 >= aWant * 7 && aValue * 8 <= aWant * 9;
+        };
+        REQUIRE(near(kSummary.p50, 500));
+        REQUIRE(near(kSummary.p90, 900));
+        REQUIRE(near(kSummary.p99, 990));
+    }
+
+    SECTION("Percentiles never exceed the maximum")
+    {
+        Metrics::Histogram histogram;
+        histogram.Record(5);
+        const auto kSummary = histogram.Summarize();
+        REQUIRE(kSummary.p99 == 5);
+        REQUIRE(kSummary.p50 == 5);
+    }
+}
+
+TEST_CASE("Metrics::WriteJson", "[metrics]")
+{
+    Metrics::GetCounter("test.json_counter").Add(2);
+    Metrics::GetHistogram("test.json_histogram").Record(10);
+
+    std::ostringstream stream;
+    Metrics::WriteJson(stream);
+    const std::string kJson = stream.str();
+    REQUIRE(kJson.starts_with("{\n  \"counters\": {"));
+    REQUIRE(kJson.find("\"test.json_counter\": ") != std::string::npos);
+    REQUIRE(kJson.find(R"("test.json_histogram": {"count": )") != std::string::npos);
+    REQUIRE(kJson.ends_with("}\n"));
+}
@@ -0,0 +1,184 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <noise_floor_estimator.h>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinAbs;
+
+constexpr size_t KBins = 256;
+
+/// @brief Rows of white noise: each bin's power is exponentially distributed
+class NoiseRows
+{
+  public:
+    /// @param aDecibels Mean power of every bin
+    explicit NoiseRows(float aDecibels)
+      : mMeanPower(std::pow(10.0f, aDecibels / 10.0f))
+    {
+    }
+
+    /// @brief Get the next row
+    const std::vector<float>& Next()
+    {
+        for (float& level : mRow) {
+            level = 10.0f * std::log10(mMeanPower * mDistribution(mGenerator));
+        }
+        return mRow;
+    }
+
+    void SetDecibels(float aDecibels) { mMeanPower = std::pow(10.0f, aDecibels / 10.0f); }
+
+  private:
+    float mMeanPower;
+    std::mt19937 mGenerator{ 1 };
+    std::exponential_distribution<float> mDistribution{ 1.0f };
+    std::vector<float> mRow = std::vector<float>(KBins);
+};
+
+/// @brief Mean of the floor over the bins
+float
+MeanFloor(const NoiseFloorEstimator& aEstimator)
+{
+    const std::span<const float> kFloor = aEstimator.GetFloor();
+    return std::accumulate(kFloor.begin(), kFloor.end(), 0.0f) / static_cast<float>(kFloor.size());
+}
+
+/// @brief Rows a rise in level takes to reach the floor: the whole window, and
+/// a few more for the smoothing
+size_t
+WindowRows(const NoiseFloorEstimator& aEstimator)
+{
+    const NoiseFloorEstimator::Config& kConfig = aEstimator.GetConfig();
+    return (kConfig.subwindow_rows * (kConfig.subwindow_count + 1)) + 30;
+}
+
+} // namespace
+
+TEST_CASE("NoiseFloorEstimator::Update", "[noise_floor_estimator]")
+{
+    NoiseFloorEstimator estimator;
+    NoiseRows noise(-80.0f);
+    CHECK(estimator.GetFloor().empty());
+
+    SECTION("white noise")
+    {
+        for (size_t row = 0; row < 500; row++) {
+            estimator.Update(noise.Next());
+        }
+        CHECK(estimator.GetRowCount() == 500);
+        REQUIRE(estimator.GetFloor().size() == KBins);
+        CHECK_THAT(MeanFloor(estimator), WithinAbs(-80.0, 1.0));
+        for (const float kLevel : estimator.GetFloor()) {
+            CHECK_THAT(kLevel, WithinAbs(-80.0, 5.0));
+        }
+    }
+
+    SECTION("tones that come and go are not noise")
+    {
+        // Gaps long enough for the smoothed level to settle
+        for (size_t row = 0; row < 500; row++) {
+            std::vector<float> levels = noise.Next();
+            if ((row / 60) % 2 == 0) {
+                for (size_t bin = 64; bin < 192; bin++) {
+                    levels[bin] = -20.0f;
+                }
+            }
+            estimator.Update(levels);
+        }
+        CHECK_THAT(MeanFloor(estimator), WithinAbs(-80.0, 1.0));
+    }
+
+    SECTION("follows the level down and up")
+    {
+        for (size_t row = 0; row < 500; row++) {
+            estimator.Update(noise.Next());
+        }
+
+        // Down as fast as the smoothing allows
+        noise.SetDecibels(-100.0f);
+        for (size_t row = 0; row < 60; row++) {
+            estimator.Update(noise.Next());
+        }
+        CHECK_THAT(MeanFloor(estimator), WithinAbs(-100.0, 2.0));
+
+        // Up once the quieter rows leave the window
+        noise.SetDecibels(-60.0f);
+        for (size_t row = 0; row < WindowRows(estimator); row++) {
+            estimator.Update(noise.Next());
+        }
+        CHECK_THAT(MeanFloor(estimator), WithinAbs(-60.0, 2.0));
+    }
+
+    SECTION("silence")
+    {
+        const std::vector<float> kSilence(KBins, -std::numeric_limits<float>::infinity());
+        estimator.Update(kSilence);
+        CHECK(estimator.GetFloor()[0] ==
+              NoiseFloorEstimator::KMinDecibels + NoiseFloorEstimator::KDefaultBiasDecibels);
+    }
+
+    SECTION("blocks of rows")
+    {
+        NoiseFloorEstimator rowByRow;
+        std::vector<float> block;
+        for (size_t row = 0; row < 100; row++) {
+            const std::vector<float>& kRow = noise.Next();
+            rowByRow.Update(kRow);
+            block.insert(block.end(), kRow.begin(), kRow.end());
+        }
+        estimator.Update(block, KBins);
+        CHECK(estimator.GetRowCount() == 100);
+        CHECK(std::ranges::equal(estimator.GetFloor(), rowByRow.GetFloor()));
+        CHECK_THROWS_AS(estimator.Update(block, KBins + 1), std::invalid_argument);
+        CHECK_THROWS_AS(estimator.Update(block, 0), std::invalid_argument);
+    }
+
+    SECTION("Reset")
+    {
+        estimator.Update(noise.Next());
+        CHECK_THROWS_AS(estimator.Update(std::vector<float>(KBins / 2)), std::invalid_argument);
+
+        estimator.Reset();
+        CHECK(estimator.GetFloor().empty());
+        CHECK(estimator.GetRowCount() == 0);
+        estimator.Update(std::vector<float>(KBins / 2, -50.0f));
+        CHECK(estimator.GetFloor().size() == KBins / 2);
+        CHECK(estimator.GetFloor()[0] == -50.0f + NoiseFloorEstimator::KDefaultBiasDecibels);
+    }
+}
+
+TEST_CASE("NoiseFloorEstimator config", "[noise_floor_estimator]")
+{
+    CHECK_THROWS_AS(NoiseFloorEstimator({ .smoothing = 1.0f }), std::invalid_argument);
+    CHECK_THROWS_AS(NoiseFloorEstimator({ .smoothing = -0.1f }), std::invalid_argument);
+    CHECK_THROWS_AS(NoiseFloorEstimator({ .subwindow_rows = 0 }), std::invalid_argument);
+    CHECK_THROWS_AS(NoiseFloorEstimator({ .subwindow_count = 0 }), std::invalid_argument);
+}
+
+TEST_CASE("NoiseFloorEstimator zero allocation", "[noise_floor_estimator]")
+{
+    NoiseFloorEstimator estimator;
+    NoiseRows noise(-80.0f);
+    estimator.Update(noise.Next());
+
+    const AllocCounter kCounter;
+    for (size_t row = 0; row < 100; row++) {
+        estimator.Update(noise.Next());
+    }
+    CHECK(kCounter.GetCount() == 0);
+}
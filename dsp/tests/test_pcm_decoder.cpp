@@ -0,0 +1,76 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "pcm_decoder.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// @brief Build a byte vector from integer literals
+std::vector<std::byte>
+Bytes(std::initializer_list<uint8_t> aValues)
+{
+    std::vector<std::byte> bytes;
+    for (const uint8_t kValue : aValues) {
+        bytes.push_back(static_cast<std::byte>(kValue));
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST_CASE("PcmDecoder::BytesPerSample", "[pcm_decoder]")
+{
+    REQUIRE(PcmDecoder::BytesPerSample(PcmDecoder::Format::S16) == 2);
+    REQUIRE(PcmDecoder::BytesPerSample(PcmDecoder::Format::S32) == 4);
+    REQUIRE(PcmDecoder::BytesPerSample(PcmDecoder::Format::F32) == 4);
+}
+
+TEST_CASE("PcmDecoder::Decode", "[pcm_decoder]")
+{
+    SECTION("s16")
+    {
+        // 0, 16384, -32768, 32767, little-endian
+        const auto kInput = Bytes({ 0x00, 0x00, 0x00, 0x40, 0x00, 0x80, 0xFF, 0x7F });
+        std::vector<float> output(4);
+        PcmDecoder::Decode(PcmDecoder::Format::S16, kInput, output);
+        REQUIRE(output[0] == 0.0f);
+        REQUIRE(output[1] == 0.5f);
+        REQUIRE(output[2] == -1.0f);
+        REQUIRE(output[3] == 32767.0f / 32768.0f);
+    }
+
+    SECTION("s32")
+    {
+        // 0x40000000, 0x80000000
+        const auto kInput = Bytes({ 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x80 });
+        std::vector<float> output(2);
+        PcmDecoder::Decode(PcmDecoder::Format::S32, kInput, output);
+        REQUIRE(output[0] == 0.5f);
+        REQUIRE(output[1] == -1.0f);
+    }
+
+    SECTION("f32")
+    {
+        // 1.0f = 0x3F800000, -0.25f = 0xBE800000
+        const auto kInput = Bytes({ 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x80, 0xBE });
+        std::vector<float> output(2);
+        PcmDecoder::Decode(PcmDecoder::Format::F32, kInput, output);
+        REQUIRE(output[0] == 1.0f);
+        REQUIRE(output[1] == -0.25f);
+    }
+
+    SECTION("Throws on size mismatch")
+    {
+        const auto kInput = Bytes({ 0x00, 0x00, 0x00 });
+        std::vector<float> output(2);
+        REQUIRE_THROWS_AS(PcmDecoder::Decode(PcmDecoder::Format::S16, kInput, output),
+                          std::invalid_argument);
+    }
+}
@@ -0,0 +1,238 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <peak_tracker.h>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinAbs;
+
+constexpr size_t KBins = 128;
+constexpr float KFloor = -120.0f;
+
+/// @brief Add a parabolic bump to a row, so interpolation is exact
+/// @param aRow Row of decibels
+/// @param aBin Vertex position, in fractional bins
+/// @param aDecibels Vertex level
+void
+AddBump(std::vector<float>& aRow, float aBin, float aDecibels)
+{
+    for (size_t bin = 0; bin < aRow.size(); bin++) {
+        const float kOffset = static_cast<float>(bin) - aBin;
+        aRow[bin] = std::max(aRow[bin], aDecibels - (10.0f * kOffset * kOffset));
+    }
+}
+
+/// @brief A row with bumps at the given positions and levels
+std::vector<float>
+MakeRow(std::initializer_list<PeakTracker::Peak> aBumps)
+{
+    std::vector<float> row(KBins, KFloor);
+    for (const PeakTracker::Peak& kBump : aBumps) {
+        AddBump(row, kBump.bin, kBump.decibels);
+    }
+    return row;
+}
+
+} // namespace
+
+TEST_CASE("PeakTracker::FindPeaks", "[peak_tracker]")
+{
+    PeakTracker tracker;
+
+    SECTION("peaks are interpolated, loudest first")
+    {
+        const std::vector<float> kRow = MakeRow({ { 10.3f, -40.0f }, { 40.75f, -20.0f } });
+        const std::span<const PeakTracker::Peak> kPeaks = tracker.FindPeaks(kRow);
+        REQUIRE(kPeaks.size() == 2);
+        CHECK_THAT(kPeaks[0].bin, WithinAbs(40.75, 1e-3));
+        CHECK_THAT(kPeaks[0].decibels, WithinAbs(-20.0, 1e-3));
+        CHECK_THAT(kPeaks[1].bin, WithinAbs(10.3, 1e-3));
+        CHECK_THAT(kPeaks[1].decibels, WithinAbs(-40.0, 1e-3));
+    }
+
+    SECTION("only the loudest are kept")
+    {
+        PeakTracker limited({ .max_peaks = 3 });
+        std::vector<float> row(KBins, KFloor);
+        for (size_t i = 0; i < 10; i++) {
+            AddBump(row, 5.0f + (10.0f * static_cast<float>(i)), -80.0f + static_cast<float>(i));
+        }
+        const std::span<const PeakTracker::Peak> kPeaks = limited.FindPeaks(row);
+        REQUIRE(kPeaks.size() == 3);
+        CHECK(kPeaks[0].bin == 95.0f);
+        CHECK(kPeaks[1].bin == 85.0f);
+        CHECK(kPeaks[2].bin == 75.0f);
+    }
+
+    SECTION("edges, plateaus and quiet maxima")
+    {
+        std::vector<float> row(KBins, KFloor);
+        row.front() = 0.0f; // Edges are never peaks
+        row.back() = 0.0f;
+        row[20] = -95.0f; // Below the default threshold
+        row[50] = -30.0f; // Plateau: its left edge is the peak
+        row[51] = -30.0f;
+        const std::span<const PeakTracker::Peak> kPeaks = tracker.FindPeaks(row);
+        REQUIRE(kPeaks.size() == 1);
+        CHECK_THAT(kPeaks[0].bin, WithinAbs(50.5, 1e-3));
+    }
+
+    SECTION("rows too short for a peak")
+    {
+        const std::vector<float> kRow{ 0.0f, 1.0f };
+        CHECK(tracker.FindPeaks(kRow).empty());
+        CHECK(tracker.FindPeaks({}).empty());
+    }
+}
+
+TEST_CASE("PeakTracker tracking", "[peak_tracker]")
+{
+    PeakTracker tracker;
+
+    SECTION("a drifting peak is one track")
+    {
+        for (size_t row = 0; row < 20; row++) {
+            tracker.Update(MakeRow({ { 30.0f + (0.5f * static_cast<float>(row)), -30.0f } }));
+        }
+        REQUIRE(tracker.GetTracks().size() == 1);
+        const PeakTracker::Track& kTrack = tracker.GetTracks()[0];
+        CHECK(kTrack.id == 0);
+        CHECK(kTrack.first_row == 0);
+        CHECK(kTrack.last_row == 19);
+        CHECK(kTrack.rows == 20);
+        CHECK_THAT(kTrack.bin, WithinAbs(39.5, 1e-3));
+        CHECK(tracker.GetRowCount() == 20);
+    }
+
+    SECTION("crossing tracks keep their identities where they are apart")
+    {
+        for (size_t row = 0; row < 10; row++) {
+            tracker.Update(MakeRow({ { 20.0f, -30.0f }, { 60.0f, -50.0f } }));
+        }
+        tracker.Update(MakeRow({ { 21.0f, -30.0f }, { 59.0f, -50.0f } }));
+        REQUIRE(tracker.GetTracks().size() == 2);
+        for (const PeakTracker::Track& kTrack : tracker.GetTracks()) {
+            CHECK(kTrack.rows == 11);
+            CHECK_THAT(kTrack.bin, WithinAbs(kTrack.id == 0 ? 21.0 : 59.0, 1e-3));
+        }
+    }
+
+    SECTION("a jump too far starts a new track")
+    {
+        tracker.Update(MakeRow({ { 30.0f, -30.0f } }));
+        tracker.Update(MakeRow({ { 35.0f, -30.0f } }));
+        REQUIRE(tracker.GetTracks().size() == 2);
+        CHECK(tracker.GetTracks()[1].id == 1);
+    }
+
+    SECTION("short gaps are bridged; long ones finish the track")
+    {
+        const std::vector<float> kTone = MakeRow({ { 30.0f, -30.0f } });
+        const std::vector<float> kSilence = MakeRow({});
+        for (size_t row = 0; row < 5; row++) {
+            tracker.Update(kTone);
+        }
+        tracker.Update(kSilence);
+        tracker.Update(kSilence);
+        tracker.Update(kTone);
+        REQUIRE(tracker.GetTracks().size() == 1);
+        CHECK(tracker.GetTracks()[0].rows == 6);
+        CHECK(tracker.GetFinishedTracks().empty());
+
+        for (size_t row = 0; row < 3; row++) {
+            tracker.Update(kSilence);
+        }
+        CHECK(tracker.GetTracks().empty());
+        REQUIRE(tracker.GetFinishedTracks().size() == 1);
+        CHECK(tracker.GetFinishedTracks()[0].first_row == 0);
+        CHECK(tracker.GetFinishedTracks()[0].last_row == 7);
+
+        tracker.ClearFinishedTracks();
+        CHECK(tracker.GetFinishedTracks().empty());
+    }
+
+    SECTION("finished tracks shorter than the minimum are dropped")
+    {
+        tracker.Update(MakeRow({ { 30.0f, -30.0f } }));
+        for (size_t row = 0; row < 5; row++) {
+            tracker.Update(MakeRow({}));
+        }
+        CHECK(tracker.GetTracks().empty());
+        CHECK(tracker.GetFinishedTracks().empty());
+    }
+
+    SECTION("blocks of rows")
+    {
+        std::vector<float> rows;
+        for (size_t row = 0; row < 4; row++) {
+            const std::vector<float> kRow = MakeRow({ { 30.0f, -30.0f } });
+            rows.insert(rows.end(), kRow.begin(), kRow.end());
+        }
+        tracker.Update(rows, KBins);
+        CHECK(tracker.GetRowCount() == 4);
+        REQUIRE(tracker.GetTracks().size() == 1);
+        CHECK(tracker.GetTracks()[0].rows == 4);
+
+        CHECK_THROWS_AS(tracker.Update(rows, KBins + 1), std::invalid_argument);
+        CHECK_THROWS_AS(tracker.Update(rows, 0), std::invalid_argument);
+    }
+
+    SECTION("Reset() forgets everything")
+    {
+        tracker.Update(MakeRow({ { 30.0f, -30.0f } }));
+        tracker.Reset();
+        CHECK(tracker.GetTracks().empty());
+        CHECK(tracker.GetRowCount() == 0);
+        tracker.Update(MakeRow({ { 30.0f, -30.0f } }));
+        CHECK(tracker.GetTracks()[0].id == 0);
+    }
+}
+
+TEST_CASE("PeakTracker config", "[peak_tracker]")
+{
+    CHECK_THROWS_AS(PeakTracker({ .max_peaks = 0 }), std::invalid_argument);
+    CHECK_THROWS_AS(PeakTracker({ .max_bin_jump = -1.0f }), std::invalid_argument);
+}
+
+TEST_CASE("PeakTracker zero allocation", "[peak_tracker]")
+{
+    // Many short-lived peaks, so tracks are born and die every row
+    std::vector<std::vector<float>> rows;
+    for (size_t row = 0; row < 8; row++) {
+        std::vector<float> levels(KBins, KFloor);
+        for (size_t bump = 0; bump < 20; bump++) {
+            AddBump(levels,
+                    static_cast<float>(((bump * 6) + (row * 3)) % (KBins - 2)) + 1.0f,
+                    -60.0f + static_cast<float>(bump));
+        }
+        rows.push_back(levels);
+    }
+
+    PeakTracker tracker;
+    for (size_t pass = 0; pass < 2; pass++) {
+        for (const std::vector<float>& kRow : rows) {
+            tracker.Update(kRow);
+        }
+        tracker.ClearFinishedTracks();
+    }
+
+    const AllocCounter kCounter;
+    for (size_t pass = 0; pass < 4; pass++) {
+        for (const std::vector<float>& kRow : rows) {
+            tracker.Update(kRow);
+        }
+        tracker.ClearFinishedTracks();
+    }
+    CHECK(kCounter.GetCount() == 0);
+}
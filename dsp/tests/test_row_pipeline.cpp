@@ -0,0 +1,148 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "mock_fft_processor.h"
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <memory>
+#include <row_pipeline.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// @brief Generate a ramp of sample values 0, 1, 2, ...
+std::vector<float>
+MakeRamp(size_t aCount)
+{
+    std::vector<float> samples(aCount);
+    for (size_t i = 0; i < aCount; i++) {
+        samples[i] = static_cast<float>(i);
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST_CASE("RowPipeline constructor", "[row_pipeline]")
+{
+    SECTION("Uses the requested thread count")
+    {
+        const RowPipeline kPipeline(8, FFTWindow::Type::Rectangular, 3);
+        REQUIRE(kPipeline.GetThreadCount() == 3);
+        REQUIRE(kPipeline.GetTransformSize() == 8);
+        REQUIRE(kPipeline.GetBinCount() == 5);
+    }
+
+    SECTION("Thread count 0 selects at least one thread")
+    {
+        const RowPipeline kPipeline(8, FFTWindow::Type::Rectangular, 0);
+        REQUIRE(kPipeline.GetThreadCount() >= 1);
+    }
+}
+
+TEST_CASE("RowPipeline#ComputeRows", "[row_pipeline]")
+{
+    // The mock processor returns the first bin-count input samples as the
+    // output, and a rectangular window leaves them unchanged, so each row
+    // should be a slice of the ramp starting at row * stride.
+    const FFTSize kTransformSize = 8;
+    const FFTSize kStride = 4;
+    const size_t kBinCount = 5;
+
+    SECTION("Computes rows in order across threads")
+    {
+        RowPipeline pipeline(
+          kTransformSize, FFTWindow::Type::Rectangular, 3, MockFFTProcessor::GetFactory());
+        const size_t kRowCount = 10;
+        const auto kSamples = MakeRamp(((kRowCount - 1) * kStride) + kTransformSize);
+        std::vector<float> output(kRowCount * kBinCount);
+
+        pipeline.ComputeRows(kSamples, kStride, kRowCount, output);
+
+        for (size_t row = 0; row < kRowCount; row++) {
+            for (size_t bin = 0; bin < kBinCount; bin++) {
+                CAPTURE(row, bin);
+                REQUIRE(output[(row * kBinCount) + bin] ==
+                        static_cast<float>((row * kStride) + bin));
+            }
+        }
+    }
+
+    SECTION("Is reusable across batches")
+    {
+        RowPipeline pipeline(
+          kTransformSize, FFTWindow::Type::Rectangular, 2, MockFFTProcessor::GetFactory());
+        const auto kSamples = MakeRamp(64);
+
+        for (size_t rowCount = 1; rowCount <= 8; rowCount++) {
+            std::vector<float> output(rowCount * kBinCount);
+            pipeline.ComputeRows(kSamples, kStride, rowCount, output);
+            CAPTURE(rowCount);
+            REQUIRE(output.back() == static_cast<float>(((rowCount - 1) * kStride) + 4));
+        }
+    }
+
+    SECTION("Handles fewer rows than threads")
+    {
+        RowPipeline pipeline(
+          kTransformSize, FFTWindow::Type::Rectangular, 4, MockFFTProcessor::GetFactory());
+        const auto kSamples = MakeRamp(kTransformSize);
+        std::vector<float> output(kBinCount);
+
+        pipeline.ComputeRows(kSamples, kStride, 1, output);
+        REQUIRE(output == std::vector<float>{ 0, 1, 2, 3, 4 });
+    }
+
+    SECTION("Zero rows is a no-op")
+    {
+        RowPipeline pipeline(kTransformSize, FFTWindow::Type::Rectangular, 2);
+        std::vector<float> output;
+        REQUIRE_NOTHROW(pipeline.ComputeRows({}, kStride, 0, output));
+    }
+
+    SECTION("Throws if there are not enough samples")
+    {
+        RowPipeline pipeline(kTransformSize, FFTWindow::Type::Rectangular, 2);
+        const auto kSamples = MakeRamp(kTransformSize + kStride - 1);
+        std::vector<float> output(2 * kBinCount);
+        REQUIRE_THROWS_AS(pipeline.ComputeRows(kSamples, kStride, 2, output),
+                          std::invalid_argument);
+    }
+
+    SECTION("Throws if the output has the wrong size")
+    {
+        RowPipeline pipeline(kTransformSize, FFTWindow::Type::Rectangular, 2);
+        const auto kSamples = MakeRamp(kTransformSize);
+        std::vector<float> output(kBinCount + 1);
+        REQUIRE_THROWS_AS(pipeline.ComputeRows(kSamples, kStride, 1, output),
+                          std::invalid_argument);
+    }
+
+    SECTION("Matches a single FFTProcessor")
+    {
+        RowPipeline pipeline(kTransformSize, FFTWindow::Type::Hann, 3);
+        const FFTProcessor kProcessor(kTransformSize);
+        const FFTWindow kWindow(kTransformSize, FFTWindow::Type::Hann);
+        const size_t kRowCount = 6;
+        const auto kSamples = MakeRamp(((kRowCount - 1) * kStride) + kTransformSize);
+        std::vector<float> output(kRowCount * kBinCount);
+
+        pipeline.ComputeRows(kSamples, kStride, kRowCount, output);
+
+        for (size_t row = 0; row < kRowCount; row++) {
+            const auto kWindowed =
+              kWindow.Apply(std::span(kSamples).subspan(row * kStride, kTransformSize));
+            const auto kExpected = kProcessor.ComputeDecibels(kWindowed);
+            const std::vector<float> kActual(
+              output.begin() + static_cast<std::ptrdiff_t>(row * kBinCount),
+              output.begin() + static_cast<std::ptrdiff_t>((row + 1) * kBinCount));
+            CAPTURE(row);
+            REQUIRE(kActual == kExpected);
+        }
+    }
+}
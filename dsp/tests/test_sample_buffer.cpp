@@ -2,13 +2,22 @@
 // SPDX-License-Identifier: GPL-3.0-only
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
+#include "alloc_counter.h"
 #include "audio_types.h"
+#include <algorithm>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include <numeric>
 #include <sample_buffer.h>
+#include <span>
 #include <stdexcept>
+#include <thread>
 #include <vector>
+#include <waveform_pyramid.h>
 
 TEST_CASE("SampleBuffer basic functionality", "[SampleBuffer]")
 {
@@ -65,4 +74,189 @@ TEST_CASE("SampleBuffer basic functionality", "[SampleBuffer]")
         const std::vector<float> kWant = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f };
         REQUIRE_THAT(kRetrieved, Catch::Matchers::RangeEquals(kWant));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("SampleBuffer::Reserve", "[SampleBuffer]")
+{
+    SampleBuffer buffer(44100);
+    buffer.Reserve(SampleCount(16));
+    const std::vector<float> kBlock = { 1.0f, 2.0f, 3.0f, 4.0f };
+
+    // Appends within the reserved capacity don't allocate
+    const AllocCounter kCounter;
+    for (size_t i = 0; i < 4; i++) {
+        buffer.AddSamples(kBlock);
+    }
+    const size_t kAllocations = kCounter.GetCount();
+    REQUIRE(kAllocations == 0);
+    REQUIRE(buffer.GetSampleCount() == SampleCount(16));
+}
+
+TEST_CASE("SampleBuffer memory accounting", "[SampleBuffer]")
+{
+    constexpr size_t kPageBytes =
+      (SampleBuffer::KPageSamples + SampleBuffer::KMaxSpanSamples) * sizeof(float);
+    SampleBuffer buffer(44100);
+    REQUIRE(buffer.GetMemoryBytes() == 0);
+
+    buffer.Reserve(SampleCount(3 * SampleBuffer::KPageSamples));
+    REQUIRE(buffer.GetMemoryBytes() >= 3 * kPageBytes);
+
+    // Only the page holding samples is kept
+    buffer.AddSamples(std::vector<float>(100, 0.5f));
+    const size_t kFreed = buffer.ShrinkToFit();
+    REQUIRE(kFreed == 2 * kPageBytes);
+    REQUIRE(buffer.GetMemoryBytes() < 2 * kPageBytes);
+    REQUIRE(buffer.GetSampleCount() == SampleCount(100));
+    REQUIRE(buffer.ShrinkToFit() == 0);
+}
+
+TEST_CASE("SampleBuffer pages", "[SampleBuffer]")
+{
+    constexpr size_t kPage = SampleBuffer::KPageSamples;
+    constexpr size_t kSpan = SampleBuffer::KMaxSpanSamples;
+    SampleBuffer buffer(44100);
+
+    // A ramp over two and a bit pages, appended in blocks that straddle pages
+    std::vector<float> ramp((2 * kPage) + 1000);
+    std::iota(ramp.begin(), ramp.end(), 0.0f);
+    const std::span<const float> kRamp(ramp);
+    constexpr size_t kBlock = 100000;
+    for (size_t i = 0; i < ramp.size(); i += kBlock) {
+        buffer.AddSamples(kRamp.subspan(i, std::min(kBlock, ramp.size() - i)));
+    }
+    REQUIRE(buffer.GetSampleCount() == SampleCount(ramp.size()));
+
+    SECTION("Ranges within the overlap are contiguous across a boundary")
+    {
+        const auto kSamples =
+          buffer.GetSamples(SampleIndex(kPage - kSpan), SampleCount(kSpan + 10));
+        REQUIRE_THAT(kSamples,
+                     Catch::Matchers::RangeEquals(kRamp.subspan(kPage - kSpan, kSpan + 10)));
+
+        const auto kLast = buffer.GetSamples(SampleIndex((2 * kPage) - 5), SampleCount(1005));
+        REQUIRE_THAT(kLast, Catch::Matchers::RangeEquals(kRamp.last(1005)));
+    }
+
+    SECTION("Longer ranges are contiguous within a page")
+    {
+        const auto kSamples = buffer.GetSamples(SampleIndex(kPage), SampleCount(kPage));
+        REQUIRE_THAT(kSamples, Catch::Matchers::RangeEquals(kRamp.subspan(kPage, kPage)));
+    }
+
+    SECTION("Longer ranges across a boundary throw")
+    {
+        REQUIRE_THROWS_AS(buffer.GetSamples(SampleIndex(kPage - kSpan - 1), SampleCount(kSpan + 2)),
+                          std::length_error);
+    }
+
+    SECTION("Spans stay valid while appending")
+    {
+        const auto kBefore = buffer.GetSamples(SampleIndex(10), SampleCount(100));
+        buffer.AddSamples(std::vector<float>(3 * kPage, -1.0f));
+        const auto kAfter = buffer.GetSamples(SampleIndex(10), SampleCount(100));
+        REQUIRE(kBefore.data() == kAfter.data());
+        REQUIRE_THAT(kBefore, Catch::Matchers::RangeEquals(kRamp.subspan(10, 100)));
+    }
+}
+
+TEST_CASE("SampleBuffer concurrent reads during append", "[SampleBuffer]")
+{
+    // Sample i holds i, which is exact in a float below 2^24
+    constexpr size_t kTotal = 3 * SampleBuffer::KPageSamples;
+    constexpr size_t kBlock = 4096;
+    constexpr size_t kWindow = 2048;
+    SampleBuffer buffer(48000);
+    std::atomic<bool> done = false;
+
+    std::jthread writer([&buffer, &done] {
+        std::vector<float> block(kBlock);
+        for (size_t first = 0; first < kTotal; first += kBlock) {
+            std::iota(block.begin(), block.end(), static_cast<float>(first));
+            buffer.AddSamples(block);
+        }
+        done.store(true);
+    });
+
+    // Read the newest window while the writer appends and grows the directory
+    bool allMatch = true;
+    size_t reads = 0;
+    while (!done.load() || reads == 0) {
+        const size_t kCount = buffer.GetSampleCount().Get();
+        if (kCount < kWindow) {
+            continue;
+        }
+        const size_t kStart = kCount - kWindow;
+        const auto kSamples = buffer.GetSamples(SampleIndex(kStart), SampleCount(kWindow));
+        for (size_t i = 0; i < kWindow; i++) {
+            allMatch = allMatch && kSamples[i] == static_cast<float>(kStart + i);
+        }
+        reads++;
+    }
+    writer.join();
+
+    REQUIRE(allMatch);
+    REQUIRE(buffer.GetSampleCount() == SampleCount(kTotal));
+}
+
+TEST_CASE("SampleBuffer::Summarize", "[SampleBuffer]")
+{
+    constexpr size_t kSampleCount = 100'000;
+    std::vector<float> samples(kSampleCount);
+    for (size_t i = 0; i < kSampleCount; i++) {
+        samples[i] = static_cast<float>((i * 7919) % 1000) / 1000.0f - 0.5f;
+    }
+    samples[12345] = 0.9f;
+    samples[kSampleCount - 3] = -0.9f;
+    SampleBuffer buffer(44100);
+    buffer.AddSamples(samples);
+
+    const auto kMeanSquare = [&](size_t aFirst, size_t aCount) {
+        double sum = 0.0;
+        for (size_t i = aFirst; i < aFirst + aCount; i++) {
+            sum += static_cast<double>(samples[i]) * samples[i];
+        }
+        return static_cast<float>(sum / static_cast<double>(aCount));
+    };
+
+    SECTION("Whole buffer, including the tail the pyramid hasn't summarized")
+    {
+        const WaveformPyramid::Entry kEntry =
+          buffer.Summarize(SampleIndex(0), SampleCount(kSampleCount));
+        REQUIRE(kEntry.min == -0.9f);
+        REQUIRE(kEntry.max == 0.9f);
+        REQUIRE(std::abs(kEntry.mean_square - kMeanSquare(0, kSampleCount)) < 1e-5f);
+    }
+
+    SECTION("Group-aligned range is exact")
+    {
+        constexpr size_t kFirst = 12288;
+        constexpr size_t kCount = 4096;
+        const auto kRange = std::span(samples).subspan(kFirst, kCount);
+        const WaveformPyramid::Entry kEntry =
+          buffer.Summarize(SampleIndex(kFirst), SampleCount(kCount));
+        REQUIRE(kEntry.min == std::ranges::min(kRange));
+        REQUIRE(kEntry.max == 0.9f);
+        REQUIRE(std::abs(kEntry.mean_square - kMeanSquare(kFirst, kCount)) < 1e-5f);
+    }
+
+    SECTION("Short range reads samples")
+    {
+        const WaveformPyramid::Entry kEntry = buffer.Summarize(SampleIndex(12340), SampleCount(10));
+        REQUIRE(kEntry.max == 0.9f);
+        REQUIRE(kEntry.min == std::ranges::min(std::span(samples).subspan(12340, 10)));
+    }
+
+    SECTION("Range is clipped to the samples present")
+    {
+        const WaveformPyramid::Entry kEntry =
+          buffer.Summarize(SampleIndex(kSampleCount - 10), SampleCount(1000));
+        REQUIRE(kEntry.min == -0.9f);
+
+        const WaveformPyramid::Entry kEmpty =
+          buffer.Summarize(SampleIndex(kSampleCount), SampleCount(1000));
+        REQUIRE(kEmpty.min == 0.0f);
+        REQUIRE(kEmpty.max == 0.0f);
+        REQUIRE(kEmpty.mean_square == 0.0f);
+    }
+}
@@ -0,0 +1,502 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include "mock_fft_processor.h"
+#include "spectrogram_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <limits>
+#include <memory>
+#include <metrics.h>
+#include <sample_source.h>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief In-memory ISampleSource, one vector per channel
+class VectorSampleSource : public ISampleSource
+{
+  public:
+    explicit VectorSampleSource(std::vector<std::vector<float>> aChannels)
+      : mChannels(std::move(aChannels))
+    {
+    }
+
+    [[nodiscard]] ChannelCount GetChannelCount() const override
+    {
+        return static_cast<ChannelCount>(mChannels.size());
+    }
+    [[nodiscard]] SampleRate GetSampleRate() const override { return 48000; }
+    [[nodiscard]] FrameCount GetFrameCount() const override
+    {
+        return FrameCount{ mChannels.empty() ? 0 : mChannels[0].size() };
+    }
+    [[nodiscard]] std::span<const float> GetSamples(ChannelCount aChannelIndex,
+                                                    SampleIndex aStartSample,
+                                                    SampleCount aSampleCount) const override
+    {
+        const std::vector<float>& kSamples = mChannels.at(aChannelIndex);
+        if (aStartSample.Get() + aSampleCount.Get() > kSamples.size()) {
+            throw std::out_of_range("Not enough samples");
+        }
+        return std::span<const float>(kSamples).subspan(aStartSample.Get(), aSampleCount.Get());
+    }
+    [[nodiscard]] ChannelCount FindIdenticalChannel(ChannelCount aChannelIndex,
+                                                    SampleIndex aStartSample,
+                                                    SampleCount aSampleCount) const override
+    {
+        const auto kRange = [&](ChannelCount aChannel) {
+            return GetSamples(aChannel, aStartSample, aSampleCount);
+        };
+        for (ChannelCount ch = 0; ch < aChannelIndex; ch++) {
+            if (std::ranges::equal(kRange(ch), kRange(aChannelIndex))) {
+                return ch;
+            }
+        }
+        return aChannelIndex;
+    }
+
+  private:
+    std::vector<std::vector<float>> mChannels;
+};
+
+/// @brief MockFFTProcessor that counts the rows it computes
+class CountingFFTProcessor : public MockFFTProcessor
+{
+  public:
+    CountingFFTProcessor(FFTSize aTransformSize, std::atomic<size_t>& aCount)
+      : MockFFTProcessor(aTransformSize)
+      , mCount(aCount)
+    {
+    }
+
+    using MockFFTProcessor::ComputeDecibels;
+
+    void ComputeDecibels(const std::span<const float>& aInputSamples,
+                         std::span<float> aDecibels) const override
+    {
+        mCount++;
+        MockFFTProcessor::ComputeDecibels(aInputSamples, aDecibels);
+    }
+
+  private:
+    std::atomic<size_t>& mCount;
+};
+
+/// @brief 0, 1, 2, ... aCount - 1, plus aOffset
+std::vector<float>
+Ramp(size_t aCount, float aOffset)
+{
+    std::vector<float> ramp(aCount);
+    for (size_t i = 0; i < aCount; i++) {
+        ramp[i] = static_cast<float>(i) + aOffset;
+    }
+    return ramp;
+}
+
+} // namespace
+
+TEST_CASE("SpectrogramEngine::Configure", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(16, 0), Ramp(16, 100) });
+    std::vector<FFTSize> procCalls;
+    const IFFTProcessor::Factory kProcSpy = [&procCalls](FFTSize aSize) {
+        procCalls.emplace_back(aSize);
+        return std::make_unique<MockFFTProcessor>(aSize);
+    };
+
+    SpectrogramEngine engine(kSource, 8, FFTWindow::Type::Rectangular, kProcSpy);
+    REQUIRE(procCalls == std::vector<FFTSize>{ 8, 8 });
+    REQUIRE(engine.GetTransformSize() == 8);
+    REQUIRE(engine.GetBinCount() == 5);
+
+    // Rows computed before reconfiguring are discarded
+    REQUIRE(engine.GetRow(0, FramePosition{ 0 }) == std::vector<float>{ 0, 1, 2, 3, 4 });
+    engine.Configure(4, FFTWindow::Type::Rectangular);
+    REQUIRE(procCalls == std::vector<FFTSize>{ 8, 8, 4, 4 });
+    REQUIRE(engine.GetRow(0, FramePosition{ 0 }) == std::vector<float>{ 0, 1, 2 });
+}
+
+TEST_CASE("SpectrogramEngine::GetRows", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(18, 0) });
+    const SpectrogramEngine kEngine(
+      kSource, 8, FFTWindow::Type::Rectangular, MockFFTProcessor::GetFactory());
+
+    SECTION("Rows are spaced by the stride")
+    {
+        const std::vector<std::vector<float>> kWant = {
+            { 0, 1, 2, 3, 4 }, { 4, 5, 6, 7, 8 }, { 8, 9, 10, 11, 12 }
+        };
+        REQUIRE(kEngine.GetRows(0, FramePosition{ 0 }, 3, 4) == kWant);
+    }
+
+    SECTION("Unavailable rows are zero-filled")
+    {
+        const std::vector<std::vector<float>> kWant = {
+            { 0, 0, 0, 0, 0 }, { 4, 5, 6, 7, 8 }, { 0, 0, 0, 0, 0 }
+        };
+        REQUIRE(kEngine.GetRows(0, FramePosition{ -4 }, 3, 8) == kWant);
+    }
+
+    SECTION("Invalid channel")
+    {
+        REQUIRE_THROWS_AS((void)kEngine.GetRows(1, FramePosition{ 0 }, 1, 8), std::out_of_range);
+        REQUIRE_THROWS_AS((void)kEngine.GetRow(1, FramePosition{ 0 }), std::out_of_range);
+        REQUIRE_THROWS_AS((void)kEngine.ComputeFFT(1, FrameIndex{ 0 }), std::out_of_range);
+    }
+
+    SECTION("ComputeFFT throws when samples are unavailable")
+    {
+        REQUIRE_THROWS_AS((void)kEngine.ComputeFFT(0, FrameIndex{ 16 }), std::out_of_range);
+    }
+}
+
+TEST_CASE("SpectrogramEngine::GetChannelRows", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(32, 0), Ramp(32, 100), Ramp(32, 200) });
+    std::atomic<size_t> computeCount{ 0 };
+    const IFFTProcessor::Factory kCountingFactory = [&computeCount](FFTSize aSize) {
+        return std::make_unique<CountingFFTProcessor>(aSize, computeCount);
+    };
+    const SpectrogramEngine kEngine(kSource, 8, FFTWindow::Type::Rectangular, kCountingFactory);
+
+    const auto kRows = kEngine.GetChannelRows(FramePosition{ 0 }, 4, 8);
+    REQUIRE(kRows.size() == 3);
+    for (ChannelCount ch = 0; ch < 3; ch++) {
+        CAPTURE(ch);
+        REQUIRE(kRows[ch] == kEngine.GetRows(ch, FramePosition{ 0 }, 4, 8));
+    }
+    REQUIRE(kRows[2][1] == std::vector<float>{ 208, 209, 210, 211, 212 });
+
+    // Every row is computed exactly once; the rest come from the cache
+    REQUIRE(computeCount == 12);
+    (void)kEngine.GetChannelRows(FramePosition{ 0 }, 4, 8);
+    REQUIRE(computeCount == 12);
+}
+
+TEST_CASE("SpectrogramEngine row views", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(32, 0), Ramp(32, 100) });
+    const SpectrogramEngine kEngine(
+      kSource, 8, FFTWindow::Type::Rectangular, MockFFTProcessor::GetFactory());
+
+    SECTION("Views match the copying getters")
+    {
+        SpectrogramEngine::RowViews views;
+        kEngine.GetChannelRowViews(FramePosition{ -8 }, 4, 8, views);
+        const auto kRows = kEngine.GetChannelRows(FramePosition{ -8 }, 4, 8);
+        REQUIRE(views.size() == 2);
+        for (ChannelCount ch = 0; ch < 2; ch++) {
+            REQUIRE(views[ch].size() == 4);
+            for (size_t row = 0; row < 4; row++) {
+                CAPTURE(ch, row);
+                REQUIRE(std::vector<float>(views[ch][row].begin(), views[ch][row].end()) ==
+                        kRows[ch][row]);
+            }
+        }
+    }
+
+    SECTION("Cached ranges are read without allocating")
+    {
+        SpectrogramEngine::RowViews views;
+        kEngine.GetChannelRowViews(FramePosition{ -8 }, 4, 8, views);
+
+        const AllocCounter kCounter;
+        kEngine.GetChannelRowViews(FramePosition{ -8 }, 4, 8, views);
+        const std::span<const float> kRow = kEngine.GetRowView(1, FramePosition{ 16 });
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 0);
+        REQUIRE(kRow.front() == 116);
+    }
+
+    SECTION("Computing rows on several channels allocates only their cache entries")
+    {
+        SpectrogramEngine::RowViews views;
+        kEngine.GetChannelRowViews(FramePosition{ 0 }, 2, 8, views);
+
+        // Two new rows on each channel, one channel on a worker: a map node
+        // and a row of bins each, and nothing for the dispatch
+        const AllocCounter kCounter;
+        kEngine.GetChannelRowViews(FramePosition{ 16 }, 2, 8, views);
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 2 * 2 * 2);
+        REQUIRE(views[0][1].front() == 24);
+        REQUIRE(views[1][1].front() == 124);
+    }
+
+    SECTION("ComputeFFT into a caller buffer does not allocate")
+    {
+        std::vector<float> decibels(kEngine.GetBinCount());
+        const AllocCounter kCounter;
+        kEngine.ComputeFFT(0, FrameIndex{ 8 }, decibels);
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 0);
+        REQUIRE(decibels == std::vector<float>{ 8, 9, 10, 11, 12 });
+        REQUIRE_THROWS_AS(kEngine.ComputeFFT(0, FrameIndex{ 8 }, std::span(decibels).first(4)),
+                          std::invalid_argument);
+    }
+}
+
+TEST_CASE("SpectrogramEngine memory accounting", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(64, 0), Ramp(64, 100) });
+    std::atomic<size_t> computeCount{ 0 };
+    const IFFTProcessor::Factory kCountingFactory = [&computeCount](FFTSize aSize) {
+        return std::make_unique<CountingFFTProcessor>(aSize, computeCount);
+    };
+    SpectrogramEngine engine(kSource, 8, FFTWindow::Type::Rectangular, kCountingFactory);
+    const size_t kEmptyBytes = engine.GetMemoryBytes();
+    REQUIRE(kEmptyBytes > 0);
+
+    // 7 rows at stride 8 in each of 2 channels
+    (void)engine.GetChannelRows(FramePosition{ 0 }, 7, 8);
+    REQUIRE(engine.GetCachedRowCount() == 14);
+    const size_t kRowBytes = (engine.GetMemoryBytes() - kEmptyBytes) / 14;
+    REQUIRE(kRowBytes >= engine.GetBinCount() * sizeof(float));
+
+    SECTION("Eviction frees whole rows, farthest from the last request first")
+    {
+        // Focus on the newest rows, as in live mode
+        (void)engine.GetChannelRows(FramePosition{ 40 }, 2, 8);
+        REQUIRE(engine.ReleaseMemory(1) == 2 * kRowBytes); // Frame 0, both channels
+        REQUIRE(engine.GetCachedRowCount() == 12);
+        REQUIRE(engine.GetMemoryBytes() == kEmptyBytes + (12 * kRowBytes));
+
+        // The rows near the focus are still cached
+        const size_t kComputedBefore = computeCount;
+        (void)engine.GetChannelRows(FramePosition{ 40 }, 2, 8);
+        REQUIRE(computeCount == kComputedBefore);
+
+        // Frame 0 has to be recomputed
+        (void)engine.GetRow(0, FramePosition{ 0 });
+        REQUIRE(computeCount == kComputedBefore + 1);
+    }
+
+    SECTION("Releasing more than the cache holds empties it")
+    {
+        REQUIRE(engine.ReleaseMemory(engine.GetMemoryBytes()) == 14 * kRowBytes);
+        REQUIRE(engine.GetCachedRowCount() == 0);
+        REQUIRE(engine.GetMemoryBytes() == kEmptyBytes);
+        REQUIRE(engine.ReleaseMemory(1) == 0);
+    }
+}
+
+TEST_CASE("SpectrogramEngine silent windows", "[spectrogram_engine]")
+{
+    // Ramp, then zeros, then subnormals
+    std::vector<float> samples = Ramp(16, 1);
+    samples.resize(48, 0.0f);
+    samples.resize(64, std::numeric_limits<float>::denorm_min());
+    const VectorSampleSource kSource({ samples, Ramp(64, 1) });
+    std::atomic<size_t> computeCount{ 0 };
+    const IFFTProcessor::Factory kCountingFactory = [&computeCount](FFTSize aSize) {
+        return std::make_unique<CountingFFTProcessor>(aSize, computeCount);
+    };
+    SpectrogramEngine engine(kSource, 8, FFTWindow::Type::Rectangular, kCountingFactory);
+    const Metrics::Counter& kSilent = Metrics::GetCounter(Metrics::KSilentRows);
+    const uint64_t kSilentBefore = kSilent.Get();
+
+    SECTION("Silence is detected from the samples alone")
+    {
+        REQUIRE(SpectrogramEngine::IsSilent(std::vector<float>(8, 0.0f)));
+        REQUIRE(SpectrogramEngine::IsSilent(std::vector<float>(8, -0.0f)));
+        REQUIRE(SpectrogramEngine::IsSilent(
+          std::vector<float>(8, -std::numeric_limits<float>::denorm_min())));
+        REQUIRE(SpectrogramEngine::IsSilent({}));
+
+        std::vector<float> quiet(8, 0.0f);
+        quiet[7] = std::numeric_limits<float>::min();
+        REQUIRE_FALSE(SpectrogramEngine::IsSilent(quiet));
+        quiet[7] = -1e-30f;
+        REQUIRE_FALSE(SpectrogramEngine::IsSilent(quiet));
+
+        // Against a limit, the sign doesn't matter and NaN is never silent
+        REQUIRE(SpectrogramEngine::IsSilent(std::vector{ 0.5f, -0.5f }, 0.6f));
+        REQUIRE_FALSE(SpectrogramEngine::IsSilent(std::vector{ 0.5f, -0.7f }, 0.6f));
+        REQUIRE_FALSE(SpectrogramEngine::IsSilent(
+          std::vector{ std::numeric_limits<float>::quiet_NaN() }, 0.6f));
+    }
+
+    SECTION("Silent rows skip the FFT and share the floor row")
+    {
+        const auto kRows = engine.GetRows(0, FramePosition{ 16 }, 6, 8);
+        REQUIRE(computeCount == 0);
+        REQUIRE(kSilent.Get() - kSilentBefore == 6);
+        for (const auto& kRow : kRows) {
+            REQUIRE(kRow == std::vector<float>(5, 0.0f));
+        }
+        const std::span<const float> kFirst = engine.GetRowView(0, FramePosition{ 16 });
+        const std::span<const float> kLast = engine.GetRowView(0, FramePosition{ 56 });
+        REQUIRE(kFirst.data() == kLast.data());
+
+        // The same frames in another channel aren't silent
+        REQUIRE(engine.GetRow(1, FramePosition{ 16 }) == std::vector<float>{ 17, 18, 19, 20, 21 });
+        REQUIRE(computeCount == 1);
+
+        // A window that ends in silence still has a spectrum
+        REQUIRE(engine.GetRow(0, FramePosition{ 12 }) == std::vector<float>{ 13, 14, 15, 16, 0 });
+        REQUIRE(computeCount == 2);
+    }
+
+    SECTION("Silent windows are cached as stretches")
+    {
+        const size_t kEmptyBytes = engine.GetMemoryBytes();
+        (void)engine.GetRows(0, FramePosition{ 32 }, 1, 8);
+        (void)engine.GetRows(0, FramePosition{ 48 }, 1, 8);
+        REQUIRE(engine.GetSilentRunCount() == 2);
+
+        // Filling the gap joins them, and overlapping windows inside are
+        // answered without looking at the samples
+        (void)engine.GetRows(0, FramePosition{ 16 }, 6, 8);
+        REQUIRE(engine.GetSilentRunCount() == 1);
+        REQUIRE(engine.GetCachedRowCount() == 0);
+        const uint64_t kSilentFound = kSilent.Get();
+        (void)engine.GetRows(0, FramePosition{ 20 }, 5, 8);
+        REQUIRE(kSilent.Get() == kSilentFound);
+        const size_t kRunBytes = engine.GetMemoryBytes() - kEmptyBytes;
+        REQUIRE(kRunBytes > 0);
+
+        // The stretch goes once the rows have
+        (void)engine.GetRows(0, FramePosition{ 0 }, 1, 8);
+        const size_t kRowBytes = engine.GetMemoryBytes() - kEmptyBytes - kRunBytes;
+        REQUIRE(engine.ReleaseMemory(kRowBytes) == kRowBytes);
+        REQUIRE(engine.GetSilentRunCount() == 1);
+        REQUIRE(engine.ReleaseMemory(1) == kRunBytes);
+        REQUIRE(engine.GetSilentRunCount() == 0);
+        REQUIRE(engine.GetMemoryBytes() == kEmptyBytes);
+    }
+
+    SECTION("A silence floor makes quiet windows silent")
+    {
+        // A rectangular window of 8 bounds the bins by 8 * peak: 42.1 dB for
+        // the window peaking at 16, 36.1 dB for the one peaking at 8
+        engine.SetSilenceFloor(42.0f);
+        REQUIRE(engine.GetRow(0, FramePosition{ 8 }) == std::vector<float>{ 9, 10, 11, 12, 13 });
+        REQUIRE(computeCount == 1);
+        REQUIRE(engine.GetRow(0, FramePosition{ 0 }) == std::vector<float>(5, 0.0f));
+        REQUIRE(computeCount == 1);
+
+        // Lowering the floor forgets the silence found with the higher one
+        engine.SetSilenceFloor(30.0f);
+        REQUIRE(engine.GetRow(0, FramePosition{ 0 }) == std::vector<float>{ 1, 2, 3, 4, 5 });
+        REQUIRE(computeCount == 2);
+    }
+}
+
+TEST_CASE("SpectrogramEngine duplicate channels", "[spectrogram_engine]")
+{
+    // Channels 1 and 2 copy channel 0 until frame 16, then channel 2 diverges
+    std::vector<float> diverging = Ramp(32, 0);
+    std::fill(diverging.begin() + 16, diverging.end(), 7.0f);
+    const VectorSampleSource kSource({ Ramp(32, 0), Ramp(32, 0), diverging });
+    std::atomic<size_t> computeCount{ 0 };
+    const IFFTProcessor::Factory kCountingFactory = [&computeCount](FFTSize aSize) {
+        return std::make_unique<CountingFFTProcessor>(aSize, computeCount);
+    };
+    const SpectrogramEngine kEngine(kSource, 8, FFTWindow::Type::Rectangular, kCountingFactory);
+
+    SECTION("Duplicates share the source channel's rows")
+    {
+        SpectrogramEngine::RowViews views;
+        kEngine.GetChannelRowViews(FramePosition{ -8 }, 3, 8, views);
+        REQUIRE(computeCount == 2);
+        REQUIRE(kEngine.GetCachedRowCount() == 2);
+        for (size_t row = 0; row < 3; row++) {
+            REQUIRE(views[1][row].data() == views[0][row].data());
+            REQUIRE(views[2][row].data() == views[0][row].data());
+        }
+
+        // Cached and aliased: nothing to allocate
+        const AllocCounter kCounter;
+        kEngine.GetChannelRowViews(FramePosition{ -8 }, 3, 8, views);
+        const size_t kAllocations = kCounter.GetCount();
+        REQUIRE(kAllocations == 0);
+    }
+
+    SECTION("Channels are only aliased where they match")
+    {
+        const auto kRows = kEngine.GetChannelRows(FramePosition{ 0 }, 4, 8);
+        REQUIRE(kRows[1] == kRows[0]);
+        REQUIRE(kRows[2][3] == std::vector<float>{ 7, 7, 7, 7, 7 });
+        REQUIRE(computeCount == 8); // Channel 0, then channel 2 on its own
+        const std::vector<std::vector<float>> kMatching(kRows[0].begin(), kRows[0].begin() + 2);
+        REQUIRE(kEngine.GetRows(2, FramePosition{ 0 }, 2, 8) == kMatching);
+        REQUIRE(computeCount == 8);
+
+        // A single row is aliased by its own window
+        REQUIRE(kEngine.GetRowView(2, FramePosition{ 8 }).data() ==
+                kEngine.GetRowView(0, FramePosition{ 8 }).data());
+        REQUIRE(kEngine.GetRowView(2, FramePosition{ 16 }).data() !=
+                kEngine.GetRowView(0, FramePosition{ 16 }).data());
+    }
+}
+
+TEST_CASE("SpectrogramEngine stride alignment", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(16, 0) });
+    const SpectrogramEngine kEngine(
+      kSource, 8, FFTWindow::Type::Rectangular, MockFFTProcessor::GetFactory());
+
+    REQUIRE(SpectrogramEngine::RoundToStride(FramePosition{ 7 }, 4) == FramePosition{ 4 });
+    REQUIRE(SpectrogramEngine::RoundToStride(FramePosition{ 8 }, 4) == FramePosition{ 8 });
+    REQUIRE(SpectrogramEngine::RoundToStride(FramePosition{ -1 }, 4) == FramePosition{ -4 });
+    REQUIRE(SpectrogramEngine::RoundToStride(FramePosition{ -4 }, 4) == FramePosition{ -4 });
+
+    REQUIRE(kEngine.CalculateTopOfWindow(FramePosition{ 13 }, 2) == FramePosition{ 4 });
+    REQUIRE(kEngine.CalculateTopOfWindow(FramePosition{ 13 }, 1) == FramePosition{ 5 });
+    REQUIRE(kEngine.CalculateTopOfWindow(FramePosition{ 6 }, 2) == FramePosition{ -2 });
+}
+
+TEST_CASE("SpectrogramEngine::GetHzPerBin", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(16, 0) });
+    const SpectrogramEngine kEngine(
+      kSource, 1024, FFTWindow::Type::Rectangular, MockFFTProcessor::GetFactory());
+    REQUIRE(kEngine.GetHzPerBin() == 46.875f);
+}
+
+TEST_CASE("SpectrogramEngine metrics", "[spectrogram_engine]")
+{
+    const VectorSampleSource kSource({ Ramp(16, 0) });
+    const Metrics::Counter& kHits = Metrics::GetCounter(Metrics::KCacheHits);
+    const Metrics::Counter& kMisses = Metrics::GetCounter(Metrics::KCacheMisses);
+    const Metrics::Counter& kComputed = Metrics::GetCounter(Metrics::KRowsComputed);
+    const Metrics::Gauge& kCacheRows = Metrics::GetGauge(Metrics::KCacheRows);
+    const uint64_t kHitsBefore = kHits.Get();
+    const uint64_t kMissesBefore = kMisses.Get();
+    const uint64_t kComputedBefore = kComputed.Get();
+    const int64_t kCacheRowsBefore = kCacheRows.Get();
+
+    {
+        SpectrogramEngine engine(
+          kSource, 8, FFTWindow::Type::Rectangular, MockFFTProcessor::GetFactory());
+        (void)engine.GetRow(0, FramePosition{ 0 });
+        (void)engine.GetRow(0, FramePosition{ 0 });
+        (void)engine.GetRow(0, FramePosition{ 4 });
+        REQUIRE(kMisses.Get() - kMissesBefore == 2);
+        REQUIRE(kHits.Get() - kHitsBefore == 1);
+        REQUIRE(kComputed.Get() - kComputedBefore == 2);
+        REQUIRE(kCacheRows.Get() - kCacheRowsBefore == 2);
+
+        // Reconfiguring empties the cache
+        engine.Configure(8, FFTWindow::Type::Rectangular);
+        REQUIRE(kCacheRows.Get() == kCacheRowsBefore);
+        (void)engine.GetRow(0, FramePosition{ 0 });
+        REQUIRE(kCacheRows.Get() - kCacheRowsBefore == 1);
+    }
+
+    // So does destroying the engine
+    REQUIRE(kCacheRows.Get() == kCacheRowsBefore);
+}
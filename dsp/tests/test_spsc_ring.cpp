@@ -0,0 +1,95 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "spsc_ring.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SpscRing constructor", "[spsc_ring]")
+{
+    REQUIRE_THROWS_AS(SpscRing<float>(0), std::invalid_argument);
+    REQUIRE(SpscRing<float>(1).GetCapacity() == 1);
+    REQUIRE(SpscRing<float>(5).GetCapacity() == 8);
+    REQUIRE(SpscRing<float>(1024).GetCapacity() == 1024);
+}
+
+TEST_CASE("SpscRing read and write", "[spsc_ring]")
+{
+    SpscRing<int> ring(8);
+    REQUIRE(ring.GetReadAvailable() == 0);
+    REQUIRE(ring.GetWriteAvailable() == 8);
+
+    SECTION("Reads back what was written")
+    {
+        const std::vector<int> kIn = { 1, 2, 3 };
+        REQUIRE(ring.Write(kIn) == 3);
+        REQUIRE(ring.GetReadAvailable() == 3);
+        REQUIRE(ring.GetWriteAvailable() == 5);
+
+        std::vector<int> out(8);
+        REQUIRE(ring.Read(out) == 3);
+        REQUIRE(std::vector<int>(out.begin(), out.begin() + 3) == kIn);
+        REQUIRE(ring.GetReadAvailable() == 0);
+    }
+
+    SECTION("Partial write when full")
+    {
+        const std::vector<int> kIn(10, 7);
+        REQUIRE(ring.Write(kIn) == 8);
+        REQUIRE(ring.Write(kIn) == 0);
+        REQUIRE(ring.GetWriteAvailable() == 0);
+    }
+
+    SECTION("Wraps around the end of storage")
+    {
+        std::vector<int> out(8);
+        for (int round = 0; round < 5; round++) {
+            const std::vector<int> kIn = { round, round + 1, round + 2, round + 3, round + 4 };
+            REQUIRE(ring.Write(kIn) == 5);
+            REQUIRE(ring.Read(out) == 5);
+            CAPTURE(round);
+            REQUIRE(std::vector<int>(out.begin(), out.begin() + 5) == kIn);
+        }
+    }
+}
+
+TEST_CASE("SpscRing across threads", "[spsc_ring]")
+{
+    constexpr int kTotal = 1 << 20;
+    SpscRing<int> ring(256);
+
+    std::jthread producer([&ring] {
+        std::vector<int> block(100);
+        int next = 0;
+        while (next < kTotal) {
+            const size_t kCount = std::min<size_t>(block.size(), kTotal - next);
+            std::iota(block.begin(), block.begin() + static_cast<std::ptrdiff_t>(kCount), next);
+            const auto kBlock = std::span<const int>(block).first(kCount);
+            size_t written = 0;
+            while (written < kCount) {
+                written += ring.Write(kBlock.subspan(written));
+            }
+            next += static_cast<int>(kCount);
+        }
+    });
+
+    std::vector<int> out(64);
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < kTotal) {
+        const size_t kRead = ring.Read(out);
+        for (size_t i = 0; i < kRead; i++) {
+            inOrder = inOrder && out[i] == expected;
+            expected++;
+        }
+    }
+    REQUIRE(inOrder);
+    REQUIRE(ring.GetReadAvailable() == 0);
+}
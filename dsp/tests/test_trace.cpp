@@ -0,0 +1,176 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <latch>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// @brief Events recorded under aName, in start order
+std::vector<Trace::Event>
+EventsNamed(std::string_view aName)
+{
+    std::vector<Trace::Event> events = Trace::Snapshot();
+    std::erase_if(events, [aName](const Trace::Event& aEvent) { return aEvent.name != aName; });
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("Trace::Zone", "[trace]")
+{
+    Trace::Clear();
+
+    SECTION("Disabled zones are not recorded")
+    {
+        Trace::SetEnabled(false);
+        {
+            const Trace::Zone kZone("disabled");
+        }
+        REQUIRE(EventsNamed("disabled").empty());
+    }
+
+    SECTION("Enabled zones record their span")
+    {
+        Trace::SetEnabled(true);
+        const uint64_t kBefore = Trace::Now();
+        {
+            const Trace::Zone kOuter("outer");
+            const Trace::Zone kInner("inner");
+        }
+        const uint64_t kAfter = Trace::Now();
+        Trace::SetEnabled(false);
+
+        const auto kOuter = EventsNamed("outer");
+        const auto kInner = EventsNamed("inner");
+        REQUIRE(kOuter.size() == 1);
+        REQUIRE(kInner.size() == 1);
+        REQUIRE(kOuter[0].start_ns >= kBefore);
+        REQUIRE(kOuter[0].start_ns + kOuter[0].duration_ns <= kAfter);
+        // The inner zone nests inside the outer one
+        REQUIRE(kInner[0].start_ns >= kOuter[0].start_ns);
+        REQUIRE(kInner[0].start_ns + kInner[0].duration_ns <=
+                kOuter[0].start_ns + kOuter[0].duration_ns);
+        REQUIRE(kInner[0].thread_id == kOuter[0].thread_id);
+    }
+
+    SECTION("Clear hides earlier events")
+    {
+        Trace::SetEnabled(true);
+        {
+            const Trace::Zone kZone("cleared");
+        }
+        Trace::Clear();
+        {
+            const Trace::Zone kZone("kept");
+        }
+        Trace::SetEnabled(false);
+        REQUIRE(EventsNamed("cleared").empty());
+        REQUIRE(EventsNamed("kept").size() == 1);
+    }
+}
+
+TEST_CASE("Trace per-thread buffers", "[trace]")
+{
+    Trace::Clear();
+    Trace::SetEnabled(true);
+
+    SECTION("Threads record to separate buffers")
+    {
+        constexpr size_t kZonesPerThread = 100;
+        // Both threads hold their buffers at once: an exited thread's buffer
+        // would otherwise be reused by the next
+        std::latch bothRecording(2);
+        auto work = [&bothRecording] {
+            for (size_t i = 0; i < kZonesPerThread; i++) {
+                const Trace::Zone kZone("worker");
+            }
+            bothRecording.arrive_and_wait();
+        };
+        {
+            std::jthread first(work);
+            std::jthread second(work);
+        }
+        Trace::SetEnabled(false);
+
+        const auto kEvents = EventsNamed("worker");
+        REQUIRE(kEvents.size() == 2 * kZonesPerThread);
+        std::set<uint32_t> threadIds;
+        for (const Trace::Event& kEvent : kEvents) {
+            threadIds.insert(kEvent.thread_id);
+        }
+        REQUIRE(threadIds.size() == 2);
+    }
+
+    SECTION("Full buffers keep the newest events")
+    {
+        constexpr size_t kExtra = 10;
+        std::jthread([] {
+            for (size_t i = 0; i < Trace::KEventsPerThread + kExtra; i++) {
+                const Trace::Zone kZone("overflow");
+            }
+        }).join();
+        Trace::SetEnabled(false);
+
+        const auto kEvents = EventsNamed("overflow");
+        REQUIRE(kEvents.size() <= Trace::KEventsPerThread);
+        REQUIRE(kEvents.size() >= Trace::KEventsPerThread - kExtra);
+        REQUIRE(std::ranges::is_sorted(kEvents, {}, &Trace::Event::start_ns));
+    }
+
+    SECTION("Snapshot while recording")
+    {
+        std::atomic<bool> done{ false };
+        std::jthread writer([&done] {
+            while (!done) {
+                const Trace::Zone kZone("concurrent");
+            }
+        });
+        for (int i = 0; i < 10; i++) {
+            for (const Trace::Event& kEvent : Trace::Snapshot()) {
+                REQUIRE(kEvent.name != nullptr);
+            }
+        }
+        done = true;
+    }
+
+    Trace::SetEnabled(false);
+}
+
+TEST_CASE("Trace::WriteChromeJson", "[trace]")
+{
+    Trace::Clear();
+    Trace::SetEnabled(true);
+    {
+        const Trace::Zone kZone("Quoted \"name\"");
+    }
+    Trace::SetEnabled(false);
+
+    std::ostringstream stream;
+    Trace::WriteChromeJson(stream);
+    const std::string kJson = stream.str();
+    REQUIRE(kJson.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    REQUIRE(kJson.find(R"({"name":"Quoted \"name\"","cat":"spectro","ph":"X","ts":)") !=
+            std::string::npos);
+    REQUIRE(kJson.ends_with("\n]}\n"));
+
+    SECTION("Empty trace is still valid JSON")
+    {
+        Trace::Clear();
+        std::ostringstream empty;
+        Trace::WriteChromeJson(empty);
+        REQUIRE(empty.str() == "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n");
+    }
+}
@@ -0,0 +1,97 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <waveform_pyramid.h>
+
+namespace {
+
+/// @brief A signal whose groups all differ: a slow sine with a fast ripple
+std::vector<float>
+MakeSignal(size_t aSampleCount)
+{
+    std::vector<float> samples(aSampleCount);
+    for (size_t i = 0; i < aSampleCount; i++) {
+        const auto kT = static_cast<float>(i);
+        samples[i] = (0.5f * std::sin(kT * 0.001f)) + (0.25f * std::sin(kT * 0.3f));
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST_CASE("WaveformPyramid::GetLevelFor", "[WaveformPyramid]")
+{
+    constexpr size_t kBase = WaveformPyramid::KBaseGroupSamples;
+    REQUIRE(WaveformPyramid::GetLevelFor(0) == WaveformPyramid::KLevelCount);
+    REQUIRE(WaveformPyramid::GetLevelFor(kBase - 1) == WaveformPyramid::KLevelCount);
+    REQUIRE(WaveformPyramid::GetLevelFor(kBase) == 0);
+    REQUIRE(WaveformPyramid::GetLevelFor((2 * kBase) - 1) == 0);
+    REQUIRE(WaveformPyramid::GetLevelFor(2 * kBase) == 1);
+    REQUIRE(WaveformPyramid::GetLevelFor(size_t{ 1 } << 30) == 22);
+    REQUIRE(WaveformPyramid::GetLevelFor(~size_t{ 0 }) == WaveformPyramid::KLevelCount - 1);
+}
+
+TEST_CASE("WaveformPyramid levels", "[WaveformPyramid]")
+{
+    constexpr size_t kSampleCount = 40000;
+    const std::vector<float> kSignal = MakeSignal(kSampleCount);
+    WaveformPyramid pyramid;
+
+    // Odd block sizes, so groups straddle blocks
+    std::span<const float> remaining(kSignal);
+    while (!remaining.empty()) {
+        const size_t kCount = std::min<size_t>(remaining.size(), 333);
+        pyramid.Add(remaining.first(kCount));
+        remaining = remaining.subspan(kCount);
+    }
+
+    for (size_t level = 0; level < 8; level++) {
+        const size_t kGroup = WaveformPyramid::GetGroupSamples(level);
+        REQUIRE(pyramid.GetEntryCount(level) == kSampleCount / kGroup);
+        for (size_t entry = 0; entry < pyramid.GetEntryCount(level); entry++) {
+            const std::span<const float> kGroupSamples =
+              std::span(kSignal).subspan(entry * kGroup, kGroup);
+            double sumOfSquares = 0.0;
+            for (const float kSample : kGroupSamples) {
+                sumOfSquares += static_cast<double>(kSample) * kSample;
+            }
+            const WaveformPyramid::Entry& kEntry = pyramid.GetEntry(level, entry);
+            REQUIRE(kEntry.min == std::ranges::min(kGroupSamples));
+            REQUIRE(kEntry.max == std::ranges::max(kGroupSamples));
+            const double kMeanSquare = sumOfSquares / static_cast<double>(kGroup);
+            REQUIRE_THAT(kEntry.mean_square, Catch::Matchers::WithinRel(kMeanSquare, 1e-5));
+        }
+    }
+    // 40000 samples hold no group of 2^16
+    REQUIRE(pyramid.GetEntryCount(8) == 0);
+}
+
+TEST_CASE("WaveformPyramid::Reserve", "[WaveformPyramid]")
+{
+    constexpr size_t kSampleCount = size_t{ 1 } << 20;
+    const std::vector<float> kSignal = MakeSignal(kSampleCount);
+    WaveformPyramid pyramid;
+    pyramid.Reserve(kSampleCount);
+    const size_t kReservedBytes = pyramid.GetMemoryBytes();
+    REQUIRE(kReservedBytes > 0);
+
+    // Filling every level within the reserved capacity doesn't allocate
+    const AllocCounter kCounter;
+    pyramid.Add(kSignal);
+    const size_t kAllocations = kCounter.GetCount();
+    REQUIRE(kAllocations == 0);
+    REQUIRE(pyramid.GetMemoryBytes() == kReservedBytes);
+    REQUIRE(pyramid.GetEntryCount(12) == 1);
+
+    // A few percent of the samples' own size
+    REQUIRE(kReservedBytes < kSampleCount * sizeof(float) / 16);
+}
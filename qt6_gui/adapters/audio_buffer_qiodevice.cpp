@@ -9,6 +9,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <sample_buffer.h>
 #include <stdexcept>
 
 bool
@@ -77,22 +78,26 @@ AudioBufferQIODevice::readData(char* aData, qint64 aRequestedBytes)
     const FrameCount kFramesRemaining{ kAvailableFrames.Get() - mCurrentReadPosition.Get() };
     const FrameCount kFramesToRead = std::min(kRequestedFrames, kFramesRemaining);
 
-    // Interleave samples into output buffer
+    // Interleave samples into output buffer.  Longer ranges may not be
+    // contiguous, so fetch in chunks.
+    constexpr size_t kChunkFrames = SampleBuffer::KMaxSpanSamples;
     for (ChannelCount ch = 0; ch < kChannelCount; ch++) {
-        const SampleIndex kStartSample{ mCurrentReadPosition.Get() };
-        const SampleCount kSamplesToRead{ kFramesToRead.Get() };
-        const auto kSamples = mAudioBuffer.GetSamples(ch, kStartSample, kSamplesToRead);
-
-        // The Qt API only provides us a pointer to a byte buffer, so we have to
-        // copy the float samples as raw byte data.
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        const char* kSamplesAsBytes = reinterpret_cast<const char*>(kSamples.data());
-
-        for (size_t i = 0; i < kSamples.size(); i++) {
-            const size_t kSourceOffset = i * sizeof(float);
-            const size_t kDestOffset = (i * kChannelCount + ch) * sizeof(float);
-            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-            std::copy_n(kSamplesAsBytes + kSourceOffset, sizeof(float), aData + kDestOffset);
+        for (size_t first = 0; first < kFramesToRead.Get(); first += kChunkFrames) {
+            const SampleIndex kStartSample{ mCurrentReadPosition.Get() + first };
+            const SampleCount kSamplesToRead{ std::min(kChunkFrames, kFramesToRead.Get() - first) };
+            const auto kSamples = mAudioBuffer.GetSamples(ch, kStartSample, kSamplesToRead);
+
+            // The Qt API only provides us a pointer to a byte buffer, so we have to
+            // copy the float samples as raw byte data.
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const char* kSamplesAsBytes = reinterpret_cast<const char*>(kSamples.data());
+
+            for (size_t i = 0; i < kSamples.size(); i++) {
+                const size_t kSourceOffset = i * sizeof(float);
+                const size_t kDestOffset = ((first + i) * kChannelCount + ch) * sizeof(float);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                std::copy_n(kSamplesAsBytes + kSourceOffset, sizeof(float), aData + kDestOffset);
+            }
         }
     }
 
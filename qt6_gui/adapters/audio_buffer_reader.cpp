@@ -0,0 +1,79 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "adapters/audio_buffer_reader.h"
+#include "models/audio_buffer.h"
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <optional>
+#include <sample_buffer.h>
+#include <stdexcept>
+#include <vector>
+
+AudioBufferReader::AudioBufferReader(const AudioBuffer& aBuffer,
+                                     FrameIndex aFirstFrame,
+                                     std::optional<FrameCount> aFrameCount)
+  : mBuffer(aBuffer)
+  , mFirstFrame(aFirstFrame)
+  , mNextFrame(aFirstFrame)
+{
+    const size_t kBufferFrames = mBuffer.GetFrameCount().Get();
+    if (aFirstFrame.Get() > kBufferFrames) {
+        throw std::out_of_range("AudioBufferReader: first frame is past the end of the buffer");
+    }
+    const size_t kAvailableFrames = kBufferFrames - aFirstFrame.Get();
+    if (aFrameCount.has_value() && aFrameCount->Get() > kAvailableFrames) {
+        throw std::out_of_range("AudioBufferReader: range extends past the end of the buffer");
+    }
+    mFrameCount = aFrameCount.value_or(FrameCount{ kAvailableFrames });
+    mFramesRemaining = mFrameCount;
+}
+
+std::vector<float>
+AudioBufferReader::ReadInterleaved(FrameCount aFrames)
+{
+    const size_t kFrames = std::min(aFrames.Get(), mFramesRemaining.Get());
+    const ChannelCount kChannels = mBuffer.GetChannelCount();
+    std::vector<float> interleaved(kFrames * kChannels);
+
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        // Longer ranges may not be contiguous, so fetch in chunks
+        for (size_t first = 0; first < kFrames; first += SampleBuffer::KMaxSpanSamples) {
+            const size_t kChunk = std::min(SampleBuffer::KMaxSpanSamples, kFrames - first);
+            const auto kSamples = mBuffer.GetSamples(
+              ch, SampleIndex{ mNextFrame.Get() + first }, SampleCount{ kChunk });
+            for (size_t i = 0; i < kChunk; i++) {
+                interleaved[((first + i) * kChannels) + ch] = kSamples[i];
+            }
+        }
+    }
+
+    mNextFrame = FrameIndex{ mNextFrame.Get() + kFrames };
+    mFramesRemaining = FrameCount{ mFramesRemaining.Get() - kFrames };
+    return interleaved;
+}
+
+bool
+AudioBufferReader::Seek(FrameIndex aFrame)
+{
+    if (aFrame.Get() > mFrameCount.Get()) {
+        return false;
+    }
+    mNextFrame = FrameIndex{ mFirstFrame.Get() + aFrame.Get() };
+    mFramesRemaining = FrameCount{ mFrameCount.Get() - aFrame.Get() };
+    return true;
+}
+
+SampleRate
+AudioBufferReader::GetSampleRate() const
+{
+    return mBuffer.GetSampleRate();
+}
+
+ChannelCount
+AudioBufferReader::GetChannelCount() const
+{
+    return mBuffer.GetChannelCount();
+}
@@ -0,0 +1,48 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "adapters/audio_file_reader.h"
+#include <audio_types.h>
+#include <optional>
+#include <vector>
+
+class AudioBuffer;
+
+/// @brief IAudioFileReader over a range of an AudioBuffer
+///
+/// Lets the offline pipeline (RowBlockSource and its consumers) process audio
+/// that is already in memory, such as a live recording, the same way it
+/// processes files.
+///
+/// The range is fixed at construction.  The buffer must not be reset while
+/// the reader is in use.
+class AudioBufferReader : public IAudioFileReader
+{
+  public:
+    /// @brief Constructor
+    /// @param aBuffer Audio buffer to read from
+    /// @param aFirstFrame First frame of the range
+    /// @param aFrameCount Number of frames in the range, or nullopt for all
+    /// frames currently in the buffer after aFirstFrame
+    /// @throws std::out_of_range if the range extends past the end of the buffer
+    explicit AudioBufferReader(const AudioBuffer& aBuffer,
+                               FrameIndex aFirstFrame = FrameIndex{ 0 },
+                               std::optional<FrameCount> aFrameCount = std::nullopt);
+
+    [[nodiscard]] std::vector<float> ReadInterleaved(FrameCount aFrames) override;
+    /// @param aFrame Frame within the range, not the buffer
+    [[nodiscard]] bool Seek(FrameIndex aFrame) override;
+    [[nodiscard]] SampleRate GetSampleRate() const override;
+    [[nodiscard]] ChannelCount GetChannelCount() const override;
+    [[nodiscard]] FrameCount GetFrameCount() const override { return mFrameCount; }
+
+  private:
+    const AudioBuffer& mBuffer;
+    FrameIndex mFirstFrame;
+    FrameIndex mNextFrame;
+    FrameCount mFrameCount;
+    FrameCount mFramesRemaining;
+};
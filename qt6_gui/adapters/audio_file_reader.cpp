@@ -4,6 +4,8 @@
 
 #include "adapters/audio_file_reader.h"
 #include "audio_types.h"
+#include <cstddef>
+#include <cstdio>
 #include <expected>
 #include <format>
 #include <sndfile.h>
@@ -40,3 +42,13 @@ AudioFileReader::ReadInterleaved(FrameCount aFrames)
     buffer.resize(framesRead * mSfInfo.channels);
     return buffer;
 }
+
+bool
+AudioFileReader::Seek(FrameIndex aFrame)
+{
+    if (aFrame.Get() > static_cast<size_t>(mSfInfo.frames)) {
+        return false;
+    }
+    // sf_seek fails, leaving the position alone, on unseekable streams
+    return sf_seek(mSndFile.get(), static_cast<sf_count_t>(aFrame.Get()), SEEK_SET) >= 0;
+}
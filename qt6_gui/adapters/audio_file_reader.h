@@ -23,6 +23,12 @@ class IAudioFileReader
     /// @return Vector of interleaved audio samples
     [[nodiscard]] virtual std::vector<float> ReadInterleaved(FrameCount aFrames) = 0;
 
+    /// @brief Move the read position
+    /// @param aFrame Frame the next read starts at, at most GetFrameCount()
+    /// @return true on success; false if the audio can't seek (e.g. a pipe) or
+    /// aFrame is out of range, leaving the position unchanged
+    [[nodiscard]] virtual bool Seek(FrameIndex aFrame) = 0;
+
     /// @brief Get the sample rate of the audio file
     /// @return Sample rate in Hz
     [[nodiscard]] virtual SampleRate GetSampleRate() const = 0;
@@ -54,6 +60,7 @@ class AudioFileReader : public IAudioFileReader
 
     ~AudioFileReader() override = default;
     [[nodiscard]] std::vector<float> ReadInterleaved(FrameCount aFrames) override;
+    [[nodiscard]] bool Seek(FrameIndex aFrame) override;
     [[nodiscard]] SampleRate GetSampleRate() const override { return mSfInfo.samplerate; }
     [[nodiscard]] ChannelCount GetChannelCount() const override { return mSfInfo.channels; }
     [[nodiscard]] FrameCount GetFrameCount() const override
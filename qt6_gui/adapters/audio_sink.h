@@ -7,8 +7,6 @@
 #include <QAudioFormat>
 #include <QAudioSink>
 #include <QIODevice>
-#include <memory>
-#include <utility>
 
 /// @brief Abstraction for QAudioSink to allow for easier mocking in unit tests.
 class IAudioSink
@@ -17,8 +15,9 @@ class IAudioSink
     virtual ~IAudioSink() = default;
 
     /// @brief Start audio playback from the given source device
-    /// @param aSourceQIODevice The source QIODevice to read audio from.
-    virtual void Start(std::unique_ptr<QIODevice> aSourceQIODevice) = 0;
+    /// @param aSourceQIODevice The source QIODevice to read audio from.  Not
+    /// owned; it must outlive the sink or the next Stop().
+    virtual void Start(QIODevice& aSourceQIODevice) = 0;
 
     /// @brief Stop audio playback
     virtual void Stop() = 0;
@@ -50,23 +49,17 @@ class AudioSink : public IAudioSink
     AudioSink(AudioSink&&) = delete;
     AudioSink& operator=(AudioSink&&) = delete;
 
-    void Start(std::unique_ptr<QIODevice> aSourceQIODevice) noexcept override
+    void Start(QIODevice& aSourceQIODevice) noexcept override
     {
         Stop();
-        mSourceQIODevice = std::move(aSourceQIODevice);
-        mAudioSink.start(mSourceQIODevice.get());
+        mAudioSink.start(&aSourceQIODevice);
     }
 
-    void Stop() noexcept override
-    {
-        mAudioSink.stop();
-        mSourceQIODevice.reset();
-    }
+    void Stop() noexcept override { mAudioSink.stop(); }
 
     [[nodiscard]] qint64 ProcessedUSecs() const override { return mAudioSink.processedUSecs(); }
 
   private:
-    std::unique_ptr<QIODevice> mSourceQIODevice;
     QAudioSink mAudioSink;
 };
 // LCOV_EXCL_STOP
\ No newline at end of file
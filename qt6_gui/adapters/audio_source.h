@@ -0,0 +1,93 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include <QAudio>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QAudioSource>
+#include <QIODevice>
+#include <QObject>
+#include <functional>
+#include <utility>
+
+/// @brief Abstraction for QAudioSource to allow for easier mocking in unit tests.
+class IAudioSource
+{
+  public:
+    virtual ~IAudioSource() = default;
+
+    /// @brief Set the device buffer size.  Applies from the next Start().
+    /// @param aBytes Buffer size in bytes
+    virtual void SetBufferSize(qsizetype aBytes) = 0;
+
+    /// @brief Get the device buffer size
+    [[nodiscard]] virtual qsizetype BufferSize() const = 0;
+
+    /// @brief Start capturing
+    /// @return Device to read captured audio from, owned by the source, or
+    /// nullptr if the source failed to start
+    virtual QIODevice* Start() = 0;
+
+    /// @brief Stop capturing.  Audio queued on the device is discarded.
+    virtual void Stop() = 0;
+
+    /// @brief Get the bytes queued on the device, waiting to be read
+    [[nodiscard]] virtual qsizetype BytesAvailable() const = 0;
+
+    /// @brief Get the last error
+    [[nodiscard]] virtual QAudio::Error Error() const = 0;
+
+    /// @brief Call aCallback, on the source's thread, whenever its state changes
+    /// @param aCallback Callback
+    virtual void OnStateChanged(std::function<void()> aCallback) = 0;
+};
+
+/// @brief Concrete implementation of IAudioSource wrapping QAudioSource
+// LCOV_EXCL_START // This class exists to encapsulate untestable interfaces.
+class AudioSource : public IAudioSource
+{
+  public:
+    /// @brief Constructor
+    /// @param aDevice Input device
+    /// @param aFormat The audio format to capture
+    AudioSource(const QAudioDevice& aDevice, const QAudioFormat& aFormat)
+      : mAudioSource(aDevice, aFormat)
+    {
+    }
+
+    /// @brief Destructor
+    /// Ensures that capture is stopped and resources are released.
+    ~AudioSource() noexcept override { Stop(); }
+
+    // Delete move and copy to prevent dangling pointer issues
+    AudioSource(const AudioSource&) = delete;
+    AudioSource& operator=(const AudioSource&) = delete;
+    AudioSource(AudioSource&&) = delete;
+    AudioSource& operator=(AudioSource&&) = delete;
+
+    void SetBufferSize(qsizetype aBytes) override { mAudioSource.setBufferSize(aBytes); }
+    [[nodiscard]] qsizetype BufferSize() const override { return mAudioSource.bufferSize(); }
+    QIODevice* Start() override { return mAudioSource.start(); }
+    void Stop() noexcept override { mAudioSource.stop(); }
+    [[nodiscard]] qsizetype BytesAvailable() const override
+    {
+        return mAudioSource.bytesAvailable();
+    }
+    [[nodiscard]] QAudio::Error Error() const override { return mAudioSource.error(); }
+
+    void OnStateChanged(std::function<void()> aCallback) override
+    {
+        // The source signals on its own thread, so this is a direct call
+        QObject::connect(&mAudioSource,
+                         &QAudioSource::stateChanged,
+                         &mAudioSource,
+                         [kCallback = std::move(aCallback)] { kCallback(); });
+    }
+
+  private:
+    QAudioSource mAudioSource;
+};
+// LCOV_EXCL_STOP
@@ -0,0 +1,271 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "adapters/scrub_device.h"
+#include "audio_types.h"
+#include <QIODevice>
+#include <QObject>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <metrics.h>
+#include <mutex>
+#include <sample_source.h>
+#include <span>
+#include <stop_token>
+#include <thread>
+
+namespace {
+
+/// @brief How often an idle prefetch thread checks for more source audio,
+/// such as a recording that is still growing
+constexpr std::chrono::milliseconds KIdlePoll{ 2 };
+
+constexpr int KMillisecondsPerSecond = 1000;
+
+int64_t
+NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+ScrubDevice::ScrubDevice(const ISampleSource& aSource, QObject* aParent)
+  : QIODevice(aParent)
+  , mSource(aSource)
+  , mChannels(aSource.GetChannelCount())
+  , mCrossfadeFrames(
+      std::max<size_t>(1, static_cast<size_t>(aSource.GetSampleRate()) * KCrossfadeMs /
+                            KMillisecondsPerSecond))
+  , mSeekToAudio(Metrics::GetHistogram(Metrics::KSeekToAudio))
+  , mRing(KRingBlocks)
+  , mFadeOut(mCrossfadeFrames * mChannels)
+  , mMix(KBlockFrames * mChannels)
+{
+}
+
+ScrubDevice::~ScrubDevice()
+{
+    Pause();
+}
+
+bool
+ScrubDevice::open(OpenMode aMode)
+{
+    if (aMode != QIODevice::ReadOnly) {
+        return false;
+    }
+    return QIODevice::open(aMode);
+}
+
+bool
+ScrubDevice::Seek(FrameIndex aFrame)
+{
+    if (aFrame.Get() > mSource.GetFrameCount().Get()) {
+        return false;
+    }
+    {
+        const std::scoped_lock kLock(mWakeMutex);
+        mSeekFrame.store(aFrame.Get(), std::memory_order_relaxed);
+        mSeekCrossfades.store(IsPlaying(), std::memory_order_relaxed);
+        mSeekTimeNs.store(NowNs(), std::memory_order_relaxed);
+        mSeekGeneration.fetch_add(1, std::memory_order_release);
+    }
+    mWake.notify_one();
+    return true;
+}
+
+bool
+ScrubDevice::Play(FrameIndex aFrame)
+{
+    if (!Seek(aFrame)) {
+        return false;
+    }
+    if (!mPrefetchThread.joinable()) {
+        mPrefetchThread =
+          std::jthread([this](const std::stop_token& aStopToken) { Prefetch(aStopToken); });
+    }
+    mPlaying.store(true, std::memory_order_release);
+    // Wakes a sink that went idle while paused
+    emit readyRead();
+    return true;
+}
+
+void
+ScrubDevice::Pause()
+{
+    mPlaying.store(false, std::memory_order_release);
+    if (mPrefetchThread.joinable()) {
+        mPrefetchThread.request_stop();
+        mPrefetchThread.join();
+    }
+}
+
+void
+ScrubDevice::Prefetch(const std::stop_token& aStopToken)
+{
+    uint64_t generation = 0;
+    size_t position = 0;
+    std::unique_lock lock(mWakeMutex);
+    while (!aStopToken.stop_requested()) {
+        const uint64_t kGeneration = mSeekGeneration.load(std::memory_order_acquire);
+        if (kGeneration != generation) {
+            generation = kGeneration;
+            position = mSeekFrame.load(std::memory_order_relaxed);
+        }
+
+        const size_t kAvailable = mSource.GetFrameCount().Get();
+        if (mRing.GetWriteAvailable() == 0 || position >= kAvailable) {
+            mWake.wait_for(lock, aStopToken, KIdlePoll, [&] {
+                return mSeekGeneration.load(std::memory_order_relaxed) != generation;
+            });
+            continue;
+        }
+
+        // Read without the lock, so a seek never waits for the source
+        lock.unlock();
+        const size_t kFrames = std::min(KBlockFrames, kAvailable - position);
+        mFillBlock.generation = generation;
+        mFillBlock.first = position;
+        mFillBlock.frames = kFrames;
+        for (ChannelCount ch = 0; ch < mChannels; ch++) {
+            const std::span<const float> kSamples =
+              mSource.GetSamples(ch, SampleIndex{ position }, SampleCount{ kFrames });
+            for (size_t i = 0; i < kFrames; i++) {
+                mFillBlock.samples[(i * mChannels) + ch] = kSamples[i];
+            }
+        }
+        mRing.Write(std::span(&mFillBlock, 1));
+        position += kFrames;
+        lock.lock();
+    }
+}
+
+qint64
+ScrubDevice::readData(char* aData, qint64 aMaxSize)
+{
+    if (aMaxSize < 0) {
+        return -1;
+    }
+    if (!IsPlaying()) {
+        return 0;
+    }
+
+    const size_t kBytesPerFrame = mChannels * sizeof(float);
+    size_t remaining = static_cast<size_t>(aMaxSize) / kBytesPerFrame;
+    size_t written = 0;
+    while (remaining > 0) {
+        const size_t kWanted = std::min(remaining, KBlockFrames);
+        const size_t kFrames = Render(std::span(mMix).first(kWanted * mChannels));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::memcpy(aData + written, mMix.data(), kFrames * kBytesPerFrame);
+        written += kFrames * kBytesPerFrame;
+        remaining -= kFrames;
+        if (kFrames < kWanted) {
+            break;
+        }
+    }
+    return static_cast<qint64>(written);
+}
+
+size_t
+ScrubDevice::Render(std::span<float> aOut)
+{
+    // A new seek: whatever was playing continues underneath, fading out.
+    // Starting from a pause just fades in.
+    const uint64_t kGeneration = mSeekGeneration.load(std::memory_order_acquire);
+    if (kGeneration != mFadeGeneration) {
+        mFadeGeneration = kGeneration;
+        mFadeOutOpen = mSeekCrossfades.load(std::memory_order_relaxed);
+        mFadeOutFrames = 0;
+        mFadeOutPosition = 0;
+        if (mBlockOffset < mBlock.frames && mBlock.generation == mPlayGeneration) {
+            AppendFadeOut(std::span<const float>(mBlock.samples)
+                            .subspan(mBlockOffset * mChannels,
+                                     (mBlock.frames - mBlockOffset) * mChannels));
+        }
+        mBlockOffset = mBlock.frames;
+    }
+
+    const float kFadeStep = 1.0f / static_cast<float>(mCrossfadeFrames);
+    const size_t kCapacity = aOut.size() / mChannels;
+    size_t frames = 0;
+    while (frames < kCapacity) {
+        const bool kHaveNew = mBlockOffset < mBlock.frames || NextBlock(kGeneration);
+        const bool kHaveOld = mFadeOutPosition < mFadeOutFrames;
+        if (!kHaveNew && !kHaveOld) {
+            break;
+        }
+
+        const float kInGain = std::min(static_cast<float>(mFadeInPosition) * kFadeStep, 1.0f);
+        const float kOutGain = 1.0f - (static_cast<float>(mFadeOutPosition) * kFadeStep);
+        for (size_t ch = 0; ch < mChannels; ch++) {
+            float sample = 0.0f;
+            if (kHaveNew) {
+                sample = mBlock.samples[(mBlockOffset * mChannels) + ch] * kInGain;
+            }
+            if (kHaveOld) {
+                sample += mFadeOut[(mFadeOutPosition * mChannels) + ch] * kOutGain;
+            }
+            aOut[(frames * mChannels) + ch] = sample;
+        }
+
+        if (kHaveNew) {
+            mBlockOffset++;
+            mFadeInPosition = std::min(mFadeInPosition + 1, mCrossfadeFrames);
+        }
+        if (kHaveOld) {
+            mFadeOutPosition++;
+        } else {
+            // Old audio arriving after this would restart a finished fade
+            mFadeOutOpen = false;
+        }
+        frames++;
+    }
+    return frames;
+}
+
+bool
+ScrubDevice::NextBlock(uint64_t aGeneration)
+{
+    while (mRing.Read(std::span(&mBlock, 1)) == 1) {
+        mBlockOffset = 0;
+        if (mBlock.generation >= aGeneration) {
+            if (mBlock.generation != mPlayGeneration) {
+                mPlayGeneration = mBlock.generation;
+                mFadeInPosition = 0;
+                const int64_t kLatencyNs = NowNs() - mSeekTimeNs.load(std::memory_order_relaxed);
+                mSeekToAudio.Record(static_cast<uint64_t>(std::max<int64_t>(kLatencyNs, 0)));
+            }
+            return true;
+        }
+
+        // Queued before the seek: what was playing continues into the fade-out,
+        // anything else was never heard
+        if (mBlock.generation == mPlayGeneration) {
+            AppendFadeOut(std::span<const float>(mBlock.samples).first(mBlock.frames * mChannels));
+        }
+    }
+    mBlock.frames = 0;
+    mBlockOffset = 0;
+    return false;
+}
+
+void
+ScrubDevice::AppendFadeOut(std::span<const float> aFrames)
+{
+    if (!mFadeOutOpen) {
+        return;
+    }
+    const size_t kFrames = std::min(aFrames.size() / mChannels, mCrossfadeFrames - mFadeOutFrames);
+    std::ranges::copy(aFrames.first(kFrames * mChannels),
+                      mFadeOut.begin() + static_cast<std::ptrdiff_t>(mFadeOutFrames * mChannels));
+    mFadeOutFrames += kFrames;
+}
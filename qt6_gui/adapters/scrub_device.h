@@ -0,0 +1,163 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "audio_types.h"
+#include "include/global_constants.h"
+#include <QIODevice>
+#include <QObject>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <mutex>
+#include <sample_source.h>
+#include <span>
+#include <spsc_ring.h>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/// @brief A seekable QIODevice for a sink that stays open, for playback and scrubbing
+///
+/// A prefetch thread reads the source ahead of the play position and hands
+/// interleaved blocks to the sink's thread through a small lock-free ring, so
+/// readData() never waits on the source, however slow it is to page in.  Each
+/// block is tagged with the seek it belongs to.  After Seek(), the sink's
+/// thread drops blocks queued for earlier seeks and crossfades from the old
+/// audio to the new over KCrossfadeMs, so jumping around doesn't click.
+///
+/// The time from Seek() to the first new frame leaving readData() is recorded
+/// in the Metrics::KSeekToAudio histogram.  That excludes the sink's own
+/// buffer, which the device can't see.
+///
+/// Seek(), Play() and Pause() are for the owner's thread; readData() is for
+/// the sink's.  The source must not be reset while playing: Pause() first.
+class ScrubDevice : public QIODevice
+{
+    Q_OBJECT
+
+  public:
+    static constexpr size_t KBlockFrames = 256; ///< Frames prefetched at a time
+    static constexpr size_t KRingBlocks = 8;    ///< Blocks queued ahead of the sink
+    static constexpr int KCrossfadeMs = 5;      ///< Length of the fade at a seek
+
+    /// @brief Constructor
+    /// @param aSource Source to play; its channel count and sample rate are
+    /// fixed for the life of the device
+    /// @param aParent Qt parent object (optional)
+    explicit ScrubDevice(const ISampleSource& aSource, QObject* aParent = nullptr);
+
+    /// @brief Destructor.  Stops the prefetch thread.
+    ~ScrubDevice() override;
+
+    ScrubDevice(const ScrubDevice&) = delete;
+    ScrubDevice& operator=(const ScrubDevice&) = delete;
+    ScrubDevice(ScrubDevice&&) = delete;
+    ScrubDevice& operator=(ScrubDevice&&) = delete;
+
+    /// @brief Open the device.
+    /// @param aMode Open mode.  Only QIODevice::ReadOnly is supported.
+    [[nodiscard]] bool open(OpenMode aMode) override;
+
+    /// @brief The device is a stream; it has no byte positions.
+    [[nodiscard]] bool isSequential() const override { return true; }
+
+    /// @brief Move the play position
+    /// @param aFrame Frame to play next
+    /// @return false if aFrame is past the end of the source
+    [[nodiscard]] bool Seek(FrameIndex aFrame);
+
+    /// @brief Seek and start delivering audio, starting the prefetch thread if needed
+    /// @param aFrame Frame to play next
+    /// @return false if aFrame is past the end of the source
+    [[nodiscard]] bool Play(FrameIndex aFrame);
+
+    /// @brief Stop delivering audio and stop the prefetch thread
+    void Pause();
+
+    /// @brief Check whether audio is being delivered
+    [[nodiscard]] bool IsPlaying() const { return mPlaying.load(std::memory_order_acquire); }
+
+  protected:
+    /// @brief Deliver interleaved audio.  Sink thread only.
+    /// @param aData Destination for interleaved float frames
+    /// @param aMaxSize Bytes wanted; rounded down to whole frames
+    /// @return Bytes delivered: fewer than asked if the prefetch thread is
+    /// behind or the source has ended, and 0 while paused
+    [[nodiscard]] qint64 readData(char* aData, qint64 aMaxSize) override;
+
+    /// @brief writeData is required for the QIODevice interface
+    /// @note Not implemented because this device is read-only.
+    [[nodiscard]] qint64 writeData(const char* /*aData*/, qint64 /*aMaxSize*/) override
+    {
+        return -1;
+    }
+
+  private:
+    /// @brief Interleaved frames prefetched for one seek
+    struct Block
+    {
+        uint64_t generation = 0; // Seek the block belongs to
+        size_t first = 0;        // Source frame of the first sample
+        size_t frames = 0;
+        std::array<float, KBlockFrames * GKMaxChannels> samples{};
+    };
+
+    /// @brief Prefetch thread body
+    void Prefetch(const std::stop_token& aStopToken);
+
+    /// @brief Mix the next frames into a buffer.  Sink thread only.
+    /// @param aOut Interleaved destination
+    /// @return Frames written
+    size_t Render(std::span<float> aOut);
+
+    /// @brief Take the next queued block for the current seek.  Sink thread only.
+    /// @param aGeneration Current seek
+    /// @return false if none is queued yet
+    bool NextBlock(uint64_t aGeneration);
+
+    /// @brief Keep the audio that would have followed, to fade it out.  Sink thread only.
+    /// @param aFrames Interleaved frames of the audio playing before the seek
+    void AppendFadeOut(std::span<const float> aFrames);
+
+    const ISampleSource& mSource;
+    const size_t mChannels;
+    const size_t mCrossfadeFrames;
+    Metrics::Histogram& mSeekToAudio;
+
+    SpscRing<Block> mRing;
+    std::atomic<bool> mPlaying{ false };
+
+    // Written by Seek(), read by both threads.  The frame and time are stored
+    // before the generation is published.
+    std::atomic<uint64_t> mSeekGeneration{ 0 };
+    std::atomic<size_t> mSeekFrame{ 0 };
+    std::atomic<int64_t> mSeekTimeNs{ 0 };
+    std::atomic<bool> mSeekCrossfades{ false }; // Seek made while playing
+
+    // Wakes the prefetch thread for a seek
+    std::mutex mWakeMutex;
+    std::condition_variable_any mWake;
+
+    // Prefetch thread only
+    Block mFillBlock;
+
+    // Sink thread only
+    Block mBlock;                 // Block being played
+    size_t mBlockOffset = 0;      // Frames of mBlock already played
+    uint64_t mPlayGeneration = 0; // Seek of the audio being played
+    uint64_t mFadeGeneration = 0; // Seek the fade-out was taken for
+    size_t mFadeInPosition = 0;
+    std::vector<float> mFadeOut; // Interleaved; allocated once
+    size_t mFadeOutFrames = 0;
+    size_t mFadeOutPosition = 0;
+    bool mFadeOutOpen = false; // More old audio may still be appended
+    std::vector<float> mMix;   // Interleaved scratch for readData()
+
+    std::jthread mPrefetchThread;
+};
@@ -0,0 +1,83 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "adapters/audio_buffer_qiodevice.h"
+#include "bench_utils.h"
+#include "include/global_constants.h"
+#include "models/audio_buffer.h"
+#include <QIODevice>
+#include <audio_types.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr SampleRate KSampleRate = 48000;
+
+/// @brief Exposes readData(), which QIODevice::read() would wrap in its own
+/// buffering
+class ExposedAudioBufferQIODevice : public AudioBufferQIODevice
+{
+  public:
+    using AudioBufferQIODevice::AudioBufferQIODevice;
+    using AudioBufferQIODevice::readData;
+};
+
+} // namespace
+
+TEST_CASE("AudioBuffer::AddSamples", "[benchmark][audio_buffer]")
+{
+    // About 20 ms at 48 kHz, a typical capture callback
+    constexpr size_t kFramesPerCall = 1024;
+    // Restart the buffer past this size so memory use stays bounded however
+    // many iterations Catch2 chooses.  The amortized cost is negligible.
+    constexpr FrameCount kMaxFrames{ size_t{ 1 } << 20 };
+
+    for (ChannelCount channels = 1; channels <= GKMaxChannels; channels++) {
+        const auto kInterleaved = MakeNoise(kFramesPerCall * channels);
+        AudioBuffer buffer;
+        buffer.Reset(channels, KSampleRate);
+
+        const std::string kName =
+          std::format("AudioBuffer::AddSamples {} frames x {} ch", kFramesPerCall, channels);
+        BENCHMARK(kName)
+        {
+            if (buffer.GetFrameCount() > kMaxFrames) {
+                buffer.Reset(channels, KSampleRate);
+            }
+            buffer.AddSamples(kInterleaved);
+        };
+    }
+}
+
+TEST_CASE("AudioBufferQIODevice::readData", "[benchmark][audio_buffer]")
+{
+    constexpr ChannelCount kChannels = 2;
+    constexpr size_t kFrames = size_t{ 10 } * KSampleRate;
+    // 4096 stereo frames, the chunk size a QAudioSink typically pulls
+    constexpr size_t kReadFrames = 4096;
+
+    AudioBuffer buffer;
+    buffer.Reset(kChannels, KSampleRate);
+    buffer.AddSamples(MakeNoise(kFrames * kChannels));
+
+    ExposedAudioBufferQIODevice device(buffer);
+    REQUIRE(device.open(QIODevice::ReadOnly));
+    std::vector<char> output(kReadFrames * buffer.GetBytesPerFrame());
+    const auto kReadBytes = static_cast<qint64>(output.size());
+
+    const std::string kName =
+      std::format("AudioBufferQIODevice::readData {} frames x {} ch", kReadFrames, kChannels);
+    BENCHMARK(kName)
+    {
+        if (device.readData(output.data(), kReadBytes) < kReadBytes) {
+            (void)device.SeekFrame(FrameIndex{ 0 });
+        }
+        return output[0];
+    };
+}
@@ -0,0 +1,132 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "bench_baseline.h"
+#include "bench_results.h"
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QJsonValue>
+#include <QString>
+#include <expected>
+#include <format>
+#include <string>
+#include <vector>
+
+BenchBaseline::BenchBaseline(const QJsonObject& aDocument)
+  : mDefaultTolerance(aDocument["default_tolerance"].toDouble(KDefaultTolerance))
+{
+    for (const QJsonValue& kValue : aDocument["benchmarks"].toArray()) {
+        const QJsonObject kObject = kValue.toObject();
+        const BenchmarkResult kResult = BenchResults::FromJson(kObject);
+        if (kObject.contains("tolerance")) {
+            mTolerances[kResult.name] = kObject["tolerance"].toDouble();
+        }
+        mResults[kResult.name] = kResult;
+    }
+}
+
+std::expected<BenchBaseline, std::string>
+BenchBaseline::Load(const std::string& aPath)
+{
+    QFile file(QString::fromStdString(aPath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::unexpected(
+          std::format("Failed to open {}: {}", aPath, file.errorString().toStdString()));
+    }
+
+    QJsonParseError error{};
+    const QJsonDocument kDocument = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !kDocument.isObject()) {
+        return std::unexpected(
+          std::format("Failed to parse {}: {}", aPath, error.errorString().toStdString()));
+    }
+    return BenchBaseline(kDocument.object());
+}
+
+std::expected<void, std::string>
+BenchBaseline::Write(const std::string& aPath, const std::vector<BenchmarkResult>& aResults)
+{
+    // Hand-tuned tolerances survive re-recording
+    BenchBaseline previous{ QJsonObject{} };
+    if (QFile::exists(QString::fromStdString(aPath))) {
+        auto loaded = Load(aPath);
+        if (!loaded) {
+            return std::unexpected(loaded.error());
+        }
+        previous = *loaded;
+    }
+
+    QJsonObject document = BenchResults::ToDocument(aResults);
+    document["default_tolerance"] = previous.mDefaultTolerance;
+    QJsonArray benchmarks;
+    for (const BenchmarkResult& kResult : aResults) {
+        QJsonObject benchmark = BenchResults::ToJson(kResult);
+        const auto kToleranceIt = previous.mTolerances.find(kResult.name);
+        if (kToleranceIt != previous.mTolerances.end()) {
+            benchmark["tolerance"] = kToleranceIt->second;
+        }
+        benchmarks.append(benchmark);
+    }
+    document["benchmarks"] = benchmarks;
+
+    QFile file(QString::fromStdString(aPath));
+    const QByteArray kJson = QJsonDocument(document).toJson();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(kJson) != kJson.size()) {
+        return std::unexpected(std::format("Failed to write {}", aPath));
+    }
+    return {};
+}
+
+std::vector<BenchBaseline::Comparison>
+BenchBaseline::Compare(const std::vector<BenchmarkResult>& aResults) const
+{
+    std::vector<Comparison> comparisons;
+    comparisons.reserve(aResults.size());
+    for (const BenchmarkResult& kCurrent : aResults) {
+        Comparison comparison{ .name = kCurrent.name,
+                               .current_median_ns = kCurrent.median_ns,
+                               .tolerance = GetTolerance(kCurrent.name) };
+
+        const auto kBaselineIt = mResults.find(kCurrent.name);
+        if (kBaselineIt == mResults.end() || kBaselineIt->second.median_ns <= 0) {
+            comparisons.push_back(comparison);
+            continue;
+        }
+
+        const double kBaselineMedian = kBaselineIt->second.median_ns;
+        comparison.baseline_median_ns = kBaselineMedian;
+        comparison.change = (kCurrent.median_ns - kBaselineMedian) / kBaselineMedian;
+        if (kCurrent.median_low_ns > kBaselineMedian * (1.0 + comparison.tolerance)) {
+            comparison.verdict = Verdict::Regression;
+        } else if (kCurrent.median_high_ns < kBaselineMedian * (1.0 - comparison.tolerance)) {
+            comparison.verdict = Verdict::Improvement;
+        } else {
+            comparison.verdict = Verdict::Unchanged;
+        }
+        comparisons.push_back(comparison);
+    }
+    return comparisons;
+}
+
+void
+BenchBaseline::ApplyTolerances(const BenchBaseline& aTolerances)
+{
+    mDefaultTolerance = aTolerances.mDefaultTolerance;
+    for (const auto& [kName, kTolerance] : aTolerances.mTolerances) {
+        mTolerances[kName] = kTolerance;
+    }
+}
+
+double
+BenchBaseline::GetTolerance(const std::string& aName) const
+{
+    const auto kIt = mTolerances.find(aName);
+    return kIt == mTolerances.end() ? mDefaultTolerance : kIt->second;
+}
@@ -0,0 +1,110 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "bench_results.h"
+#include <QJsonObject>
+#include <array>
+#include <expected>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief Recorded benchmark results to compare new runs against
+///
+/// The baseline file is a benchjson document (see BenchJsonReporter) with two
+/// optional additions:
+///
+///     {
+///       "default_tolerance": 0.10,
+///       "benchmarks": [ { "name": ..., "median_ns": ..., "tolerance": 0.25 } ]
+///     }
+///
+/// A tolerance is the fractional slowdown accepted before a change counts as
+/// a regression.  Entries without their own use the default.  Benchmarks are
+/// matched by name.
+///
+/// Medians are only comparable on one machine, so they are recorded outside
+/// the source tree, and the checked-in file holds only tolerances, applied
+/// over the recorded ones with ApplyTolerances().
+class BenchBaseline
+{
+  public:
+    /// @brief Tolerance used when the baseline does not specify one
+    static constexpr double KDefaultTolerance = 0.10;
+
+    /// @brief Outcome of comparing one benchmark
+    enum class Verdict
+    {
+        Unchanged,
+        Regression,
+        Improvement,
+        New,
+    };
+
+    static constexpr std::array<std::pair<Verdict, std::string_view>, 4> VerdictNames{ {
+      { Verdict::Unchanged, "ok" },
+      { Verdict::Regression, "REGRESSION" },
+      { Verdict::Improvement, "improved" },
+      { Verdict::New, "new" },
+    } };
+
+    /// @brief One row of a comparison report
+    struct Comparison
+    {
+        std::string name;
+        Verdict verdict{ Verdict::New };
+        double baseline_median_ns{};
+        double current_median_ns{};
+        /// Relative change of the median, e.g. 0.05 for 5% slower
+        double change{};
+        double tolerance{};
+    };
+
+    /// @brief Construct from a parsed baseline document
+    explicit BenchBaseline(const QJsonObject& aDocument);
+
+    /// @brief Read a baseline file
+    /// @param aPath Path to the JSON file
+    /// @return The baseline, or an error message if it can't be read or parsed
+    [[nodiscard]] static std::expected<BenchBaseline, std::string> Load(const std::string& aPath);
+
+    /// @brief Write results as a new baseline
+    /// @param aPath Path to the JSON file.  If it already exists, its default
+    /// and per-benchmark tolerances are carried over.
+    /// @param aResults Results to record
+    /// @return Error message on failure
+    [[nodiscard]] static std::expected<void, std::string> Write(
+      const std::string& aPath,
+      const std::vector<BenchmarkResult>& aResults);
+
+    /// @brief Compare results against the baseline
+    /// @param aResults Results of the current run
+    /// @return One comparison per result, in the same order
+    ///
+    /// A benchmark regresses only if the lower bound of its current median's
+    /// confidence interval exceeds the baseline median by more than the
+    /// tolerance, so run-to-run noise within the interval is never reported.
+    /// Improvements are the mirror image.  Benchmarks missing from the
+    /// baseline, or recorded without a median, are New; spectro_bench fails
+    /// the check if there are any, since they weren't compared.
+    [[nodiscard]] std::vector<Comparison> Compare(
+      const std::vector<BenchmarkResult>& aResults) const;
+
+    /// @brief Use another baseline's tolerances instead of this one's
+    /// @param aTolerances Baseline whose default and per-benchmark tolerances
+    /// take precedence, such as the checked-in tolerances file
+    void ApplyTolerances(const BenchBaseline& aTolerances);
+
+    /// @brief Get the tolerance that applies to a benchmark
+    /// @param aName Benchmark name
+    [[nodiscard]] double GetTolerance(const std::string& aName) const;
+
+  private:
+    double mDefaultTolerance{ KDefaultTolerance };
+    std::map<std::string, BenchmarkResult> mResults;
+    std::map<std::string, double> mTolerances;
+};
@@ -0,0 +1,117 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "bench_utils.h"
+#include "models/settings.h"
+#include <audio_types.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <distortion_meter.h>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <format>
+#include <level_histogram.h>
+#include <noise_floor_estimator.h>
+#include <numbers>
+#include <peak_tracker.h>
+#include <span>
+#include <vector>
+
+TEST_CASE("FFTProcessor::ComputeDecibels", "[benchmark][fft]")
+{
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        const FFTProcessor kProcessor(kSize);
+        const auto kSamples = MakeNoise(kSize);
+
+        BENCHMARK(std::format("FFTProcessor::ComputeDecibels {}", kSize.Get()))
+        {
+            return kProcessor.ComputeDecibels(std::span(kSamples));
+        };
+    }
+}
+
+TEST_CASE("FFTWindow::Apply", "[benchmark][fft]")
+{
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        const FFTWindow kWindow(kSize, FFTWindow::Type::Hann);
+        const auto kSamples = MakeNoise(kSize);
+
+        BENCHMARK(std::format("FFTWindow::Apply Hann {}", kSize.Get()))
+        {
+            return kWindow.Apply(kSamples);
+        };
+    }
+}
+
+TEST_CASE("PeakTracker::Update", "[benchmark][fft]")
+{
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        const FFTProcessor kProcessor(kSize);
+        const auto kSamples = MakeNoise(kSize);
+        const std::vector<float> kDecibels = kProcessor.ComputeDecibels(std::span(kSamples));
+        PeakTracker tracker;
+
+        BENCHMARK(std::format("PeakTracker::Update {}", kSize.Get()))
+        {
+            tracker.Update(kDecibels);
+            tracker.ClearFinishedTracks();
+            return tracker.GetTracks().size();
+        };
+    }
+}
+
+TEST_CASE("NoiseFloorEstimator::Update", "[benchmark][fft]")
+{
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        const FFTProcessor kProcessor(kSize);
+        const auto kSamples = MakeNoise(kSize);
+        const std::vector<float> kDecibels = kProcessor.ComputeDecibels(std::span(kSamples));
+        NoiseFloorEstimator estimator;
+
+        BENCHMARK(std::format("NoiseFloorEstimator::Update {}", kSize.Get()))
+        {
+            estimator.Update(kDecibels);
+            return estimator.GetFloor().front();
+        };
+    }
+}
+
+TEST_CASE("LevelHistogram::Add", "[benchmark][fft]")
+{
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        const FFTProcessor kProcessor(kSize);
+        const auto kSamples = MakeNoise(kSize);
+        const std::vector<float> kDecibels = kProcessor.ComputeDecibels(std::span(kSamples));
+        LevelHistogram histogram({ .half_life_rows = 100.0f });
+
+        BENCHMARK(std::format("LevelHistogram::Add {}", kSize.Get()))
+        {
+            histogram.Add(kDecibels);
+            histogram.Age();
+            return histogram.GetQuantile(0.05);
+        };
+    }
+}
+
+TEST_CASE("DistortionMeter::Measure", "[benchmark][fft]")
+{
+    // A 997 Hz tone about 80 dB above the noise, as from a sweep
+    constexpr int kSampleRate = 48000;
+    for (const FFTSize kSize : Settings::KValidFFTSizes) {
+        DistortionMeter meter(kSampleRate, { .block_frames = kSize });
+        std::vector<float> samples = MakeNoise(kSize);
+        for (size_t i = 0; i < samples.size(); i++) {
+            const double kPhase =
+              2.0 * std::numbers::pi * 997.0 * static_cast<double>(i) / kSampleRate;
+            samples[i] = static_cast<float>(std::sin(kPhase) + (1e-3 * samples[i]));
+        }
+
+        BENCHMARK(std::format("DistortionMeter::Measure {}", kSize.Get()))
+        {
+            return meter.Measure(samples).thd_n_decibels;
+        };
+    }
+}
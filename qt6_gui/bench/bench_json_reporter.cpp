@@ -0,0 +1,48 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "bench_json_reporter.h"
+#include "bench_results.h"
+#include <QJsonDocument>
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include <string>
+#include <utility>
+
+CATCH_REGISTER_REPORTER("benchjson", BenchJsonReporter)
+
+BenchJsonReporter::BenchJsonReporter(Catch::ReporterConfig&& aConfig)
+  : StreamingReporterBase(std::move(aConfig))
+{
+    m_preferences.shouldReportAllAssertions = false;
+}
+
+std::string
+BenchJsonReporter::getDescription()
+{
+    return "Writes benchmark results as a JSON document";
+}
+
+void
+BenchJsonReporter::testCaseStarting(const Catch::TestCaseInfo& aTestInfo)
+{
+    StreamingReporterBase::testCaseStarting(aTestInfo);
+    mTestCaseName = aTestInfo.name;
+}
+
+void
+BenchJsonReporter::benchmarkEnded(const Catch::BenchmarkStats<>& aStats)
+{
+    mBenchmarks.push_back(BenchResults::FromStats(aStats, mTestCaseName));
+}
+
+void
+BenchJsonReporter::testRunEnded(const Catch::TestRunStats& aStats)
+{
+    StreamingReporterBase::testRunEnded(aStats);
+    m_stream << QJsonDocument(BenchResults::ToDocument(mBenchmarks)).toJson().toStdString();
+    m_stream.flush();
+}
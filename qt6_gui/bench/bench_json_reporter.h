@@ -0,0 +1,46 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "bench_results.h"
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include <string>
+#include <vector>
+
+/// @brief Catch2 reporter that writes benchmark results as JSON
+///
+/// Selected with `--reporter benchjson::out=<file>`, usually alongside the
+/// console reporter.  Writes one document at the end of the run:
+///
+///     {
+///       "context": { "date", "host", "cpu_count", "build_type" },
+///       "benchmarks": [
+///         { "name", "test_case", "samples", "iterations",
+///           "mean_ns", "mean_low_ns", "mean_high_ns", "std_dev_ns",
+///           "outlier_variance", "median_ns", "median_low_ns",
+///           "median_high_ns" }
+///       ]
+///     }
+///
+/// See BenchmarkResult for the meaning of each field.
+class BenchJsonReporter : public Catch::StreamingReporterBase
+{
+  public:
+    /// @brief Constructor
+    /// @param aConfig Reporter configuration from Catch2
+    explicit BenchJsonReporter(Catch::ReporterConfig&& aConfig);
+
+    /// @brief Description shown by --list-reporters
+    static std::string getDescription();
+
+    void testCaseStarting(const Catch::TestCaseInfo& aTestInfo) override;
+    void benchmarkEnded(const Catch::BenchmarkStats<>& aStats) override;
+    void testRunEnded(const Catch::TestRunStats& aStats) override;
+
+  private:
+    std::string mTestCaseName;
+    std::vector<BenchmarkResult> mBenchmarks;
+};
@@ -0,0 +1,153 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+// Catch2 main for spectro_bench.  Adds baseline options on top of the usual
+// Catch2 command line:
+//
+//   --baseline <file>        compare results against a baseline and exit
+//                            non-zero on any regression, or if any benchmark
+//                            has no baseline median to compare with
+//   --tolerances <file>      take the comparison's tolerances from this file
+//                            instead of the baseline
+//   --write-baseline <file>  record results as a new baseline
+
+#define CATCH_CONFIG_RUNNER
+#include "bench_baseline.h"
+#include "bench_results.h"
+#include <QApplication>
+#include <algorithm>
+#include <catch2/catch_session.hpp>
+#include <cstdio>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief Format a duration in nanoseconds with a readable unit
+std::string
+FormatDuration(double aNanoseconds)
+{
+    if (aNanoseconds >= 1e6) {
+        return std::format("{:.2f} ms", aNanoseconds / 1e6);
+    }
+    if (aNanoseconds >= 1e3) {
+        return std::format("{:.2f} us", aNanoseconds / 1e3);
+    }
+    return std::format("{:.1f} ns", aNanoseconds);
+}
+
+/// @brief Print a comparison report
+/// @return true if nothing regressed and every benchmark had a baseline median
+bool
+PrintReport(const std::string& aBaselinePath,
+            const std::vector<BenchBaseline::Comparison>& aComparisons)
+{
+    std::println("\nComparison against {}:", aBaselinePath);
+    int regressions = 0;
+    int unrecorded = 0;
+    for (const BenchBaseline::Comparison& kComparison : aComparisons) {
+        const auto kVerdictIt =
+          std::ranges::find(BenchBaseline::VerdictNames,
+                            kComparison.verdict,
+                            &std::pair<BenchBaseline::Verdict, std::string_view>::first);
+        if (kComparison.verdict == BenchBaseline::Verdict::New) {
+            unrecorded++;
+            std::println("  {:<10}  {}  {}",
+                         kVerdictIt->second,
+                         kComparison.name,
+                         FormatDuration(kComparison.current_median_ns));
+            continue;
+        }
+        if (kComparison.verdict == BenchBaseline::Verdict::Regression) {
+            regressions++;
+        }
+        std::println("  {:<10}  {}  {} -> {} ({:+.1f}%, tolerance {:.0f}%)",
+                     kVerdictIt->second,
+                     kComparison.name,
+                     FormatDuration(kComparison.baseline_median_ns),
+                     FormatDuration(kComparison.current_median_ns),
+                     kComparison.change * 100.0,
+                     kComparison.tolerance * 100.0);
+    }
+    std::println("{} regression(s) in {} benchmark(s)", regressions, aComparisons.size());
+
+    // A benchmark with nothing to compare against can't regress, so an empty
+    // baseline would otherwise always pass
+    if (unrecorded > 0) {
+        std::println(stderr,
+                     "Error: {} benchmark(s) have no median in {}, so they were not checked.  "
+                     "Record a baseline on this machine with `make bench-baseline`.",
+                     unrecorded,
+                     aBaselinePath);
+    }
+    return regressions == 0 && unrecorded == 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    QApplication const app(argc, argv);
+
+    Catch::Session session;
+    std::string baselinePath;
+    std::string tolerancesPath;
+    std::string writeBaselinePath;
+    using Catch::Clara::Opt;
+    session.cli(session.cli() |
+                Opt(baselinePath, "file")["--baseline"](
+                  "compare results against a baseline JSON file") |
+                Opt(tolerancesPath, "file")["--tolerances"](
+                  "take tolerances from this JSON file instead of the baseline") |
+                Opt(writeBaselinePath, "file")["--write-baseline"](
+                  "write results as a new baseline JSON file"));
+
+    const int kParseResult = session.applyCommandLine(argc, argv);
+    if (kParseResult != 0) {
+        return kParseResult;
+    }
+
+    const int kRunResult = session.run();
+    if (kRunResult != 0) {
+        return kRunResult;
+    }
+
+    const auto& kResults = BenchResults::Collected();
+    if (!writeBaselinePath.empty()) {
+        const auto kWritten = BenchBaseline::Write(writeBaselinePath, kResults);
+        if (!kWritten) {
+            std::println(stderr, "Error: {}", kWritten.error());
+            return 1;
+        }
+        std::println("Baseline written to {}", writeBaselinePath);
+    }
+
+    if (!baselinePath.empty()) {
+        auto baseline = BenchBaseline::Load(baselinePath);
+        if (!baseline) {
+            std::println(stderr,
+                         "Error: {}.  Record a baseline on this machine with "
+                         "`make bench-baseline`.",
+                         baseline.error());
+            return 1;
+        }
+        if (!tolerancesPath.empty()) {
+            const auto kTolerances = BenchBaseline::Load(tolerancesPath);
+            if (!kTolerances) {
+                std::println(stderr, "Error: {}", kTolerances.error());
+                return 1;
+            }
+            baseline->ApplyTolerances(*kTolerances);
+        }
+        if (!PrintReport(baselinePath, baseline->Compare(kResults))) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "bench_results.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QSysInfo>
+#include <Qt>
+#include <algorithm>
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SPECTRO_BENCH_BUILD_TYPE
+#define SPECTRO_BENCH_BUILD_TYPE ""
+#endif
+
+namespace {
+
+/// @brief Feeds BenchResults::Collected()
+class BenchResultCollector : public Catch::EventListenerBase
+{
+  public:
+    using Catch::EventListenerBase::EventListenerBase;
+
+    void testCaseStarting(const Catch::TestCaseInfo& aTestInfo) override
+    {
+        mTestCaseName = aTestInfo.name;
+    }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& aStats) override
+    {
+        BenchResults::Collected().push_back(BenchResults::FromStats(aStats, mTestCaseName));
+    }
+
+  private:
+    std::string mTestCaseName;
+};
+
+} // namespace
+
+CATCH_REGISTER_LISTENER(BenchResultCollector)
+
+BenchmarkResult
+BenchResults::FromStats(const Catch::BenchmarkStats<>& aStats, const std::string& aTestCase)
+{
+    std::vector<double> samples;
+    samples.reserve(aStats.samples.size());
+    for (const auto& kSample : aStats.samples) {
+        samples.push_back(kSample.count());
+    }
+    const MedianEstimate kMedian = EstimateMedian(samples);
+
+    return { .name = aStats.info.name,
+             .test_case = aTestCase,
+             .samples = aStats.info.samples,
+             .iterations = aStats.info.iterations,
+             .mean_ns = aStats.mean.point.count(),
+             .mean_low_ns = aStats.mean.lower_bound.count(),
+             .mean_high_ns = aStats.mean.upper_bound.count(),
+             .std_dev_ns = aStats.standardDeviation.point.count(),
+             .outlier_variance = aStats.outlierVariance,
+             .median_ns = kMedian.point,
+             .median_low_ns = kMedian.lower_bound,
+             .median_high_ns = kMedian.upper_bound };
+}
+
+BenchResults::MedianEstimate
+BenchResults::EstimateMedian(std::span<const double> aSamples)
+{
+    if (aSamples.empty()) {
+        return {};
+    }
+
+    std::vector<double> sorted(aSamples.begin(), aSamples.end());
+    std::ranges::sort(sorted);
+    const size_t kCount = sorted.size();
+    const size_t kMiddle = kCount / 2;
+    const double kMedian =
+      kCount % 2 == 1 ? sorted[kMiddle] : (sorted[kMiddle - 1] + sorted[kMiddle]) / 2.0;
+
+    // 95% two-sided, normal approximation to Binomial(n, 0.5)
+    constexpr double kZ = 1.96;
+    const double kHalfWidth = kZ * std::sqrt(static_cast<double>(kCount)) / 2.0;
+    const double kHalf = static_cast<double>(kCount) / 2.0;
+    const auto kLowRank = static_cast<ptrdiff_t>(std::floor(kHalf - kHalfWidth));
+    const auto kHighRank = static_cast<ptrdiff_t>(std::ceil(kHalf + kHalfWidth));
+    const auto kLast = static_cast<ptrdiff_t>(kCount - 1);
+
+    return { .point = kMedian,
+             .lower_bound = sorted[static_cast<size_t>(std::clamp<ptrdiff_t>(kLowRank, 0, kLast))],
+             .upper_bound =
+               sorted[static_cast<size_t>(std::clamp<ptrdiff_t>(kHighRank, 0, kLast))] };
+}
+
+QJsonObject
+BenchResults::ToJson(const BenchmarkResult& aResult)
+{
+    QJsonObject object;
+    object["name"] = QString::fromStdString(aResult.name);
+    object["test_case"] = QString::fromStdString(aResult.test_case);
+    object["samples"] = aResult.samples;
+    object["iterations"] = aResult.iterations;
+    object["mean_ns"] = aResult.mean_ns;
+    object["mean_low_ns"] = aResult.mean_low_ns;
+    object["mean_high_ns"] = aResult.mean_high_ns;
+    object["std_dev_ns"] = aResult.std_dev_ns;
+    object["outlier_variance"] = aResult.outlier_variance;
+    object["median_ns"] = aResult.median_ns;
+    object["median_low_ns"] = aResult.median_low_ns;
+    object["median_high_ns"] = aResult.median_high_ns;
+    return object;
+}
+
+BenchmarkResult
+BenchResults::FromJson(const QJsonObject& aObject)
+{
+    return { .name = aObject["name"].toString().toStdString(),
+             .test_case = aObject["test_case"].toString().toStdString(),
+             .samples = aObject["samples"].toInt(),
+             .iterations = aObject["iterations"].toInt(),
+             .mean_ns = aObject["mean_ns"].toDouble(),
+             .mean_low_ns = aObject["mean_low_ns"].toDouble(),
+             .mean_high_ns = aObject["mean_high_ns"].toDouble(),
+             .std_dev_ns = aObject["std_dev_ns"].toDouble(),
+             .outlier_variance = aObject["outlier_variance"].toDouble(),
+             .median_ns = aObject["median_ns"].toDouble(),
+             .median_low_ns = aObject["median_low_ns"].toDouble(),
+             .median_high_ns = aObject["median_high_ns"].toDouble() };
+}
+
+QJsonObject
+BenchResults::ToDocument(const std::vector<BenchmarkResult>& aResults)
+{
+    QJsonObject context;
+    context["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    context["host"] = QSysInfo::machineHostName();
+    context["cpu_count"] = static_cast<int>(std::thread::hardware_concurrency());
+    context["build_type"] = SPECTRO_BENCH_BUILD_TYPE;
+
+    QJsonArray benchmarks;
+    for (const BenchmarkResult& kResult : aResults) {
+        benchmarks.append(ToJson(kResult));
+    }
+
+    QJsonObject document;
+    document["context"] = context;
+    document["benchmarks"] = benchmarks;
+    return document;
+}
+
+std::vector<BenchmarkResult>&
+BenchResults::Collected()
+{
+    static std::vector<BenchmarkResult> results;
+    return results;
+}
@@ -0,0 +1,79 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <QJsonObject>
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief Summary of one benchmark, as written to and read from JSON
+///
+/// All times are per iteration, in nanoseconds.  The mean comes from Catch2's
+/// bootstrap analysis.  The median and its confidence interval are computed
+/// from the raw samples, and are what baseline comparisons use: the median is
+/// robust to the occasional preempted sample that skews the mean.
+struct BenchmarkResult
+{
+    std::string name;
+    std::string test_case;
+    int samples{};
+    int iterations{};
+    double mean_ns{};
+    double mean_low_ns{};
+    double mean_high_ns{};
+    double std_dev_ns{};
+    double outlier_variance{};
+    double median_ns{};
+    double median_low_ns{};
+    double median_high_ns{};
+};
+
+/// @brief Conversions between Catch2 statistics, BenchmarkResult and JSON
+class BenchResults
+{
+  public:
+    /// @brief A median with a distribution-free confidence interval
+    struct MedianEstimate
+    {
+        double point{};
+        double lower_bound{};
+        double upper_bound{};
+    };
+
+    /// @brief Summarize a finished benchmark
+    /// @param aStats Statistics from Catch2
+    /// @param aTestCase Name of the enclosing test case
+    static BenchmarkResult FromStats(const Catch::BenchmarkStats<>& aStats,
+                                     const std::string& aTestCase);
+
+    /// @brief Estimate the median of a set of samples with a 95% confidence
+    /// interval
+    /// @param aSamples Samples, in any order
+    /// @return Median and the order statistics bounding it.  All zero if
+    /// aSamples is empty.
+    ///
+    /// The interval bounds are the samples at ranks n/2 -/+ 1.96 sqrt(n)/2,
+    /// the normal approximation to the binomial distribution of the number of
+    /// samples below the true median.  No assumption is made about the shape
+    /// of the timing distribution.
+    static MedianEstimate EstimateMedian(std::span<const double> aSamples);
+
+    /// @brief Serialize a result
+    static QJsonObject ToJson(const BenchmarkResult& aResult);
+
+    /// @brief Deserialize a result.  Missing fields are left at zero.
+    static BenchmarkResult FromJson(const QJsonObject& aObject);
+
+    /// @brief Build a complete results document with the run context
+    /// @param aResults Results in run order
+    static QJsonObject ToDocument(const std::vector<BenchmarkResult>& aResults);
+
+    /// @brief Results collected from every benchmark in this process
+    ///
+    /// Filled by a Catch2 listener, so it is available to main() after the
+    /// session runs, whatever reporters were selected.
+    static std::vector<BenchmarkResult>& Collected();
+};
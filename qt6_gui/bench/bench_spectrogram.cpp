@@ -0,0 +1,93 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "bench_utils.h"
+#include "controllers/audio_player.h"
+#include "controllers/spectrogram_controller.h"
+#include "include/global_constants.h"
+#include "models/audio_buffer.h"
+#include "models/settings.h"
+#include "tests/stub_audio_sink.h"
+#include "views/spectrogram_view.h"
+#include <QImage>
+#include <audio_types.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <fft_window.h>
+
+/// @brief Exposes SpectrogramView's private image generation
+class TestableSpectrogramView : public SpectrogramView
+{
+  public:
+    using SpectrogramView::GenerateSpectrogramImage;
+    using SpectrogramView::InvalidateImage;
+    using SpectrogramView::SpectrogramView;
+};
+
+namespace {
+
+constexpr SampleRate KSampleRate = 48000;
+constexpr FFTSize KFFTSize = 2048;
+constexpr WindowScale KWindowScale = 2;
+
+/// @brief Noise-filled buffer and a controller using the real FFT processor
+struct SpectrogramBenchFixture
+{
+    /// @param aChannels Channel count
+    /// @param aRows Number of rows the buffer must hold at the bench stride
+    SpectrogramBenchFixture(ChannelCount aChannels, size_t aRows)
+    {
+        settings.SetFFTSettings(KFFTSize, FFTWindow::Type::Hann);
+        settings.SetWindowScale(KWindowScale);
+        const size_t kFrames = (aRows * settings.GetWindowStride()) + KFFTSize;
+        audio_buffer.Reset(aChannels, KSampleRate);
+        audio_buffer.AddSamples(MakeNoise(kFrames * aChannels));
+    }
+
+    Settings settings;
+    AudioBuffer audio_buffer;
+    AudioPlayer audio_player{ audio_buffer, StubAudioSink::GetFactory() };
+    SpectrogramController controller{ settings, audio_buffer, audio_player };
+};
+
+} // namespace
+
+TEST_CASE("SpectrogramController::GetRows", "[benchmark][spectrogram]")
+{
+    constexpr size_t kRows = 512;
+    SpectrogramBenchFixture fixture(1, kRows);
+
+    // Includes recreating the FFT plan, as after a settings change
+    BENCHMARK("SpectrogramController::GetRows 512 rows cold cache")
+    {
+        fixture.controller.ResetFFT();
+        return fixture.controller.GetRows(0, FramePosition{ 0 }, kRows);
+    };
+
+    (void)fixture.controller.GetRows(0, FramePosition{ 0 }, kRows);
+    BENCHMARK("SpectrogramController::GetRows 512 rows warm cache")
+    {
+        return fixture.controller.GetRows(0, FramePosition{ 0 }, kRows);
+    };
+}
+
+TEST_CASE("SpectrogramView::GenerateSpectrogramImage", "[benchmark][spectrogram]")
+{
+    constexpr int kWidth = 1920;
+    constexpr int kHeight = 1080;
+    SpectrogramBenchFixture fixture(2, kHeight);
+    TestableSpectrogramView view(fixture.controller);
+    view.UpdateScrollbarRange(fixture.audio_buffer.GetFrameCount());
+
+    // Fill the row cache so this measures rendering, not FFTs
+    const QImage kImage = view.GenerateSpectrogramImage(kWidth, kHeight);
+    REQUIRE(kImage.width() == kWidth);
+
+    BENCHMARK("SpectrogramView::GenerateSpectrogramImage 1920x1080 2 ch warm cache")
+    {
+        view.InvalidateImage();
+        return view.GenerateSpectrogramImage(kWidth, kHeight);
+    };
+}
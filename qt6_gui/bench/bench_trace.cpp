@@ -0,0 +1,26 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <trace.h>
+
+// Cost of one zone, whether or not SPECTRO_TRACING is compiled in.  Compare
+// with the FFT benchmarks to get the tracing overhead per row.
+TEST_CASE("Trace::Zone", "[benchmark][trace]")
+{
+    Trace::SetEnabled(false);
+    BENCHMARK("Trace::Zone disabled")
+    {
+        const Trace::Zone kZone("bench");
+    };
+
+    Trace::SetEnabled(true);
+    BENCHMARK("Trace::Zone enabled")
+    {
+        const Trace::Zone kZone("bench");
+    };
+    Trace::SetEnabled(false);
+    Trace::Clear();
+}
@@ -0,0 +1,27 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/// @brief Generate reproducible Gaussian white noise
+/// @param aCount Number of samples
+/// @param aSeed Random seed
+/// @return aCount samples with a standard deviation of 0.1
+inline std::vector<float>
+MakeNoise(size_t aCount, uint32_t aSeed = 1)
+{
+    constexpr float kStandardDeviation = 0.1f;
+    std::mt19937 generator(aSeed);
+    std::normal_distribution<float> distribution(0.0f, kStandardDeviation);
+
+    std::vector<float> noise(aCount);
+    for (float& sample : noise) {
+        sample = distribution(generator);
+    }
+    return noise;
+}
@@ -7,6 +7,7 @@
 #include <audio_types.h>
 #include <expected>
 #include <string>
+#include <trace.h>
 #include <vector>
 
 std::expected<void, std::string>
@@ -23,6 +24,7 @@ AudioFile::LoadFile(const std::string& aFilePath, const ProgressCallback& aProgr
 void
 AudioFile::LoadFileFromReader(IAudioFileReader& aReader, const ProgressCallback& aProgressCallback)
 {
+    SPECTRO_TRACE_ZONE("AudioFile::LoadFileFromReader");
     // Each chunk is passed to AddSamples, which will trigger a display refresh,
     // so we want to keep these chunks fairly large for efficiency.
     constexpr FrameCount kChunkSize(1024L * 1024L);
@@ -33,6 +35,8 @@ AudioFile::LoadFileFromReader(IAudioFileReader& aReader, const ProgressCallback&
     int lastProgress = 0;
 
     mBuffer.Reset(kChannelCount, kSampleRate);
+    // Size the channels once rather than regrowing them chunk by chunk
+    mBuffer.Reserve(kTotalFrames);
 
     while (true) {
         const std::vector<float> samples = aReader.ReadInterleaved(kChunkSize);
@@ -3,52 +3,58 @@
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
 #include "controllers/audio_player.h"
-#include "adapters/audio_buffer_qiodevice.h"
 #include "adapters/audio_sink.h"
+#include "adapters/scrub_device.h"
 #include "audio_types.h"
 #include <QAudioFormat>
 #include <QAudioSink>
+#include <QIODevice>
 #include <cstdint>
 #include <expected>
 #include <memory>
 #include <optional>
 #include <string>
-#include <utility>
 
 std::expected<void, std::string>
 AudioPlayer::Start(FrameIndex aStartFrame)
 {
-    if (IsPlaying()) {
-        Stop();
+    if (aStartFrame.Get() > mAudioBuffer.GetFrameCount().Get()) {
+        return std::unexpected("Failed to seek to start frame");
     }
 
-    mAudioSink = mAudioSinkFactory();
-    if (mAudioSink == nullptr) {
-        return std::unexpected("Failed to create audio sink");
-    }
-
-    auto audioBufferQIODevice = std::make_unique<AudioBufferQIODevice>(mAudioBuffer);
-    if (!audioBufferQIODevice->open(QIODevice::ReadOnly)) {
+    const QAudioFormat kFormat = mAudioBuffer.GetAudioFormat();
+    if (mAudioSink == nullptr || kFormat != mSinkFormat) {
         mAudioSink.reset();
-        return std::unexpected("Failed to open AudioBufferQIODevice");
-    }
+        mScrubDevice.reset();
 
-    if (!audioBufferQIODevice->SeekFrame(aStartFrame)) {
-        mAudioSink.reset();
-        return std::unexpected("Failed to seek to start frame in AudioBufferQIODevice");
+        mAudioSink = mAudioSinkFactory();
+        if (mAudioSink == nullptr) {
+            return std::unexpected("Failed to create audio sink");
+        }
+
+        mScrubDevice = std::make_unique<ScrubDevice>(mAudioBuffer);
+        if (!mScrubDevice->open(QIODevice::ReadOnly)) {
+            mAudioSink.reset();
+            mScrubDevice.reset();
+            return std::unexpected("Failed to open ScrubDevice");
+        }
+        mSinkFormat = kFormat;
+        mAudioSink->Start(*mScrubDevice);
     }
 
+    if (!mScrubDevice->Play(aStartFrame)) {
+        return std::unexpected("Failed to seek to start frame");
+    }
     mStartFrame = aStartFrame;
-    mAudioSink->Start(std::move(audioBufferQIODevice));
+    mStartUSecs = mAudioSink->ProcessedUSecs();
     return {};
 }
 
 void
 AudioPlayer::Stop()
 {
-    if (mAudioSink) {
-        mAudioSink->Stop();
-        mAudioSink.reset();
+    if (mScrubDevice) {
+        mScrubDevice->Pause();
     }
 }
 
@@ -68,7 +74,7 @@ AudioPlayer::CurrentFrame() const
         return std::nullopt;
     }
     const SampleRate kSampleRate = mAudioBuffer.GetSampleRate();
-    const uint64_t kProcessedUSecs = mAudioSink->ProcessedUSecs();
+    const uint64_t kProcessedUSecs = mAudioSink->ProcessedUSecs() - mStartUSecs;
     const FrameCount kProcessedFrames{ kProcessedUSecs * kSampleRate / 1'000'000 };
     return mStartFrame + kProcessedFrames;
 }
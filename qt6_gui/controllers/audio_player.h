@@ -5,8 +5,10 @@
 #pragma once
 
 #include "adapters/audio_sink.h"
+#include "adapters/scrub_device.h"
 #include "audio_types.h"
 #include "models/audio_buffer.h"
+#include <QAudioFormat>
 #include <QAudioSink>
 #include <QObject>
 #include <expected>
@@ -17,7 +19,11 @@
 #include <utility>
 
 /// @brief Plays audio from an AudioBuffer using QAudioSink.
-/// This implements the simple case of just playing the buffer from start to finish.
+///
+/// The sink and its ScrubDevice are created on the first Start() and kept
+/// open, so starting again from another frame is a seek rather than a new
+/// sink.  That is what makes scrubbing responsive.  They are recreated only
+/// when the buffer's format changes.
 class AudioPlayer : public QObject
 {
     Q_OBJECT
@@ -41,16 +47,18 @@ class AudioPlayer : public QObject
     }
 
     /// @brief Start playing the audio from the specified start frame.
+    /// If already playing, jumps there with a short crossfade.
     /// @param aStartFrame The frame index to start playing from.
     /// @return std::expected<void, std::string> indicating success or error message.
     [[nodiscard]] std::expected<void, std::string> Start(FrameIndex aStartFrame);
 
-    /// @brief Stop playback if it is currently active.
+    /// @brief Stop playback if it is currently active.  The sink stays open.
+    /// @note Must be called before the AudioBuffer is reset.
     void Stop();
 
     /// @brief Check if currently playing.
     /// @return true if playback is active.
-    [[nodiscard]] bool IsPlaying() const { return mAudioSink != nullptr; }
+    [[nodiscard]] bool IsPlaying() const { return mScrubDevice && mScrubDevice->IsPlaying(); }
 
     /// @brief Get the current frame being played back
     /// @return FrameIndex of the current playback position, or std::nullopt if not playing
@@ -66,8 +74,12 @@ class AudioPlayer : public QObject
     // point to calculate the current frame based on the elapsed time from the
     // audio sink.
     FrameIndex mStartFrame{ 0 };
+    qint64 mStartUSecs = 0; // Sink's processed time at mStartFrame
 
     AudioBuffer& mAudioBuffer;
     AudioSinkFactory mAudioSinkFactory;
+    QAudioFormat mSinkFormat; // Format the sink and device were created for
+    // The sink reads the device, so it is declared last to be destroyed first
+    std::unique_ptr<ScrubDevice> mScrubDevice;
     std::unique_ptr<IAudioSink> mAudioSink;
 };
\ No newline at end of file
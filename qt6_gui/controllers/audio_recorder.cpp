@@ -4,26 +4,51 @@
 
 #include "audio_recorder.h"
 #include "adapters/audio_device.h"
+#include "adapters/audio_source.h"
 #include "include/global_constants.h"
 #include "models/audio_buffer.h"
 #include <QAudio>
 #include <QAudioDevice>
 #include <QAudioFormat>
-#include <QAudioSource>
-#include <QByteArray>
 #include <QIODevice>
+#include <QMetaObject>
 #include <QObject>
+#include <QThread>
+#include <Qt>
+#include <adaptive_block_sizer.h>
+#include <algorithm>
 #include <audio_types.h>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <format>
+#include <latency_probe.h>
 #include <memory>
+#include <metrics.h>
+#include <span>
 #include <stdexcept>
+#include <trace.h>
+#include <utility>
 #include <vector>
 
-AudioRecorder::AudioRecorder(AudioBuffer& aAudioBuffer, QObject* aParent)
+AudioRecorder::AudioRecorder(AudioBuffer& aAudioBuffer,
+                             AudioSourceFactory aAudioSourceFactory,
+                             QObject* aParent)
   : QObject(aParent)
+  , mCaptureContext(std::make_unique<QObject>())
+  , mAudioSourceFactory(aAudioSourceFactory ? std::move(aAudioSourceFactory)
+                                            : DefaultAudioSourceFactory())
   , mAudioBuffer(aAudioBuffer)
 {
+    mCaptureThread.setObjectName("AudioCapture");
+    mCaptureContext->moveToThread(&mCaptureThread);
+}
+
+AudioRecorder::~AudioRecorder()
+{
+    Stop();
+    mCaptureThread.quit();
+    mCaptureThread.wait();
 }
 
 bool
@@ -40,79 +65,256 @@ AudioRecorder::Start(IAudioDevice& aAudioDevice,
         throw std::invalid_argument(std::format("Invalid sample rate {}", aSampleRate));
     }
 
+    // The previous session must stop writing before the buffer is reset
+    Stop();
     mAudioBuffer.Reset(aChannelCount, aSampleRate);
     const QAudioFormat kFormat = mAudioBuffer.GetAudioFormat();
+    mOverruns = 0;
+    mUnderruns = 0;
+    mPaddedFrames = 0;
 
-    mAudioSource = std::make_unique<QAudioSource>(aAudioDevice.GetQAudioDevice(), kFormat);
+    // Unfortunately we can't override start() to inject a mock QIODevice, so we
+    // just read it here for testing, on whichever thread it signals from.
+    if (aMockQIODevice) {
+        mMockIODevice = aMockQIODevice;
+        mAudioIODevice = aMockQIODevice;
+        connect(aMockQIODevice,
+                &QIODevice::readyRead,
+                this,
+                &AudioRecorder::ReadAudioData,
+                Qt::DirectConnection);
+        emit RecordingStateChanged(true);
+        return true;
+    }
 
-    if (!mAudioSource) {
-        emit ErrorOccurred("Failed to create QAudioSource");
+    if (!mCaptureThread.isRunning()) {
+        mCaptureThread.start(QThread::TimeCriticalPriority);
+    }
+    bool started = false;
+    QMetaObject::invokeMethod(
+      mCaptureContext.get(),
+      [this, &started, kDevice = aAudioDevice.GetQAudioDevice(), kFormat] {
+          started = StartSource(kDevice, kFormat);
+      },
+      Qt::BlockingQueuedConnection);
+    if (!started) {
         return false;
     }
 
-    // How many bytes the source should buffer before triggering readyRead.
-    // 44100Hz sample rate * 2 channels * 4 bytes per sample / 60Hz display rate
-    // gives us 5880 bytes.  We'll choose something smaller than that to keep
-    // the updates coming quickly even if the sample rate is lower.  In
-    // practice, we seem to get ~3-4K, perhaps due to scheduling limitations.
-    constexpr qsizetype kSourceBufferSize = 2048;
-    mAudioSource->setBufferSize(kSourceBufferSize);
+    emit RecordingStateChanged(true);
+    return true;
+}
 
-    // Unfortunately we can't override start() to inject a mock QIODevice, so we
-    // just assign it here for testing.
-    if (aMockQIODevice) {
-        mAudioIODevice = aMockQIODevice;
-    } else {
-        mAudioIODevice = mAudioSource->start();
-    }
+AudioRecorder::AudioSourceFactory
+AudioRecorder::DefaultAudioSourceFactory()
+{
+    return [](const QAudioDevice& aDevice, const QAudioFormat& aFormat) {
+        return std::make_unique<AudioSource>(aDevice, aFormat);
+    };
+}
 
-    if (!mAudioIODevice) {
+bool
+AudioRecorder::StartSource(const QAudioDevice& aDevice, const QAudioFormat& aFormat)
+{
+    mAudioSource = mAudioSourceFactory(aDevice, aFormat);
+    mAudioSource->OnStateChanged([this] { CheckSourceError(); });
+
+    // How many bytes the source buffers before triggering readyRead is tuned
+    // while running, from how full the buffer gets and how long paints take
+    mBlockSizer = std::make_unique<AdaptiveBlockSizer>(
+      aFormat.sampleRate(),
+      static_cast<size_t>(aFormat.bytesPerFrame()),
+      &Metrics::GetHistogram(Metrics::KPaintTime));
+    if (!StartDevice()) {
+        StopSource();
         emit ErrorOccurred("Failed to start audio input");
         return false;
     }
+    return true;
+}
 
-    connect(mAudioIODevice, &QIODevice::readyRead, this, &AudioRecorder::ReadAudioData);
-    emit RecordingStateChanged(true);
+bool
+AudioRecorder::StartDevice()
+{
+    static Metrics::Gauge& bufferFrames = Metrics::GetGauge(Metrics::KCaptureBufferFrames);
+    mAudioSource->SetBufferSize(static_cast<qsizetype>(mBlockSizer->GetBufferBytes()));
+    mSourceBufferBytes = mBlockSizer->GetBufferBytes();
+    bufferFrames.Set(static_cast<int64_t>(mBlockSizer->GetBufferFrames()));
+
+    QIODevice* const kDevice = mAudioSource->Start();
+    mAudioIODevice = kDevice;
+    if (kDevice == nullptr) {
+        return false;
+    }
+
+    // The source and its device live on this thread, so this is a direct call
+    connect(kDevice, &QIODevice::readyRead, mCaptureContext.get(), [this] { ReadAudioData(); });
     return true;
 }
 
 void
-AudioRecorder::Stop()
+AudioRecorder::ApplyBufferSize()
 {
-    if (mAudioSource) {
-        mAudioSource->stop();
-        mAudioSource.reset();
+    if (!mAudioSource) {
+        return; // Stopped meanwhile
+    }
+    // Qt only applies a new buffer size on start(), and stop() discards what
+    // the source has queued, so read that first
+    QIODevice* const kDevice = mAudioIODevice;
+    ReadQueued(*kDevice);
+    disconnect(kDevice, nullptr, mCaptureContext.get(), nullptr);
+    mAudioSource->Stop();
+    const int64_t kStoppedNs = LatencyProbe::Now();
+    if (!StartDevice()) {
+        StopSource();
+        emit ErrorOccurred("Failed to restart audio input");
         emit RecordingStateChanged(false);
+        return;
+    }
+
+    // Nothing was captured while the source was stopped.  Fill the gap with
+    // silence, so the frames that follow keep their place in time.
+    constexpr double kNsPerSecond = 1e9;
+    const double kGapSeconds = static_cast<double>(LatencyProbe::Now() - kStoppedNs) / kNsPerSecond;
+    AppendSilence(static_cast<size_t>(std::lround(kGapSeconds * mAudioBuffer.GetSampleRate())));
+}
+
+void
+AudioRecorder::StopSource()
+{
+    if (mAudioSource) {
+        mAudioSource->Stop();
+    }
+    mAudioSource.reset();
+    mBlockSizer.reset();
+    mAudioIODevice = nullptr;
+}
+
+void
+AudioRecorder::CheckSourceError()
+{
+    if (mAudioSource && mAudioSource->Error() == QAudio::UnderrunError) {
+        static Metrics::Counter& underruns = Metrics::GetCounter(Metrics::KCaptureUnderruns);
+        mUnderruns++;
+        underruns.Add(1);
+    }
+}
+
+void
+AudioRecorder::Stop()
+{
+    if (!IsRecording()) {
+        return;
+    }
+    if (mMockIODevice) {
+        disconnect(mMockIODevice, &QIODevice::readyRead, this, &AudioRecorder::ReadAudioData);
+        mMockIODevice = nullptr;
+    } else {
+        // The source belongs to the capture thread, which may be restarting it
+        QMetaObject::invokeMethod(
+          mCaptureContext.get(), [this] { StopSource(); }, Qt::BlockingQueuedConnection);
     }
     mAudioIODevice = nullptr;
+    emit RecordingStateChanged(false);
 }
 
 void
 AudioRecorder::ReadAudioData()
 {
-    if (!mAudioIODevice) {
+    SPECTRO_TRACE_ZONE("AudioRecorder::ReadAudioData");
+    const int64_t kCaptureNs = LatencyProbe::Now();
+    QIODevice* const kDevice = mAudioIODevice;
+    if (!kDevice) {
         // This should be set during Start(), and this callback shouldn't
         // happen unless we're started and recording.
         throw std::runtime_error("AudioRecorder::ReadAudioData called when not recording");
     }
 
-    // Read it into a QByteArray, then convert to float vector.
-    const QByteArray audioData = mAudioIODevice->readAll();
-    if (audioData.size() % sizeof(float) != 0) {
+    if (mAudioSource) {
+        // A full device buffer means the device may have had to drop audio
+        const qsizetype kQueuedBytes = mAudioSource->BytesAvailable();
+        if (kQueuedBytes >= mAudioSource->BufferSize()) {
+            static Metrics::Counter& overruns = Metrics::GetCounter(Metrics::KCaptureOverruns);
+            mOverruns++;
+            overruns.Add(1);
+        }
+        // Resize after this callback returns, not under the device's feet
+        if (mBlockSizer->OnCallback(kCaptureNs, static_cast<size_t>(kQueuedBytes))) {
+            QMetaObject::invokeMethod(
+              mCaptureContext.get(), [this] { ApplyBufferSize(); }, Qt::QueuedConnection);
+        }
+    }
+
+    ReadQueued(*kDevice);
+}
+
+void
+AudioRecorder::ReadQueued(QIODevice& aDevice)
+{
+    // Read everything queued into a reused buffer.  It only grows, so once it
+    // fits the usual callback size, ingest doesn't allocate.  Each read asks
+    // for at least kMinReadBytes, Qt's internal buffer chunk size, so QIODevice
+    // copies straight into our buffer instead of staging through its own.
+    constexpr size_t kMinReadBytes = 16384;
+    size_t bytesRead = 0;
+    while (true) {
+        const size_t kWant =
+          std::max(static_cast<size_t>(aDevice.bytesAvailable()), kMinReadBytes);
+        const size_t kFloatsNeeded = (bytesRead + kWant + sizeof(float) - 1) / sizeof(float);
+        if (mReadBuffer.size() < kFloatsNeeded) {
+            mReadBuffer.resize(kFloatsNeeded);
+        }
+        // Type punning is intentional: the device delivers a byte stream of floats.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto* const kBytes = reinterpret_cast<char*>(mReadBuffer.data());
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const qint64 kRead = aDevice.read(kBytes + bytesRead, static_cast<qint64>(kWant));
+        if (kRead <= 0) {
+            break;
+        }
+        bytesRead += static_cast<size_t>(kRead);
+        if (static_cast<size_t>(kRead) < kWant) {
+            break;
+        }
+    }
+
+    if (bytesRead % sizeof(float) != 0) {
         throw std::runtime_error(
-          "AudioRecorder::ReadAudioData: Read bytes not divisible by sample size");
+          "AudioRecorder::ReadQueued: Read bytes not divisible by sample size");
     }
 
-    const size_t sampleCount = audioData.size() / sizeof(float);
+    const size_t sampleCount = bytesRead / sizeof(float);
+
+    // Everything queued since the last callback arrives at once
+    static Metrics::Gauge& queueFrames = Metrics::GetGauge(Metrics::KCaptureQueueFrames);
+    queueFrames.Set(static_cast<int64_t>(sampleCount / mAudioBuffer.GetChannelCount()));
+
+    const std::span<const float> kSamples(mReadBuffer.data(), sampleCount);
 
-    // Type punning is intentional: we need to interpret the byte stream as floats.
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    const auto* sampleData = reinterpret_cast<const float*>(audioData.constData());
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-    const std::vector<float> samples(sampleData, sampleData + sampleCount);
+    // Tag the block for the latency probe, which resolves it when the view
+    // first paints a row containing its last frame
+    const FrameCount kBlockFrames{ sampleCount / mAudioBuffer.GetChannelCount() };
+    LatencyProbe::Get().TagBlock(mAudioBuffer.GetFrameCount() + kBlockFrames, kCaptureNs);
 
     // Then send it to the AudioBuffer.
-    mAudioBuffer.AddSamples(samples);
+    mAudioBuffer.AddSamples(kSamples);
+}
+
+void
+AudioRecorder::AppendSilence(size_t aFrames)
+{
+    if (aFrames == 0) {
+        return;
+    }
+    static Metrics::Counter& paddedFrames = Metrics::GetCounter(Metrics::KCapturePaddedFrames);
+    const size_t kSamples = aFrames * mAudioBuffer.GetChannelCount();
+    if (mReadBuffer.size() < kSamples) {
+        mReadBuffer.resize(kSamples);
+    }
+    std::fill_n(mReadBuffer.begin(), kSamples, 0.0f);
+    mAudioBuffer.AddSamples(std::span<const float>(mReadBuffer.data(), kSamples));
+    mPaddedFrames += aFrames;
+    paddedFrames.Add(aFrames);
 }
 
 bool
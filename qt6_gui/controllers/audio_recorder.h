@@ -5,12 +5,19 @@
 #pragma once
 
 #include "adapters/audio_device.h"
+#include "adapters/audio_source.h"
 #include "audio_types.h"
 #include <QAudioFormat>
-#include <QAudioSource>
 #include <QIODevice>
 #include <QObject>
+#include <QThread>
+#include <adaptive_block_sizer.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 class QAudioDevice;
 class AudioBuffer;
@@ -21,15 +28,48 @@ class AudioBuffer;
 /// microphone/line-in. Supports runtime device changes and dependency injection
 /// for testing. Audio format (sample rate, channels) is inferred from
 /// AudioBuffer at Start().
+///
+/// The QAudioSource lives on a dedicated time-critical thread with its own
+/// event loop, so a slow paint or a modal dialog on the GUI thread can't delay
+/// reads and overrun the device.  That thread appends straight to the
+/// AudioBuffer, which publishes new frames to readers without locks, and
+/// DataAvailable reaches GUI-thread receivers as a queued signal.  An injected
+/// QIODevice is instead read on the thread that emits its readyRead().
+///
+/// Overruns (the device buffer was full when read, so audio may have been
+/// lost) and underruns reported by the device are counted.  The device buffer
+/// size is chosen by an AdaptiveBlockSizer from how full the buffer gets and
+/// how long paints take, and the source restarts when it changes.  What the
+/// source had queued is read before it stops, and the time it spends stopped
+/// is filled with silence, so the recording keeps its timeline.
+///
+/// The audio source is created, used and destroyed on the capture thread;
+/// Stop() and Start() reach it by blocking calls there.
 class AudioRecorder : public QObject
 {
     Q_OBJECT
 
   public:
+    using AudioSourceFactory =
+      std::function<std::unique_ptr<IAudioSource>(const QAudioDevice&, const QAudioFormat&)>;
+
     /// @brief Constructs an AudioRecorder.
     /// @param aAudioBuffer The AudioBuffer to write captured samples to.
+    /// @param aAudioSourceFactory Optional factory function to create IAudioSource
+    /// instances for testing.  Production uses the default.  Called on the
+    /// capture thread.
     /// @param aParent Qt parent object for memory management.
-    explicit AudioRecorder(AudioBuffer& aAudioBuffer, QObject* aParent = nullptr);
+    explicit AudioRecorder(AudioBuffer& aAudioBuffer,
+                           AudioSourceFactory aAudioSourceFactory = nullptr,
+                           QObject* aParent = nullptr);
+
+    /// @brief Destructor.  Stops capture and the capture thread.
+    ~AudioRecorder() override;
+
+    AudioRecorder(const AudioRecorder&) = delete;
+    AudioRecorder& operator=(const AudioRecorder&) = delete;
+    AudioRecorder(AudioRecorder&&) = delete;
+    AudioRecorder& operator=(AudioRecorder&&) = delete;
 
     /// @brief Starts audio capture, writing samples to the specified buffer.
     /// @param aAudioDevice The audio input device to capture from.
@@ -50,6 +90,19 @@ class AudioRecorder : public QObject
     /// @return true if recording, false otherwise.
     [[nodiscard]] bool IsRecording() const;
 
+    /// @brief Get the number of reads that found the device buffer full
+    [[nodiscard]] uint64_t GetOverrunCount() const { return mOverruns.load(); }
+
+    /// @brief Get the number of underruns reported by the device
+    [[nodiscard]] uint64_t GetUnderrunCount() const { return mUnderruns.load(); }
+
+    /// @brief Get the number of silent frames that filled restarts of the source
+    [[nodiscard]] uint64_t GetPaddedFrameCount() const { return mPaddedFrames.load(); }
+
+    /// @brief Get the device buffer size chosen by the AdaptiveBlockSizer
+    /// @return Bytes, or 0 if no device has been started
+    [[nodiscard]] size_t GetSourceBufferBytes() const { return mSourceBufferBytes.load(); }
+
   signals:
     /// @brief Emitted when recording state changes.
     /// @param aIsRecording true if now recording, false if stopped.
@@ -60,10 +113,58 @@ class AudioRecorder : public QObject
     void ErrorOccurred(const QString& aErrorMessage);
 
   private:
-    std::unique_ptr<QAudioSource> mAudioSource;
-    QIODevice* mAudioIODevice = nullptr;
-    AudioBuffer& mAudioBuffer;
+    /// @brief Create an AudioSource, wrapping QAudioSource, for the given device
+    /// @return A factory function that creates an AudioSource
+    /// @note This implementation is used in production.
+    static AudioSourceFactory DefaultAudioSourceFactory();
+
+    /// @brief Create and start the audio source.  Runs on the capture thread.
+    /// @param aDevice Input device
+    /// @param aFormat Capture format
+    /// @return true if capture started
+    bool StartSource(const QAudioDevice& aDevice, const QAudioFormat& aFormat);
+
+    /// @brief Apply the sizer's buffer size and start the source.  Runs on the
+    /// capture thread.
+    /// @return true if the source started
+    bool StartDevice();
+
+    /// @brief Restart the source with the sizer's new buffer size, keeping
+    /// the audio it had queued and padding the gap.  Runs on the capture thread.
+    void ApplyBufferSize();
+
+    /// @brief Stop and destroy the source.  Runs on the capture thread.
+    void StopSource();
+
+    /// @brief Count an underrun if the source reports one.  Runs on the capture thread.
+    void CheckSourceError();
 
     /// @brief Reads available audio data and writes to the aBuffer.
     void ReadAudioData();
+
+    /// @brief Read everything queued on a device into the AudioBuffer
+    /// @param aDevice Device to read
+    void ReadQueued(QIODevice& aDevice);
+
+    /// @brief Append silence to the AudioBuffer
+    /// @param aFrames Frames of silence
+    void AppendSilence(size_t aFrames);
+
+    QThread mCaptureThread;
+    std::unique_ptr<QObject> mCaptureContext; // Lives on mCaptureThread
+
+    // Created, used and destroyed on the capture thread
+    AudioSourceFactory mAudioSourceFactory;
+    std::unique_ptr<IAudioSource> mAudioSource;
+    std::unique_ptr<AdaptiveBlockSizer> mBlockSizer;
+    std::atomic<QIODevice*> mAudioIODevice{ nullptr }; // Also read by IsRecording()
+    // Injected device, connected and disconnected on the thread calling Start()
+    QIODevice* mMockIODevice = nullptr;
+
+    AudioBuffer& mAudioBuffer;
+    std::vector<float> mReadBuffer; // Reused by ReadAudioData()
+    std::atomic<uint64_t> mOverruns{ 0 };
+    std::atomic<uint64_t> mUnderruns{ 0 };
+    std::atomic<uint64_t> mPaddedFrames{ 0 };
+    std::atomic<size_t> mSourceBufferBytes{ 0 };
 };
@@ -0,0 +1,104 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/batch_measurer.h"
+#include "adapters/audio_file_reader.h"
+#include <QFile>
+#include <QString>
+#include <audio_types.h>
+#include <cstddef>
+#include <distortion_meter.h>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BatchMeasurer::BatchMeasurer(const Options& aOptions)
+  : mOptions(aOptions)
+{
+}
+
+std::expected<BatchMeasurer::Result, std::string>
+BatchMeasurer::MeasureFile(const std::string& aInputPath, const std::string& aOutputPath) const
+{
+    auto readerResult = AudioFileReader::Open(aInputPath);
+    if (!readerResult) {
+        return std::unexpected(readerResult.error());
+    }
+    return Measure(*readerResult, aOutputPath);
+}
+
+std::expected<BatchMeasurer::Result, std::string>
+BatchMeasurer::Measure(IAudioFileReader& aReader, const std::string& aOutputPath) const
+{
+    const ChannelCount kChannels = aReader.GetChannelCount();
+    if (mOptions.channel >= kChannels) {
+        return std::unexpected(
+          std::format("channel {} out of range, file has {}", mOptions.channel, kChannels));
+    }
+
+    const SampleRate kSampleRate = aReader.GetSampleRate();
+    const size_t kBlockFrames = mOptions.meter.block_frames;
+    Result result;
+    result.block_seconds = static_cast<double>(kBlockFrames) / kSampleRate;
+
+    // Carry the partial block left over from each read into the next
+    const FrameCount kReadFrames{ kBlockFrames * KBlocksPerRead };
+    std::vector<float> samples;
+    try {
+        for (;;) {
+            const std::vector<float> kInterleaved = aReader.ReadInterleaved(kReadFrames);
+            for (size_t i = mOptions.channel; i < kInterleaved.size(); i += kChannels) {
+                samples.push_back(kInterleaved[i]);
+            }
+
+            const auto kMeasurements = DistortionMeter::MeasureBlocks(
+              samples, kSampleRate, mOptions.meter, mOptions.thread_count);
+            result.measurements.insert(
+              result.measurements.end(), kMeasurements.begin(), kMeasurements.end());
+            const auto kMeasured = static_cast<std::ptrdiff_t>(kMeasurements.size() * kBlockFrames);
+            samples.erase(samples.begin(), std::next(samples.begin(), kMeasured));
+
+            if (kInterleaved.size() < kReadFrames.Get() * kChannels) {
+                break;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        return std::unexpected(e.what());
+    }
+    if (result.measurements.empty()) {
+        return std::unexpected("Audio file is shorter than one measurement block");
+    }
+
+    QFile file(QString::fromStdString(aOutputPath));
+    const std::string kCsv = FormatCsv(result);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(kCsv.data(), static_cast<qint64>(kCsv.size())) !=
+          static_cast<qint64>(kCsv.size())) {
+        return std::unexpected(
+          std::format("Failed to write {}: {}", aOutputPath, file.errorString().toStdString()));
+    }
+    return result;
+}
+
+std::string
+BatchMeasurer::FormatCsv(const Result& aResult)
+{
+    std::string csv = "time_s,fundamental_hz,fundamental_db,thd_db,thd_n_db,snr_db,sinad_db\n";
+    for (size_t i = 0; i < aResult.measurements.size(); i++) {
+        const DistortionMeter::Measurement& kMeasurement = aResult.measurements[i];
+        std::format_to(std::back_inserter(csv),
+                       "{:.6f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}\n",
+                       static_cast<double>(i) * aResult.block_seconds,
+                       kMeasurement.fundamental_hz,
+                       kMeasurement.fundamental_decibels,
+                       kMeasurement.thd_decibels,
+                       kMeasurement.thd_n_decibels,
+                       kMeasurement.snr_decibels,
+                       kMeasurement.sinad_decibels);
+    }
+    return csv;
+}
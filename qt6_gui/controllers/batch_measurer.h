@@ -0,0 +1,71 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "adapters/audio_file_reader.h"
+#include <audio_types.h>
+#include <cstddef>
+#include <distortion_meter.h>
+#include <expected>
+#include <string>
+#include <vector>
+
+/// @brief Measures THD, THD+N, SNR and SINAD of audio files, block by block
+///
+/// Used by the spectro_batch command line tool to qualify hardware from
+/// recorded sine sweeps: each DistortionMeter block of one channel is
+/// measured, and the results are written as CSV, one row per block.  The file
+/// is read a few hundred blocks at a time, and each batch is measured in
+/// parallel by DistortionMeter::MeasureBlocks(), so memory use does not
+/// depend on the length of the recording.
+class BatchMeasurer
+{
+  public:
+    /// @brief Blocks read and measured together
+    static constexpr size_t KBlocksPerRead = 256;
+
+    /// @brief Measurement options
+    struct Options
+    {
+        ChannelCount channel = 0;        ///< Channel to measure
+        DistortionMeter::Config meter{}; ///< Block size, harmonics and bandwidth
+        size_t thread_count = 0;         ///< Worker threads, 0 for hardware concurrency
+    };
+
+    /// @brief Measurements of a file
+    struct Result
+    {
+        std::vector<DistortionMeter::Measurement> measurements; ///< One per whole block
+        double block_seconds = 0.0;                             ///< Length of one block
+    };
+
+    /// @brief Constructor
+    /// @param aOptions Measurement options
+    explicit BatchMeasurer(const Options& aOptions);
+
+    /// @brief Measure an audio file and write the results as CSV
+    /// @param aInputPath Path to the audio file
+    /// @param aOutputPath Path of the CSV file to write
+    /// @return Measurements, or error message on failure
+    [[nodiscard]] std::expected<Result, std::string> MeasureFile(
+      const std::string& aInputPath,
+      const std::string& aOutputPath) const;
+
+    /// @brief Measure audio from a reader and write the results as CSV
+    /// @param aReader Audio file reader, positioned at the start of the file
+    /// @param aOutputPath Path of the CSV file to write
+    /// @return Measurements, or error message on failure.  A partial block at
+    /// the end of the audio is not measured.
+    [[nodiscard]] std::expected<Result, std::string> Measure(IAudioFileReader& aReader,
+                                                             const std::string& aOutputPath) const;
+
+    /// @brief Format measurements as CSV
+    /// @param aResult Measurements of a file
+    /// @return A header line and one line per block, starting with the
+    /// block's time in seconds.  Levels and ratios are in decibels.
+    [[nodiscard]] static std::string FormatCsv(const Result& aResult);
+
+  private:
+    Options mOptions;
+};
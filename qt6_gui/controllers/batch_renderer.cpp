@@ -0,0 +1,201 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/batch_renderer.h"
+#include "adapters/audio_file_reader.h"
+#include "controllers/row_block_source.h"
+#include "include/global_constants.h"
+#include "models/colormap.h"
+#include "models/settings.h"
+#include <QImage>
+#include <QString>
+#include <algorithm>
+#include <audio_types.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <future>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+BatchRenderer::BatchRenderer(const Settings& aSettings,
+                             Options aOptions,
+                             IFFTProcessor::Factory aFFTProcessorFactory,
+                             FFTWindowFactory aFFTWindowFactory)
+  : mSettings(aSettings)
+  , mOptions(aOptions)
+  , mFFTProcessorFactory(std::move(aFFTProcessorFactory))
+  , mFFTWindowFactory(std::move(aFFTWindowFactory))
+{
+    if (mOptions.strip_height == 0) {
+        throw std::invalid_argument("Strip height must be positive");
+    }
+}
+
+std::expected<std::vector<std::string>, std::string>
+BatchRenderer::RenderFile(const std::string& aInputPath, const std::string& aOutputPath) const
+{
+    auto readerResult = AudioFileReader::Open(aInputPath);
+    if (!readerResult) {
+        return std::unexpected(readerResult.error());
+    }
+    return Render(*readerResult, aOutputPath);
+}
+
+std::expected<std::vector<std::string>, std::string>
+BatchRenderer::Render(IAudioFileReader& aReader, const std::string& aOutputPath) const
+{
+    const ChannelCount kChannels = aReader.GetChannelCount();
+    if (kChannels > GKMaxChannels || kChannels < 1) {
+        return std::unexpected(
+          std::format("channel count {} out of range [1, {}]", kChannels, GKMaxChannels));
+    }
+
+    RowBlockSource source(aReader,
+                          mSettings.GetFFTSize(),
+                          mSettings.GetWindowType(),
+                          mSettings.GetWindowStride(),
+                          mOptions.strip_height,
+                          mOptions.thread_count,
+                          FrameIndex{ 0 },
+                          std::nullopt,
+                          mFFTProcessorFactory,
+                          mFFTWindowFactory);
+    const size_t kTotalRows = source.GetExpectedRowCount();
+    if (kTotalRows == 0) {
+        return std::unexpected("Audio file is shorter than one FFT window");
+    }
+    const size_t kStripCount = (kTotalRows + mOptions.strip_height - 1) / mOptions.strip_height;
+
+    std::future<bool> pendingWrite;
+    std::vector<std::string> writtenPaths;
+    std::string writeError;
+    auto finishPendingWrite = [&] {
+        if (pendingWrite.valid() && !pendingWrite.get() && writeError.empty()) {
+            writeError = std::format("Failed to write {}", writtenPaths.back());
+        }
+    };
+
+    for (size_t strip = 0; strip < kStripCount && writeError.empty(); strip++) {
+        // A truncated file may not supply every row the header promised
+        if (source.NextBlock() == 0) {
+            break;
+        }
+
+        std::vector<std::span<const float>> channelRows;
+        for (ChannelCount ch = 0; ch < kChannels; ch++) {
+            channelRows.push_back(source.GetChannelRows(ch));
+        }
+        QImage image = ColorizeRows(channelRows, source.GetBinCount(), mSettings);
+
+        // Encode this strip while the next one is being transformed
+        finishPendingWrite();
+        writtenPaths.push_back(StripPath(aOutputPath, strip, kStripCount));
+        pendingWrite = std::async(std::launch::async,
+                                  [image = std::move(image), path = writtenPaths.back()] {
+                                      return image.save(QString::fromStdString(path), "PNG");
+                                  });
+    }
+    finishPendingWrite();
+
+    if (!writeError.empty()) {
+        return std::unexpected(writeError);
+    }
+    if (writtenPaths.empty()) {
+        return std::unexpected("Audio file is shorter than one FFT window");
+    }
+    return writtenPaths;
+}
+
+std::string
+BatchRenderer::StripPath(const std::string& aOutputPath, size_t aStripIndex, size_t aStripCount)
+{
+    if (aStripCount <= 1) {
+        return aOutputPath;
+    }
+
+    // Insert the index before the extension, if the file name has one
+    const size_t kSlash = aOutputPath.find_last_of('/');
+    const size_t kDot = aOutputPath.find_last_of('.');
+    const bool kHasExtension =
+      kDot != std::string::npos && (kSlash == std::string::npos || kDot > kSlash);
+    const std::string kStem = kHasExtension ? aOutputPath.substr(0, kDot) : aOutputPath;
+    const std::string kExtension = kHasExtension ? aOutputPath.substr(kDot) : ".png";
+    return std::format("{}.{:04}{}", kStem, aStripIndex, kExtension);
+}
+
+QImage
+BatchRenderer::ColorizeRows(const std::vector<std::span<const float>>& aChannelRows,
+                            size_t aBinCount,
+                            const Settings& aSettings)
+{
+    const size_t kChannels = aChannelRows.size();
+    if (kChannels > GKMaxChannels || kChannels < 1) {
+        throw std::invalid_argument(
+          std::format("channel count {} out of range [1, {}]", kChannels, GKMaxChannels));
+    }
+    const size_t kRows = aChannelRows[0].size() / aBinCount;
+
+    QImage image(static_cast<int>(aBinCount), static_cast<int>(kRows), QImage::Format_RGBA8888);
+    image.fill(Qt::black);
+
+    const float kApertureFloorDecibels = aSettings.GetApertureFloorDecibels();
+    const float kApertureRangeDecibels =
+      aSettings.GetApertureCeilingDecibels() - kApertureFloorDecibels;
+    constexpr float kImplausiblySmallDecibelRange = 1e-6f;
+    if (std::abs(kApertureRangeDecibels) < kImplausiblySmallDecibelRange) {
+        return image;
+    }
+    constexpr auto kColorMapMaxIndex = static_cast<float>(ColorMap::KLUTSize - 1);
+    const float kApertureRangeInverseDecibels = kColorMapMaxIndex / kApertureRangeDecibels;
+    const Settings::ColorMapLUTs& kColorMapLUTs = aSettings.GetColorMapLUTs();
+
+    for (size_t y = 0; y < kRows; y++) { // NOLINT(readability-identifier-length)
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto* const kScanLine = reinterpret_cast<uint8_t*>(image.scanLine(static_cast<int>(y)));
+        const size_t kRowOffset = y * aBinCount;
+
+        for (size_t x = 0; x < aBinCount; x++) { // NOLINT(readability-identifier-length)
+            // NOLINTBEGIN(readability-identifier-length)
+            int r = 0;
+            int g = 0;
+            int b = 0;
+            // NOLINTEND(readability-identifier-length)
+            for (size_t ch = 0; ch < kChannels; ch++) {
+                const float kDecibels = aChannelRows[ch][kRowOffset + x];
+                auto colorMapIndex =
+                  (kDecibels - kApertureFloorDecibels) * kApertureRangeInverseDecibels;
+                colorMapIndex = std::clamp(colorMapIndex, 0.0f, kColorMapMaxIndex);
+                const ColorMap::Entry kColor =
+                  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                  kColorMapLUTs[ch][static_cast<uint8_t>(colorMapIndex)];
+                r += kColor.r;
+                g += kColor.g;
+                b += kColor.b;
+            }
+
+            constexpr int kMaxColorChannelValue = std::numeric_limits<uint8_t>::max();
+            r = std::min(r, kMaxColorChannelValue);
+            g = std::min(g, kMaxColorChannelValue);
+            b = std::min(b, kMaxColorChannelValue);
+
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            constexpr size_t kBytesPerRGBAPixel = 4;
+            const size_t kScanLineIndex = x * kBytesPerRGBAPixel;
+            kScanLine[kScanLineIndex + 0] = static_cast<uint8_t>(r);
+            kScanLine[kScanLineIndex + 1] = static_cast<uint8_t>(g);
+            kScanLine[kScanLineIndex + 2] = static_cast<uint8_t>(b);
+            kScanLine[kScanLineIndex + 3] = kMaxColorChannelValue;
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    }
+    return image;
+}
@@ -0,0 +1,101 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "adapters/audio_file_reader.h"
+#include "models/settings.h"
+#include <QImage>
+#include <audio_types.h>
+#include <cstddef>
+#include <expected>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief Renders audio files to spectrogram PNG images without a display
+///
+/// Used by the spectro_batch command line tool to process archives of
+/// recordings on headless servers.  Pulls one strip of rows at a time from a
+/// RowBlockSource, colorizes them with the same compositing as SpectrogramView,
+/// and writes the result as a series of PNG strips so memory use does not
+/// depend on the length of the recording.
+///
+/// PNG encoding of the previous strip runs asynchronously while the current
+/// strip is being transformed.
+///
+/// Each row of the image is one FFT window, oldest at the top, and each column
+/// is one frequency bin, DC at the left.
+class BatchRenderer
+{
+  public:
+    static constexpr size_t KDefaultStripHeight = 1024;
+
+    /// @brief Rendering options that are not part of Settings
+    struct Options
+    {
+        size_t strip_height = KDefaultStripHeight; ///< Maximum rows per output image
+        size_t thread_count = 0; ///< FFT worker threads, 0 for hardware concurrency
+    };
+
+    /// @brief Constructor
+    /// @param aSettings FFT, aperture and color map settings to render with
+    /// @param aOptions Rendering options
+    /// @param aFFTProcessorFactory Factory for FFT processors (optional)
+    /// @param aFFTWindowFactory Factory for FFT windows (optional)
+    /// @throws std::invalid_argument if aOptions.strip_height is zero
+    BatchRenderer(const Settings& aSettings,
+                  Options aOptions,
+                  IFFTProcessor::Factory aFFTProcessorFactory = nullptr,
+                  FFTWindowFactory aFFTWindowFactory = nullptr);
+
+    /// @brief Render an audio file to PNG strips
+    /// @param aInputPath Path to the audio file
+    /// @param aOutputPath Path of the PNG to write.  See StripPath().
+    /// @return Paths of the images written, or error message on failure
+    [[nodiscard]] std::expected<std::vector<std::string>, std::string> RenderFile(
+      const std::string& aInputPath,
+      const std::string& aOutputPath) const;
+
+    /// @brief Render audio from a reader to PNG strips
+    /// @param aReader Audio file reader, positioned at the start of the file
+    /// @param aOutputPath Path of the PNG to write.  See StripPath().
+    /// @return Paths of the images written, or error message on failure
+    ///
+    /// If the reader returns fewer frames than GetFrameCount() reported, the
+    /// rows that could be computed are written and the remaining strips are
+    /// omitted.
+    [[nodiscard]] std::expected<std::vector<std::string>, std::string> Render(
+      IAudioFileReader& aReader,
+      const std::string& aOutputPath) const;
+
+    /// @brief Get the output path for a strip
+    /// @param aOutputPath Requested output path
+    /// @param aStripIndex Zero-based strip index
+    /// @param aStripCount Total number of strips
+    /// @return aOutputPath if there is only one strip, otherwise aOutputPath
+    /// with the strip index inserted before the extension, e.g. out.0003.png
+    [[nodiscard]] static std::string StripPath(const std::string& aOutputPath,
+                                               size_t aStripIndex,
+                                               size_t aStripCount);
+
+    /// @brief Colorize rows of decibel data into an image
+    /// @param aChannelRows Row-major decibels for each channel, all the same size
+    /// @param aBinCount Number of bins per row
+    /// @param aSettings Aperture and color map settings
+    /// @return RGBA8888 image, aBinCount wide with one line per row
+    ///
+    /// Channel colors are summed and clamped, matching SpectrogramView.
+    [[nodiscard]] static QImage ColorizeRows(
+      const std::vector<std::span<const float>>& aChannelRows,
+      size_t aBinCount,
+      const Settings& aSettings);
+
+  private:
+    const Settings& mSettings;
+    Options mOptions;
+    IFFTProcessor::Factory mFFTProcessorFactory;
+    FFTWindowFactory mFFTWindowFactory;
+};
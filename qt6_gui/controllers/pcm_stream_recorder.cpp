@@ -0,0 +1,284 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "pcm_stream_recorder.h"
+#include "include/global_constants.h"
+#include "models/audio_buffer.h"
+#include <QMetaObject>
+#include <QObject>
+#include <QString>
+#include <Qt>
+#include <algorithm>
+#include <audio_types.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <fcntl.h>
+#include <format>
+#include <memory>
+#include <metrics.h>
+#include <pcm_decoder.h>
+#include <poll.h>
+#include <span>
+#include <spsc_ring.h>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// @brief How often the reader thread checks for a stop request while idle
+constexpr int KPollTimeoutMs = 100;
+
+/// @brief Describe the current errno
+std::string
+ErrnoMessage()
+{
+    return std::generic_category().message(errno);
+}
+
+/// @brief Check a stream format
+/// @throws std::invalid_argument if the channel count or sample rate is invalid
+void
+ValidateFormat(const PcmStreamRecorder::Format& aFormat)
+{
+    if (aFormat.channel_count == 0 || aFormat.channel_count > GKMaxChannels) {
+        throw std::invalid_argument(
+          std::format("Invalid channel count {}", aFormat.channel_count));
+    }
+    if (aFormat.sample_rate <= 0) {
+        throw std::invalid_argument(std::format("Invalid sample rate {}", aFormat.sample_rate));
+    }
+}
+
+} // namespace
+
+PcmStreamRecorder::PcmStreamRecorder(AudioBuffer& aAudioBuffer, QObject* aParent)
+  : QObject(aParent)
+  , mAudioBuffer(aAudioBuffer)
+{
+}
+
+PcmStreamRecorder::~PcmStreamRecorder()
+{
+    Stop();
+}
+
+bool
+PcmStreamRecorder::Start(const std::string& aSource, const Format& aFormat)
+{
+    ValidateFormat(aFormat);
+
+    const auto kFileDescriptor = OpenSource(aSource);
+    if (!kFileDescriptor) {
+        emit ErrorOccurred(QString::fromStdString(kFileDescriptor.error()));
+        return false;
+    }
+    return StartFileDescriptor(*kFileDescriptor, aFormat);
+}
+
+bool
+PcmStreamRecorder::StartFileDescriptor(int aFileDescriptor, const Format& aFormat)
+{
+    try {
+        ValidateFormat(aFormat);
+    } catch (const std::invalid_argument&) {
+        ::close(aFileDescriptor);
+        throw;
+    }
+
+    Stop();
+    mAudioBuffer.Reset(aFormat.channel_count, aFormat.sample_rate);
+
+    mFormat = aFormat;
+    mFileDescriptor = aFileDescriptor;
+
+    // Half a second of audio lets the consumer stall briefly without losing
+    // samples.  Never less than a few reads, for low rates.
+    const size_t kBytesPerSample = PcmDecoder::BytesPerSample(mFormat.sample_format);
+    const size_t kRingSamples =
+      std::max(static_cast<size_t>(mFormat.sample_rate) * mFormat.channel_count / 2,
+               4 * KReadBytes / kBytesPerSample);
+    mRing = std::make_unique<SpscRing<float>>(kRingSamples);
+    mDrainBuffer.reserve(mRing->GetCapacity());
+    mDrainPending = false;
+    mDroppedFrames = 0;
+
+    mReaderThread = std::jthread([this, session = mSession](const std::stop_token& aStopToken) {
+        ReadLoop(aStopToken, session);
+    });
+    emit RecordingStateChanged(true);
+    return true;
+}
+
+void
+PcmStreamRecorder::Stop()
+{
+    if (!mReaderThread.joinable()) {
+        return;
+    }
+    mReaderThread.request_stop();
+    mReaderThread.join();
+    ::close(mFileDescriptor);
+    mFileDescriptor = -1;
+    mSession++;
+    emit RecordingStateChanged(false);
+}
+
+std::expected<int, std::string>
+PcmStreamRecorder::OpenSource(const std::string& aSource)
+{
+    if (aSource == "-") {
+        const int kFileDescriptor = ::dup(STDIN_FILENO);
+        if (kFileDescriptor < 0) {
+            return std::unexpected(std::format("stdin: {}", ErrnoMessage()));
+        }
+        return kFileDescriptor;
+    }
+
+    constexpr std::string_view kUnixPrefix = "unix:";
+    if (aSource.starts_with(kUnixPrefix)) {
+        const std::string kPath = aSource.substr(kUnixPrefix.size());
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (kPath.size() >= sizeof(address.sun_path)) {
+            return std::unexpected(std::format("{}: socket path too long", kPath));
+        }
+        std::ranges::copy(kPath, std::begin(address.sun_path));
+
+        const int kSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (kSocket < 0) {
+            return std::unexpected(std::format("{}: {}", kPath, ErrnoMessage()));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (::connect(kSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            const std::string kError = ErrnoMessage();
+            ::close(kSocket);
+            return std::unexpected(std::format("{}: {}", kPath, kError));
+        }
+        return kSocket;
+    }
+
+    // Non-blocking so opening a FIFO doesn't wait for a writer.  The reader
+    // thread polls before every read.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    const int kFileDescriptor = ::open(aSource.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+    if (kFileDescriptor < 0) {
+        return std::unexpected(std::format("{}: {}", aSource, ErrnoMessage()));
+    }
+    return kFileDescriptor;
+}
+
+void
+PcmStreamRecorder::ReadLoop(const std::stop_token& aStopToken, uint64_t aSession)
+{
+    const ChannelCount kChannels = mFormat.channel_count;
+    const size_t kBytesPerFrame = PcmDecoder::BytesPerSample(mFormat.sample_format) * kChannels;
+
+    // Allocated once per session.  The byte buffer has room for one read plus
+    // a partial frame carried over from the previous read.
+    std::vector<std::byte> bytes(KReadBytes + kBytesPerFrame);
+    std::vector<float> samples((bytes.size() / kBytesPerFrame) * kChannels);
+    size_t carriedBytes = 0;
+    Metrics::Counter& droppedFrames = Metrics::GetCounter(Metrics::KDroppedFrames);
+
+    while (!aStopToken.stop_requested()) {
+        pollfd pollRequest{ .fd = mFileDescriptor, .events = POLLIN, .revents = 0 };
+        const int kReady = ::poll(&pollRequest, 1, KPollTimeoutMs);
+        if (kReady == 0 || (kReady < 0 && errno == EINTR)) {
+            continue;
+        }
+        if (kReady < 0) {
+            PostStreamEnded(QString::fromStdString(ErrnoMessage()), aSession);
+            return;
+        }
+
+        const ssize_t kRead = ::read(mFileDescriptor, &bytes[carriedBytes], KReadBytes);
+        if (kRead < 0 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        }
+        if (kRead <= 0) {
+            const QString kMessage =
+              kRead == 0 ? QString("End of stream") : QString::fromStdString(ErrnoMessage());
+            PostStreamEnded(kMessage, aSession);
+            return;
+        }
+
+        // Decode whole frames and keep any partial frame for the next read
+        const size_t kAvailableBytes = carriedBytes + static_cast<size_t>(kRead);
+        const size_t kFrames = kAvailableBytes / kBytesPerFrame;
+        const size_t kFrameBytes = kFrames * kBytesPerFrame;
+        const auto kSamples = std::span(samples).first(kFrames * kChannels);
+        PcmDecoder::Decode(mFormat.sample_format, std::span(bytes).first(kFrameBytes), kSamples);
+        carriedBytes = kAvailableBytes - kFrameBytes;
+        std::memmove(bytes.data(), &bytes[kFrameBytes], carriedBytes);
+
+        if (kSamples.empty()) {
+            continue;
+        }
+        if (mRing->GetWriteAvailable() >= kSamples.size()) {
+            mRing->Write(kSamples);
+        } else {
+            mDroppedFrames += kFrames;
+            droppedFrames.Add(kFrames);
+        }
+
+        // Coalesce notifications: one queued drain at a time
+        if (!mDrainPending.exchange(true)) {
+            QMetaObject::invokeMethod(
+              this,
+              [this, aSession] {
+                  if (aSession == mSession) {
+                      Drain();
+                  }
+              },
+              Qt::QueuedConnection);
+        }
+    }
+}
+
+void
+PcmStreamRecorder::PostStreamEnded(const QString& aMessage, uint64_t aSession)
+{
+    QMetaObject::invokeMethod(
+      this,
+      [this, aMessage, aSession] {
+          if (aSession != mSession) {
+              return;
+          }
+          Drain();
+          emit ErrorOccurred(aMessage);
+          Stop();
+      },
+      Qt::QueuedConnection);
+}
+
+void
+PcmStreamRecorder::Drain()
+{
+    // Clear first, so data pushed while draining triggers another drain
+    mDrainPending = false;
+
+    const size_t kAvailable = mRing->GetReadAvailable();
+    const size_t kSamples = kAvailable - (kAvailable % mFormat.channel_count);
+    static Metrics::Gauge& queueFrames = Metrics::GetGauge(Metrics::KStreamQueueFrames);
+    queueFrames.Set(static_cast<int64_t>(kSamples / mFormat.channel_count));
+    if (kSamples == 0) {
+        return;
+    }
+
+    // Capacity was reserved at Start(), so this does not allocate
+    mDrainBuffer.resize(kSamples);
+    mRing->Read(mDrainBuffer);
+    mAudioBuffer.AddSamples(mDrainBuffer);
+}
@@ -0,0 +1,138 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "audio_types.h"
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <pcm_decoder.h>
+#include <spsc_ring.h>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AudioBuffer;
+
+/// @brief Captures raw PCM piped in from another process and writes to an
+/// AudioBuffer.
+///
+/// An alternative to AudioRecorder for headless monitoring, where audio comes
+/// from arecord, sox, an SDR demodulator, or similar rather than a Qt audio
+/// device.  Reads raw interleaved little-endian PCM from stdin, a FIFO, a file
+/// or a Unix domain socket.
+///
+/// A dedicated reader thread does large blocking reads into buffers allocated
+/// once at Start(), decodes to float, and pushes whole frames into a lock-free
+/// ring.  The ring is drained on the AudioBuffer's thread, so AudioBuffer sees
+/// the same AddSamples() calls it gets from AudioRecorder.  If the consumer
+/// falls behind by more than the ring holds, whole reads are dropped and
+/// counted rather than blocking the producer.
+class PcmStreamRecorder : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /// @brief Stream format.  Raw PCM has no header, so this must be given.
+    struct Format
+    {
+        PcmDecoder::Format sample_format = PcmDecoder::Format::F32;
+        ChannelCount channel_count = 2;
+        SampleRate sample_rate = 48000;
+    };
+
+    /// @brief Bytes requested per read(2) call
+    static constexpr size_t KReadBytes = size_t{ 256 } * 1024;
+
+    /// @brief Constructs a PcmStreamRecorder.
+    /// @param aAudioBuffer The AudioBuffer to write captured samples to.
+    /// @param aParent Qt parent object for memory management.
+    explicit PcmStreamRecorder(AudioBuffer& aAudioBuffer, QObject* aParent = nullptr);
+
+    /// @brief Destructor.  Stops the reader thread.
+    ~PcmStreamRecorder() override;
+
+    PcmStreamRecorder(const PcmStreamRecorder&) = delete;
+    PcmStreamRecorder& operator=(const PcmStreamRecorder&) = delete;
+    PcmStreamRecorder(PcmStreamRecorder&&) = delete;
+    PcmStreamRecorder& operator=(PcmStreamRecorder&&) = delete;
+
+    /// @brief Opens a stream and starts capture.
+    /// @param aSource "-" for stdin, "unix:<path>" for a Unix domain stream
+    /// socket, otherwise the path of a FIFO or file.
+    /// @param aFormat Stream format.
+    /// @return true if capture started successfully, false otherwise.
+    /// @throws std::invalid_argument if the channel count or sample rate is invalid
+    bool Start(const std::string& aSource, const Format& aFormat);
+
+    /// @brief Starts capture from an open file descriptor.
+    /// @param aFileDescriptor Readable descriptor.  Ownership is transferred;
+    /// it is closed on Stop() or on failure.
+    /// @param aFormat Stream format.
+    /// @return true if capture started successfully, false otherwise.
+    /// @throws std::invalid_argument if the channel count or sample rate is invalid
+    bool StartFileDescriptor(int aFileDescriptor, const Format& aFormat);
+
+    /// @brief Stops capture and closes the stream.
+    /// @note no-op unless a capture is in progress.
+    void Stop();
+
+    /// @brief Returns whether capture is currently active.
+    /// @return true if recording, false otherwise.
+    [[nodiscard]] bool IsRecording() const { return mReaderThread.joinable(); }
+
+    /// @brief Get the number of frames dropped because the ring was full
+    [[nodiscard]] uint64_t GetDroppedFrames() const { return mDroppedFrames.load(); }
+
+  signals:
+    /// @brief Emitted when recording state changes.
+    /// @param aIsRecording true if now recording, false if stopped.
+    void RecordingStateChanged(bool aIsRecording);
+
+    /// @brief Emitted when an error occurs during capture, including end of
+    /// stream.
+    /// @param aErrorMessage Description of the error.
+    void ErrorOccurred(const QString& aErrorMessage);
+
+  private:
+    /// @brief Open a stream source
+    /// @param aSource See Start()
+    /// @return File descriptor, or error message on failure
+    static std::expected<int, std::string> OpenSource(const std::string& aSource);
+
+    /// @brief Reader thread body
+    /// @param aStopToken Stop request from Stop()
+    /// @param aSession Session the thread belongs to
+    void ReadLoop(const std::stop_token& aStopToken, uint64_t aSession);
+
+    /// @brief Move all complete frames from the ring into the AudioBuffer.
+    /// Runs on this object's thread.
+    void Drain();
+
+    /// @brief Report the end of the stream from the reader thread
+    /// @param aMessage Reason the stream ended
+    /// @param aSession Session the reader thread belongs to
+    void PostStreamEnded(const QString& aMessage, uint64_t aSession);
+
+    AudioBuffer& mAudioBuffer;
+    Format mFormat;
+    int mFileDescriptor = -1;
+
+    std::unique_ptr<SpscRing<float>> mRing;
+    std::vector<float> mDrainBuffer;
+    std::atomic<bool> mDrainPending{ false };
+    std::atomic<uint64_t> mDroppedFrames{ 0 };
+
+    // Incremented on every Stop(), so notifications queued by a previous
+    // session's reader thread are ignored
+    uint64_t mSession = 0;
+
+    std::jthread mReaderThread;
+};
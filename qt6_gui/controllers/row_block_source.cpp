@@ -0,0 +1,167 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/row_block_source.h"
+#include "adapters/audio_file_reader.h"
+#include "include/global_constants.h"
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <format>
+#include <future>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+RowBlockSource::RowBlockSource(IAudioFileReader& aReader,
+                               FFTSize aTransformSize,
+                               FFTWindow::Type aWindowType,
+                               FFTSize aStride,
+                               size_t aBlockRows,
+                               size_t aThreadCount,
+                               FrameIndex aFirstFrame,
+                               std::optional<FrameCount> aFrameCount,
+                               const IFFTProcessor::Factory& aFFTProcessorFactory,
+                               const FFTWindowFactory& aFFTWindowFactory)
+  : mReader(aReader)
+  , mPipeline(aTransformSize, aWindowType, aThreadCount, aFFTProcessorFactory, aFFTWindowFactory)
+  , mChannelCount(aReader.GetChannelCount())
+  , mTransformSize(aTransformSize)
+  , mStride(aStride)
+  , mBlockRows(aBlockRows)
+  , mChunkFrames(std::max<size_t>(aBlockRows * aStride, aTransformSize))
+  , mFramesToSkip(aFirstFrame.Get())
+{
+    if (mChannelCount > GKMaxChannels || mChannelCount < 1) {
+        throw std::invalid_argument(
+          std::format("channel count {} out of range [1, {}]", mChannelCount, GKMaxChannels));
+    }
+    if (mStride == 0 || mBlockRows == 0) {
+        throw std::invalid_argument("Stride and block rows must be positive");
+    }
+
+    // Work out how many frames of the range the reader actually has
+    const size_t kReaderFrames = aReader.GetFrameCount().Get();
+    size_t rangeFrames = kReaderFrames > mFramesToSkip ? kReaderFrames - mFramesToSkip : 0;
+    if (aFrameCount.has_value()) {
+        mFramesRemaining = aFrameCount->Get();
+        rangeFrames = std::min(rangeFrames, aFrameCount->Get());
+    }
+    mExpectedRowCount = CalculateRowCount(FrameCount{ rangeFrames }, mTransformSize, mStride);
+
+    mChannelSamples.resize(mChannelCount);
+    mChannelRows.assign(mChannelCount, std::vector<float>(mBlockRows * GetBinCount()));
+
+    // Skip to the range without decoding what comes before it, where the
+    // reader can.  Otherwise AppendChunk drops those frames as they arrive.
+    if (mFramesToSkip > 0 && mFramesToSkip <= kReaderFrames && mReader.Seek(aFirstFrame)) {
+        mFramesToSkip = 0;
+    }
+
+    StartRead();
+}
+
+RowBlockSource::~RowBlockSource()
+{
+    // The read in flight references mReader, so it must finish first
+    if (mNextChunk.valid()) {
+        mNextChunk.wait();
+    }
+}
+
+void
+RowBlockSource::StartRead()
+{
+    mNextChunk = std::async(std::launch::async, [this] {
+        return mReader.ReadInterleaved(mChunkFrames);
+    });
+}
+
+size_t
+RowBlockSource::NextBlock()
+{
+    // Fill the sample buffers for a full block, keeping one read in flight
+    const size_t kFramesNeeded = ((mBlockRows - 1) * mStride) + mTransformSize;
+    while (mChannelSamples[0].size() < kFramesNeeded && !mEndOfInput) {
+        const std::vector<float> kInterleaved = mNextChunk.get();
+        if (kInterleaved.empty()) {
+            mEndOfInput = true;
+            break;
+        }
+        AppendChunk(kInterleaved);
+        if (mFramesRemaining == 0U) {
+            // End of the requested range; no need to read further
+            mEndOfInput = true;
+            break;
+        }
+        StartRead();
+    }
+
+    const FrameCount kAvailableFrames{ mChannelSamples[0].size() };
+    mCurrentBlockRows =
+      std::min(mBlockRows, CalculateRowCount(kAvailableFrames, mTransformSize, mStride));
+    if (mCurrentBlockRows == 0) {
+        return 0;
+    }
+
+    const size_t kBinCount = GetBinCount();
+    for (ChannelCount ch = 0; ch < mChannelCount; ch++) {
+        mPipeline.ComputeRows(mChannelSamples[ch],
+                              mStride,
+                              mCurrentBlockRows,
+                              std::span(mChannelRows[ch]).first(mCurrentBlockRows * kBinCount));
+    }
+
+    // Drop the samples that no later row needs
+    const size_t kConsumedFrames = mCurrentBlockRows * mStride;
+    for (auto& samples : mChannelSamples) {
+        const size_t kErase = std::min(kConsumedFrames, samples.size());
+        samples.erase(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(kErase));
+    }
+
+    mRowsDone += mCurrentBlockRows;
+    return mCurrentBlockRows;
+}
+
+std::span<const float>
+RowBlockSource::GetChannelRows(ChannelCount aChannel) const
+{
+    return std::span(mChannelRows.at(aChannel)).first(mCurrentBlockRows * GetBinCount());
+}
+
+void
+RowBlockSource::AppendChunk(const std::vector<float>& aInterleaved)
+{
+    const size_t kFrames = aInterleaved.size() / mChannelCount;
+
+    // Drop frames before the start of the range, and after its end
+    const size_t kSkip = std::min(mFramesToSkip, kFrames);
+    mFramesToSkip -= kSkip;
+    size_t take = kFrames - kSkip;
+    if (mFramesRemaining.has_value()) {
+        take = std::min(take, *mFramesRemaining);
+        *mFramesRemaining -= take;
+    }
+
+    for (ChannelCount ch = 0; ch < mChannelCount; ch++) {
+        auto& samples = mChannelSamples[ch];
+        const size_t kOldSize = samples.size();
+        samples.resize(kOldSize + take);
+        for (size_t frame = 0; frame < take; frame++) {
+            samples[kOldSize + frame] = aInterleaved[((kSkip + frame) * mChannelCount) + ch];
+        }
+    }
+}
+
+size_t
+RowBlockSource::CalculateRowCount(FrameCount aFrameCount, FFTSize aTransformSize, FFTSize aStride)
+{
+    if (aFrameCount.Get() < aTransformSize) {
+        return 0;
+    }
+    return ((aFrameCount.Get() - aTransformSize) / aStride) + 1;
+}
@@ -0,0 +1,138 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "adapters/audio_file_reader.h"
+#include <audio_types.h>
+#include <cstddef>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <future>
+#include <optional>
+#include <row_pipeline.h>
+#include <span>
+#include <vector>
+
+/// @brief Streams spectrogram rows from an audio reader in fixed-size blocks
+///
+/// Shared front end for offline consumers (BatchRenderer, SpectrogramExporter).
+/// Reads interleaved audio in chunks, keeps the overlap between successive FFT
+/// windows, and computes each block of rows on a RowPipeline.  The next chunk
+/// is read on a background thread while the current block is transformed, so
+/// decoding and FFT work overlap.
+///
+/// A range that starts part way through the audio is reached with
+/// IAudioFileReader::Seek(), so the frames before it aren't decoded.  Readers
+/// that can't seek are read from the start and the frames before the range
+/// discarded.
+///
+/// Memory use is bounded by the block size, independent of the length of the
+/// recording.
+class RowBlockSource
+{
+  public:
+    /// @brief Constructor
+    /// @param aReader Audio reader, positioned at the start of the audio.  Must
+    /// outlive this object.
+    /// @param aTransformSize FFT transform size
+    /// @param aWindowType Window function type
+    /// @param aStride Frames between the starts of successive rows
+    /// @param aBlockRows Maximum rows per block
+    /// @param aThreadCount FFT worker threads, 0 for hardware concurrency
+    /// @param aFirstFrame First frame of the range to process
+    /// @param aFrameCount Number of frames in the range, or nullopt for the
+    /// rest of the audio
+    /// @param aFFTProcessorFactory Factory for FFT processors (optional)
+    /// @param aFFTWindowFactory Factory for FFT windows (optional)
+    /// @throws std::invalid_argument if the reader's channel count is out of
+    /// range, or aStride or aBlockRows is zero
+    RowBlockSource(IAudioFileReader& aReader,
+                   FFTSize aTransformSize,
+                   FFTWindow::Type aWindowType,
+                   FFTSize aStride,
+                   size_t aBlockRows,
+                   size_t aThreadCount = 0,
+                   FrameIndex aFirstFrame = FrameIndex{ 0 },
+                   std::optional<FrameCount> aFrameCount = std::nullopt,
+                   const IFFTProcessor::Factory& aFFTProcessorFactory = nullptr,
+                   const FFTWindowFactory& aFFTWindowFactory = nullptr);
+
+    /// @brief Destructor.  Waits for any read in flight.
+    ~RowBlockSource();
+
+    RowBlockSource(const RowBlockSource&) = delete;
+    RowBlockSource& operator=(const RowBlockSource&) = delete;
+    RowBlockSource(RowBlockSource&&) = delete;
+    RowBlockSource& operator=(RowBlockSource&&) = delete;
+
+    /// @brief Get the number of rows the range should produce
+    /// @return Expected row count, based on the reader's reported frame count
+    ///
+    /// If the reader delivers fewer frames than it reported, fewer rows are
+    /// produced.
+    [[nodiscard]] size_t GetExpectedRowCount() const { return mExpectedRowCount; }
+
+    /// @brief Get the number of frequency bins per row
+    [[nodiscard]] size_t GetBinCount() const { return mPipeline.GetBinCount(); }
+
+    /// @brief Get the number of channels
+    [[nodiscard]] ChannelCount GetChannelCount() const { return mChannelCount; }
+
+    /// @brief Get the number of rows produced so far, including the current block
+    [[nodiscard]] size_t GetRowsDone() const { return mRowsDone; }
+
+    /// @brief Compute the next block of rows
+    /// @return Number of rows in the block, or 0 when the range is exhausted
+    size_t NextBlock();
+
+    /// @brief Get the rows of the current block for one channel
+    /// @param aChannel Channel index
+    /// @return Row-major decibels, rows * GetBinCount() floats.  Valid until
+    /// the next call to NextBlock().
+    /// @throws std::out_of_range if aChannel is out of range
+    [[nodiscard]] std::span<const float> GetChannelRows(ChannelCount aChannel) const;
+
+    /// @brief Calculate the number of complete FFT windows in a run of frames
+    /// @param aFrameCount Number of frames
+    /// @param aTransformSize FFT window size
+    /// @param aStride Frames between successive windows
+    /// @return Number of rows
+    [[nodiscard]] static size_t CalculateRowCount(FrameCount aFrameCount,
+                                                  FFTSize aTransformSize,
+                                                  FFTSize aStride);
+
+  private:
+    /// @brief Start reading the next chunk on a background thread
+    void StartRead();
+
+    /// @brief Append a chunk of interleaved samples to the channel buffers,
+    /// dropping frames outside the requested range
+    /// @param aInterleaved Interleaved samples
+    void AppendChunk(const std::vector<float>& aInterleaved);
+
+    IAudioFileReader& mReader;
+    RowPipeline mPipeline;
+    ChannelCount mChannelCount;
+    FFTSize mTransformSize;
+    FFTSize mStride;
+    size_t mBlockRows;
+    FrameCount mChunkFrames;
+
+    size_t mExpectedRowCount{ 0 };
+    size_t mRowsDone{ 0 };
+    size_t mCurrentBlockRows{ 0 };
+
+    // Range bookkeeping, in frames of the underlying reader
+    size_t mFramesToSkip;
+    std::optional<size_t> mFramesRemaining;
+
+    // Per-channel samples not yet consumed.  The front of each buffer is the
+    // first sample of the next row to compute.
+    std::vector<std::vector<float>> mChannelSamples;
+    // Per-channel decibel rows for the current block
+    std::vector<std::vector<float>> mChannelRows;
+
+    std::future<std::vector<float>> mNextChunk;
+    bool mEndOfInput{ false };
+};
@@ -11,6 +11,8 @@
 #include "models/settings.h"
 #include <QAudioFormat>
 #include <QObject>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -91,3 +93,30 @@ SettingsController::StartRecording(const QByteArray& aDeviceId,
 
     return mRecorder.Start(*device, aChannels, aSampleRate);
 }
+
+bool
+SettingsController::ApplyAutoAperture(const float aFloorDecibels, const float aCeilingDecibels)
+{
+    if (!mSettings.IsAutoAperture()) {
+        return false;
+    }
+    if (std::abs(aFloorDecibels - mSettings.GetApertureFloorDecibels()) <
+          KAutoApertureStepDecibels &&
+        std::abs(aCeilingDecibels - mSettings.GetApertureCeilingDecibels()) <
+          KAutoApertureStepDecibels) {
+        return false;
+    }
+
+    const auto kLowest = static_cast<float>(Settings::KApertureLimitsDecibels.first);
+    const auto kHighest = static_cast<float>(Settings::KApertureLimitsDecibels.second);
+    const float kFloor =
+      std::clamp(std::round(aFloorDecibels), kLowest, kHighest - KMinAutoApertureDecibels);
+    const float kCeiling =
+      std::clamp(std::round(aCeilingDecibels), kFloor + KMinAutoApertureDecibels, kHighest);
+    if (kFloor == mSettings.GetApertureFloorDecibels() &&
+        kCeiling == mSettings.GetApertureCeilingDecibels()) {
+        return false;
+    }
+    mSettings.SetAperture(kFloor, kCeiling);
+    return true;
+}
@@ -23,12 +23,20 @@ class Settings;
 /// @brief Controller for application settings
 ///
 /// Coordinates the interaction between SettingsPanel (view) and Settings (model).
-/// Handles audio device enumeration, capability queries, and recording lifecycle.
+/// Handles audio device enumeration, capability queries, recording lifecycle,
+/// and the automatic aperture.
 class SettingsController : public QObject
 {
     Q_OBJECT
 
   public:
+    /// @brief Least change of either end that moves the automatic aperture
+    static constexpr float KAutoApertureStepDecibels = 2.0f;
+
+    /// @brief Least range the automatic aperture shows, so silence isn't
+    /// stretched across the color map
+    static constexpr float KMinAutoApertureDecibels = 20.0f;
+
     /// @brief Constructor
     /// @param aSettings Reference to the settings model
     /// @param aDeviceProvider Reference to the audio device provider
@@ -103,6 +111,18 @@ class SettingsController : public QObject
     /// @return true if playback is active
     [[nodiscard]] bool IsPlaying() const { return mPlayer.IsPlaying(); }
 
+    /// @brief Move the aperture to measured levels, if it is automatic
+    /// @param aFloorDecibels Measured floor, such as from
+    /// SpectrogramController::GetLiveAperture()
+    /// @param aCeilingDecibels Measured ceiling
+    /// @return true if the aperture changed
+    ///
+    /// Every change redraws the whole spectrogram, so the aperture only moves
+    /// once either end is KAutoApertureStepDecibels from the measurement.  It
+    /// then moves to whole decibels, at least KMinAutoApertureDecibels apart,
+    /// within Settings::KApertureLimitsDecibels.
+    bool ApplyAutoAperture(float aFloorDecibels, float aCeilingDecibels);
+
   private:
     Settings& mSettings;
     IMediaDevices& mAudioDeviceProvider;
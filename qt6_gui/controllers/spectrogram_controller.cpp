@@ -7,19 +7,34 @@
 #include "models/audio_buffer.h"
 #include "models/settings.h"
 #include <QObject>
+#include <algorithm>
+#include <array>
 #include <audio_types.h>
-#include <cassert>
+#include <block_summary_index.h>
+#include <cmath>
+#include <condition_variable>
 #include <cstddef>
-#include <cstdint>
 #include <fft_processor.h>
 #include <fft_window.h>
-#include <memory>
+#include <level_histogram.h>
+#include <mutex>
+#include <noise_floor_estimator.h>
 #include <optional>
+#include <peak_tracker.h>
 #include <span>
-#include <stdexcept>
+#include <stop_token>
+#include <thread>
 #include <utility>
 #include <vector>
 
+namespace {
+
+/// @brief Width of a third-octave band as a fraction of its centre,
+/// 2^(1/6) - 2^(-1/6)
+constexpr float KThirdOctaveWidth = 0.2316f;
+
+} // namespace
+
 SpectrogramController::SpectrogramController(const Settings& aSettings,
                                              const AudioBuffer& aAudioBuffer,
                                              const AudioPlayer& aAudioPlayer,
@@ -30,166 +45,338 @@ SpectrogramController::SpectrogramController(const Settings& aSettings,
   , mSettings(aSettings)
   , mAudioBuffer(aAudioBuffer)
   , mAudioPlayer(aAudioPlayer)
-  , mFFTProcessorFactory(std::move(aFFTProcessorFactory))
-  , mFFTWindowFactory(std::move(aFFTWindowFactory))
+  , mEngine(aAudioBuffer,
+            aSettings.GetFFTSize(),
+            aSettings.GetWindowType(),
+            std::move(aFFTProcessorFactory),
+            std::move(aFFTWindowFactory))
 {
-    // Provide default factories if none supplied
-    if (!mFFTProcessorFactory) {
-        mFFTProcessorFactory = [](FFTSize size) { return std::make_unique<FFTProcessor>(size); };
-    }
-
-    if (!mFFTWindowFactory) {
-        mFFTWindowFactory = [](FFTSize size, FFTWindow::Type type) {
-            return std::make_unique<FFTWindow>(size, type);
-        };
-    }
+    // No aperture shows anything below its lowest floor, so quieter windows
+    // can skip the FFT
+    mEngine.SetSilenceFloor(static_cast<float>(Settings::KApertureLimitsDecibels.first));
 
     // Reset FFT when settings update (such as size or window type)
     connect(&mSettings, &Settings::FFTSettingsChanged, this, &SpectrogramController::ResetFFT);
 
     // Reset FFT when audio buffer is reset (such as new recording or file load)
     connect(&mAudioBuffer, &AudioBuffer::BufferReset, this, &SpectrogramController::ResetFFT);
+    // The summary worker reads the buffer, so it stops while the buffer resets
+    connect(&mAudioBuffer,
+            &AudioBuffer::BufferAboutToReset,
+            this,
+            &SpectrogramController::StopSummaries);
+    connect(&mAudioBuffer, &AudioBuffer::BufferReset, this, [this] {
+        mSummaryIndex.Reset();
+        StartSummaries();
+    });
+
+    // Queued when the buffer is written from a capture thread
+    connect(
+      &mAudioBuffer, &AudioBuffer::DataAvailable, this, &SpectrogramController::OnDataAvailable);
+
+    mPeakTrackers.resize(mEngine.GetChannelCount());
+    mNoiseFloors.resize(mEngine.GetChannelCount());
+    UpdateHistoryModel();
+    StartSummaries();
+}
+
+void
+SpectrogramController::StartSummaries()
+{
+    {
+        const std::scoped_lock kLock(mSummaryMutex);
+        mSummaryPending = true; // Catch up with whatever the buffer holds
+        mSummaryBusy = false;
+    }
+    mSummaryThread =
+      std::jthread([this](const std::stop_token& aStopToken) { RunSummaries(aStopToken); });
+}
+
+void
+SpectrogramController::StopSummaries()
+{
+    if (mSummaryThread.joinable()) {
+        mSummaryThread.request_stop();
+        mSummaryThread.join();
+    }
+}
+
+void
+SpectrogramController::RunSummaries(const std::stop_token& aStopToken)
+{
+    std::unique_lock lock(mSummaryMutex);
+    while (mSummaryChanged.wait(lock, aStopToken, [this] { return mSummaryPending; })) {
+        mSummaryPending = false;
+        mSummaryBusy = true;
+        lock.unlock();
+        mSummaryIndex.Update(mAudioBuffer, aStopToken);
+        lock.lock();
+        mSummaryBusy = false;
+        mSummaryChanged.notify_all();
+    }
+}
 
-    // Initialize with default FFT settings
-    ResetFFT();
+void
+SpectrogramController::WaitForSummaries()
+{
+    std::unique_lock lock(mSummaryMutex);
+    mSummaryChanged.wait(lock, [this] { return !mSummaryPending && !mSummaryBusy; });
 }
 
 void
 SpectrogramController::ResetFFT()
 {
-    // Clear out the old DSP objects
-    mFFTProcessors.clear();
-    mFFTWindows.clear();
-    mSpectrogramRowCache.clear();
+    mEngine.Configure(mSettings.GetFFTSize(), mSettings.GetWindowType());
+    mPeakTrackers.assign(mEngine.GetChannelCount(), PeakTracker());
+    mNoiseFloors.assign(mEngine.GetChannelCount(), NoiseFloorEstimator());
+    mLiveLevels.Reset();
+    UpdateHistoryModel();
+    emit RowsInvalidated();
+}
+
+void
+SpectrogramController::UpdateHistoryModel()
+{
+    // Row decibels are 20 log10 |X| of the windowed FFT.  A tone of mean-square
+    // power P peaks at P (sum w)^2 / 2 in |X|^2, and noise of power P spread
+    // over a band of B Hz averages P sr (sum w^2) / (2 B) in each bin, with
+    // |X|^2 exponentially distributed about that mean.
+    const FFTSize kFFTSize = mSettings.GetFFTSize();
+    const std::vector<float> kWindow =
+      FFTWindow(kFFTSize, mSettings.GetWindowType()).Apply(std::vector<float>(kFFTSize, 1.0f));
+    double windowSum = 0.0;
+    double windowSquareSum = 0.0;
+    for (const float kCoefficient : kWindow) {
+        windowSum += kCoefficient;
+        windowSquareSum += static_cast<double>(kCoefficient) * kCoefficient;
+    }
+    const auto kSampleRate = static_cast<double>(mAudioBuffer.GetSampleRate());
+    mHistoryModel.tone_offset = static_cast<float>(10.0 * std::log10(windowSum * windowSum / 2.0));
 
-    // Create FFT and window instances for each channel
-    for (size_t i = 0; i < mAudioBuffer.GetChannelCount(); i++) {
-        auto fftProcessor = mFFTProcessorFactory(mSettings.GetFFTSize());
-        auto fftWindow = mFFTWindowFactory(mSettings.GetFFTSize(), mSettings.GetWindowType());
+    for (size_t level = 0; level < KNoiseLevelCount; level++) {
+        const double kFraction =
+          (static_cast<double>(level) + 0.5) / static_cast<double>(KNoiseLevelCount);
+        mHistoryModel.noise_spread[level] =
+          static_cast<float>(10.0 * std::log10(-std::log1p(-kFraction)));
+    }
 
-        mFFTProcessors.emplace_back(std::move(fftProcessor));
-        mFFTWindows.emplace_back(std::move(fftWindow));
+    for (size_t band = 0; band < BlockSummaryIndex::KBandCount; band++) {
+        const double kWidthHz = KThirdOctaveWidth * BlockSummaryIndex::GetBandCenterHz(band);
+        mHistoryModel.noise_offsets[band] =
+          static_cast<float>(10.0 * std::log10(kSampleRate * windowSquareSum / (2.0 * kWidthHz)));
+        // One of the band's bins holds the tone
+        const double kBins = kWidthHz * static_cast<double>(kFFTSize) / kSampleRate;
+        mHistoryModel.noise_bins[band] =
+          std::max(kBins - 1.0, 0.0) / static_cast<double>(KNoiseLevelCount);
     }
 }
 
-std::vector<std::vector<float>>
-SpectrogramController::GetRows(ChannelCount aChannel,
-                               FramePosition aFirstFrame,
-                               size_t aRowCount) const
+void
+SpectrogramController::OnDataAvailable(FrameCount aTotalFrameCount, FrameIndex aFirstNewFrame)
 {
-    if (aChannel >= mAudioBuffer.GetChannelCount()) {
-        throw std::out_of_range("Channel index out of range");
+    {
+        const std::scoped_lock kLock(mSummaryMutex);
+        mSummaryPending = true;
+    }
+    mSummaryChanged.notify_all();
+
+    const FFTSize kFFTSize = mSettings.GetFFTSize();
+    const FFTSize kStride = mSettings.GetWindowStride();
+
+    // A row at R is complete once R + FFT size <= available frames.  The rows
+    // this append completed are those that weren't complete before it.
+    const FramePosition kPreviousEnd = FrameCount{ aFirstNewFrame.Get() }.AsPosition();
+    const FramePosition kFirstRow =
+      std::max(RoundToStride(kPreviousEnd - kFFTSize) + kStride, FramePosition{ 0 });
+    const FramePosition kEndRow = RoundToStride(aTotalFrameCount.AsPosition() - kFFTSize) + kStride;
+    if (kFirstRow < kEndRow) {
+        AnalyzeRows(
+          kFirstRow, kEndRow, FrameCount{ aTotalFrameCount.Get() - aFirstNewFrame.Get() });
+        emit RowsCompleted(kFirstRow, kEndRow);
     }
+}
 
-    std::vector<std::vector<float>> spectrogram;
-    spectrogram.reserve(aRowCount);
+void
+SpectrogramController::AnalyzeRows(FramePosition aFirstRow,
+                                   FramePosition aEndRow,
+                                   FrameCount aAppendedFrames)
+{
+    // Analyzing a whole file as it loads would compute every row of it here,
+    // on the GUI thread.  Live input arrives in much smaller appends.
+    if (aAppendedFrames.Get() >= static_cast<size_t>(mAudioBuffer.GetSampleRate())) {
+        for (PeakTracker& tracker : mPeakTrackers) {
+            tracker.Reset();
+        }
+        for (NoiseFloorEstimator& estimator : mNoiseFloors) {
+            estimator.Reset();
+        }
+        mLiveLevels.Reset();
+        return;
+    }
 
-    const FFTSize kWindowStride = mSettings.GetWindowStride();
+    // Every channel's levels of a row count in the histogram before it ages
+    const FFTSize kStride = mSettings.GetWindowStride();
+    for (FramePosition row = aFirstRow; row < aEndRow; row = row + kStride) {
+        for (ChannelCount ch = 0; ch < mPeakTrackers.size(); ch++) {
+            const std::span<const float> kRow = mEngine.GetRowView(ch, row);
+            mPeakTrackers[ch].Update(kRow);
+            mNoiseFloors[ch].Update(kRow);
+            mLiveLevels.Add(kRow);
+        }
+        mLiveLevels.Age();
+    }
+    for (PeakTracker& tracker : mPeakTrackers) {
+        tracker.ClearFinishedTracks();
+    }
+}
 
-    for (size_t row = 0; row < aRowCount; row++) {
-        const FramePosition kWindowFirstSample = aFirstFrame + FrameCount{ row * kWindowStride };
-        const auto kSpectrum = GetRow(aChannel, kWindowFirstSample);
-        spectrogram.push_back(kSpectrum);
+std::vector<PeakTracker::Track>
+SpectrogramController::GetPeakTracks(ChannelCount aChannel) const
+{
+    const PeakTracker& kTracker = mPeakTrackers.at(aChannel);
+    std::vector<PeakTracker::Track> tracks;
+    for (const PeakTracker::Track& kTrack : kTracker.GetTracks()) {
+        if (kTrack.last_row + 1 == kTracker.GetRowCount() &&
+            kTrack.rows >= kTracker.GetConfig().min_track_rows) {
+            tracks.push_back(kTrack);
+        }
     }
-    return spectrogram;
+    return tracks;
 }
 
 std::vector<float>
-SpectrogramController::GetRow(ChannelCount aChannel, FramePosition aFirstFrame) const
+SpectrogramController::GetNoiseFloor(ChannelCount aChannel) const
+{
+    const std::span<const float> kFloor = mNoiseFloors.at(aChannel).GetFloor();
+    return { kFloor.begin(), kFloor.end() };
+}
+
+std::optional<SpectrogramController::Aperture>
+SpectrogramController::GetLiveAperture() const
+{
+    if (mLiveLevels.GetWeight() <= 0.0) {
+        return std::nullopt;
+    }
+    return Aperture{ .floor_decibels = mLiveLevels.GetQuantile(KApertureFloorQuantile),
+                     .ceiling_decibels = mLiveLevels.GetQuantile(KApertureCeilingQuantile) };
+}
+
+std::optional<SpectrogramController::Aperture>
+SpectrogramController::ComputeHistoryAperture(FramePosition aFirstFrame,
+                                              FramePosition aEndFrame) const
 {
-    if (aChannel >= mAudioBuffer.GetChannelCount()) {
-        throw std::out_of_range("Channel index out of range");
+    const auto kBlockFrames = static_cast<std::ptrdiff_t>(mSummaryIndex.GetBlockFrames().Get());
+    const auto kBlockCount = static_cast<std::ptrdiff_t>(mSummaryIndex.GetBlockCount());
+    const std::ptrdiff_t kFirstBlock =
+      std::max(aFirstFrame.Get() / kBlockFrames, std::ptrdiff_t{ 0 });
+    const std::ptrdiff_t kEndBlock =
+      std::min((aEndFrame.Get() + kBlockFrames - 1) / kBlockFrames, kBlockCount);
+    if (kFirstBlock >= kEndBlock) {
+        return std::nullopt;
     }
 
-    const FFTSize kFFTSize = mFFTWindows.at(aChannel)->GetSize();
-    // We want the number of samples in single channel
-    const FrameCount kAvailableFrames = GetAvailableFrameCount();
-    const FramePosition kLastNeededSample = aFirstFrame + kFFTSize;
-    // Check if the requested window is within available data, else return zeroed row
-    if (aFirstFrame < FramePosition{ 0 } || kLastNeededSample > kAvailableFrames.AsPosition()) {
-        return std::vector<float>((kFFTSize / 2) + 1, 0.0f);
+    // The offsets depend only on the FFT settings, so are worked out when
+    // they change, and the histogram is reused
+    const HistoryModel& kModel = mHistoryModel;
+    LevelHistogram& levels = mHistoryLevels;
+    levels.Reset();
+    for (std::ptrdiff_t block = kFirstBlock; block < kEndBlock; block++) {
+        const BlockSummaryIndex::Summary kSummary =
+          mSummaryIndex.GetSummary(static_cast<size_t>(block));
+        for (size_t band = 0; band < BlockSummaryIndex::KBandCount; band++) {
+            // Silent, or above the Nyquist frequency
+            if (kSummary.bands[band] == BlockSummaryIndex::KFloorDecibels) {
+                continue;
+            }
+            const auto kDecibels = static_cast<float>(kSummary.bands[band]);
+            levels.Add(kDecibels + kModel.tone_offset);
+            for (const float kSpread : kModel.noise_spread) {
+                levels.Add(kDecibels + kModel.noise_offsets[band] + kSpread,
+                           kModel.noise_bins[band]);
+            }
+        }
     }
+    if (levels.GetWeight() <= 0.0) {
+        return std::nullopt;
+    }
+    return Aperture{ .floor_decibels = levels.GetQuantile(KApertureFloorQuantile),
+                     .ceiling_decibels = levels.GetQuantile(KApertureCeilingQuantile) };
+}
 
-    // The aFirstFrame < 0 check above ensures this cast is safe
-    const FrameIndex kFirstFrameIndex(aFirstFrame.Get());
+std::vector<BlockSummaryIndex::TimeRange>
+SpectrogramController::FindBandPowerAbove(float aLowHz,
+                                          float aHighHz,
+                                          float aThresholdDecibels) const
+{
+    return mSummaryIndex.FindBandPowerAbove(aLowHz, aHighHz, aThresholdDecibels);
+}
 
-    // Check cache first
-    const std::pair<ChannelCount, FrameIndex> cacheKey = { aChannel, kFirstFrameIndex };
+std::vector<std::vector<float>>
+SpectrogramController::GetRows(ChannelCount aChannel,
+                               FramePosition aFirstFrame,
+                               size_t aRowCount) const
+{
+    return mEngine.GetRows(aChannel, aFirstFrame, aRowCount, mSettings.GetWindowStride());
+}
 
-    const auto cacheIt = mSpectrogramRowCache.find(cacheKey);
-    if (cacheIt != mSpectrogramRowCache.end()) {
-        // Found in cache
-        return cacheIt->second;
-    }
+std::vector<std::vector<std::vector<float>>>
+SpectrogramController::GetChannelRows(FramePosition aFirstFrame, size_t aRowCount) const
+{
+    return mEngine.GetChannelRows(aFirstFrame, aRowCount, mSettings.GetWindowStride());
+}
 
-    // Not in cache, compute it
-    const auto kSpectrum = ComputeFFT(aChannel, kFirstFrameIndex);
-    // Store in cache
-    mSpectrogramRowCache.emplace(cacheKey, kSpectrum);
+void
+SpectrogramController::GetChannelRowViews(FramePosition aFirstFrame,
+                                          size_t aRowCount,
+                                          SpectrogramEngine::RowViews& aViews) const
+{
+    mEngine.GetChannelRowViews(aFirstFrame, aRowCount, mSettings.GetWindowStride(), aViews);
+}
 
-    return kSpectrum;
+std::vector<float>
+SpectrogramController::GetRow(ChannelCount aChannel, FramePosition aFirstFrame) const
+{
+    return mEngine.GetRow(aChannel, aFirstFrame);
 }
 
 std::vector<float>
 SpectrogramController::ComputeFFT(ChannelCount aChannel, FrameIndex aFirstFrame) const
 {
-    const FFTSize kFFTSize = mFFTWindows.at(aChannel)->GetSize();
-    // We need to convert FrameIndex to SampleIndex for audio buffer access
-    const SampleIndex kFirstSample(aFirstFrame.Get());
-    // Future performance optimization: grab the entire needed range once
-    // before the loop to minimize locking and copy overhead.
-    const auto kSamples = mAudioBuffer.GetSamples(aChannel, kFirstSample, SampleCount(kFFTSize));
-    auto windowedSamples = mFFTWindows[aChannel]->Apply(kSamples);
-    auto windowedSpan = std::span<float>(windowedSamples);
-    return mFFTProcessors[aChannel]->ComputeDecibels(windowedSpan);
+    return mEngine.ComputeFFT(aChannel, aFirstFrame);
 }
 
 FrameCount
 SpectrogramController::GetAvailableFrameCount() const
 {
-    return mAudioBuffer.GetFrameCount();
+    return mEngine.GetAvailableFrameCount();
 }
 
 ChannelCount
 SpectrogramController::GetChannelCount() const
 {
-    return mAudioBuffer.GetChannelCount();
+    return mEngine.GetChannelCount();
 }
 
 FramePosition
 SpectrogramController::CalculateTopOfWindow(FramePosition aCursorFrame) const
 {
-    const FramePosition kUnalignedFrame = aCursorFrame - mSettings.GetFFTSize();
-    return RoundToStride(kUnalignedFrame);
+    return mEngine.CalculateTopOfWindow(aCursorFrame, mSettings.GetWindowStride());
 }
 
 FramePosition
 SpectrogramController::RoundToStride(FramePosition aFrame) const
 {
-    const int64_t kStride = static_cast<int64_t>(mSettings.GetWindowStride());
-
-    // Calculate floor(aFrame / kStride) for both positive and negative values.
-    // For positive values, this is just integer division.
-    // For negative values, division truncates toward zero, so we use:
-    //      ceil(n / d) == ( n + d - 1) / d
-    //     ceil(-n / d) == (-n + d - 1) / d
-    //     floor(n / d) == -ceil(-n / d)
-    //                  == -((-n + d - 1) / d)
-    const int64_t kStrideIndex =
-      aFrame.Get() >= 0 ? aFrame.Get() / kStride : -((-aFrame.Get() + kStride - 1) / kStride);
-    return FramePosition{ kStrideIndex * kStride };
+    return SpectrogramEngine::RoundToStride(aFrame, mSettings.GetWindowStride());
 }
 
 float
 SpectrogramController::GetHzPerBin() const
 {
-    const SampleRate kSampleRate = mAudioBuffer.GetSampleRate();
-    const FFTSize kFFTSize = mSettings.GetFFTSize();
-    return static_cast<float>(kSampleRate) / static_cast<float>(kFFTSize);
+    return mEngine.GetHzPerBin();
 }
 
 std::optional<FrameIndex>
 SpectrogramController::GetPlaybackFrame() const
 {
     return mAudioPlayer.CurrentFrame();
-}
\ No newline at end of file
+}
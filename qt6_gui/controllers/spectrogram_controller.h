@@ -7,21 +7,37 @@
 #include "models/audio_buffer.h"
 #include "models/settings.h"
 #include <QObject>
+#include <array>
 #include <audio_types.h>
+#include <block_summary_index.h>
+#include <condition_variable>
 #include <cstddef>
 #include <fft_processor.h>
 #include <fft_window.h>
-#include <map>
-#include <memory>
+#include <level_histogram.h>
+#include <memory_budget.h>
+#include <mutex>
+#include <noise_floor_estimator.h>
 #include <optional>
-#include <utility>
+#include <peak_tracker.h>
+#include <spectrogram_engine.h>
+#include <stop_token>
+#include <thread>
 #include <vector>
 
 /// @brief Controller for spectrogram data flow and view state
 ///
 /// Coordinates the data flow between AudioBuffer (model) and SpectrogramView (view).
-/// Owns FFT processing components (FFTProcessor, FFTWindow) per channel.
-/// Manages view state including live/historical mode and scroll position.
+/// A thin Qt adapter over SpectrogramEngine, which owns the FFT processing
+/// components and row cache: this class keeps the engine in step with Settings
+/// and AudioBuffer, and supplies the current stride.  It also translates
+/// appended audio into the rows it completes, so views can repaint just those,
+/// and keeps a BlockSummaryIndex of the recording up to date for searches.
+/// The index is updated on a worker thread, since a file load completes
+/// hundreds of blocks at once.
+/// Rows completed by live input are also fed to a PeakTracker and a
+/// NoiseFloorEstimator per channel, and to one LevelHistogram for the
+/// automatic aperture.
 class SpectrogramController : public QObject
 {
     Q_OBJECT
@@ -30,6 +46,22 @@ class SpectrogramController : public QObject
     static constexpr FFTSize KDefaultFftSize = 2048;
     static constexpr auto KDefaultWindowType = FFTWindow::Type::Hann;
 
+    /// @brief Fractions of the levels shown below the automatic aperture's
+    /// floor and ceiling
+    static constexpr double KApertureFloorQuantile = 0.05;
+    static constexpr double KApertureCeilingQuantile = 0.999;
+
+    /// @brief Rows for a live level's weight in the automatic aperture to
+    /// halve: about two seconds at 48 kHz with the default stride
+    static constexpr float KApertureHalfLifeRows = 100.0f;
+
+    /// @brief An aperture, in row decibels
+    struct Aperture
+    {
+        float floor_decibels{};
+        float ceiling_decibels{};
+    };
+
     /// @brief Constructor
     /// @param aSettings Reference to application settings model
     /// @param aAudioBuffer Reference to the audio buffer model
@@ -60,6 +92,25 @@ class SpectrogramController : public QObject
                                                           FramePosition aFirstFrame,
                                                           size_t aRowCount) const;
 
+    /// @brief Get spectrogram rows for every channel
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aRowCount Number of rows to compute
+    /// @return 3D vector [channel][aRowCount][frequency_bins]
+    /// @note Channels with rows to compute are computed in parallel
+    [[nodiscard]] std::vector<std::vector<std::vector<float>>> GetChannelRows(
+      FramePosition aFirstFrame,
+      size_t aRowCount) const;
+
+    /// @brief Get views of spectrogram rows for every channel, without copying
+    /// @param aFirstFrame First frame position (aligned to stride)
+    /// @param aRowCount Number of rows to compute
+    /// @param aViews Resized to [channel][aRowCount] and filled with row views
+    /// @note The views are valid until the transform settings change.  See
+    /// SpectrogramEngine::GetChannelRowViews().
+    void GetChannelRowViews(FramePosition aFirstFrame,
+                            size_t aRowCount,
+                            SpectrogramEngine::RowViews& aViews) const;
+
     /// @brief Get a single spectrogram row for a channel
     /// @param aChannel Channel index (0-based)
     /// @param aFirstFrame First frame position (aligned to stride)
@@ -91,8 +142,7 @@ class SpectrogramController : public QObject
     /// @brief Reset FFT processing components
     ///
     /// Clears spectrogram cache, recreates FFTProcessor and FFTWindow for each
-    /// channel.  Called when settings or audio buffer change.  Also used during
-    /// initialization.
+    /// channel.  Called when settings or audio buffer change.
     void ResetFFT();
 
     /// @brief Get reference to application settings
@@ -118,19 +168,154 @@ class SpectrogramController : public QObject
     /// @return Current playback position as FrameIndex, or std::nullopt if not playing
     [[nodiscard]] std::optional<FrameIndex> GetPlaybackFrame() const;
 
+    /// @brief Find when the power in a frequency range reached a level
+    /// @param aLowHz Lowest third-octave band centre to include
+    /// @param aHighHz Highest third-octave band centre to include
+    /// @param aThresholdDecibels Level relative to full scale
+    /// @return Time ranges in milliseconds from the start of the recording
+    /// @throws std::invalid_argument if no band centre lies in [aLowHz, aHighHz]
+    /// @note Searches the block summaries, so covers every complete block of
+    /// BlockSummaryIndex::KDefaultBlockFrames summarized so far without
+    /// reading samples.  See WaitForSummaries().
+    [[nodiscard]] std::vector<BlockSummaryIndex::TimeRange> FindBandPowerAbove(
+      float aLowHz,
+      float aHighHz,
+      float aThresholdDecibels) const;
+
+    /// @brief Get the established peak tracks of a channel
+    /// @param aChannel Channel index (0-based)
+    /// @return Tracks with a peak in the newest completed row and at least
+    /// PeakTracker::Config::min_track_rows rows, loudest first
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @note Only live input is tracked.  An append of a second or more, such as
+    /// a file load, restarts tracking rather than computing every row.
+    [[nodiscard]] std::vector<PeakTracker::Track> GetPeakTracks(ChannelCount aChannel) const;
+
+    /// @brief Get the estimated noise floor of a channel
+    /// @param aChannel Channel index (0-based)
+    /// @return Decibels per bin, or empty until a live row completes
+    /// @throws std::out_of_range if aChannel is invalid
+    /// @note Updated as live rows complete, as GetPeakTracks() is, so this
+    /// only copies the current estimate
+    [[nodiscard]] std::vector<float> GetNoiseFloor(ChannelCount aChannel) const;
+
+    /// @brief Get the automatic aperture of the live rows
+    /// @return The KApertureFloorQuantile and KApertureCeilingQuantile of every
+    /// channel's levels, weighted toward the newest rows, or std::nullopt until
+    /// a live row completes
+    /// @note Updated as live rows complete, as GetPeakTracks() is, so this only
+    /// reads the histogram
+    [[nodiscard]] std::optional<Aperture> GetLiveAperture() const;
+
+    /// @brief Estimate the automatic aperture of a range of the recording
+    /// @param aFirstFrame First frame of the range
+    /// @param aEndFrame Frame after the last of the range
+    /// @return Estimated quantiles of the levels of the rows in the range, or
+    /// std::nullopt if no block summarized so far overlaps it
+    /// @note Reads the block summaries instead of computing rows, so is cheap
+    /// enough to call as the view scrolls, but approximate: each third-octave
+    /// band of a block is taken as one tone over noise spread evenly across
+    /// the band's bins, scaled to the current FFT size and window.  The floor
+    /// of noise comes out within a decibel or so, but its ceiling comes out
+    /// high, by up to the band's width in bins, which leaves headroom.
+    /// @note Does not match GetLiveAperture() for the same audio, which
+    /// measures every channel's rows and favours the newest.  The summaries
+    /// average power over channels, so a sound on one of two channels comes
+    /// out 3 dB lower here.  For steady noise the floors agree within 1.5 dB
+    /// and this ceiling is the higher, so switching from live to history
+    /// never clips what the live aperture showed.
+    [[nodiscard]] std::optional<Aperture> ComputeHistoryAperture(FramePosition aFirstFrame,
+                                                                 FramePosition aEndFrame) const;
+
+    /// @brief Wait until every complete block appended so far is summarized
+    ///
+    /// Blocks are summarized on a worker thread, so a search or history
+    /// aperture just after an append may not include it yet.  For tests and
+    /// callers that need the whole recording.
+    void WaitForSummaries();
+
+    /// @brief Get the row cache, for registration with a MemoryBudget
+    [[nodiscard]] IMemoryConsumer& GetRowCache() { return mEngine; }
+
+  signals:
+    /// @brief Emitted when appended audio completes spectrogram rows
+    /// @param aFirstRow First frame of the first newly completed row
+    /// @param aEndRow First frame of the row after the last newly completed one
+    ///
+    /// A row completes once its whole transform window is available.  Rows are
+    /// stride-aligned, and all channels share one timeline, so the range
+    /// applies to every channel.
+    void RowsCompleted(FramePosition aFirstRow, FramePosition aEndRow);
+
+    /// @brief Emitted after ResetFFT(), when any previously returned row may
+    /// have changed
+    void RowsInvalidated();
+
   private:
+    /// @brief Equally likely levels a bin of noise is spread over
+    static constexpr size_t KNoiseLevelCount = 32;
+
+    /// @brief How ComputeHistoryAperture() turns a block summary into levels
+    /// of rows.  Depends only on the FFT settings and the sample rate.
+    struct HistoryModel
+    {
+        float tone_offset = 0.0f; ///< From band power to a tone's peak bin
+        std::array<float, KNoiseLevelCount> noise_spread{}; ///< Of one bin about its mean
+        std::array<float, BlockSummaryIndex::KBandCount> noise_offsets{}; ///< To a bin's mean
+        std::array<double, BlockSummaryIndex::KBandCount> noise_bins{};   ///< Per spread level
+    };
+
+    /// @brief Recompute mHistoryModel for the current FFT settings and sample rate
+    void UpdateHistoryModel();
+
+    /// @brief Wake the summary worker and emit RowsCompleted() for the rows an
+    /// append completed
+    /// @param aTotalFrameCount Frames available after the append
+    /// @param aFirstNewFrame First appended frame
+    void OnDataAvailable(FrameCount aTotalFrameCount, FrameIndex aFirstNewFrame);
+
+    /// @brief Feed newly completed rows to the peak trackers, noise floor
+    /// estimators and level histogram
+    /// @param aFirstRow First frame of the first newly completed row
+    /// @param aEndRow First frame of the row after the last newly completed one
+    /// @param aAppendedFrames Frames in the append that completed them
+    void AnalyzeRows(FramePosition aFirstRow, FramePosition aEndRow, FrameCount aAppendedFrames);
+
+    /// @brief Start the summary worker
+    void StartSummaries();
+
+    /// @brief Stop the summary worker and wait for it, before the buffer resets
+    void StopSummaries();
+
+    /// @brief Summarize new blocks each time OnDataAvailable() asks, until
+    /// stopped.  Runs on mSummaryThread.
+    /// @param aStopToken Stops the worker
+    void RunSummaries(const std::stop_token& aStopToken);
+
     const Settings& mSettings;       // Reference to application settings model
     const AudioBuffer& mAudioBuffer; // Reference to audio buffer model
     const AudioPlayer& mAudioPlayer; // Reference to audio player
 
-    // FFT processing components (per channel)
-    std::vector<std::unique_ptr<IFFTProcessor>> mFFTProcessors;
-    std::vector<std::unique_ptr<FFTWindow>> mFFTWindows;
+    // FFT processing and row cache
+    SpectrogramEngine mEngine;
+
+    // Levels per block, for searching the whole recording
+    BlockSummaryIndex mSummaryIndex;
+    HistoryModel mHistoryModel;
+    mutable LevelHistogram mHistoryLevels; // Scratch for ComputeHistoryAperture()
+
+    // Peaks and noise floor of live rows, one of each per channel
+    std::vector<PeakTracker> mPeakTrackers;
+    std::vector<NoiseFloorEstimator> mNoiseFloors;
 
-    IFFTProcessor::Factory mFFTProcessorFactory;
-    FFTWindowFactory mFFTWindowFactory;
+    // Levels of live rows, of every channel, for the automatic aperture
+    LevelHistogram mLiveLevels{ { .half_life_rows = KApertureHalfLifeRows } };
 
-    // Spectrogram row cache.  Key: (channel, first frame).  Stores a single row
-    // of spectrogram data for reuse.
-    mutable std::map<std::pair<ChannelCount, FrameIndex>, std::vector<float>> mSpectrogramRowCache;
+    // Worker that updates mSummaryIndex.  Declared last, so it stops before
+    // anything it uses is destroyed.
+    std::mutex mSummaryMutex;
+    std::condition_variable_any mSummaryChanged; // Work requested, or done
+    bool mSummaryPending = false;                // Guarded by mSummaryMutex
+    bool mSummaryBusy = false;                   // Guarded by mSummaryMutex
+    std::jthread mSummaryThread;
 };
@@ -0,0 +1,352 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/spectrogram_exporter.h"
+#include "adapters/audio_file_reader.h"
+#include "controllers/row_block_source.h"
+#include "include/global_constants.h"
+#include "models/settings.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <algorithm>
+#include <audio_types.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <fft_window.h>
+#include <format>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief Store a value as little-endian bytes
+template<typename T>
+void
+StoreLittleEndian(T aValue, std::byte* aOut)
+{
+    if constexpr (std::endian::native == std::endian::big) {
+        aValue = std::byteswap(aValue);
+    }
+    std::memcpy(aOut, &aValue, sizeof(T));
+}
+
+/// @brief Get the size in bytes of one exported value
+size_t
+BytesPerValue(SpectrogramExporter::Format aFormat)
+{
+    return aFormat == SpectrogramExporter::Format::Float16 ? sizeof(uint16_t) : sizeof(float);
+}
+
+/// @brief Get the NumPy dtype string for a format
+std::string_view
+DType(SpectrogramExporter::Format aFormat)
+{
+    return aFormat == SpectrogramExporter::Format::Float16 ? "<f2" : "<f4";
+}
+
+/// @brief Convert the current block of a RowBlockSource to output bytes
+/// @param aSource Source positioned on the block to convert
+/// @param aRows Number of rows in the block
+/// @param aFormat Output format
+/// @param aOut Destination, resized to fit.  Reused between blocks to avoid
+/// reallocating.
+void
+ConvertBlock(const RowBlockSource& aSource,
+             size_t aRows,
+             SpectrogramExporter::Format aFormat,
+             std::vector<std::byte>& aOut)
+{
+    const ChannelCount kChannels = aSource.GetChannelCount();
+    const size_t kBins = aSource.GetBinCount();
+    const size_t kValueBytes = BytesPerValue(aFormat);
+    aOut.resize(aRows * kChannels * kBins * kValueBytes);
+
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        const auto kRows = aSource.GetChannelRows(ch);
+        for (size_t row = 0; row < aRows; row++) {
+            const auto kRow = kRows.subspan(row * kBins, kBins);
+            std::byte* out = aOut.data() + (((row * kChannels) + ch) * kBins * kValueBytes);
+            for (const float kValue : kRow) {
+                // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                if (aFormat == SpectrogramExporter::Format::Float16) {
+                    StoreLittleEndian(SpectrogramExporter::FloatToHalf(kValue), out);
+                } else {
+                    StoreLittleEndian(std::bit_cast<uint32_t>(kValue), out);
+                }
+                out += kValueBytes;
+                // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+        }
+    }
+}
+
+/// @brief Write a whole buffer to a file
+/// @return true if every byte was written
+bool
+WriteAll(QFile& aFile, const std::vector<std::byte>& aData)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* const kBytes = reinterpret_cast<const char*>(aData.data());
+    return aFile.write(kBytes, static_cast<qint64>(aData.size())) ==
+           static_cast<qint64>(aData.size());
+}
+
+} // namespace
+
+SpectrogramExporter::SpectrogramExporter(const Settings& aSettings,
+                                         Options aOptions,
+                                         IFFTProcessor::Factory aFFTProcessorFactory,
+                                         FFTWindowFactory aFFTWindowFactory)
+  : mSettings(aSettings)
+  , mOptions(aOptions)
+  , mFFTProcessorFactory(std::move(aFFTProcessorFactory))
+  , mFFTWindowFactory(std::move(aFFTWindowFactory))
+{
+    if (mOptions.block_rows == 0) {
+        throw std::invalid_argument("Block rows must be positive");
+    }
+}
+
+std::expected<SpectrogramExporter::Result, std::string>
+SpectrogramExporter::ExportFile(const std::string& aInputPath,
+                                const std::string& aOutputPath,
+                                FrameIndex aFirstFrame,
+                                std::optional<FrameCount> aFrameCount) const
+{
+    auto readerResult = AudioFileReader::Open(aInputPath);
+    if (!readerResult) {
+        return std::unexpected(readerResult.error());
+    }
+    return Export(*readerResult, aOutputPath, aFirstFrame, aFrameCount);
+}
+
+std::expected<SpectrogramExporter::Result, std::string>
+SpectrogramExporter::Export(IAudioFileReader& aReader,
+                            const std::string& aOutputPath,
+                            FrameIndex aFirstFrame,
+                            std::optional<FrameCount> aFrameCount,
+                            const ProgressCallback& aProgressCallback) const
+{
+    const ChannelCount kChannels = aReader.GetChannelCount();
+    if (kChannels > GKMaxChannels || kChannels < 1) {
+        return std::unexpected(
+          std::format("channel count {} out of range [1, {}]", kChannels, GKMaxChannels));
+    }
+
+    RowBlockSource source(aReader,
+                          mSettings.GetFFTSize(),
+                          mSettings.GetWindowType(),
+                          mSettings.GetWindowStride(),
+                          mOptions.block_rows,
+                          mOptions.thread_count,
+                          aFirstFrame,
+                          aFrameCount,
+                          mFFTProcessorFactory,
+                          mFFTWindowFactory);
+    const size_t kExpectedRows = source.GetExpectedRowCount();
+    const size_t kBins = source.GetBinCount();
+    if (kExpectedRows == 0) {
+        return std::unexpected("Range is shorter than one FFT window");
+    }
+
+    QFile file(QString::fromStdString(aOutputPath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        return std::unexpected(
+          std::format("Failed to open {}: {}", aOutputPath, file.errorString().toStdString()));
+    }
+
+    const bool kIsNpy = mOptions.format == Format::Npy;
+    if (kIsNpy) {
+        const std::string kHeader =
+          BuildNpyHeader(mOptions.format, kExpectedRows, kChannels, kBins);
+        if (file.write(kHeader.data(), static_cast<qint64>(kHeader.size())) !=
+            static_cast<qint64>(kHeader.size())) {
+            return std::unexpected(std::format("Failed to write {}", aOutputPath));
+        }
+    }
+
+    // Double buffered: one block is written in the background while the next
+    // is transformed and converted.
+    std::vector<std::byte> fillBuffer;
+    std::vector<std::byte> writeBuffer;
+    std::future<bool> pendingWrite;
+    bool writeFailed = false;
+    auto finishPendingWrite = [&] {
+        if (pendingWrite.valid() && !pendingWrite.get()) {
+            writeFailed = true;
+        }
+    };
+
+    size_t rowsWritten = 0;
+    bool cancelled = false;
+    for (size_t rows = source.NextBlock(); rows > 0 && !writeFailed; rows = source.NextBlock()) {
+        ConvertBlock(source, rows, mOptions.format, fillBuffer);
+        finishPendingWrite();
+        std::swap(fillBuffer, writeBuffer);
+        pendingWrite = std::async(std::launch::async, [&file, &writeBuffer] {
+            return WriteAll(file, writeBuffer);
+        });
+        rowsWritten += rows;
+        if (aProgressCallback && !aProgressCallback(rowsWritten, kExpectedRows)) {
+            cancelled = true;
+            break;
+        }
+    }
+    finishPendingWrite();
+    if (cancelled) {
+        file.remove();
+        return std::unexpected("Export cancelled");
+    }
+    if (writeFailed) {
+        return std::unexpected(
+          std::format("Failed to write {}: {}", aOutputPath, file.errorString().toStdString()));
+    }
+
+    // A truncated file may not supply every row the header promised
+    if (kIsNpy && rowsWritten != kExpectedRows) {
+        const std::string kHeader = BuildNpyHeader(mOptions.format, rowsWritten, kChannels, kBins);
+        if (!file.seek(0) || file.write(kHeader.data(), static_cast<qint64>(kHeader.size())) !=
+                               static_cast<qint64>(kHeader.size())) {
+            return std::unexpected(std::format("Failed to write {}", aOutputPath));
+        }
+    }
+    file.close();
+
+    const SampleRate kSampleRate = aReader.GetSampleRate();
+    const FFTSize kStride = mSettings.GetWindowStride();
+    const auto kWindowIt = std::ranges::find(
+      FFTWindow::TypeNames,
+      mSettings.GetWindowType(),
+      &std::pair<FFTWindow::Type, std::string_view>::first);
+    const auto kFormatIt = std::ranges::find(
+      FormatNames, mOptions.format, &std::pair<Format, std::string_view>::first);
+
+    QJsonObject sidecar;
+    sidecar["data_file"] = QFileInfo(QString::fromStdString(aOutputPath)).fileName();
+    sidecar["format"] = QString::fromUtf8(kFormatIt->second);
+    sidecar["dtype"] = QString::fromUtf8(DType(mOptions.format));
+    sidecar["data_offset"] = static_cast<qint64>(kIsNpy ? KNpyHeaderSize : 0);
+    sidecar["layout"] = "rows, channels, bins";
+    sidecar["shape"] = QJsonArray{ static_cast<qint64>(rowsWritten),
+                                   static_cast<qint64>(kChannels),
+                                   static_cast<qint64>(kBins) };
+    sidecar["unit"] = "dB";
+    sidecar["sample_rate"] = kSampleRate;
+    sidecar["fft_size"] = static_cast<qint64>(mSettings.GetFFTSize().Get());
+    sidecar["window"] = QString::fromUtf8(kWindowIt->second);
+    sidecar["window_scale"] = static_cast<qint64>(mSettings.GetWindowScale());
+    sidecar["stride"] = static_cast<qint64>(kStride.Get());
+    sidecar["first_frame"] = static_cast<qint64>(aFirstFrame.Get());
+    sidecar["hz_per_bin"] =
+      static_cast<double>(kSampleRate) / static_cast<double>(mSettings.GetFFTSize().Get());
+    sidecar["seconds_per_row"] =
+      static_cast<double>(kStride.Get()) / static_cast<double>(kSampleRate);
+
+    Result result{ .row_count = rowsWritten,
+                   .bin_count = kBins,
+                   .channel_count = kChannels,
+                   .data_path = aOutputPath,
+                   .sidecar_path = aOutputPath + ".json" };
+
+    QFile sidecarFile(QString::fromStdString(result.sidecar_path));
+    const QByteArray kJson = QJsonDocument(sidecar).toJson();
+    if (!sidecarFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        sidecarFile.write(kJson) != kJson.size()) {
+        return std::unexpected(std::format("Failed to write {}", result.sidecar_path));
+    }
+    return result;
+}
+
+std::string_view
+SpectrogramExporter::FileExtension(Format aFormat)
+{
+    switch (aFormat) {
+        case Format::Npy:
+            return ".npy";
+        case Format::Float32:
+            return ".f32";
+        case Format::Float16:
+            return ".f16";
+    }
+    return ".bin";
+}
+
+std::string
+SpectrogramExporter::BuildNpyHeader(Format aFormat,
+                                    size_t aRowCount,
+                                    ChannelCount aChannelCount,
+                                    size_t aBinCount)
+{
+    // Magic, version 1.0, then a little-endian uint16 length of the header
+    // dictionary.  The dictionary is padded with spaces and terminated with
+    // a newline so the data starts at KNpyHeaderSize.
+    constexpr size_t kMagicSize = 8;
+    constexpr std::string_view kMagic("\x93NUMPY\x01\x00", kMagicSize);
+    constexpr size_t kPreambleSize = kMagic.size() + sizeof(uint16_t);
+    constexpr size_t kDictSize = KNpyHeaderSize - kPreambleSize;
+
+    std::string dict =
+      std::format("{{'descr': '{}', 'fortran_order': False, 'shape': ({}, {}, {}), }}",
+                  DType(aFormat),
+                  aRowCount,
+                  aChannelCount,
+                  aBinCount);
+    dict.resize(kDictSize - 1, ' ');
+    dict.push_back('\n');
+
+    std::string header(kMagic);
+    header.push_back(static_cast<char>(kDictSize & 0xFFU));
+    header.push_back(static_cast<char>(kDictSize >> 8U));
+    header += dict;
+    return header;
+}
+
+uint16_t
+SpectrogramExporter::FloatToHalf(float aValue)
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    const auto kBits = std::bit_cast<uint32_t>(aValue);
+    const uint32_t kSign = (kBits >> 16U) & 0x8000U;
+    const uint32_t kExponent = (kBits >> 23U) & 0xFFU;
+    const uint32_t kMantissa = kBits & 0x7FFFFFU;
+
+    // Round away the low aShift bits, to nearest with ties to even
+    auto roundShift = [](uint32_t aValue, uint32_t aShift) {
+        const uint32_t kKept = aValue >> aShift;
+        const uint32_t kRemainder = aValue & ((1U << aShift) - 1U);
+        const uint32_t kHalfway = 1U << (aShift - 1U);
+        const bool kRoundUp = kRemainder > kHalfway || (kRemainder == kHalfway && (kKept & 1U));
+        return kKept + (kRoundUp ? 1U : 0U);
+    };
+
+    uint32_t half = 0;
+    const int kHalfExponent = static_cast<int>(kExponent) - 127 + 15; // Rebias
+    if (kExponent == 0xFFU) {
+        // Infinity, or NaN with the quiet bit set so it stays NaN
+        half = 0x7C00U | (kMantissa != 0 ? 0x200U : 0U);
+    } else if (kHalfExponent >= 0x1F) {
+        half = 0x7C00U;
+    } else if (kHalfExponent > 0) {
+        // A carry out of the mantissa correctly bumps the exponent, up to infinity
+        half = roundShift((static_cast<uint32_t>(kHalfExponent) << 23U) | kMantissa, 13U);
+    } else if (kHalfExponent >= -10) {
+        // Subnormal half: shift in the implicit leading bit
+        half = roundShift(kMantissa | 0x800000U, static_cast<uint32_t>(14 - kHalfExponent));
+    }
+    // Anything smaller rounds to signed zero
+    return static_cast<uint16_t>(kSign | half);
+    // NOLINTEND(readability-magic-numbers)
+}
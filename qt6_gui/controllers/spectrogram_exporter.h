@@ -0,0 +1,156 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+#include "adapters/audio_file_reader.h"
+#include "models/settings.h"
+#include <array>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fft_processor.h>
+#include <fft_window.h>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/// @brief Exports raw spectrogram rows for offline analysis
+///
+/// Streams decibel rows for a file or a range of frames to disk, for use in
+/// NumPy, MATLAB, or anything else that can read a flat array of floats.  Rows
+/// are computed in blocks by a RowBlockSource, and each block is converted and
+/// written with one large sequential write while the next block is being
+/// transformed, so long exports are limited by disk bandwidth rather than FFT
+/// throughput.
+///
+/// The data is C-order with shape (rows, channels, bins), little-endian.  Each
+/// row is one FFT window, oldest first, and bin 0 is DC.  A JSON sidecar next
+/// to the data file records the settings needed to interpret it.
+class SpectrogramExporter
+{
+  public:
+    /// @brief Output data format
+    enum class Format : uint8_t
+    {
+        Npy,     ///< NumPy .npy file, float32
+        Float32, ///< Headerless little-endian float32
+        Float16, ///< Headerless little-endian IEEE half precision
+    };
+
+    /// @brief Format names, used for command line options and the sidecar
+    static constexpr std::array<std::pair<Format, std::string_view>, 3> FormatNames{ {
+      { Format::Npy, "npy" },
+      { Format::Float32, "f32" },
+      { Format::Float16, "f16" },
+    } };
+
+    static constexpr size_t KDefaultBlockRows = 512;
+
+    /// @brief Size of the .npy header, including magic and padding
+    ///
+    /// The header is padded to a fixed size so it can be rewritten in place if
+    /// the reader delivers fewer rows than it promised.
+    static constexpr size_t KNpyHeaderSize = 128;
+
+    /// @brief Export options that are not part of Settings
+    struct Options
+    {
+        Format format = Format::Npy;
+        size_t block_rows = KDefaultBlockRows; ///< Rows computed and written per block
+        size_t thread_count = 0; ///< FFT worker threads, 0 for hardware concurrency
+    };
+
+    /// @brief Progress callback, called after each block is computed
+    /// @param aRowsDone Rows computed so far
+    /// @param aRowCount Rows the range should produce
+    /// @return false to cancel the export
+    using ProgressCallback = std::function<bool(size_t aRowsDone, size_t aRowCount)>;
+
+    /// @brief Summary of a completed export
+    struct Result
+    {
+        size_t row_count = 0;
+        size_t bin_count = 0;
+        ChannelCount channel_count = 0;
+        std::string data_path;
+        std::string sidecar_path;
+    };
+
+    /// @brief Constructor
+    /// @param aSettings FFT settings to export with
+    /// @param aOptions Export options
+    /// @param aFFTProcessorFactory Factory for FFT processors (optional)
+    /// @param aFFTWindowFactory Factory for FFT windows (optional)
+    /// @throws std::invalid_argument if aOptions.block_rows is zero
+    SpectrogramExporter(const Settings& aSettings,
+                        Options aOptions,
+                        IFFTProcessor::Factory aFFTProcessorFactory = nullptr,
+                        FFTWindowFactory aFFTWindowFactory = nullptr);
+
+    /// @brief Export a range of an audio file
+    /// @param aInputPath Path to the audio file
+    /// @param aOutputPath Path of the data file to write.  The sidecar is
+    /// written to aOutputPath + ".json".
+    /// @param aFirstFrame First frame of the range
+    /// @param aFrameCount Number of frames in the range, or nullopt for the
+    /// rest of the file
+    /// @return Export summary, or error message on failure
+    [[nodiscard]] std::expected<Result, std::string> ExportFile(
+      const std::string& aInputPath,
+      const std::string& aOutputPath,
+      FrameIndex aFirstFrame = FrameIndex{ 0 },
+      std::optional<FrameCount> aFrameCount = std::nullopt) const;
+
+    /// @brief Export a range of audio from a reader
+    /// @param aReader Audio reader, positioned at the start of the audio
+    /// @param aOutputPath Path of the data file to write.  The sidecar is
+    /// written to aOutputPath + ".json".
+    /// @param aFirstFrame First frame of the range
+    /// @param aFrameCount Number of frames in the range, or nullopt for the
+    /// rest of the audio
+    /// @param aProgressCallback Called after each block (optional).  It runs on
+    /// the calling thread.
+    /// @return Export summary, or error message on failure or cancellation
+    ///
+    /// If the reader returns fewer frames than GetFrameCount() reported, the
+    /// rows that could be computed are written and the .npy header and sidecar
+    /// reflect the actual row count.  A cancelled export removes its data file.
+    [[nodiscard]] std::expected<Result, std::string> Export(
+      IAudioFileReader& aReader,
+      const std::string& aOutputPath,
+      FrameIndex aFirstFrame = FrameIndex{ 0 },
+      std::optional<FrameCount> aFrameCount = std::nullopt,
+      const ProgressCallback& aProgressCallback = nullptr) const;
+
+    /// @brief Get the conventional file extension for a format
+    /// @param aFormat Output format
+    /// @return Extension including the dot, e.g. ".npy"
+    [[nodiscard]] static std::string_view FileExtension(Format aFormat);
+
+    /// @brief Build a .npy version 1.0 header for an export
+    /// @param aFormat Output format
+    /// @param aRowCount Number of rows
+    /// @param aChannelCount Number of channels
+    /// @param aBinCount Number of bins per row
+    /// @return Header bytes, exactly KNpyHeaderSize long
+    [[nodiscard]] static std::string BuildNpyHeader(Format aFormat,
+                                                    size_t aRowCount,
+                                                    ChannelCount aChannelCount,
+                                                    size_t aBinCount);
+
+    /// @brief Convert a float to IEEE 754 half precision bits
+    /// @param aValue Value to convert
+    /// @return Half precision bits, rounded to nearest even.  Out of range
+    /// values become infinity; NaN stays NaN.
+    [[nodiscard]] static uint16_t FloatToHalf(float aValue);
+
+  private:
+    const Settings& mSettings;
+    Options mOptions;
+    IFFTProcessor::Factory mFFTProcessorFactory;
+    FFTWindowFactory mFFTWindowFactory;
+};
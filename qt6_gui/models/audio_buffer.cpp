@@ -6,12 +6,19 @@
 #include "include/global_constants.h"
 #include <QAudioFormat>
 #include <QObject>
+#include <atomic>
 #include <audio_types.h>
 #include <cstddef>
+#include <identical_channels.h>
+#include <latency_probe.h>
 #include <memory>
+#include <memory_budget.h>
+#include <metrics.h>
+#include <mutex>
 #include <sample_buffer.h>
 #include <span>
 #include <stdexcept>
+#include <trace.h>
 #include <vector>
 
 AudioBuffer::AudioBuffer(QObject* aParent)
@@ -45,43 +52,84 @@ AudioBuffer::InitializeChannelBuffers(ChannelCount aChannelCount, SampleRate aSa
     // correctness.
     mChannelBuffers.clear();
     mChannelBuffers.resize(aChannelCount);
+    mFrameCount.store(0, std::memory_order_release);
 
     for (size_t i = 0; i < aChannelCount; ++i) {
         mChannelBuffers[i] = std::make_unique<SampleBuffer>(aSampleRate);
     }
+    mIdenticalChannels = std::make_unique<IdenticalChannels>(aChannelCount);
 }
 
 void
 AudioBuffer::Reset(ChannelCount aChannelCount, SampleRate aSampleRate)
 {
-    InitializeChannelBuffers(aChannelCount, aSampleRate);
+    // Let writers on other threads stop before their buffers go away
+    emit BufferAboutToReset();
+    {
+        const std::scoped_lock kLock(mWriterMutex);
+        InitializeChannelBuffers(aChannelCount, aSampleRate);
+    }
+
+    // Frame counts restart at zero, so pending latency tags no longer apply
+    LatencyProbe::Get().Clear();
 
     // Invalidate any cached data in listeners; update channel count in UI
     emit BufferReset(aChannelCount);
 }
 
 void
-AudioBuffer::AddSamples(const std::vector<float>& aSamples)
+AudioBuffer::AddSamples(std::span<const float> aSamples)
 {
+    SPECTRO_TRACE_ZONE("AudioBuffer::AddSamples");
     if (aSamples.size() % mChannelCount != 0) {
         throw std::invalid_argument(
           "AudioBuffer::AddSamples: Sample count must be divisible by channel count");
     }
 
     const size_t kSamplesPerChannel = aSamples.size() / mChannelCount;
-    std::vector<float> channelSamples(kSamplesPerChannel); // Deinterleave buffer
-
-    for (size_t channelID = 0; channelID < mChannelCount; channelID++) {
-        // De-interleave one channel
-        for (size_t i = 0; i < kSamplesPerChannel; i++) {
-            channelSamples[i] = aSamples[(i * mChannelCount) + channelID];
+    size_t frameCount = 0;
+    {
+        const std::scoped_lock kLock(mWriterMutex);
+        // Only grows, so steady-state block sizes reuse it
+        if (mDeinterleave.size() < aSamples.size()) {
+            mDeinterleave.resize(aSamples.size());
+            mDeinterleaveBytes.store(mDeinterleave.capacity() * sizeof(float),
+                                     std::memory_order_relaxed);
+        }
+        const std::span<float> kPlanar(mDeinterleave.data(), aSamples.size());
+
+        for (size_t channelID = 0; channelID < mChannelCount; channelID++) {
+            // De-interleave one channel
+            const std::span<float> kChannelSamples =
+              kPlanar.subspan(channelID * kSamplesPerChannel, kSamplesPerChannel);
+            for (size_t i = 0; i < kSamplesPerChannel; i++) {
+                kChannelSamples[i] = aSamples[(i * mChannelCount) + channelID];
+            }
+
+            // Then feed it to the SampleBuffer
+            mChannelBuffers[channelID]->AddSamples(kChannelSamples);
         }
 
-        // Then feed it to the SampleBuffer
-        mChannelBuffers[channelID]->AddSamples(channelSamples);
+        // Publish once every channel has the new frames, and the duplicate
+        // channel runs cover them
+        const size_t kFirstNewFrame = mFrameCount.load(std::memory_order_relaxed);
+        mIdenticalChannels->AddBlock(FrameIndex{ kFirstNewFrame }, kPlanar, kSamplesPerChannel);
+        frameCount = kFirstNewFrame + kSamplesPerChannel;
+        mFrameCount.store(frameCount, std::memory_order_release);
     }
 
-    emit DataAvailable(GetFrameCount());
+    static Metrics::Counter& framesIngested = Metrics::GetCounter(Metrics::KFramesIngested);
+    framesIngested.Add(kSamplesPerChannel);
+    emit DataAvailable(FrameCount{ frameCount }, FrameIndex{ frameCount - kSamplesPerChannel });
+}
+
+void
+AudioBuffer::Reserve(FrameCount aFrameCount)
+{
+    const std::scoped_lock kLock(mWriterMutex);
+    for (const auto& kBuffer : mChannelBuffers) {
+        kBuffer->Reserve(SampleCount{ aFrameCount.Get() });
+    }
 }
 
 std::span<const float>
@@ -96,6 +144,23 @@ AudioBuffer::GetSamples(const ChannelCount aChannelIndex,
     return mChannelBuffers[aChannelIndex]->GetSamples(aStartSample, aSampleCount);
 }
 
+ChannelCount
+AudioBuffer::FindIdenticalChannel(ChannelCount aChannelIndex,
+                                  SampleIndex aStartSample,
+                                  SampleCount aSampleCount) const
+{
+    if (aChannelIndex >= mChannelCount) {
+        throw std::out_of_range("AudioBuffer::FindIdenticalChannel: Channel index out of range");
+    }
+
+    // Runs only cover published frames
+    const size_t kFrames = mFrameCount.load(std::memory_order_acquire);
+    if (aStartSample.Get() > kFrames || aSampleCount.Get() > kFrames - aStartSample.Get()) {
+        return aChannelIndex;
+    }
+    return mIdenticalChannels->Find(aChannelIndex, FrameIndex{ aStartSample.Get() });
+}
+
 const SampleBuffer&
 AudioBuffer::GetChannelBuffer(ChannelCount aChannelIndex) const
 {
@@ -106,6 +171,34 @@ AudioBuffer::GetChannelBuffer(ChannelCount aChannelIndex) const
     return *mChannelBuffers[aChannelIndex];
 }
 
+size_t
+AudioBuffer::GetMemoryBytes() const
+{
+    // The writer may be resizing the scratch, so read the size it published
+    size_t bytes = mDeinterleaveBytes.load(std::memory_order_relaxed);
+    for (const auto& kBuffer : mChannelBuffers) {
+        bytes += kBuffer->GetMemoryBytes();
+    }
+    return bytes;
+}
+
+size_t
+AudioBuffer::ReleaseMemory(size_t /*aBytes*/)
+{
+    // Never stall the writer for this; the budget asks again next time
+    const std::unique_lock kLock(mWriterMutex, std::try_to_lock);
+    if (!kLock.owns_lock()) {
+        return 0;
+    }
+    // Keep the scratch: it is one block, and freeing it would make the next
+    // AddSamples() allocate on the capture thread
+    size_t freed = 0;
+    for (const auto& kBuffer : mChannelBuffers) {
+        freed += kBuffer->ShrinkToFit();
+    }
+    return freed;
+}
+
 QAudioFormat
 AudioBuffer::GetAudioFormat() const
 {
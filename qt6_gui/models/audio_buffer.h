@@ -6,8 +6,14 @@
 #include "audio_types.h"
 #include "include/global_constants.h"
 #include <QObject>
+#include <atomic>
+#include <cstddef>
+#include <identical_channels.h>
 #include <memory>
+#include <memory_budget.h>
+#include <mutex>
 #include <sample_buffer.h>
+#include <sample_source.h>
 #include <span>
 #include <vector>
 
@@ -16,8 +22,23 @@ class QAudioFormat;
 /// @brief Multi-channel audio buffer
 ///
 /// Wraps multiple SampleBuffer instances (one per channel) and provides
-/// Qt signal/slot integration for the MVC architecture.
-class AudioBuffer : public QObject
+/// Qt signal/slot integration for the MVC architecture.  Implements
+/// ISampleSource so the Qt-free SpectrogramEngine can read from it, and
+/// IMemoryConsumer so a MemoryBudget can account for the sample history.
+///
+/// One thread appends with AddSamples() while any thread reads.  The frame
+/// count is published only after every channel holds the new frames, so a
+/// reader can fetch any frame below GetFrameCount() from every channel.  Spans
+/// stay valid until Reset().  Reserve() and ReleaseMemory() may be called from
+/// another thread; they briefly exclude the writer.  Reset() emits
+/// BufferAboutToReset() first so writers on other threads can be stopped.
+///
+/// Each appended block is compared across channels, so FindIdenticalChannel()
+/// can report duplicated channels and the engine transforms them once.
+class AudioBuffer
+  : public QObject
+  , public ISampleSource
+  , public IMemoryConsumer
 {
     Q_OBJECT
 
@@ -35,11 +56,11 @@ class AudioBuffer : public QObject
 
     /// @brief Get the number of channels
     /// @return Channel count
-    [[nodiscard]] ChannelCount GetChannelCount() const { return mChannelCount; }
+    [[nodiscard]] ChannelCount GetChannelCount() const override { return mChannelCount; }
 
     /// @brief Get the sample rate
     /// @return Sample rate in Hz
-    [[nodiscard]] SampleRate GetSampleRate() const { return mSampleRate; }
+    [[nodiscard]] SampleRate GetSampleRate() const override { return mSampleRate; }
 
     /// @brief Add interleaved audio samples to all channels
     /// @param aSamples Interleaved audio data (channel 0, channel 1, ..., repeat)
@@ -48,19 +69,46 @@ class AudioBuffer : public QObject
     /// Example for stereo (2 channels): [L0, R0, L1, R1, L2, R2, ...]
     /// This method de-interleaves and appends to respective channel buffers.
     ///
-    /// Emits dataAvailable() signal after samples are added.
-    void AddSamples(const std::vector<float>& aSamples);
+    /// Emits dataAvailable() signal after samples are added.  Does not
+    /// allocate once the block size is steady and the channel buffers have
+    /// room (see Reserve()).
+    void AddSamples(std::span<const float> aSamples);
+
+    /// @brief Add interleaved audio samples to all channels
+    /// @param aSamples Interleaved audio data
+    /// @throws std::invalid_argument if sample count not divisible by channel count
+    void AddSamples(const std::vector<float>& aSamples)
+    {
+        AddSamples(std::span<const float>(aSamples));
+    }
+
+    /// @brief Reserve storage in every channel
+    /// @param aFrameCount Total number of frames to make room for
+    void Reserve(FrameCount aFrameCount);
 
     /// @brief Get samples from a specific channel
     /// @param aChannelIndex Channel index (0-based)
     /// @param aStartSample Starting sample index
     /// @param aSampleCount Number of samples to retrieve
-    /// @return Read-only span of samples.
+    /// @return Read-only span of samples, valid until Reset()
     /// @throws std::out_of_range if aChannelIndex >= channel count, or if there
     /// aren't enough samples to fill the request.
+    /// @throws std::length_error if the range is longer than
+    /// SampleBuffer::KMaxSpanSamples and isn't contiguous
     [[nodiscard]] std::span<const float> GetSamples(ChannelCount aChannelIndex,
                                                     SampleIndex aStartSample,
-                                                    SampleCount aSampleCount) const;
+                                                    SampleCount aSampleCount) const override;
+
+    /// @brief Find a channel whose samples duplicate another's over a range
+    /// @param aChannelIndex Channel index (0-based)
+    /// @param aStartSample Starting sample index
+    /// @param aSampleCount Number of samples in the range
+    /// @return The lowest channel with identical samples throughout the range,
+    /// or aChannelIndex.  Safe from any thread.
+    /// @throws std::out_of_range if aChannelIndex >= channel count
+    [[nodiscard]] ChannelCount FindIdenticalChannel(ChannelCount aChannelIndex,
+                                                    SampleIndex aStartSample,
+                                                    SampleCount aSampleCount) const override;
 
     /// @brief Get the underlying SampleBuffer for a specific channel
     /// @param aChannelIndex Channel index (0-based)
@@ -69,21 +117,26 @@ class AudioBuffer : public QObject
     [[nodiscard]] const SampleBuffer& GetChannelBuffer(ChannelCount aChannelIndex) const;
 
     /// @brief Get the total number of frames available
-    /// @return Frame count
-    [[nodiscard]] FrameCount GetFrameCount() const
+    /// @return Frame count published to readers.  Safe from any thread.
+    [[nodiscard]] FrameCount GetFrameCount() const override
     {
-        if (mChannelBuffers.empty()) {
-            return FrameCount{ 0 };
-        }
-        // Cast to FrameCount.  In AudioBuffer, all channels have the same
-        // sample count, so we can use any channel to get the frame count.
-        return FrameCount{ mChannelBuffers[0]->GetSampleCount().Get() };
+        return FrameCount{ mFrameCount.load(std::memory_order_acquire) };
     }
 
     /// @brief Get the number of bytes per audio frame
     /// @return Bytes per frame (channel count * bytes per sample)
     [[nodiscard]] BytesPerFrame GetBytesPerFrame() const { return mChannelCount * sizeof(float); }
 
+    /// @brief Get the bytes held by the sample history and scratch buffers
+    [[nodiscard]] size_t GetMemoryBytes() const override;
+
+    /// @brief Release reserved but unused sample capacity
+    /// @param aBytes Bytes the budget would like freed (ignored; all slack is freed)
+    /// @return Bytes freed
+    /// @note Samples themselves are never dropped: the history is append-only.
+    /// The AddSamples() scratch is kept too; it is bounded by one block.
+    size_t ReleaseMemory(size_t aBytes) override;
+
     /// @brief Get the audio format for this buffer
     /// @return QAudioFormat representing the buffer's format
     [[nodiscard]] QAudioFormat GetAudioFormat() const;
@@ -91,7 +144,16 @@ class AudioBuffer : public QObject
   signals:
     /// @brief Emitted when new audio frames are added
     /// @param aTotalFrameCount Total number of frames available per channel
-    void DataAvailable(FrameCount aTotalFrameCount);
+    /// @param aFirstNewFrame First frame appended by this call; the new frames
+    /// are [aFirstNewFrame, aTotalFrameCount)
+    /// @note Emitted on the writer's thread.
+    void DataAvailable(FrameCount aTotalFrameCount, FrameIndex aFirstNewFrame);
+
+    /// @brief Emitted by Reset() before the samples are discarded
+    ///
+    /// Connect writers on other threads with a direct connection and stop them
+    /// here; nothing may append while the buffer is reset.
+    void BufferAboutToReset();
 
     /// @brief Emitted when the buffer is reset
     /// @param aChannelCount New channel count
@@ -111,4 +173,9 @@ class AudioBuffer : public QObject
     ChannelCount mChannelCount{};
     SampleRate mSampleRate{};
     std::vector<std::unique_ptr<SampleBuffer>> mChannelBuffers;
+    std::unique_ptr<IdenticalChannels> mIdenticalChannels;
+    std::vector<float> mDeinterleave; // Scratch for AddSamples(), one channel after another
+    std::atomic<size_t> mDeinterleaveBytes{ 0 }; // Capacity of mDeinterleave, for other threads
+    std::atomic<size_t> mFrameCount{ 0 }; // Frames present in every channel
+    std::mutex mWriterMutex; // Held by AddSamples(); excludes Reserve() and ReleaseMemory()
 };
@@ -64,4 +64,21 @@ Settings::SetApertureCeilingDecibels(const float aCeilingDecibels)
 {
     mApertureCeilingDecibels = aCeilingDecibels;
     emit DisplaySettingsChanged();
-}
\ No newline at end of file
+}
+
+void
+Settings::SetAperture(const float aFloorDecibels, const float aCeilingDecibels)
+{
+    mApertureFloorDecibels = aFloorDecibels;
+    mApertureCeilingDecibels = aCeilingDecibels;
+    emit DisplaySettingsChanged();
+}
+
+void
+Settings::SetAutoAperture(const bool aIsAutoAperture)
+{
+    if (aIsAutoAperture != mIsAutoAperture) {
+        mIsAutoAperture = aIsAutoAperture;
+        emit DisplaySettingsChanged();
+    }
+}
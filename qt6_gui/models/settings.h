@@ -93,6 +93,19 @@ class Settings : public QObject
     /// @return Ceiling decibel value
     [[nodiscard]] float GetApertureCeilingDecibels() const { return mApertureCeilingDecibels; }
 
+    /// @brief Set the floor and ceiling together, redrawing once
+    /// @param aFloorDecibels New floor decibel value
+    /// @param aCeilingDecibels New ceiling decibel value
+    void SetAperture(float aFloorDecibels, float aCeilingDecibels);
+
+    /// @brief Set whether the aperture follows the levels shown
+    /// @param aIsAutoAperture True to let SettingsController::ApplyAutoAperture()
+    /// set the aperture, false to leave it to the user
+    void SetAutoAperture(bool aIsAutoAperture);
+
+    /// @brief Get whether the aperture follows the levels shown
+    [[nodiscard]] bool IsAutoAperture() const { return mIsAutoAperture; }
+
     ///
     /// Color map settings
     ///
@@ -153,6 +166,7 @@ class Settings : public QObject
     static constexpr float KDefaultApertureCeilingDecibels = 40.0f;
     float mApertureFloorDecibels = KDefaultApertureFloorDecibels;
     float mApertureCeilingDecibels = KDefaultApertureCeilingDecibels;
+    bool mIsAutoAperture = false;
 
     // Default color maps for each channel.
     static constexpr std::array<ColorMap::Type, GKMaxChannels> KDefaultColorMaps = {
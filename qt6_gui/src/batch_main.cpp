@@ -0,0 +1,480 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+// spectro_batch: headless command line tool for processing audio files.
+//
+// Usage:
+//   spectro_batch render [options] <input>...
+//   spectro_batch export [options] <input>...
+//   spectro_batch measure [options] <input>...
+
+#include "adapters/audio_file_reader.h"
+#include "controllers/batch_measurer.h"
+#include "controllers/batch_renderer.h"
+#include "controllers/spectrogram_exporter.h"
+#include "include/global_constants.h"
+#include "models/colormap.h"
+#include "models/settings.h"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <audio_types.h>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <distortion_meter.h>
+#include <expected>
+#include <fft_window.h>
+#include <format>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// @brief Command line options shared by all subcommands that compute rows
+struct CommonOptions
+{
+    QCommandLineOption fft_size{ "fft-size", "FFT size (512-16384).", "size", "2048" };
+    QCommandLineOption window{ "window",
+                               "Window type: rectangular, hann, hamming, blackman, "
+                               "blackman-harris.",
+                               "type",
+                               "hann" };
+    QCommandLineOption scale{ "scale", "Window scale (1, 2, 4, 8, 16).", "scale", "2" };
+    QCommandLineOption threads{ "threads", "FFT threads per file, 0 for all cores.", "n", "0" };
+    QCommandLineOption jobs{ "jobs", "Number of files to process concurrently.", "n", "1" };
+
+    void AddTo(QCommandLineParser& aParser) const
+    {
+        aParser.addOptions({ fft_size, window, scale, threads, jobs });
+    }
+};
+
+/// @brief Parse a non-negative integer option
+/// @throws std::invalid_argument if the value is not a non-negative integer
+size_t
+ParseCount(const QCommandLineParser& aParser, const QCommandLineOption& aOption)
+{
+    bool ok = false;
+    const qulonglong kValue = aParser.value(aOption).toULongLong(&ok);
+    if (!ok) {
+        const std::string kName = aOption.names().front().toStdString();
+        throw std::invalid_argument(std::format("--{}: expected a non-negative integer", kName));
+    }
+    return kValue;
+}
+
+/// @brief Parse a decibel option
+/// @throws std::invalid_argument if the value is not a number
+float
+ParseDecibels(const QCommandLineParser& aParser, const QCommandLineOption& aOption)
+{
+    bool ok = false;
+    const float kValue = aParser.value(aOption).toFloat(&ok);
+    if (!ok) {
+        const std::string kName = aOption.names().front().toStdString();
+        throw std::invalid_argument(std::format("--{}: expected a number", kName));
+    }
+    return kValue;
+}
+
+/// @brief Parse a non-negative time option in seconds
+/// @throws std::invalid_argument if the value is not a non-negative number
+double
+ParseSeconds(const QCommandLineParser& aParser, const QCommandLineOption& aOption)
+{
+    bool ok = false;
+    const double kValue = aParser.value(aOption).toDouble(&ok);
+    if (!ok || kValue < 0.0 || !std::isfinite(kValue)) {
+        const std::string kName = aOption.names().front().toStdString();
+        throw std::invalid_argument(std::format("--{}: expected a non-negative number", kName));
+    }
+    return kValue;
+}
+
+/// @brief Apply the FFT options to Settings
+/// @throws std::invalid_argument on invalid option values
+void
+ApplyFFTOptions(const QCommandLineParser& aParser,
+                const CommonOptions& aOptions,
+                Settings& aSettings)
+{
+    const FFTSize kFFTSize{ ParseCount(aParser, aOptions.fft_size) };
+    if (std::ranges::find(Settings::KValidFFTSizes, kFFTSize) == Settings::KValidFFTSizes.end()) {
+        throw std::invalid_argument("--fft-size: must be a power of 2 from 512 to 16384");
+    }
+
+    const std::string kWindowName = aParser.value(aOptions.window).toLower().toStdString();
+    const auto kWindowIt = std::ranges::find(
+      FFTWindow::TypeNames, kWindowName, &std::pair<FFTWindow::Type, std::string_view>::second);
+    if (kWindowIt == FFTWindow::TypeNames.end()) {
+        throw std::invalid_argument(std::format("--window: unknown window type {}", kWindowName));
+    }
+    aSettings.SetFFTSettings(kFFTSize, kWindowIt->first);
+
+    const size_t kScale = ParseCount(aParser, aOptions.scale);
+    if (kScale > std::numeric_limits<WindowScale>::max()) {
+        throw std::invalid_argument("--scale: must be 1, 2, 4, 8 or 16");
+    }
+    aSettings.SetWindowScale(static_cast<WindowScale>(kScale));
+}
+
+/// @brief Run a job over each input file, aJobs files at a time
+/// @return Number of files that failed
+template<typename JobFunction>
+size_t
+RunJobs(const QStringList& aInputs, size_t aJobs, const JobFunction& aJob)
+{
+    std::atomic<size_t> nextInput{ 0 };
+    std::atomic<size_t> failures{ 0 };
+    std::mutex outputMutex;
+
+    auto worker = [&] {
+        for (size_t i = nextInput++; i < static_cast<size_t>(aInputs.size()); i = nextInput++) {
+            const std::string kInput = aInputs.at(static_cast<qsizetype>(i)).toStdString();
+            const std::expected<std::string, std::string> kResult = aJob(kInput);
+            const std::scoped_lock kLock(outputMutex);
+            if (kResult) {
+                std::println("{}: {}", kInput, *kResult);
+            } else {
+                std::println(stderr, "{}: {}", kInput, kResult.error());
+                failures++;
+            }
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (size_t j = 1; j < std::max<size_t>(aJobs, 1); j++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    workers.clear();
+    return failures;
+}
+
+/// @brief The render subcommand: render each input file to PNG strips
+int
+RunRender(QCommandLineParser& aParser, const QStringList& aArguments)
+{
+    const CommonOptions kCommon;
+    kCommon.AddTo(aParser);
+    const QCommandLineOption kOutputDir(
+      { "o", "output-dir" }, "Directory for the output images.", "dir", ".");
+    const QCommandLineOption kFloor("floor", "Aperture floor in dB.", "dB", "-20");
+    const QCommandLineOption kCeiling("ceiling", "Aperture ceiling in dB.", "dB", "40");
+    const QCommandLineOption kColorMap(
+      "colormap", "Comma separated color map per channel, e.g. Magenta,Green.", "names");
+    const QCommandLineOption kStripHeight("strip-height",
+                                          "Maximum rows per image.  Longer renders are "
+                                          "split into numbered strips.",
+                                          "rows",
+                                          QString::number(BatchRenderer::KDefaultStripHeight));
+    aParser.addOptions({ kOutputDir, kFloor, kCeiling, kColorMap, kStripHeight });
+    aParser.addPositionalArgument("input", "Audio files to render.", "<input>...");
+    aParser.process(aArguments);
+
+    const QStringList kInputs = aParser.positionalArguments().mid(1);
+    if (kInputs.isEmpty()) {
+        aParser.showHelp(1);
+    }
+
+    Settings settings;
+    BatchRenderer::Options options;
+    size_t jobs = 1;
+    try {
+        ApplyFFTOptions(aParser, kCommon, settings);
+        settings.SetApertureFloorDecibels(ParseDecibels(aParser, kFloor));
+        settings.SetApertureCeilingDecibels(ParseDecibels(aParser, kCeiling));
+
+        if (aParser.isSet(kColorMap)) {
+            const QStringList kNames = aParser.value(kColorMap).split(',');
+            if (kNames.size() > GKMaxChannels) {
+                throw std::invalid_argument("--colormap: too many channels");
+            }
+            for (ChannelCount ch = 0; ch < kNames.size(); ch++) {
+                const QString kName = kNames.at(ch).trimmed();
+                auto matchesName = [&](const auto& aPair) {
+                    const QString kTypeName = QString::fromUtf8(aPair.second);
+                    return kTypeName.compare(kName, Qt::CaseInsensitive) == 0;
+                };
+                const auto kTypeIt = std::ranges::find_if(ColorMap::TypeNames, matchesName);
+                if (kTypeIt == ColorMap::TypeNames.end()) {
+                    throw std::invalid_argument(
+                      std::format("--colormap: unknown color map {}", kName.toStdString()));
+                }
+                settings.SetColorMapType(ch, kTypeIt->first);
+            }
+        }
+
+        options.strip_height = ParseCount(aParser, kStripHeight);
+        options.thread_count = ParseCount(aParser, kCommon.threads);
+        jobs = ParseCount(aParser, kCommon.jobs);
+        if (options.strip_height == 0) {
+            throw std::invalid_argument("--strip-height: must be positive");
+        }
+    } catch (const std::invalid_argument& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+
+    const BatchRenderer kRenderer(settings, options);
+    const QDir kOutputDir(aParser.value(kOutputDir));
+
+    auto renderOne = [&](const std::string& aInput) -> std::expected<std::string, std::string> {
+        const QString kBaseName = QFileInfo(QString::fromStdString(aInput)).completeBaseName();
+        const std::string kOutput = kOutputDir.filePath(kBaseName + ".png").toStdString();
+        const auto kResult = kRenderer.RenderFile(aInput, kOutput);
+        if (!kResult) {
+            return std::unexpected(kResult.error());
+        }
+        return std::format("wrote {} image(s), first {}", kResult->size(), kResult->front());
+    };
+    const size_t kFailures = RunJobs(kInputs, jobs, renderOne);
+    return kFailures == 0 ? 0 : 1;
+}
+
+/// @brief The export subcommand: export raw spectrogram rows for each input file
+int
+RunExport(QCommandLineParser& aParser, const QStringList& aArguments)
+{
+    const CommonOptions kCommon;
+    kCommon.AddTo(aParser);
+    const QCommandLineOption kOutputDir(
+      { "o", "output-dir" }, "Directory for the output files.", "dir", ".");
+    const QCommandLineOption kFormat(
+      "format", "Output format: npy, f32 (raw float32) or f16 (raw half).", "format", "npy");
+    const QCommandLineOption kStart("start", "Start of the range to export, in seconds.", "s", "0");
+    const QCommandLineOption kDuration(
+      "duration", "Length of the range to export, in seconds.  Default: to the end.", "s");
+    const QCommandLineOption kBlockRows(
+      "block-rows",
+      "Rows computed and written per block.",
+      "rows",
+      QString::number(SpectrogramExporter::KDefaultBlockRows));
+    aParser.addOptions({ kOutputDir, kFormat, kStart, kDuration, kBlockRows });
+    aParser.addPositionalArgument("input", "Audio files to export.", "<input>...");
+    aParser.process(aArguments);
+
+    const QStringList kInputs = aParser.positionalArguments().mid(1);
+    if (kInputs.isEmpty()) {
+        aParser.showHelp(1);
+    }
+
+    Settings settings;
+    SpectrogramExporter::Options options;
+    double startSeconds = 0.0;
+    std::optional<double> durationSeconds;
+    size_t jobs = 1;
+    try {
+        ApplyFFTOptions(aParser, kCommon, settings);
+
+        const std::string kFormatName = aParser.value(kFormat).toLower().toStdString();
+        const auto kFormatIt =
+          std::ranges::find(SpectrogramExporter::FormatNames,
+                            kFormatName,
+                            &std::pair<SpectrogramExporter::Format, std::string_view>::second);
+        if (kFormatIt == SpectrogramExporter::FormatNames.end()) {
+            throw std::invalid_argument(std::format("--format: unknown format {}", kFormatName));
+        }
+        options.format = kFormatIt->first;
+
+        startSeconds = ParseSeconds(aParser, kStart);
+        if (aParser.isSet(kDuration)) {
+            durationSeconds = ParseSeconds(aParser, kDuration);
+        }
+        options.block_rows = ParseCount(aParser, kBlockRows);
+        options.thread_count = ParseCount(aParser, kCommon.threads);
+        jobs = ParseCount(aParser, kCommon.jobs);
+        if (options.block_rows == 0) {
+            throw std::invalid_argument("--block-rows: must be positive");
+        }
+    } catch (const std::invalid_argument& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+
+    const SpectrogramExporter kExporter(settings, options);
+    const QDir kOutputDir(aParser.value(kOutputDir));
+    const QString kExtension =
+      QString::fromUtf8(SpectrogramExporter::FileExtension(options.format));
+
+    auto exportOne = [&](const std::string& aInput) -> std::expected<std::string, std::string> {
+        auto readerResult = AudioFileReader::Open(aInput);
+        if (!readerResult) {
+            return std::unexpected(readerResult.error());
+        }
+
+        // Convert the time range to frames at this file's sample rate
+        const auto kSampleRate = static_cast<double>(readerResult->GetSampleRate());
+        auto toFrames = [&](double aSeconds) {
+            return static_cast<size_t>(std::llround(aSeconds * kSampleRate));
+        };
+        const FrameIndex kFirstFrame{ toFrames(startSeconds) };
+        std::optional<FrameCount> frameCount;
+        if (durationSeconds.has_value()) {
+            frameCount = FrameCount{ toFrames(*durationSeconds) };
+        }
+
+        const QString kBaseName = QFileInfo(QString::fromStdString(aInput)).completeBaseName();
+        const std::string kOutput = kOutputDir.filePath(kBaseName + kExtension).toStdString();
+        const auto kResult = kExporter.Export(*readerResult, kOutput, kFirstFrame, frameCount);
+        if (!kResult) {
+            return std::unexpected(kResult.error());
+        }
+        return std::format("wrote {} rows x {} channels x {} bins to {}",
+                           kResult->row_count,
+                           kResult->channel_count,
+                           kResult->bin_count,
+                           kResult->data_path);
+    };
+    const size_t kFailures = RunJobs(kInputs, jobs, exportOne);
+    return kFailures == 0 ? 0 : 1;
+}
+
+/// @brief The measure subcommand: THD, THD+N, SNR and SINAD of each block of each input file
+int
+RunMeasure(QCommandLineParser& aParser, const QStringList& aArguments)
+{
+    const QCommandLineOption kOutputDir(
+      { "o", "output-dir" }, "Directory for the output CSV files.", "dir", ".");
+    const QCommandLineOption kChannel("channel", "Channel to measure, from 0.", "n", "0");
+    const QCommandLineOption kBlockSize(
+      "block-size",
+      "Frames per measurement (power of 2).",
+      "frames",
+      QString::number(DistortionMeter::KDefaultBlockFrames));
+    const QCommandLineOption kHarmonics(
+      "harmonics",
+      "Highest harmonic counted as distortion.",
+      "n",
+      QString::number(DistortionMeter::KDefaultMaxHarmonic));
+    const QCommandLineOption kBandwidth(
+      "bandwidth",
+      "Measurement bandwidth in Hz.",
+      "hz",
+      QString::number(DistortionMeter::KDefaultBandwidthHz));
+    const QCommandLineOption kThreads("threads", "Threads per file, 0 for all cores.", "n", "0");
+    const QCommandLineOption kJobs("jobs", "Number of files to process concurrently.", "n", "1");
+    aParser.addOptions(
+      { kOutputDir, kChannel, kBlockSize, kHarmonics, kBandwidth, kThreads, kJobs });
+    aParser.addPositionalArgument("input", "Audio files to measure.", "<input>...");
+    aParser.process(aArguments);
+
+    const QStringList kInputs = aParser.positionalArguments().mid(1);
+    if (kInputs.isEmpty()) {
+        aParser.showHelp(1);
+    }
+
+    BatchMeasurer::Options options;
+    size_t jobs = 1;
+    try {
+        const size_t kChannelIndex = ParseCount(aParser, kChannel);
+        if (kChannelIndex >= GKMaxChannels) {
+            throw std::invalid_argument(
+              std::format("--channel: must be less than {}", GKMaxChannels));
+        }
+        options.channel = static_cast<ChannelCount>(kChannelIndex);
+
+        const size_t kBlockFrames = ParseCount(aParser, kBlockSize);
+        if (kBlockFrames < 64 || !std::has_single_bit(kBlockFrames)) {
+            throw std::invalid_argument("--block-size: must be a power of 2 of at least 64");
+        }
+        options.meter.block_frames = FFTSize{ kBlockFrames };
+
+        options.meter.max_harmonic = ParseCount(aParser, kHarmonics);
+        bool ok = false;
+        options.meter.bandwidth_hz = aParser.value(kBandwidth).toFloat(&ok);
+        if (!ok || !(options.meter.bandwidth_hz > 0.0f)) {
+            throw std::invalid_argument("--bandwidth: expected a positive number");
+        }
+        options.thread_count = ParseCount(aParser, kThreads);
+        jobs = ParseCount(aParser, kJobs);
+    } catch (const std::invalid_argument& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+
+    const BatchMeasurer kMeasurer(options);
+    const QDir kOutputDir(aParser.value(kOutputDir));
+
+    auto measureOne = [&](const std::string& aInput) -> std::expected<std::string, std::string> {
+        const QString kBaseName = QFileInfo(QString::fromStdString(aInput)).completeBaseName();
+        const std::string kOutput = kOutputDir.filePath(kBaseName + ".csv").toStdString();
+        const auto kResult = kMeasurer.MeasureFile(aInput, kOutput);
+        if (!kResult) {
+            return std::unexpected(kResult.error());
+        }
+
+        // Summarize by the worst block
+        const auto kWorst = std::ranges::max_element(
+          kResult->measurements, {}, &DistortionMeter::Measurement::thd_n_decibels);
+        return std::format("measured {} blocks to {}, worst THD+N {:.1f} dB at {:.0f} Hz",
+                           kResult->measurements.size(),
+                           kOutput,
+                           kWorst->thd_n_decibels,
+                           kWorst->fundamental_hz);
+    };
+    const size_t kFailures = RunJobs(kInputs, jobs, measureOne);
+    return kFailures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    QCoreApplication const app(argc, argv);
+    QCoreApplication::setApplicationName("spectro_batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless spectrogram processing.\n\n"
+                                     "Commands:\n"
+                                     "  render   Render audio files to PNG spectrograms\n"
+                                     "  export   Export raw spectrogram data (.npy, float32, "
+                                     "float16)\n"
+                                     "  measure  Measure THD, THD+N, SNR and SINAD to CSV");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "Command to run.", "<command>");
+
+    // Parse once to find the subcommand, then let it add its own options.
+    const QStringList kArguments = QCoreApplication::arguments();
+    parser.parse(kArguments);
+    const QStringList kPositional = parser.positionalArguments();
+    const QString kCommand = kPositional.isEmpty() ? QString() : kPositional.first();
+
+    parser.clearPositionalArguments();
+    parser.addPositionalArgument(kCommand, "", kCommand);
+
+    if (kCommand == "render") {
+        return RunRender(parser, kArguments);
+    }
+    if (kCommand == "export") {
+        return RunExport(parser, kArguments);
+    }
+    if (kCommand == "measure") {
+        return RunMeasure(parser, kArguments);
+    }
+
+    if (!kCommand.isEmpty()) {
+        std::println(stderr, "Unknown command: {}", kCommand.toStdString());
+    }
+    parser.process(kArguments);
+    parser.showHelp(1);
+}
@@ -2,16 +2,184 @@
 // SPDX-License-Identifier: GPL-3.0-only
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
+#include "controllers/pcm_stream_recorder.h"
+#include "include/global_constants.h"
 #include "main_window.h"
 #include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QKeySequence>
+#include <QObject>
+#include <QShortcut>
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <format>
+#include <latency_probe.h>
+#include <memory_budget.h>
+#include <pcm_decoder.h>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <trace.h>
+#include <utility>
+
+namespace {
+
+/// @brief Parse a positive integer option
+/// @throws std::invalid_argument if the value is not a positive integer
+int
+ParsePositive(const QCommandLineParser& aParser, const QCommandLineOption& aOption)
+{
+    bool ok = false;
+    const int kValue = aParser.value(aOption).toInt(&ok);
+    if (!ok || kValue <= 0) {
+        const std::string kName = aOption.names().front().toStdString();
+        throw std::invalid_argument(std::format("--{}: expected a positive integer", kName));
+    }
+    return kValue;
+}
+
+/// @brief Write the trace file, reporting the outcome on stderr
+void
+WriteTrace(const std::string& aPath)
+{
+    const auto kResult = Trace::WriteChromeJsonFile(aPath);
+    if (kResult) {
+        std::println(stderr, "Trace written to {}", aPath);
+    } else {
+        std::println(stderr, "{}", kResult.error());
+    }
+}
+
+/// @brief Print the capture-to-pixel latency percentiles on stderr
+void
+ReportLatency()
+{
+    const auto kSummary = LatencyProbe::Get().Summarize();
+    if (kSummary.count == 0) {
+        std::println(stderr, "Latency: no blocks were displayed");
+        return;
+    }
+    constexpr double kNanosecondsPerMillisecond = 1e6;
+    auto toMs = [](auto aNanoseconds) {
+        return static_cast<double>(aNanoseconds) / kNanosecondsPerMillisecond;
+    };
+    std::println(stderr,
+                 "Capture-to-pixel latency over {} blocks: p50 {:.1f} ms, p90 {:.1f} ms, "
+                 "p99 {:.1f} ms, max {:.1f} ms",
+                 kSummary.count,
+                 toMs(kSummary.p50),
+                 toMs(kSummary.p90),
+                 toMs(kSummary.p99),
+                 toMs(kSummary.max));
+}
+
+} // namespace
 
 int
 main(int argc, char* argv[])
 {
     QApplication const app(argc, argv);
+    QCoreApplication::setApplicationName("spectro");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Real-time spectrum analyzer.");
+    parser.addHelpOption();
+    const QCommandLineOption kInput(
+      "input",
+      "Read raw interleaved PCM instead of an audio device: - for stdin, a FIFO path, or "
+      "unix:<path> for a Unix socket.",
+      "source");
+    const QCommandLineOption kInputFormat(
+      "input-format", "Raw PCM sample format (s16, s32, f32).", "format", "f32");
+    const QCommandLineOption kInputRate("input-rate", "Raw PCM sample rate.", "Hz", "48000");
+    const QCommandLineOption kInputChannels(
+      "input-channels", "Raw PCM channel count.", "n", "2");
+    const QCommandLineOption kTrace(
+      "trace",
+      "Record trace zones and write them as Chrome trace JSON on exit and on Ctrl+Shift+T. "
+      "Needs a build configured with -DSPECTRO_TRACING=ON.",
+      "file");
+    const QCommandLineOption kLatency(
+      "latency",
+      "Measure latency from audio capture to the first paint showing it, and print the "
+      "percentiles on exit.");
+    const QCommandLineOption kMemoryLimit(
+      "memory-limit",
+      "Cap the memory held by the sample history and caches. Caches are evicted first.",
+      "MiB");
+    parser.addOptions(
+      { kInput, kInputFormat, kInputRate, kInputChannels, kTrace, kLatency, kMemoryLimit });
+    parser.process(app);
+
+    PcmStreamRecorder::Format inputFormat;
+    if (parser.isSet(kInput)) {
+        try {
+            const std::string kFormatName = parser.value(kInputFormat).toLower().toStdString();
+            const auto kFormatIt =
+              std::ranges::find(PcmDecoder::TypeNames,
+                                kFormatName,
+                                &std::pair<PcmDecoder::Format, std::string_view>::second);
+            if (kFormatIt == PcmDecoder::TypeNames.end()) {
+                throw std::invalid_argument(
+                  std::format("--input-format: unknown format {}", kFormatName));
+            }
+            inputFormat.sample_format = kFormatIt->first;
+            inputFormat.sample_rate = ParsePositive(parser, kInputRate);
+            const int kChannels = ParsePositive(parser, kInputChannels);
+            if (kChannels > GKMaxChannels) {
+                throw std::invalid_argument(
+                  std::format("--input-channels: at most {} channels", GKMaxChannels));
+            }
+            inputFormat.channel_count = static_cast<ChannelCount>(kChannels);
+        } catch (const std::exception& e) {
+            std::println(stderr, "{}", e.what());
+            return 1;
+        }
+    }
+
+    if (parser.isSet(kMemoryLimit)) {
+        try {
+            constexpr size_t kBytesPerMebibyte = size_t{ 1024 } * 1024;
+            MemoryBudget::Get().SetLimit(static_cast<size_t>(ParsePositive(parser, kMemoryLimit)) *
+                                         kBytesPerMebibyte);
+        } catch (const std::exception& e) {
+            std::println(stderr, "{}", e.what());
+            return 1;
+        }
+    }
+
+    LatencyProbe::Get().SetEnabled(parser.isSet(kLatency));
 
     MainWindow mainWindow;
+    if (parser.isSet(kInput) &&
+        !mainWindow.StartPcmInput(parser.value(kInput).toStdString(), inputFormat)) {
+        return 1;
+    }
     mainWindow.show();
 
-    return QApplication::exec();
+    const std::string kTracePath = parser.value(kTrace).toStdString();
+    if (!kTracePath.empty()) {
+        if (!Trace::KCompiledIn) {
+            std::println(stderr, "--trace: built without SPECTRO_TRACING, no zones are recorded");
+        }
+        Trace::SetEnabled(true);
+        auto* traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), &mainWindow);
+        QObject::connect(
+          traceShortcut, &QShortcut::activated, [kTracePath] { WriteTrace(kTracePath); });
+    }
+
+    const int kExitCode = QApplication::exec();
+    if (!kTracePath.empty()) {
+        WriteTrace(kTracePath);
+    }
+    if (parser.isSet(kLatency)) {
+        ReportLatency();
+    }
+    return kExitCode;
 }
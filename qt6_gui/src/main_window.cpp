@@ -3,41 +3,117 @@
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
 #include "main_window.h"
+#include "adapters/audio_buffer_reader.h"
 #include "adapters/media_devices.h"
+#include "controllers/audio_player.h"
 #include "controllers/audio_recorder.h"
+#include "controllers/pcm_stream_recorder.h"
+#include "controllers/settings_controller.h"
 #include "controllers/spectrogram_controller.h"
+#include "controllers/spectrogram_exporter.h"
 #include "models/audio_buffer.h"
 #include "models/settings.h"
 #include "views/scale_view.h"
 #include "views/settings_panel.h"
 #include "views/spectrogram_view.h"
 #include "views/spectrum_plot.h"
+#include "views/stats_panel.h"
+#include "views/waveform_view.h"
+#include <QAction>
 #include <QApplication>
 #include <QColor>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDockWidget>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFormLayout>
 #include <QHBoxLayout>
 #include <QLoggingCategory>
 #include <QMainWindow>
 #include <QMediaDevices>
+#include <QMenu>
+#include <QMenuBar>
+#include <QMessageBox>
+#include <QMetaObject>
 #include <QObject>
 #include <QPalette>
+#include <QProgressDialog>
 #include <QScrollBar>
+#include <QString>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 #include <Qt>
 #include <QtLogging>
+#include <algorithm>
 #include <audio_types.h>
 #include <cmath>
+#include <cstddef>
+#include <expected>
+#include <memory_budget.h>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 namespace {
 constexpr ChannelCount KDefaultChannelCount = 2;
 constexpr SampleRate KDefaultSampleRate = 44100;
+constexpr int KProgressMaxPercent = 100;
+
+/// @brief Ask for the time range to export
+/// @param aParent Parent widget for the dialog
+/// @param aFrameCount Frames in the buffer
+/// @param aSampleRate Sample rate of the buffer
+/// @return First frame and frame count, or nullopt if cancelled
+std::optional<std::pair<FrameIndex, FrameCount>>
+PromptExportRange(QWidget* aParent, FrameCount aFrameCount, SampleRate aSampleRate)
+{
+    constexpr int kDecimals = 3;
+    const double kDuration =
+      static_cast<double>(aFrameCount.Get()) / static_cast<double>(aSampleRate);
+
+    QDialog dialog(aParent);
+    dialog.setWindowTitle("Export Spectrogram Data");
+    auto* layout = new QFormLayout(&dialog);
+    auto* startBox = new QDoubleSpinBox(&dialog);
+    auto* endBox = new QDoubleSpinBox(&dialog);
+    for (QDoubleSpinBox* box : { startBox, endBox }) {
+        box->setRange(0.0, kDuration);
+        box->setDecimals(kDecimals);
+        box->setSuffix(" s");
+    }
+    endBox->setValue(kDuration);
+    layout->addRow("Start:", startBox);
+    layout->addRow("End:", endBox);
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    QObject::connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    QObject::connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return std::nullopt;
+    }
+
+    const auto kToFrame = [&](double aSeconds) {
+        const auto kFrame = static_cast<size_t>(std::lround(aSeconds * aSampleRate));
+        return std::min(kFrame, aFrameCount.Get());
+    };
+    const size_t kFirst = kToFrame(startBox->value());
+    const size_t kLast = std::max(kFirst, kToFrame(endBox->value()));
+    return std::pair{ FrameIndex{ kFirst }, FrameCount{ kLast - kFirst } };
 }
+} // namespace
 
 MainWindow::MainWindow(QWidget* parent)
   : QMainWindow(parent)
   , mSettings(this)
   , mAudioBuffer(this)
-  , mAudioRecorder(mAudioBuffer, this)
+  , mAudioRecorder(mAudioBuffer, nullptr, this)
+  , mPcmStreamRecorder(mAudioBuffer, this)
   , mAudioPlayer(mAudioBuffer, nullptr, this)
   , mSpectrogramController(mSettings, mAudioBuffer, mAudioPlayer, nullptr, nullptr, this)
   , mAudioFile(mAudioBuffer, this)
@@ -45,7 +121,9 @@ MainWindow::MainWindow(QWidget* parent)
   , mSpectrogramView(mSpectrogramController, this)
   , mScaleView(mSpectrogramController, this)
   , mSpectrumPlot(mSpectrogramController, this)
+  , mWaveformView(mAudioBuffer, this)
   , mSettingsPanel(mSettings, mSettingsController, mAudioFile, this)
+  , mStatsPanel(this)
 {
     constexpr int kDefaultWindowWidth = 1400;
     constexpr int kDefaultWindowHeight = 800;
@@ -58,7 +136,9 @@ MainWindow::MainWindow(QWidget* parent)
 
     SetDarkMode();
     CreateLayout();
+    CreateMenus();
     SetupConnections();
+    SetupMemoryBudget();
 
     // Start recording from default audio input device.  This needs to happen
     // after SetupConnections so the UI shows the recording state correctly.
@@ -71,6 +151,42 @@ MainWindow::MainWindow(QWidget* parent)
     }
 }
 
+MainWindow::~MainWindow()
+{
+    // The export reads the buffer and settings
+    CancelExport();
+    MemoryBudget& budget = MemoryBudget::Get();
+    budget.Unregister(mSpectrogramController.GetRowCache());
+    budget.Unregister(mSpectrogramView);
+    budget.Unregister(mAudioBuffer);
+}
+
+void
+MainWindow::SetupMemoryBudget()
+{
+    // Caches are released in registration order, so the row cache goes before
+    // the image that is needed for the next paint
+    MemoryBudget& budget = MemoryBudget::Get();
+    budget.Register(
+      "row_cache", IMemoryConsumer::Kind::Cache, mSpectrogramController.GetRowCache());
+    budget.Register("view_image", IMemoryConsumer::Kind::Cache, mSpectrogramView);
+    budget.Register("history", IMemoryConsumer::Kind::History, mAudioBuffer);
+
+    // Everything registered lives on this thread, so enforce from its event
+    // loop, which runs between paints
+    constexpr int kEnforceIntervalMs = 250;
+    mMemoryBudgetTimer.setInterval(kEnforceIntervalMs);
+    connect(&mMemoryBudgetTimer, &QTimer::timeout, [] { MemoryBudget::Get().Enforce(); });
+    mMemoryBudgetTimer.start();
+}
+
+bool
+MainWindow::StartPcmInput(const std::string& aSource, const PcmStreamRecorder::Format& aFormat)
+{
+    // Resetting the buffer for the stream stops the audio device capture
+    return mPcmStreamRecorder.Start(aSource, aFormat);
+}
+
 void
 MainWindow::CreateLayout()
 {
@@ -79,6 +195,9 @@ MainWindow::CreateLayout()
     // │ ┌──────────────────────────────┬────────────────────┐   │
     // │ │ QVBoxLayout (left)           │ SettingsPanel      │   │
     // │ │ ┌──────────────────────────┐ │ (~300px)           │   │
+    // │ │ │ WaveformView (min 60px)  │ │                    │   │
+    // │ │ └──────────────────────────┘ │                    │   │
+    // │ │ ┌──────────────────────────┐ │                    │   │
     // │ │ │ SpectrogramView          │ │                    │   │
     // │ │ │ (stretch 7)              │ │                    │   │
     // │ │ └──────────────────────────┘ │                    │   │
@@ -92,13 +211,14 @@ MainWindow::CreateLayout()
     // │ └──────────────────────────────┴────────────────────┘   │
     // └─────────────────────────────────────────────────────────┘
 
-    // Create left container with vertical layout for the two plots
+    // Create left container with vertical layout for the plots
     auto* leftContainer = new QWidget(this);
     auto* leftLayout = new QVBoxLayout(leftContainer);
     leftLayout->setContentsMargins(0, 0, 0, 0);
     leftLayout->setSpacing(0);
     constexpr int kSpectrogramStretch = 7; // 70% of vertical space
     constexpr int kSpectrumStretch = 3;    // 30% of vertical space
+    leftLayout->addWidget(&mWaveformView, 0); // Minimum height (no stretch)
     leftLayout->addWidget(&mSpectrogramView, kSpectrogramStretch);
     leftLayout->addWidget(&mScaleView, 0); // Fixed height (no stretch)
     leftLayout->addWidget(&mSpectrumPlot, kSpectrumStretch);
@@ -111,6 +231,140 @@ MainWindow::CreateLayout()
     mainLayout->addWidget(&mSettingsPanel, 0); // Fixed width (no stretch)
 
     setCentralWidget(mainWidget);
+
+    // Performance statistics, hidden until chosen from the View menu
+    mStatsDock = new QDockWidget("Performance", this);
+    mStatsDock->setObjectName("StatsDock");
+    mStatsDock->setWidget(&mStatsPanel);
+    addDockWidget(Qt::RightDockWidgetArea, mStatsDock);
+    mStatsDock->hide();
+}
+
+void
+MainWindow::CreateMenus()
+{
+    QMenu* fileMenu = menuBar()->addMenu("&File");
+    QAction* exportAction = fileMenu->addAction("Export Spectrogram &Data...");
+    connect(exportAction, &QAction::triggered, this, &MainWindow::ExportSpectrogramData);
+
+    QMenu* viewMenu = menuBar()->addMenu("&View");
+    QAction* statsAction = mStatsDock->toggleViewAction();
+    statsAction->setText("&Performance Statistics");
+    viewMenu->addAction(statsAction);
+}
+
+void
+MainWindow::ExportSpectrogramData()
+{
+    const FrameCount kBufferFrames = mAudioBuffer.GetFrameCount();
+    if (kBufferFrames < FrameCount{ mSettings.GetFFTSize() }) {
+        QMessageBox::information(
+          this, "Export Spectrogram Data", "There is not enough audio to export yet.");
+        return;
+    }
+
+    const auto kRange = PromptExportRange(this, kBufferFrames, mAudioBuffer.GetSampleRate());
+    if (!kRange) {
+        return;
+    }
+    const auto [kFirstFrame, kFrameCount] = *kRange;
+    if (kFrameCount < FrameCount{ mSettings.GetFFTSize() }) {
+        QMessageBox::information(
+          this, "Export Spectrogram Data", "The range is shorter than one FFT window.");
+        return;
+    }
+
+    const QString kPath = QFileDialog::getSaveFileName(
+      this,
+      "Export Spectrogram Data",
+      "spectrogram.npy",
+      "NumPy array (*.npy);;Raw float32 (*.f32);;Raw float16 (*.f16)");
+    if (kPath.isEmpty()) {
+        return;
+    }
+
+    // Pick the format from the extension, defaulting to .npy
+    using Format = SpectrogramExporter::Format;
+    const std::string kSuffix = QFileInfo(kPath).suffix().toLower().toStdString();
+    const auto kFormatIt =
+      std::ranges::find_if(SpectrogramExporter::FormatNames, [&](const auto& aPair) {
+          return SpectrogramExporter::FileExtension(aPair.first).substr(1) == kSuffix;
+      });
+    const Format kFormat =
+      kFormatIt == SpectrogramExporter::FormatNames.end() ? Format::Npy : kFormatIt->first;
+
+    // Export on a worker thread.  The range is fixed, so a recording may keep
+    // appending to the buffer meanwhile; a reset cancels the export first.  The
+    // progress dialog is modal, so the settings can't change while the worker
+    // reads them.
+    mExportProgress = new QProgressDialog(
+      "Exporting spectrogram data...", "Cancel", 0, KProgressMaxPercent, this);
+    mExportProgress->setWindowModality(Qt::WindowModal);
+    mExportProgress->setMinimumDuration(0);
+    mExportProgress->setAutoClose(false);
+    mExportProgress->setAutoReset(false);
+    connect(mExportProgress, &QProgressDialog::canceled, this, [this] {
+        mExportThread.request_stop();
+    });
+    mExportProgress->show();
+
+    mExportThread = std::jthread([this, kProgress = mExportProgress, kFirstFrame, kFrameCount,
+                                  kFormat, kPath](const std::stop_token& aStopToken) {
+        AudioBufferReader reader(mAudioBuffer);
+        const SpectrogramExporter kExporter(mSettings, { .format = kFormat });
+        auto result = kExporter.Export(
+          reader,
+          kPath.toStdString(),
+          kFirstFrame,
+          kFrameCount,
+          [&](size_t aRowsDone, size_t aRowCount) {
+              const int kPercent = static_cast<int>(aRowsDone * KProgressMaxPercent / aRowCount);
+              QMetaObject::invokeMethod(
+                kProgress, [kProgress, kPercent] { kProgress->setValue(kPercent); },
+                Qt::QueuedConnection);
+              return !aStopToken.stop_requested();
+          });
+        QMetaObject::invokeMethod(
+          this, [this, result = std::move(result)] { FinishExport(result); },
+          Qt::QueuedConnection);
+    });
+}
+
+void
+MainWindow::FinishExport(const std::expected<SpectrogramExporter::Result, std::string>& aResult)
+{
+    // CancelExport() may have joined the thread already
+    const bool kCancelled = mExportThread.get_stop_token().stop_requested();
+    if (mExportThread.joinable()) {
+        mExportThread.join();
+    }
+    mExportProgress->deleteLater();
+    mExportProgress = nullptr;
+
+    if (kCancelled) {
+        return;
+    }
+    if (!aResult) {
+        QMessageBox::warning(
+          this, "Export Spectrogram Data", QString::fromStdString(aResult.error()));
+        return;
+    }
+    QMessageBox::information(this,
+                             "Export Spectrogram Data",
+                             QString("Wrote %1 rows to %2")
+                               .arg(aResult->row_count)
+                               .arg(QString::fromStdString(aResult->data_path)));
+}
+
+void
+MainWindow::CancelExport()
+{
+    if (!mExportThread.joinable()) {
+        return;
+    }
+    // FinishExport() is still queued, and cleans up after the thread
+    mExportThread.request_stop();
+    mExportThread.join();
 }
 
 void
@@ -131,6 +385,17 @@ MainWindow::SetupConnections()
             &mSpectrumPlot,
             qOverload<>(&SpectrumPlot::update));
 
+    // The waveform overview covers the whole recording, so it changes with
+    // every append
+    connect(&mAudioBuffer,
+            &AudioBuffer::DataAvailable,
+            &mWaveformView,
+            qOverload<>(&WaveformView::update));
+    connect(&mAudioBuffer,
+            &AudioBuffer::BufferReset,
+            &mWaveformView,
+            qOverload<>(&WaveformView::update));
+
     // Update views when display settings change
     connect(
       &mSettings, &Settings::DisplaySettingsChanged, &mScaleView, qOverload<>(&ScaleView::update));
@@ -143,8 +408,31 @@ MainWindow::SetupConnections()
             &mSpectrogramView,
             &SpectrogramView::UpdateViewport);
 
-    // Stop recording when buffer is reset (e.g., when loading a new file)
-    connect(&mAudioBuffer, &AudioBuffer::BufferReset, &mAudioRecorder, &AudioRecorder::Stop);
+    // Stop recording before the buffer is reset (e.g., when loading a new
+    // file).  The capture thread must not be appending while it is.
+    connect(
+      &mAudioBuffer, &AudioBuffer::BufferAboutToReset, &mAudioRecorder, &AudioRecorder::Stop);
+    connect(&mAudioBuffer,
+            &AudioBuffer::BufferAboutToReset,
+            &mPcmStreamRecorder,
+            &PcmStreamRecorder::Stop);
+    connect(&mAudioBuffer, &AudioBuffer::BufferAboutToReset, &mAudioPlayer, &AudioPlayer::Stop);
+    connect(&mAudioBuffer, &AudioBuffer::BufferAboutToReset, this, &MainWindow::CancelExport);
+
+    // Dragging in the spectrogram plays from the row under the pointer.  The
+    // sink stays open, so each move is just a seek.
+    connect(&mSpectrogramView, &SpectrogramView::ScrubRequested, [&](FrameIndex aFrame) {
+        const auto kResult = mAudioPlayer.Start(aFrame);
+        if (!kResult) {
+            qWarning("Scrubbing: %s", kResult.error().c_str());
+        }
+    });
+    connect(&mSpectrogramView, &SpectrogramView::ScrubFinished, &mAudioPlayer, &AudioPlayer::Stop);
+
+    // Report raw PCM stream errors, including end of stream
+    connect(&mPcmStreamRecorder, &PcmStreamRecorder::ErrorOccurred, [](const QString& aMessage) {
+        qWarning("PcmStreamRecorder: %s", qUtf8Printable(aMessage));
+    });
 
     // Update channel count in UI when buffer is reset
     connect(&mAudioBuffer,
@@ -168,6 +456,41 @@ MainWindow::SetupConnections()
             &QScrollBar::actionTriggered,
             &mSettings,
             &Settings::ClearLiveMode);
+
+    // An automatic aperture follows new rows, scrolling, and being turned on.
+    // Applying it changes the display settings again, but by less than a step,
+    // so that stops there.
+    connect(&mSpectrogramController,
+            &SpectrogramController::RowsCompleted,
+            this,
+            &MainWindow::ApplyAutoAperture);
+    connect(mSpectrogramView.verticalScrollBar(),
+            &QScrollBar::valueChanged,
+            this,
+            &MainWindow::ApplyAutoAperture);
+    connect(&mSettings, &Settings::DisplaySettingsChanged, this, &MainWindow::ApplyAutoAperture);
+}
+
+void
+MainWindow::ApplyAutoAperture()
+{
+    if (!mSettings.IsAutoAperture()) {
+        return;
+    }
+
+    // A loaded file has no live rows, so falls back to the history in view
+    std::optional<SpectrogramController::Aperture> aperture;
+    if (mSettings.IsLiveMode()) {
+        aperture = mSpectrogramController.GetLiveAperture();
+    }
+    if (!aperture) {
+        const FramePosition kEnd = mSpectrogramView.GetScrollPosition() + FrameCount{ 1 };
+        aperture = mSpectrogramController.ComputeHistoryAperture(
+          kEnd - mSpectrogramView.GetPageStep(), kEnd);
+    }
+    if (aperture) {
+        mSettingsController.ApplyAutoAperture(aperture->floor_decibels, aperture->ceiling_decibels);
+    }
 }
 
 void
@@ -8,16 +8,26 @@
 #include "controllers/audio_file.h"
 #include "controllers/audio_player.h"
 #include "controllers/audio_recorder.h"
+#include "controllers/pcm_stream_recorder.h"
 #include "controllers/settings_controller.h"
 #include "controllers/spectrogram_controller.h"
+#include "controllers/spectrogram_exporter.h"
 #include "models/audio_buffer.h"
 #include "views/scale_view.h"
 #include "views/settings_panel.h"
 #include "views/spectrogram_view.h"
 #include "views/spectrum_plot.h"
+#include "views/stats_panel.h"
+#include "views/waveform_view.h"
 #include <QMainWindow>
+#include <QTimer>
 #include <QWidget>
+#include <expected>
+#include <string>
+#include <thread>
 
+class QDockWidget;
+class QProgressDialog;
 class Settings;
 
 /// @brief Main application window for Spectro-v3 spectrum analyzer
@@ -32,7 +42,14 @@ class MainWindow : public QMainWindow
     /// @brief Constructor for MainWindow
     /// @param parent Optional parent widget
     explicit MainWindow(QWidget* parent = nullptr);
-    ~MainWindow() override = default;
+    ~MainWindow() override;
+
+    /// @brief Capture raw PCM from a pipe, FIFO or socket instead of the audio
+    /// input device
+    /// @param aSource Stream source, see PcmStreamRecorder::Start()
+    /// @param aFormat Stream format
+    /// @return true if capture started, false if the source could not be opened
+    bool StartPcmInput(const std::string& aSource, const PcmStreamRecorder::Format& aFormat);
 
   private:
     /// @brief Sets up the main layout of the application window
@@ -41,13 +58,36 @@ class MainWindow : public QMainWindow
     /// @brief Sets up signal-slot connections between components
     void SetupConnections();
 
+    /// @brief Sets up the menu bar
+    void CreateMenus();
+
+    /// @brief Prompts for a time range and file name, and exports that range
+    /// of the buffered audio as raw spectrogram data on a worker thread
+    void ExportSpectrogramData();
+
+    /// @brief Joins the export thread and reports its result
+    /// @param aResult Export summary, or error message
+    void FinishExport(const std::expected<SpectrogramExporter::Result, std::string>& aResult);
+
+    /// @brief Cancels an export in progress and waits for its thread
+    void CancelExport();
+
+    /// @brief Moves an automatic aperture to the levels of the live rows, or
+    /// of the history in view
+    void ApplyAutoAperture();
+
     /// @brief Applies dark mode theme to the application
     static void SetDarkMode();
 
+    /// @brief Registers the history and caches with the process-wide
+    /// MemoryBudget and starts enforcing it
+    void SetupMemoryBudget();
+
     // Models and controllers
     Settings mSettings;
     AudioBuffer mAudioBuffer;
     AudioRecorder mAudioRecorder;
+    PcmStreamRecorder mPcmStreamRecorder;
     AudioPlayer mAudioPlayer;
     SpectrogramController mSpectrogramController;
     AudioFile mAudioFile;
@@ -58,5 +98,15 @@ class MainWindow : public QMainWindow
     SpectrogramView mSpectrogramView;
     ScaleView mScaleView;
     SpectrumPlot mSpectrumPlot;
+    WaveformView mWaveformView;
     SettingsPanel mSettingsPanel;
+    StatsPanel mStatsPanel;
+    QDockWidget* mStatsDock = nullptr;
+
+    // Enforces the MemoryBudget between paints
+    QTimer mMemoryBudgetTimer;
+
+    // Spectrogram data export in progress
+    QProgressDialog* mExportProgress = nullptr;
+    std::jthread mExportThread;
 };
@@ -0,0 +1,257 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "adapters/audio_source.h"
+#include "controllers/audio_recorder.h"
+#include <QAudio>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QIODevice>
+#include <QMetaObject>
+#include <QThread>
+#include <Qt>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// @brief Audio waiting to be captured, pushed by a test and read by the
+/// device of a FakeAudioSource
+///
+/// The test pushes on its own thread.  The device lives on the capture thread
+/// and hears of new audio by a queued readyRead, as QAudioSource's does.
+class CaptureFeed
+{
+  public:
+    /// @brief Queue interleaved samples and announce them
+    /// @param aSamples Samples
+    void Push(const std::vector<float>& aSamples)
+    {
+        const std::scoped_lock kLock(mMutex);
+        Append(mBytes, aSamples);
+        if (mDevice != nullptr) {
+            QMetaObject::invokeMethod(
+              mDevice, [kDevice = mDevice] { emit kDevice->readyRead(); }, Qt::QueuedConnection);
+        }
+    }
+
+    /// @brief Queue interleaved samples, unannounced, once the next read has
+    /// emptied the feed, as if they arrived while the recorder was reading
+    /// @param aSamples Samples
+    void PushAfterNextRead(const std::vector<float>& aSamples)
+    {
+        const std::scoped_lock kLock(mMutex);
+        Append(mLateBytes, aSamples);
+    }
+
+    /// @brief Get the bytes queued
+    [[nodiscard]] qsizetype GetBytesAvailable() const
+    {
+        const std::scoped_lock kLock(mMutex);
+        return mBytes.size();
+    }
+
+    /// @brief Read queued bytes
+    /// @param aData Destination
+    /// @param aMaxLength Bytes wanted
+    /// @return Bytes read
+    qint64 Read(char* aData, qint64 aMaxLength)
+    {
+        const std::scoped_lock kLock(mMutex);
+        const qint64 kRead = std::min(aMaxLength, static_cast<qint64>(mBytes.size()));
+        std::memcpy(aData, mBytes.constData(), static_cast<size_t>(kRead));
+        mBytes.remove(0, kRead);
+        if (mBytes.isEmpty()) {
+            mBytes = std::exchange(mLateBytes, {});
+        }
+        return kRead;
+    }
+
+    /// @brief Keep the capture thread busy for a while, so that what the test
+    /// queues for it meanwhile runs afterwards, in the order it was queued
+    /// @param aMilliseconds How long
+    void HoldCaptureThread(unsigned long aMilliseconds)
+    {
+        const std::scoped_lock kLock(mMutex);
+        QMetaObject::invokeMethod(
+          mDevice, [aMilliseconds] { QThread::msleep(aMilliseconds); }, Qt::QueuedConnection);
+    }
+
+    /// @brief Discard everything queued, as stopping a source does
+    void Clear()
+    {
+        const std::scoped_lock kLock(mMutex);
+        mBytes.clear();
+        mLateBytes.clear();
+    }
+
+    /// @brief Announce pushes to aDevice from now on
+    void Attach(QIODevice* aDevice)
+    {
+        const std::scoped_lock kLock(mMutex);
+        mDevice = aDevice;
+    }
+
+    /// @brief Stop announcing pushes to aDevice
+    void Detach(const QIODevice* aDevice)
+    {
+        const std::scoped_lock kLock(mMutex);
+        if (mDevice == aDevice) {
+            mDevice = nullptr;
+        }
+    }
+
+  private:
+    static void Append(QByteArray& aBytes, const std::vector<float>& aSamples)
+    {
+        // Type punning is intentional: the device delivers a byte stream of floats.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        aBytes.append(reinterpret_cast<const char*>(aSamples.data()),
+                      static_cast<qsizetype>(aSamples.size() * sizeof(float)));
+    }
+
+    mutable std::mutex mMutex;
+    QByteArray mBytes;
+    QByteArray mLateBytes;        // Queued by the read that empties mBytes
+    QIODevice* mDevice = nullptr; // Attached device, on the capture thread
+};
+
+/// @brief Device returned by FakeAudioSource::Start(), reading a CaptureFeed
+class FakeCaptureDevice : public QIODevice
+{
+  public:
+    /// @brief Constructor.  Attaches to aFeed.
+    explicit FakeCaptureDevice(CaptureFeed& aFeed)
+      : mFeed(aFeed)
+    {
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        mFeed.Attach(this);
+    }
+
+    ~FakeCaptureDevice() override { mFeed.Detach(this); }
+
+    FakeCaptureDevice(const FakeCaptureDevice&) = delete;
+    FakeCaptureDevice& operator=(const FakeCaptureDevice&) = delete;
+    FakeCaptureDevice(FakeCaptureDevice&&) = delete;
+    FakeCaptureDevice& operator=(FakeCaptureDevice&&) = delete;
+
+    [[nodiscard]] bool isSequential() const override { return true; }
+
+    [[nodiscard]] qint64 bytesAvailable() const override
+    {
+        return mFeed.GetBytesAvailable() + QIODevice::bytesAvailable();
+    }
+
+    qint64 readData(char* aData, qint64 aMaxLength) override
+    {
+        return mFeed.Read(aData, aMaxLength);
+    }
+
+    // Required for the QIODevice interface, but a capture device is read-only
+    qint64 writeData(const char* /*aData*/, qint64 /*aLength*/) override { return -1; }
+
+  private:
+    CaptureFeed& mFeed;
+};
+
+/// @brief What a test controls and observes of its FakeAudioSource
+struct FakeCapture
+{
+    CaptureFeed feed;                               // Audio to capture
+    bool fail_start = false;                        // Start() returns nullptr
+    QAudio::Error start_error = QAudio::NoError;    // Reported by each Start()
+    std::atomic<int> starts{ 0 };                   // Successful Start() calls
+    std::atomic<bool> source_alive{ false };        // A source exists
+    std::atomic<QThread*> source_thread{ nullptr }; // Thread that created the source
+
+    /// @brief Get a factory creating FakeAudioSources for this capture
+    AudioRecorder::AudioSourceFactory GetFactory();
+};
+
+/// @brief IAudioSource capturing whatever its test pushes to a CaptureFeed
+///
+/// Like QAudioSource, it reports a state change from Start() and Stop(), and
+/// Stop() discards the audio still queued.
+class FakeAudioSource : public IAudioSource
+{
+  public:
+    /// @brief Constructor
+    explicit FakeAudioSource(FakeCapture& aCapture)
+      : mCapture(aCapture)
+    {
+        mCapture.source_thread = QThread::currentThread();
+        mCapture.source_alive = true;
+    }
+
+    ~FakeAudioSource() override { mCapture.source_alive = false; }
+
+    FakeAudioSource(const FakeAudioSource&) = delete;
+    FakeAudioSource& operator=(const FakeAudioSource&) = delete;
+    FakeAudioSource(FakeAudioSource&&) = delete;
+    FakeAudioSource& operator=(FakeAudioSource&&) = delete;
+
+    void SetBufferSize(qsizetype aBytes) override { mBufferSize = aBytes; }
+    [[nodiscard]] qsizetype BufferSize() const override { return mBufferSize; }
+
+    QIODevice* Start() override
+    {
+        if (mCapture.fail_start) {
+            return nullptr;
+        }
+        mDevice = std::make_unique<FakeCaptureDevice>(mCapture.feed);
+        mError = mCapture.start_error;
+        mCapture.starts++;
+        NotifyStateChanged();
+        return mDevice.get();
+    }
+
+    void Stop() override
+    {
+        mCapture.feed.Detach(mDevice.get());
+        mCapture.feed.Clear();
+        mError = QAudio::NoError;
+        NotifyStateChanged();
+    }
+
+    [[nodiscard]] qsizetype BytesAvailable() const override
+    {
+        return mCapture.feed.GetBytesAvailable();
+    }
+
+    [[nodiscard]] QAudio::Error Error() const override { return mError; }
+
+    void OnStateChanged(std::function<void()> aCallback) override
+    {
+        mStateChanged = std::move(aCallback);
+    }
+
+  private:
+    void NotifyStateChanged() const
+    {
+        if (mStateChanged) {
+            mStateChanged();
+        }
+    }
+
+    FakeCapture& mCapture;
+    qsizetype mBufferSize = 0;
+    QAudio::Error mError = QAudio::NoError;
+    std::function<void()> mStateChanged;
+    std::unique_ptr<FakeCaptureDevice> mDevice;
+};
+
+inline AudioRecorder::AudioSourceFactory
+FakeCapture::GetFactory()
+{
+    return [this](const QAudioDevice& /*aDevice*/, const QAudioFormat& /*aFormat*/) {
+        return std::make_unique<FakeAudioSource>(*this);
+    };
+}
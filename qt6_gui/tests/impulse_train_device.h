@@ -0,0 +1,89 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "audio_types.h"
+#include "mock_media_devices.h"
+#include <QIODevice>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+/// @brief Synthetic capture device producing an impulse train
+///
+/// Stands in for the QIODevice returned by QAudioSource::start(), so capture
+/// can be exercised in CI without audio hardware.  Each PushBlock() makes
+/// another block of interleaved float frames readable, with a full-scale
+/// impulse on every channel once per KPeriodFrames and silence elsewhere, then
+/// emits readyRead.  Frames are synthesized as they are read and the device is
+/// unbuffered, so pushing and reading a block allocates nothing.
+class ImpulseTrainIODevice : public QIODevice
+{
+  public:
+    /// @brief Frames between impulses
+    static constexpr size_t KPeriodFrames = 4800;
+
+    /// @brief Constructor
+    /// @param aChannelCount Channels per frame
+    explicit ImpulseTrainIODevice(ChannelCount aChannelCount)
+      : mChannelCount(aChannelCount)
+    {
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    /// @brief Capture the next block and announce it
+    /// @param aFrames Frames in the block
+    void PushBlock(FrameCount aFrames)
+    {
+        mPendingFrames += aFrames.Get();
+        emit readyRead(); // NOLINT(misc-include-cleaner)
+    }
+
+    [[nodiscard]] bool isSequential() const override { return true; }
+
+    [[nodiscard]] qint64 bytesAvailable() const override
+    {
+        return static_cast<qint64>(mPendingFrames * GetBytesPerFrame()) +
+               QIODevice::bytesAvailable();
+    }
+
+    qint64 readData(char* aData, qint64 aMaxLength) override
+    {
+        const size_t kFrames =
+          std::min(mPendingFrames, static_cast<size_t>(aMaxLength) / GetBytesPerFrame());
+        for (size_t frame = 0; frame < kFrames; frame++) {
+            const float kSample = (mFramesGenerated + frame) % KPeriodFrames == 0 ? 1.0f : 0.0f;
+            for (size_t ch = 0; ch < mChannelCount; ch++) {
+                const size_t kOffset = ((frame * mChannelCount) + ch) * sizeof(float);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                std::memcpy(aData + kOffset, &kSample, sizeof(float));
+            }
+        }
+        mFramesGenerated += kFrames;
+        mPendingFrames -= kFrames;
+        return static_cast<qint64>(kFrames * GetBytesPerFrame());
+    }
+
+    // Required for the QIODevice interface, but a capture device is read-only
+    qint64 writeData(const char* /*aData*/, qint64 /*aLength*/) override { return -1; }
+
+  private:
+    [[nodiscard]] size_t GetBytesPerFrame() const { return mChannelCount * sizeof(float); }
+
+    ChannelCount mChannelCount;
+    size_t mFramesGenerated = 0;
+    size_t mPendingFrames = 0;
+};
+
+/// @brief Audio device entry for the synthetic impulse train, for use with
+/// MockMediaDevices::AddDevice()
+class ImpulseTrainAudioDevice : public MockAudioDevice
+{
+  public:
+    ImpulseTrainAudioDevice()
+      : MockAudioDevice("impulse-train", "Synthetic Impulse Train")
+    {
+    }
+};
@@ -0,0 +1,101 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "adapters/audio_file_reader.h"
+#include <algorithm>
+#include <audio_types.h>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// @brief Mock implementation of IAudioFileReader for testing
+/// Returns predefined audio data, and can seek within it.
+class MockAudioFileReader : public IAudioFileReader
+{
+  public:
+    /// @brief Constructor
+    /// @param channelCount Number of channels
+    /// @param sampleRate Sample rate in Hz
+    /// @param samples Interleaved audio samples to return
+    MockAudioFileReader(ChannelCount channelCount,
+                        SampleRate sampleRate,
+                        std::vector<float> samples)
+      : mSamples(std::move(samples))
+      , mSampleRate(sampleRate)
+      , mChannelCount(channelCount)
+    {
+        if (mSamples.size() % mChannelCount != 0) {
+            throw std::invalid_argument("Sample count must be divisible by channel count");
+        }
+    }
+
+    /// @brief Read interleaved audio samples
+    /// @param aFrames Number of frames to read
+    /// @return Vector of interleaved audio samples
+    [[nodiscard]] std::vector<float> ReadInterleaved(FrameCount aFrames) override
+    {
+        const SampleCount kRequestedSamples = aFrames * mChannelCount;
+        const size_t samplesToRead =
+          std::min(kRequestedSamples.Get(), mSamples.size() - mPosition);
+        const auto begin = std::next(mSamples.begin(), static_cast<std::ptrdiff_t>(mPosition));
+        const auto end = std::next(begin, static_cast<std::ptrdiff_t>(samplesToRead));
+        mPosition += samplesToRead;
+        return { begin, end };
+    }
+
+    /// @brief Move the read position
+    /// @param aFrame Frame the next read starts at
+    /// @return false if aFrame is past the end
+    [[nodiscard]] bool Seek(FrameIndex aFrame) override
+    {
+        if (aFrame.Get() > mSamples.size() / mChannelCount) {
+            return false;
+        }
+        mPosition = aFrame.Get() * mChannelCount;
+        return true;
+    }
+
+    /// @brief Get the sample rate of the simulated audio file
+    /// @return Sample rate in Hz
+    [[nodiscard]] SampleRate GetSampleRate() const override { return mSampleRate; }
+
+    /// @brief Get the number of channels in the simulated audio file
+    /// @return Number of channels
+    [[nodiscard]] ChannelCount GetChannelCount() const override { return mChannelCount; }
+
+    /// @brief Get the total number of frames in the simulated audio file
+    /// @return Total frames
+    [[nodiscard]] FrameCount GetFrameCount() const override
+    {
+        return FrameCount{ mSamples.size() / mChannelCount };
+    }
+
+  private:
+    std::vector<float> mSamples;
+    size_t mPosition{ 0 }; // Next sample to read
+    SampleRate mSampleRate;
+    ChannelCount mChannelCount;
+};
+
+/// @brief Interleaved ramp where frame f of channel c has value f + aChannelOffset * c
+/// @param aFrames Frames to make
+/// @param aChannels Channels per frame
+/// @param aChannelOffset Value between one channel and the next, larger than
+/// aFrames so every channel is distinct
+/// @return Interleaved samples, for a MockAudioFileReader
+inline std::vector<float>
+MakeInterleavedRamp(size_t aFrames, ChannelCount aChannels, size_t aChannelOffset)
+{
+    std::vector<float> samples(aFrames * aChannels);
+    for (size_t frame = 0; frame < aFrames; frame++) {
+        for (ChannelCount ch = 0; ch < aChannels; ch++) {
+            samples[(frame * aChannels) + ch] = static_cast<float>(frame + (aChannelOffset * ch));
+        }
+    }
+    return samples;
+}
@@ -13,7 +13,7 @@
 class StubAudioSink : public IAudioSink
 {
   public:
-    void Start(std::unique_ptr<QIODevice> /*aSourceQIODevice*/) override {}
+    void Start(QIODevice& /*aSourceQIODevice*/) override {}
     void Stop() override {}
     [[nodiscard]] qint64 ProcessedUSecs() const override { return mProcessedUSecs; }
 
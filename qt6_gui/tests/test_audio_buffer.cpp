@@ -7,10 +7,13 @@
 #include "models/audio_buffer.h"
 #include <QAudioFormat>
 #include <QSignalSpy>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include <cstddef>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 TEST_CASE("AudioBuffer constructor", "[audio_buffer]")
@@ -81,6 +84,14 @@ TEST_CASE("AudioBuffer::AddSamples emits signal", "[audio_buffer]")
     auto firstCallArgs = spy.takeFirst();
     auto have = firstCallArgs.takeFirst().value<FrameCount>();
     REQUIRE(have == FrameCount(2));
+    REQUIRE(firstCallArgs.takeFirst().value<FrameIndex>() == FrameIndex(0));
+
+    // The second block's range starts where the first ended
+    buffer.AddSamples({ 5, 6, 7, 8, 9, 10 });
+    REQUIRE(spy.count() == 1);
+    auto secondCallArgs = spy.takeFirst();
+    REQUIRE(secondCallArgs.takeFirst().value<FrameCount>() == FrameCount(5));
+    REQUIRE(secondCallArgs.takeFirst().value<FrameIndex>() == FrameIndex(2));
 }
 
 TEST_CASE("AudioBuffer::Reset clears samples", "[audio_buffer]")
@@ -132,6 +143,21 @@ TEST_CASE("AudioBuffer::Reset emits buffer reset signal", "[audio_buffer]")
     REQUIRE(spy.count() == 2);
 }
 
+TEST_CASE("AudioBuffer::Reset announces itself before discarding samples", "[audio_buffer]")
+{
+    AudioBuffer buffer;
+    buffer.AddSamples({ 1, 2, 3, 4 });
+
+    FrameCount framesWhenAnnounced(0);
+    QObject::connect(&buffer, &AudioBuffer::BufferAboutToReset, [&] {
+        framesWhenAnnounced = buffer.GetFrameCount();
+    });
+    buffer.Reset(2, 44100);
+
+    REQUIRE(framesWhenAnnounced == FrameCount(2));
+    REQUIRE(buffer.GetFrameCount() == FrameCount(0));
+}
+
 TEST_CASE("AudioBuffer::BytesPerFrame returns correct value", "[audio_buffer]")
 {
     AudioBuffer buffer;
@@ -174,4 +200,63 @@ TEST_CASE("AudioBuffer::GetAudioFormat returns correct format", "[audio_buffer]"
         CHECK(format.bytesPerSample() == 4);
         CHECK(format.bytesPerFrame() == 4);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("AudioBuffer publishes frames present in every channel", "[audio_buffer]")
+{
+    // Frame i holds i on the left and -i on the right
+    constexpr size_t kTotalFrames = 1 << 18;
+    constexpr size_t kBlockFrames = 480;
+    AudioBuffer buffer;
+    std::atomic<bool> done = false;
+
+    std::jthread writer([&buffer, &done] {
+        std::vector<float> block(2 * kBlockFrames);
+        for (size_t first = 0; first < kTotalFrames; first += kBlockFrames) {
+            for (size_t i = 0; i < kBlockFrames; i++) {
+                block[2 * i] = static_cast<float>(first + i);
+                block[(2 * i) + 1] = -static_cast<float>(first + i);
+            }
+            buffer.AddSamples(block);
+        }
+        done.store(true);
+    });
+
+    bool allMatch = true;
+    while (!done.load()) {
+        const size_t kFrames = buffer.GetFrameCount().Get();
+        if (kFrames == 0) {
+            continue;
+        }
+        const SampleIndex kLast(kFrames - 1);
+        const float kLeft = buffer.GetSamples(0, kLast, SampleCount(1))[0];
+        const float kRight = buffer.GetSamples(1, kLast, SampleCount(1))[0];
+        allMatch = allMatch && kLeft == static_cast<float>(kFrames - 1) && kRight == -kLeft;
+    }
+    writer.join();
+
+    REQUIRE(allMatch);
+    REQUIRE(buffer.GetFrameCount() == FrameCount(kTotalFrames));
+}
+
+TEST_CASE("AudioBuffer::FindIdenticalChannel", "[audio_buffer]")
+{
+    AudioBuffer buffer;
+    buffer.Reset(3, 48000);
+    buffer.AddSamples({ 1, 1, 1, 2, 2, 2 }); // Frames 0-1: all the same
+    buffer.AddSamples({ 3, 3, 4, 5, 5, 6 }); // Frames 2-3: channel 2 differs
+    buffer.AddSamples({ 7, 7, 7, 8, 8, 8 }); // Frames 4-5: all the same again
+
+    REQUIRE(buffer.FindIdenticalChannel(0, SampleIndex{ 0 }, SampleCount{ 6 }) == 0);
+    REQUIRE(buffer.FindIdenticalChannel(1, SampleIndex{ 0 }, SampleCount{ 6 }) == 0);
+    REQUIRE(buffer.FindIdenticalChannel(2, SampleIndex{ 0 }, SampleCount{ 6 }) == 2);
+    REQUIRE(buffer.FindIdenticalChannel(2, SampleIndex{ 4 }, SampleCount{ 2 }) == 0);
+
+    // Unpublished frames are never reported as duplicates
+    REQUIRE(buffer.FindIdenticalChannel(1, SampleIndex{ 4 }, SampleCount{ 4 }) == 1);
+    REQUIRE_THROWS_AS((void)buffer.FindIdenticalChannel(3, SampleIndex{ 0 }, SampleCount{ 1 }),
+                      std::out_of_range);
+
+    // Reset forgets the runs
+    buffer.Reset(2, 48000);
+    REQUIRE(buffer.FindIdenticalChannel(1, SampleIndex{ 0 }, SampleCount{ 0 }) == 1);
+}
@@ -0,0 +1,80 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "adapters/audio_buffer_reader.h"
+#include "models/audio_buffer.h"
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// @brief Two channel buffer where frame f is { f, 100 + f }, 5 frames
+void
+FillBuffer(AudioBuffer& aBuffer)
+{
+    aBuffer.Reset(2, 48000);
+    aBuffer.AddSamples({ 0, 100, 1, 101, 2, 102, 3, 103, 4, 104 });
+}
+
+} // namespace
+
+TEST_CASE("AudioBufferReader", "[audio_buffer_reader]")
+{
+    AudioBuffer buffer;
+    FillBuffer(buffer);
+
+    SECTION("Reports the buffer format")
+    {
+        const AudioBufferReader kReader(buffer);
+        REQUIRE(kReader.GetChannelCount() == 2);
+        REQUIRE(kReader.GetSampleRate() == 48000);
+        REQUIRE(kReader.GetFrameCount() == FrameCount{ 5 });
+    }
+
+    SECTION("Reads the whole buffer interleaved")
+    {
+        AudioBufferReader reader(buffer);
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 2 }) == std::vector<float>{ 0, 100, 1, 101 });
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }) ==
+                std::vector<float>{ 2, 102, 3, 103, 4, 104 });
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }).empty());
+    }
+
+    SECTION("Reads only the requested range")
+    {
+        AudioBufferReader reader(buffer, FrameIndex{ 1 }, FrameCount{ 3 });
+        REQUIRE(reader.GetFrameCount() == FrameCount{ 3 });
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }) ==
+                std::vector<float>{ 1, 101, 2, 102, 3, 103 });
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }).empty());
+    }
+
+    SECTION("Range starting at the end is empty")
+    {
+        AudioBufferReader reader(buffer, FrameIndex{ 5 });
+        REQUIRE(reader.GetFrameCount() == FrameCount{ 0 });
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 1 }).empty());
+    }
+
+    SECTION("Seeks within the range")
+    {
+        AudioBufferReader reader(buffer, FrameIndex{ 1 }, FrameCount{ 3 });
+        REQUIRE(reader.Seek(FrameIndex{ 2 }));
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }) == std::vector<float>{ 3, 103 });
+        REQUIRE(reader.Seek(FrameIndex{ 0 }));
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 1 }) == std::vector<float>{ 1, 101 });
+        REQUIRE_FALSE(reader.Seek(FrameIndex{ 4 }));
+        REQUIRE(reader.ReadInterleaved(FrameCount{ 10 }) ==
+                std::vector<float>{ 2, 102, 3, 103 });
+    }
+
+    SECTION("Throws if the range extends past the end")
+    {
+        REQUIRE_THROWS_AS(AudioBufferReader(buffer, FrameIndex{ 6 }), std::out_of_range);
+        REQUIRE_THROWS_AS(AudioBufferReader(buffer, FrameIndex{ 2 }, FrameCount{ 4 }),
+                          std::out_of_range);
+    }
+}
@@ -5,73 +5,14 @@
 #include "adapters/audio_file_reader.h"
 #include "audio_types.h"
 #include "controllers/audio_file.h"
+#include "mock_audio_file_reader.h"
 #include "models/audio_buffer.h"
-#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
-#include <cstddef>
-#include <iterator>
 #include <qsignalspy.h>
-#include <stdexcept>
-#include <utility>
 #include <vector>
 
-/// @brief Mock implementation of IAudioFileReader for testing
-/// Returns predefined audio data.
-class MockAudioFileReader : public IAudioFileReader
-{
-  public:
-    /// @brief Constructor
-    /// @param channelCount Number of channels
-    /// @param sampleRate Sample rate in Hz
-    /// @param samples Interleaved audio samples to return
-    MockAudioFileReader(ChannelCount channelCount,
-                        SampleRate sampleRate,
-                        std::vector<float> samples)
-      : mSamples(std::move(samples))
-      , mSampleRate(sampleRate)
-      , mChannelCount(channelCount)
-    {
-        if (mSamples.size() % mChannelCount != 0) {
-            throw std::invalid_argument("Sample count must be divisible by channel count");
-        }
-    }
-
-    /// @brief Read interleaved audio samples
-    /// @param aFrames Number of frames to read
-    /// @return Vector of interleaved audio samples
-    [[nodiscard]] std::vector<float> ReadInterleaved(FrameCount aFrames) override
-    {
-        const SampleCount kRequestedSamples = aFrames * mChannelCount;
-        const size_t samplesToRead = std::min(kRequestedSamples.Get(), mSamples.size());
-        const auto end = std::next(mSamples.begin(), static_cast<std::ptrdiff_t>(samplesToRead));
-        std::vector<float> result(mSamples.begin(), end);
-        mSamples.erase(mSamples.begin(), end);
-        return result;
-    }
-
-    /// @brief Get the sample rate of the simulated audio file
-    /// @return Sample rate in Hz
-    [[nodiscard]] SampleRate GetSampleRate() const override { return mSampleRate; }
-
-    /// @brief Get the number of channels in the simulated audio file
-    /// @return Number of channels
-    [[nodiscard]] ChannelCount GetChannelCount() const override { return mChannelCount; }
-
-    /// @brief Get the total number of frames in the simulated audio file
-    /// @return Total frames
-    [[nodiscard]] FrameCount GetFrameCount() const override
-    {
-        return FrameCount{ mSamples.size() / mChannelCount };
-    }
-
-  private:
-    std::vector<float> mSamples;
-    SampleRate mSampleRate;
-    ChannelCount mChannelCount;
-};
-
 TEST_CASE("AudioFile - construction", "[audio_file]")
 {
     AudioBuffer buffer;
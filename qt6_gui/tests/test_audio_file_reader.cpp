@@ -69,4 +69,15 @@ TEST_CASE("AudioFileReader", "[audio_file_reader]")
         REQUIRE(reader.ReadInterleaved(FrameCount(1000)).size() == 1000);
         REQUIRE(reader.ReadInterleaved(FrameCount(1000)).size() == 410);
     }
+
+    SECTION("seeks to a frame")
+    {
+        const auto kFromStart = reader.ReadInterleaved(FrameCount(10));
+        REQUIRE(reader.Seek(FrameIndex{ 4 }));
+        const auto kHave = reader.ReadInterleaved(FrameCount(3));
+        REQUIRE(kHave == std::vector<float>(kFromStart.begin() + 4, kFromStart.begin() + 7));
+        REQUIRE(reader.Seek(FrameIndex{ 4410 }));
+        REQUIRE(reader.ReadInterleaved(FrameCount(1)).empty());
+        REQUIRE_FALSE(reader.Seek(FrameIndex{ 4411 }));
+    }
 }
@@ -50,7 +50,7 @@ TEST_CASE("AudioPlayer::Start", "[audio_player]")
         // Requesting start beyond the end of the buffer should cause seek to fail
         const auto kResult = fixture.audio_player.Start(FrameIndex{ 1 });
         CHECK_FALSE(kResult);
-        CHECK(kResult.error() == "Failed to seek to start frame in AudioBufferQIODevice");
+        CHECK(kResult.error() == "Failed to seek to start frame");
         CHECK_FALSE(fixture.audio_player.IsPlaying());
     }
 
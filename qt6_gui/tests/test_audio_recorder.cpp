@@ -7,10 +7,14 @@
 #include "include/global_constants.h"
 #include "mock_media_devices.h"
 #include "models/audio_buffer.h"
+#include "tests/fake_audio_source.h"
+#include "tests/wait_for.h"
+#include <QAudio>
 #include <QAudioFormat>
 #include <QAudioSource>
 #include <QList>
 #include <QSignalSpy>
+#include <QThread>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
@@ -61,6 +65,25 @@ class MockQIODevice : public QIODevice
     QByteArray mBuffer;
 };
 
+namespace {
+
+/// @brief Make interleaved stereo frames numbered from aFirstFrame: frame n
+/// holds n + 1 on channel 0 and -(n + 1) on channel 1, so none is silent
+std::vector<float>
+MakeRamp(size_t aFrames, size_t aFirstFrame)
+{
+    std::vector<float> samples;
+    samples.reserve(aFrames * 2);
+    for (size_t i = 0; i < aFrames; i++) {
+        const auto kValue = static_cast<float>(aFirstFrame + i + 1);
+        samples.push_back(kValue);
+        samples.push_back(-kValue);
+    }
+    return samples;
+}
+
+} // namespace
+
 TEST_CASE("AudioRecorder constructor succeeds", "[audio_recorder]")
 {
     AudioBuffer buffer;
@@ -200,4 +223,137 @@ TEST_CASE("AudioRecorder::IsRecording", "[audio_recorder]")
     REQUIRE(recorder.IsRecording() == false);
 }
 
+TEST_CASE("AudioRecorder runs the audio source on the capture thread", "[audio_recorder]")
+{
+    AudioBuffer buffer;
+    FakeCapture capture;
+    AudioRecorder recorder(buffer, capture.GetFactory());
+    MockAudioDevice mockAudioDevice;
+    const QSignalSpy spy(&recorder, &AudioRecorder::RecordingStateChanged);
+
+    // Start() waits for the capture thread to create and start the source
+    REQUIRE(recorder.Start(mockAudioDevice, 2, 48000));
+    REQUIRE(recorder.IsRecording());
+    REQUIRE(spy.count() == 1);
+    REQUIRE(capture.starts.load() == 1);
+    REQUIRE(capture.source_thread.load() != nullptr);
+    REQUIRE(capture.source_thread.load() != QThread::currentThread());
+
+    // Audio is read there and reaches the buffer
+    capture.feed.Push(MakeRamp(100, 0));
+    REQUIRE(WaitFor([&] { return buffer.GetFrameCount() == FrameCount(100); }));
+    REQUIRE(recorder.GetOverrunCount() == 0);
+
+    // Stop() waits for the capture thread to destroy the source
+    recorder.Stop();
+    REQUIRE_FALSE(recorder.IsRecording());
+    REQUIRE_FALSE(capture.source_alive.load());
+    REQUIRE(spy.count() == 2);
+}
+
+TEST_CASE("AudioRecorder reports a source that fails to start", "[audio_recorder]")
+{
+    AudioBuffer buffer;
+    FakeCapture capture;
+    capture.fail_start = true;
+    AudioRecorder recorder(buffer, capture.GetFactory());
+    MockAudioDevice mockAudioDevice;
+    const QSignalSpy errors(&recorder, &AudioRecorder::ErrorOccurred);
+    const QSignalSpy states(&recorder, &AudioRecorder::RecordingStateChanged);
+
+    REQUIRE_FALSE(recorder.Start(mockAudioDevice, 1, 48000));
+    REQUIRE_FALSE(recorder.IsRecording());
+    REQUIRE_FALSE(capture.source_alive.load());
+    REQUIRE(errors.count() == 1);
+    REQUIRE(states.count() == 0);
+}
+
+TEST_CASE("AudioRecorder counts underruns reported by the source", "[audio_recorder]")
+{
+    AudioBuffer buffer;
+    FakeCapture capture;
+    capture.start_error = QAudio::UnderrunError;
+    AudioRecorder recorder(buffer, capture.GetFactory());
+    MockAudioDevice mockAudioDevice;
+
+    REQUIRE(recorder.Start(mockAudioDevice, 1, 48000));
+    REQUIRE(recorder.GetUnderrunCount() == 1);
+
+    // Stopping reports no error, and starting again counts afresh
+    recorder.Stop();
+    REQUIRE(recorder.GetUnderrunCount() == 1);
+    REQUIRE(recorder.Start(mockAudioDevice, 1, 48000));
+    REQUIRE(recorder.GetUnderrunCount() == 1);
+}
+
+TEST_CASE("AudioRecorder restarts the source when the buffer size changes", "[audio_recorder]")
+{
+    AudioBuffer buffer;
+    FakeCapture capture;
+    AudioRecorder recorder(buffer, capture.GetFactory());
+    MockAudioDevice mockAudioDevice;
+    REQUIRE(recorder.Start(mockAudioDevice, 2, 48000));
+
+    // The source starts with 5 ms of audio.  A read that finds it full counts
+    // an overrun, and the sizer doubles it.
+    constexpr size_t kBufferFrames = 240;
+    constexpr size_t kFrameBytes = 2 * sizeof(float);
+    REQUIRE(recorder.GetSourceBufferBytes() == kBufferFrames * kFrameBytes);
+
+    SECTION("Audio queued when the source stops is kept, and the gap is padded")
+    {
+        // The late frames arrive during the read that requests the restart,
+        // so only the restart itself can read them before stopping the source
+        constexpr size_t kLateFrames = 100;
+        constexpr size_t kCaptured = kBufferFrames + kLateFrames;
+        capture.feed.PushAfterNextRead(MakeRamp(kLateFrames, kBufferFrames));
+        capture.feed.Push(MakeRamp(kBufferFrames, 0));
+        REQUIRE(WaitFor([&] { return capture.starts == 2; }));
+        REQUIRE(recorder.GetOverrunCount() == 1);
+        REQUIRE(recorder.GetSourceBufferBytes() == 2 * kBufferFrames * kFrameBytes);
+
+        // Read after the restart has finished, so these follow the padding
+        constexpr size_t kNextFrames = 50;
+        capture.feed.Push(MakeRamp(kNextFrames, kCaptured));
+        REQUIRE(WaitFor([&] {
+            return buffer.GetFrameCount() ==
+                   FrameCount(kCaptured + recorder.GetPaddedFrameCount() + kNextFrames);
+        }));
+
+        // Every captured frame is there, in order, around the silence
+        const size_t kPadded = recorder.GetPaddedFrameCount();
+        std::vector<float> expected;
+        for (size_t i = 0; i < kCaptured; i++) {
+            expected.push_back(static_cast<float>(i + 1));
+        }
+        expected.insert(expected.end(), kPadded, 0.0f);
+        for (size_t i = kCaptured; i < kCaptured + kNextFrames; i++) {
+            expected.push_back(static_cast<float>(i + 1));
+        }
+        const auto kHave = buffer.GetSamples(0, SampleIndex(0), SampleCount(expected.size()));
+        REQUIRE_THAT(kHave, Catch::Matchers::RangeEquals(expected));
+    }
+
+    SECTION("Stopping while the restart is pending is safe")
+    {
+        // While the capture thread is held, the read that requests the
+        // restart and then the stop queue up, so the restart runs after the
+        // stop and finds the source gone
+        capture.feed.HoldCaptureThread(50);
+        capture.feed.Push(MakeRamp(kBufferFrames, 0));
+        recorder.Stop();
+        REQUIRE_FALSE(recorder.IsRecording());
+        REQUIRE_FALSE(capture.source_alive.load());
+        REQUIRE(buffer.GetFrameCount() ==
+                FrameCount(kBufferFrames + recorder.GetPaddedFrameCount()));
+
+        // Starting again queues behind the restart, and gets a new source
+        // with the initial buffer size
+        REQUIRE(recorder.Start(mockAudioDevice, 2, 48000));
+        REQUIRE(recorder.IsRecording());
+        REQUIRE(capture.source_alive.load());
+        REQUIRE(recorder.GetSourceBufferBytes() == kBufferFrames * kFrameBytes);
+    }
+}
+
 // NOLINTEND(misc-const-correctness)
\ No newline at end of file
@@ -0,0 +1,128 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/batch_measurer.h"
+#include "mock_audio_file_reader.h"
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <distortion_meter.h>
+#include <numbers>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinAbs;
+
+constexpr int KSampleRate = 48000;
+constexpr size_t KBlockFrames = 4096;
+
+/// @brief Stereo tones, 1 kHz with -60 dB of second harmonic on the left and
+/// pure 2 kHz on the right, interleaved
+std::vector<float>
+MakeStereoTones(size_t aFrames)
+{
+    std::vector<float> samples(aFrames * 2);
+    for (size_t frame = 0; frame < aFrames; frame++) {
+        const double kPhase = 2.0 * std::numbers::pi * 1000.0 * static_cast<double>(frame) /
+                              KSampleRate;
+        samples[frame * 2] = static_cast<float>((0.5 * std::sin(kPhase)) +
+                                                (0.0005 * std::sin(2.0 * kPhase)));
+        samples[(frame * 2) + 1] = static_cast<float>(0.5 * std::sin(2.0 * kPhase));
+    }
+    return samples;
+}
+
+BatchMeasurer::Options
+MakeOptions(ChannelCount aChannel)
+{
+    return { .channel = aChannel, .meter = { .block_frames = KBlockFrames }, .thread_count = 2 };
+}
+
+} // namespace
+
+TEST_CASE("BatchMeasurer::Measure", "[batch_measurer]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const std::string kOutput = dir.filePath("out.csv").toStdString();
+
+    SECTION("every whole block of the chosen channel")
+    {
+        // More than one read, and a partial block at the end
+        const size_t kBlocks = BatchMeasurer::KBlocksPerRead + 3;
+        MockAudioFileReader reader(2, KSampleRate, MakeStereoTones((kBlocks * KBlockFrames) + 100));
+        const auto kResult = BatchMeasurer(MakeOptions(0)).Measure(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->measurements.size() == kBlocks);
+        CHECK(kResult->block_seconds == static_cast<double>(KBlockFrames) / KSampleRate);
+        for (const DistortionMeter::Measurement& kMeasurement : kResult->measurements) {
+            CHECK_THAT(kMeasurement.fundamental_hz, WithinAbs(1000.0, 0.5));
+            CHECK_THAT(kMeasurement.thd_decibels, WithinAbs(-60.0, 0.1));
+        }
+
+        QFile file(QString::fromStdString(kOutput));
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        const QStringList kLines =
+          QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+        REQUIRE(kLines.size() == static_cast<qsizetype>(kBlocks + 1));
+        CHECK(kLines.front() ==
+              "time_s,fundamental_hz,fundamental_db,thd_db,thd_n_db,snr_db,sinad_db");
+        CHECK(kLines.at(2).startsWith("0.085333,1000.000,-9.031,"));
+    }
+
+    SECTION("the other channel")
+    {
+        MockAudioFileReader reader(2, KSampleRate, MakeStereoTones(KBlockFrames));
+        const auto kResult = BatchMeasurer(MakeOptions(1)).Measure(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->measurements.size() == 1);
+        CHECK_THAT(kResult->measurements[0].fundamental_hz, WithinAbs(2000.0, 0.5));
+        CHECK(kResult->measurements[0].thd_decibels < -100.0f);
+    }
+
+    SECTION("errors")
+    {
+        MockAudioFileReader shortReader(2, KSampleRate, MakeStereoTones(KBlockFrames - 1));
+        CHECK_FALSE(BatchMeasurer(MakeOptions(0)).Measure(shortReader, kOutput).has_value());
+
+        MockAudioFileReader stereoReader(2, KSampleRate, MakeStereoTones(KBlockFrames));
+        CHECK_FALSE(BatchMeasurer(MakeOptions(2)).Measure(stereoReader, kOutput).has_value());
+
+        MockAudioFileReader reader(2, KSampleRate, MakeStereoTones(KBlockFrames));
+        BatchMeasurer::Options options = MakeOptions(0);
+        options.meter.bandwidth_hz = 0.0f;
+        CHECK_FALSE(BatchMeasurer(options).Measure(reader, kOutput).has_value());
+
+        MockAudioFileReader unwritable(2, KSampleRate, MakeStereoTones(KBlockFrames));
+        const std::string kBadPath = dir.filePath("missing/out.csv").toStdString();
+        CHECK_FALSE(BatchMeasurer(MakeOptions(0)).Measure(unwritable, kBadPath).has_value());
+    }
+}
+
+TEST_CASE("BatchMeasurer::FormatCsv", "[batch_measurer]")
+{
+    BatchMeasurer::Result result;
+    result.block_seconds = 0.5;
+    result.measurements.push_back({ .fundamental_hz = 1000.0f,
+                                    .fundamental_decibels = -3.0f,
+                                    .thd_decibels = -80.0f,
+                                    .thd_n_decibels = -70.0f,
+                                    .snr_decibels = 70.5f,
+                                    .sinad_decibels = 70.0f,
+                                    .harmonic_count = 9 });
+    result.measurements.push_back(result.measurements.front());
+
+    const std::string kCsv = BatchMeasurer::FormatCsv(result);
+    CHECK(kCsv == "time_s,fundamental_hz,fundamental_db,thd_db,thd_n_db,snr_db,sinad_db\n"
+                  "0.000000,1000.000,-3.000,-80.000,-70.000,70.500,70.000\n"
+                  "0.500000,1000.000,-3.000,-80.000,-70.000,70.500,70.000\n");
+}
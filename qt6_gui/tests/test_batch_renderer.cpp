@@ -0,0 +1,209 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/batch_renderer.h"
+#include "mock_audio_file_reader.h"
+#include "mock_fft_processor.h"
+#include "models/colormap.h"
+#include "models/settings.h"
+#include <QImage>
+#include <QString>
+#include <QTemporaryDir>
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <fft_window.h>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// @brief Settings for small, predictable renders
+///
+/// FFT size 512 with scale 2 gives a stride of 256 and 257 bins per row.
+void
+ConfigureSettings(Settings& aSettings)
+{
+    aSettings.SetFFTSettings(512, FFTWindow::Type::Rectangular);
+    aSettings.SetWindowScale(2);
+    aSettings.SetApertureFloorDecibels(0.0f);
+    aSettings.SetApertureCeilingDecibels(255.0f);
+    aSettings.SetColorMapType(0, ColorMap::Type::White);
+    aSettings.SetColorMapType(1, ColorMap::Type::White);
+}
+
+/// @brief Compare an image pixel with a LUT entry
+bool
+PixelMatches(const QImage& aImage, int aX, int aY, const ColorMap::Entry& aEntry)
+{
+    const QRgb kPixel = aImage.pixel(aX, aY);
+    return qRed(kPixel) == aEntry.r && qGreen(kPixel) == aEntry.g && qBlue(kPixel) == aEntry.b;
+}
+
+} // namespace
+
+TEST_CASE("BatchRenderer constructor", "[batch_renderer]")
+{
+    const Settings kSettings;
+    REQUIRE_NOTHROW(BatchRenderer(kSettings, {}));
+    REQUIRE_THROWS_AS(BatchRenderer(kSettings, { .strip_height = 0 }), std::invalid_argument);
+}
+
+TEST_CASE("BatchRenderer::StripPath", "[batch_renderer]")
+{
+    REQUIRE(BatchRenderer::StripPath("out.png", 0, 1) == "out.png");
+    REQUIRE(BatchRenderer::StripPath("out.png", 3, 10) == "out.0003.png");
+    REQUIRE(BatchRenderer::StripPath("dir.d/out", 12, 20) == "dir.d/out.0012.png");
+    REQUIRE(BatchRenderer::StripPath("dir/out.v2.png", 0, 2) == "dir/out.v2.0000.png");
+}
+
+TEST_CASE("BatchRenderer::ColorizeRows", "[batch_renderer]")
+{
+    Settings settings;
+    ConfigureSettings(settings);
+    const auto& kLUT = settings.GetColorMapLUTs()[0];
+
+    SECTION("Maps the aperture onto the LUT")
+    {
+        const std::vector<float> kRows = { -10.0f, 0.0f, 100.0f, 255.0f, 1000.0f, //
+                                           1.0f,   2.0f, 3.0f,   4.0f,   5.0f };
+        const QImage kImage = BatchRenderer::ColorizeRows({ std::span(kRows) }, 5, settings);
+
+        REQUIRE(kImage.width() == 5);
+        REQUIRE(kImage.height() == 2);
+        CHECK(PixelMatches(kImage, 0, 0, kLUT[0]));
+        CHECK(PixelMatches(kImage, 1, 0, kLUT[0]));
+        CHECK(PixelMatches(kImage, 2, 0, kLUT[100]));
+        CHECK(PixelMatches(kImage, 3, 0, kLUT[255]));
+        CHECK(PixelMatches(kImage, 4, 0, kLUT[255]));
+        CHECK(PixelMatches(kImage, 4, 1, kLUT[5]));
+    }
+
+    SECTION("Sums and clamps channels")
+    {
+        const std::vector<float> kChannel0 = { 100.0f, 200.0f };
+        const std::vector<float> kChannel1 = { 50.0f, 200.0f };
+        const QImage kImage = BatchRenderer::ColorizeRows(
+          { std::span(kChannel0), std::span(kChannel1) }, 2, settings);
+
+        CHECK(qRed(kImage.pixel(0, 0)) == kLUT[100].r + kLUT[50].r);
+        CHECK(qRed(kImage.pixel(1, 0)) == 255);
+    }
+
+    SECTION("Zero aperture range renders black")
+    {
+        settings.SetApertureCeilingDecibels(0.0f);
+        const std::vector<float> kRows = { 100.0f, 200.0f };
+        const QImage kImage = BatchRenderer::ColorizeRows({ std::span(kRows) }, 2, settings);
+        CHECK(kImage.pixel(0, 0) == qRgb(0, 0, 0));
+    }
+}
+
+TEST_CASE("BatchRenderer#Render", "[batch_renderer]")
+{
+    Settings settings;
+    ConfigureSettings(settings);
+    const QTemporaryDir kTempDir;
+    REQUIRE(kTempDir.isValid());
+    const std::string kOutput = kTempDir.filePath("out.png").toStdString();
+    const int kBinCount = 257;
+
+    SECTION("Writes a single image when it fits one strip")
+    {
+        // 10 rows: 512 + 9 * 256 frames
+        MockAudioFileReader reader(1, 44100, std::vector<float>(512 + (9 * 256), 1.0f));
+        const BatchRenderer kRenderer(settings, { .strip_height = 16, .thread_count = 2 });
+
+        const auto kResult = kRenderer.Render(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(*kResult == std::vector<std::string>{ kOutput });
+
+        const QImage kImage(QString::fromStdString(kOutput));
+        REQUIRE(kImage.width() == kBinCount);
+        REQUIRE(kImage.height() == 10);
+    }
+
+    SECTION("Splits long renders into strips")
+    {
+        MockAudioFileReader reader(2, 44100, std::vector<float>(2 * (512 + (9 * 256)), 1.0f));
+        const BatchRenderer kRenderer(settings, { .strip_height = 4, .thread_count = 3 });
+
+        const auto kResult = kRenderer.Render(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->size() == 3);
+
+        const std::vector<int> kExpectedHeights = { 4, 4, 2 };
+        for (size_t i = 0; i < kResult->size(); i++) {
+            CAPTURE(i);
+            REQUIRE(kResult->at(i) == BatchRenderer::StripPath(kOutput, i, 3));
+            const QImage kImage(QString::fromStdString(kResult->at(i)));
+            REQUIRE(kImage.width() == kBinCount);
+            REQUIRE(kImage.height() == kExpectedHeights[i]);
+        }
+    }
+
+    SECTION("Rows continue across strips")
+    {
+        // With the mock FFT, bin b of row r is sample r * stride + b.  A ramp
+        // scaled so each row starts one dB higher lets us check the strip seams.
+        std::vector<float> samples(512 + (5 * 256));
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = static_cast<float>(i) / 256.0f;
+        }
+        MockAudioFileReader reader(1, 44100, samples);
+        const BatchRenderer kRenderer(
+          settings, { .strip_height = 2, .thread_count = 2 }, MockFFTProcessor::GetFactory());
+
+        const auto kResult = kRenderer.Render(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->size() == 3);
+
+        const auto& kLUT = settings.GetColorMapLUTs()[0];
+        for (size_t strip = 0; strip < 3; strip++) {
+            const QImage kImage(QString::fromStdString(kResult->at(strip)));
+            for (int y = 0; y < 2; y++) {
+                const size_t kRow = (strip * 2) + static_cast<size_t>(y);
+                CAPTURE(strip, y);
+                CHECK(PixelMatches(kImage, 0, y, kLUT[kRow]));
+            }
+        }
+    }
+
+    SECTION("Fails on files shorter than one window")
+    {
+        MockAudioFileReader reader(1, 44100, std::vector<float>(511));
+        const BatchRenderer kRenderer(settings, {});
+        REQUIRE_FALSE(kRenderer.Render(reader, kOutput).has_value());
+    }
+
+    SECTION("Fails on unwritable output")
+    {
+        MockAudioFileReader reader(1, 44100, std::vector<float>(512));
+        const BatchRenderer kRenderer(settings, {});
+        const std::string kMissingDirOutput = kTempDir.filePath("missing/out.png").toStdString();
+        REQUIRE_FALSE(kRenderer.Render(reader, kMissingDirOutput).has_value());
+    }
+}
+
+TEST_CASE("BatchRenderer#RenderFile", "[batch_renderer]")
+{
+    const Settings kSettings;
+    const QTemporaryDir kTempDir;
+    const BatchRenderer kRenderer(kSettings, {});
+
+    SECTION("Renders a real file")
+    {
+        const auto kResult =
+          kRenderer.RenderFile("testdata/chirp.wav", kTempDir.filePath("chirp.png").toStdString());
+        REQUIRE(kResult.has_value());
+        REQUIRE_FALSE(QImage(QString::fromStdString(kResult->front())).isNull());
+    }
+
+    SECTION("Reports errors opening the file")
+    {
+        REQUIRE_FALSE(kRenderer.RenderFile("testdata/corrupt.wav", "out.png").has_value());
+    }
+}
@@ -0,0 +1,86 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "audio_types.h"
+#include "controllers/audio_recorder.h"
+#include "impulse_train_device.h"
+#include "mock_media_devices.h"
+#include "models/audio_buffer.h"
+#include "tests/spectrogram_controller_test_fixture.h"
+#include "views/spectrogram_view.h"
+#include <QObject>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <latency_probe.h>
+#include <memory>
+
+TEST_CASE("Impulse train device is listed by MockMediaDevices", "[capture_latency]")
+{
+    MockMediaDevices devices;
+    devices.AddDevice(ImpulseTrainAudioDevice());
+    const auto kDevice = devices.GetAudioInputById("impulse-train");
+    REQUIRE(kDevice != nullptr);
+    REQUIRE(kDevice->Description() == "Synthetic Impulse Train");
+}
+
+TEST_CASE("Impulse train device produces periodic impulses", "[capture_latency]")
+{
+    AudioBuffer buffer;
+    AudioRecorder recorder(buffer);
+    ImpulseTrainAudioDevice device;
+    ImpulseTrainIODevice input(2);
+    REQUIRE(recorder.Start(device, 2, 48000, &input));
+
+    input.PushBlock(FrameCount{ ImpulseTrainIODevice::KPeriodFrames + 1 });
+
+    const auto kSamples = buffer.GetSamples(
+      1, SampleIndex{ 0 }, SampleCount{ ImpulseTrainIODevice::KPeriodFrames + 1 });
+    REQUIRE(kSamples[0] == 1.0f);
+    REQUIRE(kSamples[1] == 0.0f);
+    REQUIRE(kSamples[ImpulseTrainIODevice::KPeriodFrames - 1] == 0.0f);
+    REQUIRE(kSamples[ImpulseTrainIODevice::KPeriodFrames] == 1.0f);
+}
+
+TEST_CASE("Capture-to-pixel latency is measured for every block", "[capture_latency]")
+{
+    SpectrogramControllerTestFixture fixture;
+    AudioRecorder recorder(fixture.audio_buffer);
+    SpectrogramView view(fixture.controller);
+    QObject::connect(&fixture.audio_buffer,
+                     &AudioBuffer::DataAvailable,
+                     &view,
+                     &SpectrogramView::UpdateScrollbarRange);
+    view.resize(400, 300);
+    view.show();
+
+    LatencyProbe& probe = LatencyProbe::Get();
+    probe.SetEnabled(true);
+    const uint64_t kCountBefore = probe.Summarize().count;
+
+    ImpulseTrainAudioDevice device;
+    ImpulseTrainIODevice input(2);
+    REQUIRE(recorder.Start(device, 2, 48000, &input));
+
+    // Half-stride blocks, so a block is only fully on screen once the next
+    // row completes, every other block
+    constexpr int kBlocks = 16;
+    constexpr FrameCount kBlockFrames{ 512 };
+    for (int i = 0; i < kBlocks; i++) {
+        input.PushBlock(kBlockFrames);
+        view.viewport()->repaint();
+    }
+
+    const auto kSummary = probe.Summarize();
+    CHECK(kSummary.count - kCountBefore == kBlocks);
+    CHECK(probe.GetPendingCount() == 0);
+    constexpr uint64_t kImplausibleLatencyNs = 10'000'000'000;
+    CHECK(kSummary.max < kImplausibleLatencyNs);
+
+    // A block still waiting for its row is discarded when disabled
+    input.PushBlock(kBlockFrames);
+    REQUIRE(probe.GetPendingCount() == 1);
+    probe.SetEnabled(false);
+    REQUIRE(probe.GetPendingCount() == 0);
+    recorder.Stop();
+}
@@ -0,0 +1,187 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "audio_types.h"
+#include "controllers/pcm_stream_recorder.h"
+#include "include/global_constants.h"
+#include "models/audio_buffer.h"
+#include "tests/wait_for.h"
+#include <QList>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVariant>
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <pcm_decoder.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::RangeEquals;
+
+/// @brief Write raw values to a descriptor
+template<typename T>
+void
+WriteValues(int aFileDescriptor, const std::vector<T>& aValues)
+{
+    const auto kBytes = static_cast<ssize_t>(aValues.size() * sizeof(T));
+    REQUIRE(::write(aFileDescriptor, aValues.data(), aValues.size() * sizeof(T)) == kBytes);
+}
+
+const PcmStreamRecorder::Format KStereoS16{ .sample_format = PcmDecoder::Format::S16,
+                                            .channel_count = 2,
+                                            .sample_rate = 8000 };
+
+} // namespace
+
+TEST_CASE("PcmStreamRecorder::StartFileDescriptor throws with invalid arguments",
+          "[pcm_stream_recorder]")
+{
+    AudioBuffer buffer;
+    PcmStreamRecorder recorder(buffer);
+
+    for (const ChannelCount kChannels : { ChannelCount{ 0 }, ChannelCount{ GKMaxChannels + 1 } }) {
+        const int kFileDescriptor = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        REQUIRE_THROWS_AS(
+          recorder.StartFileDescriptor(kFileDescriptor, { .channel_count = kChannels }),
+          std::invalid_argument);
+        // Ownership was taken, so the descriptor is closed
+        REQUIRE(::fcntl(kFileDescriptor, F_GETFD) == -1);
+    }
+
+    REQUIRE_THROWS_AS(recorder.Start("-", { .sample_rate = 0 }), std::invalid_argument);
+    REQUIRE_FALSE(recorder.IsRecording());
+}
+
+TEST_CASE("PcmStreamRecorder reads a pipe", "[pcm_stream_recorder]")
+{
+    AudioBuffer buffer;
+    PcmStreamRecorder recorder(buffer);
+    QSignalSpy stateSpy(&recorder, &PcmStreamRecorder::RecordingStateChanged);
+    QSignalSpy errorSpy(&recorder, &PcmStreamRecorder::ErrorOccurred);
+
+    std::array<int, 2> pipeEnds{};
+    REQUIRE(::pipe(pipeEnds.data()) == 0);
+    REQUIRE(recorder.StartFileDescriptor(pipeEnds[0], KStereoS16));
+    REQUIRE(recorder.IsRecording());
+    REQUIRE(stateSpy.count() == 1);
+    REQUIRE(stateSpy.takeFirst().at(0).toBool() == true);
+    REQUIRE(buffer.GetChannelCount() == 2);
+    REQUIRE(buffer.GetSampleRate() == 8000);
+
+    SECTION("Decodes and deinterleaves frames, including split frames")
+    {
+        WriteValues<int16_t>(pipeEnds[1], { 0, 16384, -32768, 8192 });
+        REQUIRE(WaitFor([&] { return buffer.GetFrameCount() == FrameCount(2); }));
+
+        // A frame split across two writes arrives once it is complete
+        WriteValues<uint8_t>(pipeEnds[1], { 0x00 });
+        QThread::msleep(20);
+        WriteValues<uint8_t>(pipeEnds[1], { 0x20, 0x00, 0xC0 }); // 8192, -16384
+        REQUIRE(WaitFor([&] { return buffer.GetFrameCount() == FrameCount(3); }));
+
+        const auto kChannel0 = buffer.GetSamples(0, SampleIndex(0), SampleCount(3));
+        const auto kChannel1 = buffer.GetSamples(1, SampleIndex(0), SampleCount(3));
+        REQUIRE_THAT(kChannel0, RangeEquals(std::vector<float>{ 0.0f, -1.0f, 0.25f }));
+        REQUIRE_THAT(kChannel1, RangeEquals(std::vector<float>{ 0.5f, 0.25f, -0.5f }));
+        ::close(pipeEnds[1]);
+    }
+
+    SECTION("Stops at end of stream")
+    {
+        WriteValues<int16_t>(pipeEnds[1], { 1, 2 });
+        ::close(pipeEnds[1]);
+
+        REQUIRE(WaitFor([&] { return !recorder.IsRecording(); }));
+        REQUIRE(buffer.GetFrameCount() == FrameCount(1));
+        REQUIRE(errorSpy.count() == 1);
+        REQUIRE(errorSpy.takeFirst().at(0).toString() == "End of stream");
+        REQUIRE(stateSpy.count() == 1);
+        REQUIRE(stateSpy.takeFirst().at(0).toBool() == false);
+    }
+
+    SECTION("Stop ends capture")
+    {
+        recorder.Stop();
+        REQUIRE_FALSE(recorder.IsRecording());
+        REQUIRE(stateSpy.count() == 1);
+        REQUIRE(stateSpy.takeFirst().at(0).toBool() == false);
+
+        recorder.Stop(); // Repeating is a no-op
+        REQUIRE(stateSpy.count() == 0);
+        ::close(pipeEnds[1]);
+    }
+}
+
+TEST_CASE("PcmStreamRecorder::Start", "[pcm_stream_recorder]")
+{
+    AudioBuffer buffer;
+    PcmStreamRecorder recorder(buffer);
+    QSignalSpy errorSpy(&recorder, &PcmStreamRecorder::ErrorOccurred);
+    const QTemporaryDir kTempDir;
+    REQUIRE(kTempDir.isValid());
+    const PcmStreamRecorder::Format kMonoF32{ .sample_format = PcmDecoder::Format::F32,
+                                              .channel_count = 1,
+                                              .sample_rate = 768000 };
+
+    SECTION("Reports a missing source")
+    {
+        REQUIRE_FALSE(recorder.Start(kTempDir.filePath("missing").toStdString(), kMonoF32));
+        REQUIRE_FALSE(recorder.IsRecording());
+        REQUIRE(errorSpy.count() == 1);
+    }
+
+    SECTION("Opens a FIFO without waiting for a writer")
+    {
+        const std::string kPath = kTempDir.filePath("fifo").toStdString();
+        REQUIRE(::mkfifo(kPath.c_str(), 0600) == 0);
+        REQUIRE(recorder.Start(kPath, kMonoF32));
+
+        const int kWriter = ::open(kPath.c_str(), O_WRONLY | O_CLOEXEC);
+        REQUIRE(kWriter >= 0);
+        WriteValues<float>(kWriter, { 0.5f, -0.5f, 0.125f });
+        REQUIRE(WaitFor([&] { return buffer.GetFrameCount() == FrameCount(3); }));
+        REQUIRE_THAT(buffer.GetSamples(0, SampleIndex(0), SampleCount(3)),
+                     RangeEquals(std::vector<float>{ 0.5f, -0.5f, 0.125f }));
+        ::close(kWriter);
+        REQUIRE(WaitFor([&] { return !recorder.IsRecording(); }));
+    }
+
+    SECTION("Connects to a Unix socket")
+    {
+        const std::string kPath = kTempDir.filePath("sock").toStdString();
+        const int kListener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(kListener >= 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::ranges::copy(kPath, std::begin(address.sun_path));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        REQUIRE(::bind(kListener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) ==
+                0);
+        REQUIRE(::listen(kListener, 1) == 0);
+
+        REQUIRE(recorder.Start("unix:" + kPath, kMonoF32));
+        const int kConnection = ::accept(kListener, nullptr, nullptr);
+        REQUIRE(kConnection >= 0);
+        WriteValues<float>(kConnection, { 0.25f, 0.75f });
+        REQUIRE(WaitFor([&] { return buffer.GetFrameCount() == FrameCount(2); }));
+
+        recorder.Stop();
+        ::close(kConnection);
+        ::close(kListener);
+    }
+}
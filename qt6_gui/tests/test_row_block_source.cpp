@@ -0,0 +1,218 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/row_block_source.h"
+#include "mock_audio_file_reader.h"
+#include "mock_fft_processor.h"
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <fft_window.h>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr FFTSize KTransformSize = 8;
+constexpr FFTSize KStride = 4;
+constexpr size_t KBinCount = 5;
+
+/// Ramp value between channels
+constexpr size_t KChannelOffset = 1000;
+
+/// @brief Collect the first bin of every row for one channel
+///
+/// With the mock FFT and a rectangular window, bin 0 of a row is the first
+/// sample of its window.
+std::vector<float>
+CollectFirstBins(RowBlockSource& aSource, ChannelCount aChannel)
+{
+    std::vector<float> firstBins;
+    while (aSource.NextBlock() > 0) {
+        const auto kRows = aSource.GetChannelRows(aChannel);
+        for (size_t i = 0; i < kRows.size(); i += aSource.GetBinCount()) {
+            firstBins.push_back(kRows[i]);
+        }
+    }
+    return firstBins;
+}
+
+/// @brief Mock reader that counts the frames it delivers, and can refuse to seek
+class CountingAudioFileReader : public MockAudioFileReader
+{
+  public:
+    CountingAudioFileReader(std::vector<float> aSamples, bool aCanSeek)
+      : MockAudioFileReader(1, 8000, std::move(aSamples))
+      , mCanSeek(aCanSeek)
+    {
+    }
+
+    [[nodiscard]] std::vector<float> ReadInterleaved(FrameCount aFrames) override
+    {
+        std::vector<float> samples = MockAudioFileReader::ReadInterleaved(aFrames);
+        mFramesRead += samples.size();
+        return samples;
+    }
+
+    [[nodiscard]] bool Seek(FrameIndex aFrame) override
+    {
+        return mCanSeek && MockAudioFileReader::Seek(aFrame);
+    }
+
+    [[nodiscard]] size_t GetFramesRead() const { return mFramesRead; }
+
+  private:
+    bool mCanSeek;
+    size_t mFramesRead{ 0 };
+};
+
+} // namespace
+
+TEST_CASE("RowBlockSource::CalculateRowCount", "[row_block_source]")
+{
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 0 }, 512, 256) == 0);
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 511 }, 512, 256) == 0);
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 512 }, 512, 256) == 1);
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 767 }, 512, 256) == 1);
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 768 }, 512, 256) == 2);
+    REQUIRE(RowBlockSource::CalculateRowCount(FrameCount{ 512 * 10 }, 512, 512) == 10);
+}
+
+TEST_CASE("RowBlockSource constructor", "[row_block_source]")
+{
+    SECTION("Rejects zero block rows")
+    {
+        MockAudioFileReader reader(1, 8000, std::vector<float>(64));
+        REQUIRE_THROWS_AS(
+          RowBlockSource(reader, KTransformSize, FFTWindow::Type::Rectangular, KStride, 0),
+          std::invalid_argument);
+    }
+
+    SECTION("Rejects too many channels")
+    {
+        MockAudioFileReader reader(7, 8000, std::vector<float>(7 * 16));
+        REQUIRE_THROWS_AS(
+          RowBlockSource(reader, KTransformSize, FFTWindow::Type::Rectangular, KStride, 4),
+          std::invalid_argument);
+    }
+
+    SECTION("Computes the expected row count for the range")
+    {
+        MockAudioFileReader reader(1, 8000, std::vector<float>(100));
+        const RowBlockSource kWhole(
+          reader, KTransformSize, FFTWindow::Type::Rectangular, KStride, 4);
+        REQUIRE(kWhole.GetExpectedRowCount() == 24);
+        REQUIRE(kWhole.GetBinCount() == KBinCount);
+        REQUIRE(kWhole.GetChannelCount() == 1);
+    }
+}
+
+TEST_CASE("RowBlockSource#NextBlock", "[row_block_source]")
+{
+    SECTION("Streams every row in order across blocks")
+    {
+        // 10 rows, blocks of 3
+        MockAudioFileReader reader(2, 8000, MakeInterleavedRamp(8 + (9 * 4), 2, KChannelOffset));
+        RowBlockSource source(reader,
+                              KTransformSize,
+                              FFTWindow::Type::Rectangular,
+                              KStride,
+                              3,
+                              2,
+                              FrameIndex{ 0 },
+                              std::nullopt,
+                              MockFFTProcessor::GetFactory());
+        REQUIRE(source.GetExpectedRowCount() == 10);
+
+        const std::vector<size_t> kExpectedBlocks = { 3, 3, 3, 1, 0 };
+        std::vector<size_t> blocks;
+        std::vector<float> channel1FirstBins;
+        for (const size_t kExpected : kExpectedBlocks) {
+            blocks.push_back(source.NextBlock());
+            const auto kRows = source.GetChannelRows(1);
+            REQUIRE(kRows.size() == kExpected * KBinCount);
+            for (size_t i = 0; i < kRows.size(); i += KBinCount) {
+                channel1FirstBins.push_back(kRows[i]);
+            }
+        }
+        REQUIRE(blocks == kExpectedBlocks);
+        REQUIRE(source.GetRowsDone() == 10);
+
+        std::vector<float> expected;
+        for (size_t row = 0; row < 10; row++) {
+            expected.push_back(static_cast<float>(KChannelOffset + (row * KStride)));
+        }
+        REQUIRE(channel1FirstBins == expected);
+    }
+
+    SECTION("Honors the frame range")
+    {
+        MockAudioFileReader reader(1, 8000, MakeInterleavedRamp(200, 1, KChannelOffset));
+        RowBlockSource source(reader,
+                              KTransformSize,
+                              FFTWindow::Type::Rectangular,
+                              KStride,
+                              2,
+                              1,
+                              FrameIndex{ 50 },
+                              FrameCount{ 20 },
+                              MockFFTProcessor::GetFactory());
+        REQUIRE(source.GetExpectedRowCount() == 4);
+        REQUIRE(CollectFirstBins(source, 0) == std::vector<float>{ 50, 54, 58, 62 });
+    }
+
+    SECTION("Seeks to the start of the range")
+    {
+        for (const bool kCanSeek : { true, false }) {
+            CountingAudioFileReader reader(MakeInterleavedRamp(10000, 1, KChannelOffset), kCanSeek);
+            RowBlockSource source(reader,
+                                  KTransformSize,
+                                  FFTWindow::Type::Rectangular,
+                                  KStride,
+                                  2,
+                                  1,
+                                  FrameIndex{ 9000 },
+                                  FrameCount{ 20 },
+                                  MockFFTProcessor::GetFactory());
+            REQUIRE(CollectFirstBins(source, 0) == std::vector<float>{ 9000, 9004, 9008, 9012 });
+            // Without seeking, everything before the range is decoded too
+            REQUIRE((reader.GetFramesRead() < 1000) == kCanSeek);
+        }
+    }
+
+    SECTION("Range past the end of the audio produces no rows")
+    {
+        MockAudioFileReader reader(1, 8000, MakeInterleavedRamp(20, 1, KChannelOffset));
+        RowBlockSource source(reader,
+                              KTransformSize,
+                              FFTWindow::Type::Rectangular,
+                              KStride,
+                              2,
+                              1,
+                              FrameIndex{ 100 },
+                              std::nullopt,
+                              MockFFTProcessor::GetFactory());
+        REQUIRE(source.GetExpectedRowCount() == 0);
+        REQUIRE(source.NextBlock() == 0);
+    }
+
+    SECTION("Audio shorter than one window produces no rows")
+    {
+        MockAudioFileReader reader(1, 8000, MakeInterleavedRamp(7, 1, KChannelOffset));
+        RowBlockSource source(
+          reader, KTransformSize, FFTWindow::Type::Rectangular, KStride, 2);
+        REQUIRE(source.NextBlock() == 0);
+        REQUIRE(source.GetChannelRows(0).empty());
+    }
+
+    SECTION("Throws on an invalid channel")
+    {
+        MockAudioFileReader reader(1, 8000, MakeInterleavedRamp(8, 1, KChannelOffset));
+        RowBlockSource source(
+          reader, KTransformSize, FFTWindow::Type::Rectangular, KStride, 2);
+        REQUIRE_THROWS_AS(source.GetChannelRows(1), std::out_of_range);
+    }
+}
@@ -0,0 +1,165 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "adapters/scrub_device.h"
+#include "audio_types.h"
+#include "models/audio_buffer.h"
+#include <QIODevice>
+#include <QtTypes>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cstddef>
+#include <metrics.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Catch::Matchers::WithinRel;
+
+/// @brief Testable subclass of ScrubDevice that exposes protected members for testing
+class TestableScrubDevice : public ScrubDevice
+{
+  public:
+    using ScrubDevice::readData;
+    using ScrubDevice::ScrubDevice;
+};
+
+struct ScrubDeviceTestFixture
+{
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    static constexpr size_t KFrames = 4096;
+    static constexpr int KSampleRate = 48000;
+    static constexpr size_t KCrossfadeFrames =
+      KSampleRate * ScrubDevice::KCrossfadeMs / 1000; // 240
+
+    AudioBuffer audio_buffer;
+    TestableScrubDevice dev{ audio_buffer };
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+    ScrubDeviceTestFixture()
+    {
+        // Mono ramp: each sample holds its own frame index, exactly
+        audio_buffer.Reset(1, KSampleRate);
+        std::vector<float> samples(KFrames);
+        for (size_t i = 0; i < KFrames; i++) {
+            samples[i] = static_cast<float>(i);
+        }
+        audio_buffer.AddSamples(samples);
+        REQUIRE(dev.open(QIODevice::ReadOnly));
+    }
+
+    /// @brief Read frames, waiting for the prefetch thread as needed
+    /// @param aFrames Frames wanted
+    /// @return The frames read; fewer only if they don't arrive within a second
+    std::vector<float> ReadFrames(size_t aFrames)
+    {
+        std::vector<float> frames(aFrames);
+        size_t read = 0;
+        const auto kDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (read < aFrames && std::chrono::steady_clock::now() < kDeadline) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            char* destination = reinterpret_cast<char*>(frames.data() + read);
+            const qint64 kBytes =
+              dev.readData(destination, static_cast<qint64>((aFrames - read) * sizeof(float)));
+            REQUIRE(kBytes >= 0);
+            read += static_cast<size_t>(kBytes) / sizeof(float);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        frames.resize(read);
+        return frames;
+    }
+};
+
+} // namespace
+
+TEST_CASE("ScrubDevice open", "[scrub_device]")
+{
+    AudioBuffer buffer;
+    ScrubDevice dev(buffer);
+    CHECK_FALSE(dev.open(QIODevice::WriteOnly));
+    CHECK(dev.open(QIODevice::ReadOnly));
+    CHECK(dev.isSequential());
+}
+
+TEST_CASE("ScrubDevice playback", "[scrub_device]")
+{
+    ScrubDeviceTestFixture fixture;
+
+    SECTION("nothing is delivered before Play()")
+    {
+        std::vector<float> frames(16);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        CHECK(fixture.dev.readData(reinterpret_cast<char*>(frames.data()), 64) == 0);
+        CHECK_FALSE(fixture.dev.IsPlaying());
+    }
+
+    SECTION("plays from the start frame, fading in")
+    {
+        REQUIRE(fixture.dev.Play(FrameIndex{ 100 }));
+        CHECK(fixture.dev.IsPlaying());
+        const std::vector<float> kFrames = fixture.ReadFrames(1000);
+        REQUIRE(kFrames.size() == 1000);
+
+        CHECK(kFrames[0] == 0.0f);
+        CHECK_THAT(kFrames[120], WithinRel(220.0f * 0.5f, 1e-5f));
+        for (size_t i = ScrubDeviceTestFixture::KCrossfadeFrames; i < kFrames.size(); i++) {
+            REQUIRE(kFrames[i] == static_cast<float>(100 + i));
+        }
+    }
+
+    SECTION("stops at the end of the source")
+    {
+        REQUIRE(fixture.dev.Play(FrameIndex{ ScrubDeviceTestFixture::KFrames - 300 }));
+        const std::vector<float> kFrames = fixture.ReadFrames(1000);
+        REQUIRE(kFrames.size() == 300);
+        CHECK(kFrames.back() == static_cast<float>(ScrubDeviceTestFixture::KFrames - 1));
+    }
+
+    SECTION("Pause() stops delivery")
+    {
+        REQUIRE(fixture.dev.Play(FrameIndex{ 0 }));
+        REQUIRE(fixture.ReadFrames(10).size() == 10);
+        fixture.dev.Pause();
+        CHECK_FALSE(fixture.dev.IsPlaying());
+        std::vector<float> frames(16);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        CHECK(fixture.dev.readData(reinterpret_cast<char*>(frames.data()), 64) == 0);
+    }
+
+    SECTION("frames past the end are refused")
+    {
+        CHECK(fixture.dev.Play(FrameIndex{ ScrubDeviceTestFixture::KFrames }));
+        CHECK_FALSE(fixture.dev.Play(FrameIndex{ ScrubDeviceTestFixture::KFrames + 1 }));
+        CHECK_FALSE(fixture.dev.Seek(FrameIndex{ ScrubDeviceTestFixture::KFrames + 1 }));
+    }
+}
+
+TEST_CASE("ScrubDevice seeking", "[scrub_device]")
+{
+    ScrubDeviceTestFixture fixture;
+    const Metrics::Histogram& kLatency = Metrics::GetHistogram(Metrics::KSeekToAudio);
+
+    REQUIRE(fixture.dev.Play(FrameIndex{ 0 }));
+    REQUIRE(fixture.ReadFrames(500).size() == 500);
+    const size_t kSeeks = kLatency.Summarize().count;
+
+    REQUIRE(fixture.dev.Seek(FrameIndex{ 2000 }));
+    const std::vector<float> kFrames = fixture.ReadFrames(1000);
+    REQUIRE(kFrames.size() == 1000);
+
+    // The old audio carries on at full level, so there's no jump
+    CHECK(kFrames[0] == 500.0f);
+
+    // After the crossfade, only the new audio is heard
+    const float kSettled = kFrames[ScrubDeviceTestFixture::KCrossfadeFrames * 2];
+    CHECK(kSettled >= 2000.0f);
+    for (size_t i = ScrubDeviceTestFixture::KCrossfadeFrames * 2; i < kFrames.size(); i++) {
+        REQUIRE(kFrames[i] ==
+                kSettled + static_cast<float>(i - (ScrubDeviceTestFixture::KCrossfadeFrames * 2)));
+    }
+
+    CHECK(kLatency.Summarize().count == kSeeks + 1);
+}
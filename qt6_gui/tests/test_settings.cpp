@@ -175,6 +175,36 @@ TEST_CASE("Settings::SetAperture", "[settings]")
     REQUIRE(settings.GetApertureCeilingDecibels() == 20.0f);
 }
 
+TEST_CASE("Settings::SetAperture together", "[settings]")
+{
+    Settings settings;
+    const QSignalSpy spy(&settings, &Settings::DisplaySettingsChanged);
+
+    settings.SetAperture(-60.0f, 30.0f);
+    REQUIRE(spy.count() == 1);
+    REQUIRE(settings.GetApertureFloorDecibels() == -60.0f);
+    REQUIRE(settings.GetApertureCeilingDecibels() == 30.0f);
+}
+
+TEST_CASE("Settings::SetAutoAperture", "[settings]")
+{
+    Settings settings;
+    const QSignalSpy spy(&settings, &Settings::DisplaySettingsChanged);
+    REQUIRE_FALSE(settings.IsAutoAperture());
+
+    settings.SetAutoAperture(true);
+    REQUIRE(settings.IsAutoAperture());
+    REQUIRE(spy.count() == 1);
+
+    // No signal if unchanged
+    settings.SetAutoAperture(true);
+    REQUIRE(spy.count() == 1);
+
+    settings.SetAutoAperture(false);
+    REQUIRE_FALSE(settings.IsAutoAperture());
+    REQUIRE(spy.count() == 2);
+}
+
 TEST_CASE("Settings Live Mode", "[settings]")
 {
     Settings settings;
@@ -208,5 +208,57 @@ TEST_CASE("SettingsController::StopRecording", "[settings_controller]")
     }
 }
 
+TEST_CASE("SettingsController::ApplyAutoAperture", "[settings_controller]")
+{
+    SettingsControllerFixture fixture;
+    Settings& settings = fixture.settings;
+    settings.SetAperture(-20.0f, 40.0f);
+
+    SECTION("only when automatic")
+    {
+        REQUIRE_FALSE(fixture.controller.ApplyAutoAperture(-50.0f, 10.0f));
+        REQUIRE(settings.GetApertureFloorDecibels() == -20.0f);
+    }
+
+    settings.SetAutoAperture(true);
+    const QSignalSpy spy(&settings, &Settings::DisplaySettingsChanged);
+
+    SECTION("to whole decibels, redrawing once")
+    {
+        REQUIRE(fixture.controller.ApplyAutoAperture(-50.4f, 10.6f));
+        REQUIRE(settings.GetApertureFloorDecibels() == -50.0f);
+        REQUIRE(settings.GetApertureCeilingDecibels() == 11.0f);
+        REQUIRE(spy.count() == 1);
+    }
+
+    SECTION("not for small changes")
+    {
+        const float kStep = SettingsController::KAutoApertureStepDecibels;
+        REQUIRE_FALSE(fixture.controller.ApplyAutoAperture(-20.0f + (kStep / 2), 40.0f));
+        REQUIRE_FALSE(fixture.controller.ApplyAutoAperture(-20.0f, 40.0f - (kStep / 2)));
+        REQUIRE(fixture.controller.ApplyAutoAperture(-20.0f, 40.0f + kStep));
+        REQUIRE(spy.count() == 1);
+    }
+
+    SECTION("within the limits")
+    {
+        REQUIRE(fixture.controller.ApplyAutoAperture(-200.0f, 200.0f));
+        REQUIRE(settings.GetApertureFloorDecibels() == Settings::KApertureLimitsDecibels.first);
+        REQUIRE(settings.GetApertureCeilingDecibels() == Settings::KApertureLimitsDecibels.second);
+
+        // Still beyond them, but already as close as allowed
+        REQUIRE_FALSE(fixture.controller.ApplyAutoAperture(-200.0f, 200.0f));
+        REQUIRE(spy.count() == 1);
+    }
+
+    SECTION("at least the least range")
+    {
+        REQUIRE(fixture.controller.ApplyAutoAperture(-60.0f, -60.0f));
+        REQUIRE(settings.GetApertureFloorDecibels() == -60.0f);
+        REQUIRE(settings.GetApertureCeilingDecibels() ==
+                -60.0f + SettingsController::KMinAutoApertureDecibels);
+    }
+}
+
 // NOLINTEND(bugprone-unchecked-optional-access)
 // NOLINTEND(misc-const-correctness)
\ No newline at end of file
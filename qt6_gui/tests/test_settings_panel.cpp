@@ -114,6 +114,9 @@ TEST_CASE("SettingsPanel has named FFT controls", "[settings_panel]")
 
     REQUIRE(fixture.panel.GetApertureCeilingLabel() != nullptr);
     REQUIRE(fixture.panel.GetApertureCeilingLabel()->objectName() == "ApertureCeilingLabel");
+
+    REQUIRE(fixture.panel.GetAutoApertureCheckBox() != nullptr);
+    REQUIRE(fixture.panel.GetAutoApertureCheckBox()->objectName() == "AutoApertureCheckBox");
 }
 
 TEST_CASE("SettingsPanel has named color map controls", "[settings_panel]")
@@ -279,6 +282,37 @@ TEST_CASE("SettingsPanel aperture ceiling slider updates Settings", "[settings_p
     REQUIRE(spy.count() >= 1);
 }
 
+TEST_CASE("SettingsPanel auto aperture check box updates Settings", "[settings_panel]")
+{
+    TestFixture const fixture;
+    auto* checkBox = fixture.panel.GetAutoApertureCheckBox();
+    REQUIRE_FALSE(checkBox->isChecked());
+
+    checkBox->setChecked(true);
+    REQUIRE(fixture.settings.IsAutoAperture());
+
+    // Moving a slider takes the aperture back
+    fixture.panel.GetApertureFloorSlider()->setValue(-30);
+    REQUIRE_FALSE(fixture.settings.IsAutoAperture());
+    REQUIRE_FALSE(checkBox->isChecked());
+}
+
+TEST_CASE("SettingsPanel shows the aperture Settings holds", "[settings_panel]")
+{
+    TestFixture fixture;
+    fixture.settings.SetAutoAperture(true);
+    fixture.settings.SetAperture(-45.0f, 25.0f);
+
+    REQUIRE(fixture.panel.GetApertureFloorSlider()->value() == -45);
+    REQUIRE(fixture.panel.GetApertureFloorLabel()->text() == "-45");
+    REQUIRE(fixture.panel.GetApertureCeilingSlider()->value() == 25);
+    REQUIRE(fixture.panel.GetApertureCeilingLabel()->text() == "25");
+    REQUIRE(fixture.panel.GetAutoApertureCheckBox()->isChecked());
+
+    // Showing the values doesn't set them, so the aperture stays automatic
+    REQUIRE(fixture.settings.IsAutoAperture());
+}
+
 //
 // Color Map Controls Tests
 //
@@ -2,22 +2,34 @@
 // SPDX-License-Identifier: GPL-3.0-only
 // Copyright (C) 2025-2026 Chris "Kai" Frederick
 
+#include "controllers/audio_player.h"
 #include "controllers/spectrogram_controller.h"
 #include "models/audio_buffer.h"
 #include "models/settings.h"
 #include "tests/spectrogram_controller_test_fixture.h"
+#include "tests/stub_audio_sink.h"
+#include <QList>
+#include <QSignalSpy>
+#include <QVariant>
 #include <audio_types.h>
+#include <block_summary_index.h>
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <fft_processor.h>
 #include <fft_window.h>
 #include <format>
+#include <level_histogram.h>
 #include <memory>
 #include <mock_fft_processor.h>
+#include <noise_floor_estimator.h>
+#include <numbers>
+#include <peak_tracker.h>
+#include <random>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -205,6 +217,21 @@ TEST_CASE("SpectrogramController::GetRows, GetRow, ComputeFFT", "[spectrogram_co
     }
 }
 
+TEST_CASE("SpectrogramController::GetChannelRows", "[spectrogram_controller]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.settings.SetFFTSettings(8, FFTWindow::Type::Rectangular);
+    fixture.settings.SetWindowScale(1);
+    fixture.audio_buffer.Reset(2, 44100);
+    fixture.audio_buffer.AddSamples({ 1, -1, 2, -2, 3, -3, 4, -4, 5, -5, 6, -6, 7, -7, 8, -8 });
+
+    const std::vector<std::vector<std::vector<float>>> kWant = {
+        { { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }, { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } },
+        { { -1.0f, -2.0f, -3.0f, -4.0f, -5.0f }, { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } },
+    };
+    REQUIRE(fixture.controller.GetChannelRows(FramePosition{ 0 }, 2) == kWant);
+}
+
 TEST_CASE("SpectrogramController::GetAvailableFrameCount", "[spectrogram_controller]")
 {
     SpectrogramControllerTestFixture fixture;
@@ -214,6 +241,129 @@ TEST_CASE("SpectrogramController::GetAvailableFrameCount", "[spectrogram_control
     REQUIRE(fixture.controller.GetAvailableFrameCount() == FrameCount(kExpectedSampleCount));
 }
 
+TEST_CASE("SpectrogramController::RowsCompleted", "[spectrogram_controller]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 44100);
+    fixture.settings.SetFFTSettings(8, FFTWindow::Type::Hann);
+    fixture.settings.SetWindowScale(2); // stride = 4
+    QSignalSpy spy(&fixture.controller, &SpectrogramController::RowsCompleted);
+
+    const auto kRange = [&spy]() {
+        REQUIRE(spy.count() == 1);
+        QList<QVariant> args = spy.takeFirst();
+        const auto kFirst = args.takeFirst().value<FramePosition>();
+        const auto kEnd = args.takeFirst().value<FramePosition>();
+        return std::make_pair(kFirst.Get(), kEnd.Get());
+    };
+
+    SECTION("no row completes before a whole window is available")
+    {
+        fixture.audio_buffer.AddSamples(std::vector<float>(7, 0.0f));
+        CHECK(spy.count() == 0);
+    }
+
+    SECTION("each append reports the rows it completed")
+    {
+        // Rows at 0 and 4 need 8 and 12 frames
+        fixture.audio_buffer.AddSamples(std::vector<float>(13, 0.0f));
+        CHECK(kRange() == std::pair<std::ptrdiff_t, std::ptrdiff_t>{ 0, 8 });
+
+        // Row 8 needs 16 frames
+        fixture.audio_buffer.AddSamples(std::vector<float>(2, 0.0f));
+        CHECK(spy.count() == 0);
+        fixture.audio_buffer.AddSamples(std::vector<float>(1, 0.0f));
+        CHECK(kRange() == std::pair<std::ptrdiff_t, std::ptrdiff_t>{ 8, 12 });
+    }
+
+    SECTION("a reset invalidates every row")
+    {
+        const QSignalSpy invalidated(&fixture.controller, &SpectrogramController::RowsInvalidated);
+        fixture.audio_buffer.Reset(2, 44100);
+        CHECK(invalidated.count() == 1);
+    }
+}
+
+TEST_CASE("SpectrogramController::GetPeakTracks", "[spectrogram_controller]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 44100);
+    fixture.settings.SetFFTSettings(512, FFTWindow::Type::Rectangular);
+    fixture.settings.SetWindowScale(1); // stride = 512
+
+    // The mock transform passes samples through as decibels, so every row
+    // holds this bump at bin 100
+    std::vector<float> period(512, -120.0f);
+    period[99] = -30.0f;
+    period[100] = -20.0f;
+    period[101] = -30.0f;
+
+    SECTION("live input is tracked")
+    {
+        fixture.audio_buffer.AddSamples(period);
+        fixture.audio_buffer.AddSamples(period);
+        CHECK(fixture.controller.GetPeakTracks(0).empty()); // Only 2 rows so far
+        fixture.audio_buffer.AddSamples(period);
+        const std::vector<PeakTracker::Track> kTracks = fixture.controller.GetPeakTracks(0);
+        REQUIRE(kTracks.size() == 1);
+        CHECK_THAT(kTracks[0].bin, Catch::Matchers::WithinAbs(100.0, 1e-3));
+        CHECK_THAT(kTracks[0].decibels, Catch::Matchers::WithinAbs(-20.0, 1e-3));
+        CHECK(kTracks[0].rows == 3);
+    }
+
+    SECTION("a bulk append is not tracked")
+    {
+        std::vector<float> samples;
+        for (size_t i = 0; i < 100; i++) {
+            samples.insert(samples.end(), period.begin(), period.end());
+        }
+        fixture.audio_buffer.AddSamples(samples);
+        CHECK(fixture.controller.GetPeakTracks(0).empty());
+    }
+
+    SECTION("throws out_of_range for invalid channel")
+    {
+        CHECK_THROWS_AS(fixture.controller.GetPeakTracks(1), std::out_of_range);
+    }
+}
+
+TEST_CASE("SpectrogramController::GetNoiseFloor", "[spectrogram_controller]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 44100);
+    fixture.settings.SetFFTSettings(512, FFTWindow::Type::Rectangular);
+    fixture.settings.SetWindowScale(1); // stride = 512
+
+    // With the mock transform, every row is -90 dB in every bin
+    const std::vector<float> kPeriod(512, -90.0f);
+
+    SECTION("live input is estimated")
+    {
+        CHECK(fixture.controller.GetNoiseFloor(0).empty());
+        fixture.audio_buffer.AddSamples(kPeriod);
+        fixture.audio_buffer.AddSamples(kPeriod);
+        const std::vector<float> kFloor = fixture.controller.GetNoiseFloor(0);
+        REQUIRE(kFloor.size() == 512);
+        const float kExpected = -90.0f + NoiseFloorEstimator::KDefaultBiasDecibels;
+        CHECK_THAT(kFloor[100], Catch::Matchers::WithinAbs(kExpected, 1e-3));
+    }
+
+    SECTION("a bulk append is not estimated")
+    {
+        std::vector<float> samples;
+        for (size_t i = 0; i < 100; i++) {
+            samples.insert(samples.end(), kPeriod.begin(), kPeriod.end());
+        }
+        fixture.audio_buffer.AddSamples(samples);
+        CHECK(fixture.controller.GetNoiseFloor(0).empty());
+    }
+
+    SECTION("throws out_of_range for invalid channel")
+    {
+        CHECK_THROWS_AS(fixture.controller.GetNoiseFloor(1), std::out_of_range);
+    }
+}
+
 TEST_CASE("SpectrogramController::GetChannelCount", "[spectrogram_controller]")
 {
     SpectrogramControllerTestFixture fixture;
@@ -384,3 +534,153 @@ TEST_CASE("SpectrogramController::GetPlaybackFrame", "[spectrogram_controller]")
         CHECK(fixture.controller.GetPlaybackFrame() == FrameIndex{ 123 });
     }
 }
+
+TEST_CASE("SpectrogramController::GetLiveAperture", "[spectrogram_controller]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 44100);
+    fixture.settings.SetFFTSettings(512, FFTWindow::Type::Rectangular);
+    fixture.settings.SetWindowScale(1); // stride = 512
+
+    // With the mock transform, every row is -90 dB in every bin
+    const std::vector<float> kPeriod(512, -90.0f);
+    const float kResolution = LevelHistogram::Config{}.resolution_decibels;
+    CHECK_FALSE(fixture.controller.GetLiveAperture().has_value());
+
+    SECTION("live input is measured")
+    {
+        fixture.audio_buffer.AddSamples(kPeriod);
+        fixture.audio_buffer.AddSamples(kPeriod);
+        const auto kAperture = fixture.controller.GetLiveAperture();
+        REQUIRE(kAperture.has_value());
+        CHECK_THAT(kAperture->floor_decibels, Catch::Matchers::WithinAbs(-90.0, kResolution));
+        CHECK_THAT(kAperture->ceiling_decibels, Catch::Matchers::WithinAbs(-90.0, kResolution));
+
+        // New FFT settings start again
+        fixture.settings.SetFFTSettings(1024, FFTWindow::Type::Rectangular);
+        CHECK_FALSE(fixture.controller.GetLiveAperture().has_value());
+    }
+
+    SECTION("a bulk append is not measured")
+    {
+        std::vector<float> samples;
+        for (size_t i = 0; i < 100; i++) {
+            samples.insert(samples.end(), kPeriod.begin(), kPeriod.end());
+        }
+        fixture.audio_buffer.AddSamples(samples);
+        CHECK_FALSE(fixture.controller.GetLiveAperture().has_value());
+    }
+}
+
+TEST_CASE("SpectrogramController::ComputeHistoryAperture", "[spectrogram_controller]")
+{
+    constexpr size_t kBlock = BlockSummaryIndex::KDefaultBlockFrames;
+    const FramePosition kEnd{ static_cast<std::ptrdiff_t>(4 * kBlock) };
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 48000);
+    fixture.settings.SetFFTSettings(2048, FFTWindow::Type::Hann);
+    CHECK_FALSE(fixture.controller.ComputeHistoryAperture(FramePosition{ 0 }, kEnd).has_value());
+
+    SECTION("noise")
+    {
+        // A bin of this noise averages 10 log10(0.01^2 * sum w^2), about -11 dB,
+        // and its power is exponentially distributed, so 5% of bins are 13 dB
+        // or more below that
+        std::mt19937 generator(1);
+        std::normal_distribution<float> noise(0.0f, 0.01f);
+        std::vector<float> samples(4 * kBlock);
+        for (float& sample : samples) {
+            sample = noise(generator);
+        }
+        fixture.audio_buffer.AddSamples(samples);
+        fixture.controller.WaitForSummaries();
+        const auto kAperture = fixture.controller.ComputeHistoryAperture(FramePosition{ 0 }, kEnd);
+        REQUIRE(kAperture.has_value());
+        CHECK_THAT(kAperture->floor_decibels, Catch::Matchers::WithinAbs(-24.0, 1.5));
+        CHECK(kAperture->ceiling_decibels > kAperture->floor_decibels);
+    }
+
+    SECTION("a tone")
+    {
+        // A 0.5 amplitude tone peaks at 20 log10(0.5 * sum w / 2), about 48 dB
+        std::vector<float> samples(4 * kBlock);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = 0.5f * static_cast<float>(std::sin(2.0 * std::numbers::pi * 1000.0 *
+                                                            static_cast<double>(i) / 48000.0));
+        }
+        fixture.audio_buffer.AddSamples(samples);
+        fixture.controller.WaitForSummaries();
+        const auto kAperture = fixture.controller.ComputeHistoryAperture(FramePosition{ 0 }, kEnd);
+        REQUIRE(kAperture.has_value());
+        CHECK_THAT(kAperture->ceiling_decibels, Catch::Matchers::WithinAbs(48.0, 3.0));
+
+        // Only the blocks a range overlaps count
+        CHECK_FALSE(
+          fixture.controller.ComputeHistoryAperture(kEnd, kEnd + FrameCount{ kBlock }).has_value());
+        CHECK(fixture.controller.ComputeHistoryAperture(kEnd - FrameCount{ 1 }, kEnd).has_value());
+    }
+
+    SECTION("silence")
+    {
+        fixture.audio_buffer.AddSamples(std::vector<float>(4 * kBlock, 0.0f));
+        fixture.controller.WaitForSummaries();
+        const auto kAperture = fixture.controller.ComputeHistoryAperture(FramePosition{ 0 }, kEnd);
+        CHECK_FALSE(kAperture.has_value());
+    }
+}
+
+TEST_CASE("SpectrogramController history and live apertures", "[spectrogram_controller]")
+{
+    constexpr size_t kBlock = BlockSummaryIndex::KDefaultBlockFrames;
+    constexpr size_t kChunk = 2048;
+    Settings settings;
+    AudioBuffer audioBuffer;
+    AudioPlayer audioPlayer{ audioBuffer, StubAudioSink::GetFactory() };
+    SpectrogramController controller{ settings, audioBuffer, audioPlayer }; // Real FFT
+    audioBuffer.Reset(1, 48000);
+    settings.SetFFTSettings(2048, FFTWindow::Type::Hann);
+
+    // Steady noise in live-sized appends, so every row is measured live too
+    std::mt19937 generator(1);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<float> chunk(kChunk);
+    for (size_t appended = 0; appended < 4 * kBlock; appended += kChunk) {
+        for (float& sample : chunk) {
+            sample = noise(generator);
+        }
+        audioBuffer.AddSamples(chunk);
+    }
+    controller.WaitForSummaries();
+
+    const auto kLive = controller.GetLiveAperture();
+    const auto kHistory = controller.ComputeHistoryAperture(
+      FramePosition{ 0 }, FramePosition{ static_cast<std::ptrdiff_t>(4 * kBlock) });
+    REQUIRE(kLive.has_value());
+    REQUIRE(kHistory.has_value());
+    CHECK_THAT(kHistory->floor_decibels, Catch::Matchers::WithinAbs(kLive->floor_decibels, 1.5));
+    CHECK(kHistory->ceiling_decibels >= kLive->ceiling_decibels);
+}
+
+TEST_CASE("SpectrogramController::FindBandPowerAbove", "[spectrogram_controller]")
+{
+    using Ranges = std::vector<BlockSummaryIndex::TimeRange>;
+    constexpr size_t kBlock = BlockSummaryIndex::KDefaultBlockFrames;
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(1, 48000);
+
+    // A silent block, then a block of 3 kHz, each about 171 ms
+    std::vector<float> samples(2 * kBlock, 0.0f);
+    for (size_t i = kBlock; i < samples.size(); i++) {
+        samples[i] = 0.5f * static_cast<float>(std::sin(2.0 * std::numbers::pi * 3000.0 *
+                                                        static_cast<double>(i) / 48000.0));
+    }
+    fixture.audio_buffer.AddSamples(samples);
+    fixture.controller.WaitForSummaries();
+    CHECK(fixture.controller.FindBandPowerAbove(2000.0f, 4000.0f, -20.0f) ==
+          Ranges{ { 170, 342 } });
+    CHECK(fixture.controller.FindBandPowerAbove(200.0f, 400.0f, -20.0f).empty());
+
+    // A new recording starts a new index
+    fixture.audio_buffer.Reset(1, 48000);
+    CHECK(fixture.controller.FindBandPowerAbove(2000.0f, 4000.0f, -100.0f).empty());
+}
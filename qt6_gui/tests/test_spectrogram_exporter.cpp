@@ -0,0 +1,321 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "controllers/spectrogram_exporter.h"
+#include "mock_audio_file_reader.h"
+#include "mock_fft_processor.h"
+#include "models/settings.h"
+#include <QByteArray>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QTemporaryDir>
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fft_window.h>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// FFT size 512 with scale 2 gives a stride of 256 and 257 bins per row.
+constexpr size_t KStride = 256;
+constexpr size_t KBinCount = 257;
+
+void
+ConfigureSettings(Settings& aSettings)
+{
+    aSettings.SetFFTSettings(512, FFTWindow::Type::Rectangular);
+    aSettings.SetWindowScale(2);
+}
+
+/// Ramp value between channels.  With the mock FFT and a rectangular window,
+/// bin b of row r of channel c is r * stride + b + KChannelOffset * c.
+constexpr size_t KChannelOffset = 10000;
+
+QByteArray
+ReadFile(const std::string& aPath)
+{
+    QFile file(QString::fromStdString(aPath));
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    return file.readAll();
+}
+
+/// @brief Read a little-endian float32 at a byte offset
+float
+ReadFloat(const QByteArray& aData, size_t aOffset)
+{
+    float value = 0;
+    std::memcpy(&value, aData.constData() + aOffset, sizeof(value));
+    return value;
+}
+
+/// @brief Read a little-endian uint16 at a byte offset
+uint16_t
+ReadUInt16(const QByteArray& aData, size_t aOffset)
+{
+    uint16_t value = 0;
+    std::memcpy(&value, aData.constData() + aOffset, sizeof(value));
+    return value;
+}
+
+/// @brief Mock reader that delivers fewer frames than it reports
+class TruncatedAudioFileReader : public MockAudioFileReader
+{
+  public:
+    TruncatedAudioFileReader(std::vector<float> aSamples, FrameCount aReportedFrames)
+      : MockAudioFileReader(1, 44100, std::move(aSamples))
+      , mReportedFrames(aReportedFrames)
+    {
+    }
+
+    [[nodiscard]] FrameCount GetFrameCount() const override { return mReportedFrames; }
+
+  private:
+    FrameCount mReportedFrames;
+};
+
+} // namespace
+
+TEST_CASE("SpectrogramExporter constructor", "[spectrogram_exporter]")
+{
+    const Settings kSettings;
+    REQUIRE_NOTHROW(SpectrogramExporter(kSettings, {}));
+    REQUIRE_THROWS_AS(SpectrogramExporter(kSettings, { .block_rows = 0 }), std::invalid_argument);
+}
+
+TEST_CASE("SpectrogramExporter::FileExtension", "[spectrogram_exporter]")
+{
+    using Format = SpectrogramExporter::Format;
+    REQUIRE(SpectrogramExporter::FileExtension(Format::Npy) == ".npy");
+    REQUIRE(SpectrogramExporter::FileExtension(Format::Float32) == ".f32");
+    REQUIRE(SpectrogramExporter::FileExtension(Format::Float16) == ".f16");
+}
+
+TEST_CASE("SpectrogramExporter::BuildNpyHeader", "[spectrogram_exporter]")
+{
+    const std::string kHeader =
+      SpectrogramExporter::BuildNpyHeader(SpectrogramExporter::Format::Npy, 12345, 2, 1025);
+
+    REQUIRE(kHeader.size() == SpectrogramExporter::KNpyHeaderSize);
+    REQUIRE(kHeader.substr(0, 8) == std::string("\x93NUMPY\x01\x00", 8));
+    const size_t kDictSize = static_cast<uint8_t>(kHeader[8]) |
+                             (static_cast<size_t>(static_cast<uint8_t>(kHeader[9])) << 8U);
+    REQUIRE(kDictSize == kHeader.size() - 10);
+    REQUIRE(kHeader.find("'descr': '<f4'") != std::string::npos);
+    REQUIRE(kHeader.find("'fortran_order': False") != std::string::npos);
+    REQUIRE(kHeader.find("'shape': (12345, 2, 1025)") != std::string::npos);
+    REQUIRE(kHeader.back() == '\n');
+}
+
+TEST_CASE("SpectrogramExporter::FloatToHalf", "[spectrogram_exporter]")
+{
+    REQUIRE(SpectrogramExporter::FloatToHalf(0.0f) == 0x0000);
+    REQUIRE(SpectrogramExporter::FloatToHalf(-0.0f) == 0x8000);
+    REQUIRE(SpectrogramExporter::FloatToHalf(1.0f) == 0x3C00);
+    REQUIRE(SpectrogramExporter::FloatToHalf(-2.0f) == 0xC000);
+    REQUIRE(SpectrogramExporter::FloatToHalf(0.1f) == 0x2E66);
+    REQUIRE(SpectrogramExporter::FloatToHalf(-120.5f) == 0xD788);
+    REQUIRE(SpectrogramExporter::FloatToHalf(65504.0f) == 0x7BFF);
+    REQUIRE(SpectrogramExporter::FloatToHalf(65520.0f) == 0x7C00);
+    REQUIRE(SpectrogramExporter::FloatToHalf(5.9604645e-8f) == 0x0001);
+    REQUIRE(SpectrogramExporter::FloatToHalf(1e-9f) == 0x0000);
+    REQUIRE(SpectrogramExporter::FloatToHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+    REQUIRE(SpectrogramExporter::FloatToHalf(-std::numeric_limits<float>::infinity()) == 0xFC00);
+    const uint16_t kNaN =
+      SpectrogramExporter::FloatToHalf(std::numeric_limits<float>::quiet_NaN());
+    REQUIRE((kNaN & 0x7C00U) == 0x7C00U);
+    REQUIRE((kNaN & 0x03FFU) != 0);
+}
+
+TEST_CASE("SpectrogramExporter#Export", "[spectrogram_exporter]")
+{
+    using Format = SpectrogramExporter::Format;
+    Settings settings;
+    ConfigureSettings(settings);
+    const QTemporaryDir kTempDir;
+    REQUIRE(kTempDir.isValid());
+    const auto kFactory = MockFFTProcessor::GetFactory();
+
+    SECTION("Writes .npy data in (rows, channels, bins) order")
+    {
+        // 10 rows, exported in blocks of 3
+        MockAudioFileReader reader(
+          2, 44100, MakeInterleavedRamp(512 + (9 * KStride), 2, KChannelOffset));
+        const SpectrogramExporter kExporter(
+          settings, { .format = Format::Npy, .block_rows = 3, .thread_count = 2 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("out.npy").toStdString();
+
+        const auto kResult = kExporter.Export(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->row_count == 10);
+        REQUIRE(kResult->bin_count == KBinCount);
+        REQUIRE(kResult->channel_count == 2);
+        REQUIRE(kResult->data_path == kOutput);
+        REQUIRE(kResult->sidecar_path == kOutput + ".json");
+
+        const QByteArray kData = ReadFile(kOutput);
+        const size_t kHeaderSize = SpectrogramExporter::KNpyHeaderSize;
+        REQUIRE(static_cast<size_t>(kData.size()) ==
+                kHeaderSize + (10 * 2 * KBinCount * sizeof(float)));
+        REQUIRE(kData.mid(0, 6) == QByteArray("\x93NUMPY"));
+        REQUIRE(kData.mid(0, kHeaderSize).contains("'shape': (10, 2, 257)"));
+
+        for (const size_t kRow : { 0, 4, 9 }) {
+            for (const ChannelCount kChannel : { 0, 1 }) {
+                for (const size_t kBin : { 0, 1, 256 }) {
+                    CAPTURE(kRow, kChannel, kBin);
+                    const size_t kIndex = (((kRow * 2) + kChannel) * KBinCount) + kBin;
+                    const float kExpected =
+                      static_cast<float>((kRow * KStride) + kBin + (KChannelOffset * kChannel));
+                    CHECK(ReadFloat(kData, kHeaderSize + (kIndex * sizeof(float))) == kExpected);
+                }
+            }
+        }
+    }
+
+    SECTION("Writes a JSON sidecar")
+    {
+        MockAudioFileReader reader(1, 48000, MakeInterleavedRamp(2048, 1, KChannelOffset));
+        const SpectrogramExporter kExporter(settings, { .format = Format::Float16 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("out.f16").toStdString();
+
+        const auto kResult = kExporter.Export(reader, kOutput, FrameIndex{ 256 });
+        REQUIRE(kResult.has_value());
+
+        const QByteArray kJson = ReadFile(kResult->sidecar_path);
+        const QJsonObject kSidecar = QJsonDocument::fromJson(kJson).object();
+        CHECK(kSidecar["data_file"].toString() == "out.f16");
+        CHECK(kSidecar["format"].toString() == "f16");
+        CHECK(kSidecar["dtype"].toString() == "<f2");
+        CHECK(kSidecar["data_offset"].toInteger() == 0);
+        CHECK(kSidecar["shape"].toArray() == QJsonArray{ 6, 1, 257 });
+        CHECK(kSidecar["sample_rate"].toInt() == 48000);
+        CHECK(kSidecar["fft_size"].toInt() == 512);
+        CHECK(kSidecar["window"].toString() == "rectangular");
+        CHECK(kSidecar["window_scale"].toInt() == 2);
+        CHECK(kSidecar["stride"].toInt() == 256);
+        CHECK(kSidecar["first_frame"].toInteger() == 256);
+        CHECK(kSidecar["hz_per_bin"].toDouble() == 48000.0 / 512.0);
+        CHECK(kSidecar["unit"].toString() == "dB");
+    }
+
+    SECTION("Writes headerless half precision")
+    {
+        MockAudioFileReader reader(1, 44100, MakeInterleavedRamp(512 + KStride, 1, KChannelOffset));
+        const SpectrogramExporter kExporter(settings, { .format = Format::Float16 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("out.f16").toStdString();
+
+        REQUIRE(kExporter.Export(reader, kOutput).has_value());
+        const QByteArray kData = ReadFile(kOutput);
+        REQUIRE(static_cast<size_t>(kData.size()) == 2 * KBinCount * sizeof(uint16_t));
+        CHECK(ReadUInt16(kData, 0) == SpectrogramExporter::FloatToHalf(0.0f));
+        CHECK(ReadUInt16(kData, 1 * sizeof(uint16_t)) == SpectrogramExporter::FloatToHalf(1.0f));
+        CHECK(ReadUInt16(kData, KBinCount * sizeof(uint16_t)) ==
+              SpectrogramExporter::FloatToHalf(256.0f));
+    }
+
+    SECTION("Exports only the requested range")
+    {
+        MockAudioFileReader reader(1, 44100, MakeInterleavedRamp(8192, 1, KChannelOffset));
+        const SpectrogramExporter kExporter(settings, { .format = Format::Float32 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("out.f32").toStdString();
+
+        const auto kResult =
+          kExporter.Export(reader, kOutput, FrameIndex{ 1000 }, FrameCount{ 512 + KStride });
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->row_count == 2);
+
+        const QByteArray kData = ReadFile(kOutput);
+        REQUIRE(static_cast<size_t>(kData.size()) == 2 * KBinCount * sizeof(float));
+        CHECK(ReadFloat(kData, 0) == 1000.0f);
+        CHECK(ReadFloat(kData, KBinCount * sizeof(float)) == 1256.0f);
+    }
+
+    SECTION("Rewrites the .npy header when the reader comes up short")
+    {
+        // Reports 10 rows' worth of frames but only delivers 4
+        TruncatedAudioFileReader reader(MakeInterleavedRamp(512 + (3 * KStride), 1, KChannelOffset),
+                                        FrameCount{ 512 + (9 * KStride) });
+        const SpectrogramExporter kExporter(settings, { .block_rows = 3 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("short.npy").toStdString();
+
+        const auto kResult = kExporter.Export(reader, kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->row_count == 4);
+
+        const QByteArray kData = ReadFile(kOutput);
+        REQUIRE(static_cast<size_t>(kData.size()) ==
+                SpectrogramExporter::KNpyHeaderSize + (4 * KBinCount * sizeof(float)));
+        const QByteArray kHeader = kData.mid(0, SpectrogramExporter::KNpyHeaderSize);
+        REQUIRE(kHeader.contains("'shape': (4, 1, 257)"));
+    }
+
+    SECTION("Reports progress, and cancels")
+    {
+        // 10 rows in blocks of 3
+        MockAudioFileReader reader(
+          1, 44100, MakeInterleavedRamp(512 + (9 * KStride), 1, KChannelOffset));
+        const SpectrogramExporter kExporter(settings, { .block_rows = 3 }, kFactory);
+        const std::string kOutput = kTempDir.filePath("progress.npy").toStdString();
+
+        std::vector<size_t> progress;
+        const auto kResult = kExporter.Export(
+          reader, kOutput, FrameIndex{ 0 }, std::nullopt, [&](size_t aRowsDone, size_t aRowCount) {
+              REQUIRE(aRowCount == 10);
+              progress.push_back(aRowsDone);
+              return aRowsDone < 6;
+          });
+        REQUIRE_FALSE(kResult.has_value());
+        REQUIRE(progress == std::vector<size_t>{ 3, 6 });
+        REQUIRE_FALSE(QFile::exists(QString::fromStdString(kOutput)));
+    }
+
+    SECTION("Fails on ranges shorter than one window")
+    {
+        MockAudioFileReader reader(1, 44100, std::vector<float>(1000));
+        const SpectrogramExporter kExporter(settings, {});
+        const std::string kOutput = kTempDir.filePath("out.npy").toStdString();
+        REQUIRE_FALSE(kExporter.Export(reader, kOutput, FrameIndex{ 600 }).has_value());
+        REQUIRE_FALSE(QFile::exists(QString::fromStdString(kOutput)));
+    }
+
+    SECTION("Fails on unwritable output")
+    {
+        MockAudioFileReader reader(1, 44100, std::vector<float>(512));
+        const SpectrogramExporter kExporter(settings, {});
+        const std::string kOutput = kTempDir.filePath("missing/out.npy").toStdString();
+        REQUIRE_FALSE(kExporter.Export(reader, kOutput).has_value());
+    }
+}
+
+TEST_CASE("SpectrogramExporter#ExportFile", "[spectrogram_exporter]")
+{
+    const Settings kSettings;
+    const QTemporaryDir kTempDir;
+    const SpectrogramExporter kExporter(kSettings, {});
+
+    SECTION("Exports a real file")
+    {
+        const std::string kOutput = kTempDir.filePath("chirp.npy").toStdString();
+        const auto kResult = kExporter.ExportFile("testdata/chirp.wav", kOutput);
+        REQUIRE(kResult.has_value());
+        REQUIRE(kResult->row_count > 0);
+        REQUIRE(QFile::exists(QString::fromStdString(kResult->sidecar_path)));
+    }
+
+    SECTION("Reports errors opening the file")
+    {
+        REQUIRE_FALSE(kExporter.ExportFile("testdata/corrupt.wav", "out.npy").has_value());
+    }
+}
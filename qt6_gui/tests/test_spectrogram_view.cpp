@@ -11,14 +11,18 @@
 #include "views/spectrogram_view.h"
 #include <QAbstractScrollArea>
 #include <QAbstractSlider>
+#include <QCoreApplication>
+#include <QEvent>
 #include <QImage>
+#include <QMouseEvent>
 #include <QObject>
+#include <QPointF>
+#include <QRect>
 #include <QRgb>
 #include <QScrollBar>
 #include <QSignalSpy>
 #include <QWidget>
 #include <Qt>
-#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
@@ -40,6 +44,7 @@ class TestableSpectrogramView : public SpectrogramView
 
     // Expose private methods for testing
     using SpectrogramView::GenerateSpectrogramImage;
+    using SpectrogramView::GetCompositedFrameEnd;
     using SpectrogramView::GetRenderConfig;
 
     /// @brief Override the viewport updater for testing.
@@ -48,6 +53,17 @@ class TestableSpectrogramView : public SpectrogramView
     {
         mUpdateViewport = std::move(aUpdater);
     }
+
+    /// @brief Override the partial viewport updater for testing.
+    /// @param aUpdater Lambda to call for partial viewport updates.
+    void OverrideViewportRectUpdater(ViewportRectUpdater aUpdater)
+    {
+        mUpdateViewportRect = std::move(aUpdater);
+    }
+
+    /// @brief Override where the crosshair is drawn for testing.
+    /// @param aGetter Lambda returning the crosshair's x coordinate.
+    void OverrideCrosshairXGetter(CrosshairXGetter aGetter) { mGetCrosshairX = std::move(aGetter); }
 };
 
 namespace {
@@ -151,46 +167,59 @@ TEST_CASE("SpectrogramView::GenerateSpectrogramImage", "[spectrogram_view]")
 
         REQUIRE(kHave == kWant);
     }
-}
-
-TEST_CASE("Benchmark", "[spectrogram_view][!benchmark]")
-{
-    SpectrogramViewTestFixture fixture;
 
-    SECTION("GenerateSpectrogramImage performance")
+    SECTION("renders rows completed after the last render")
     {
-        // Simple performance benchmark to ensure image generation is efficient.
-        fixture.settings.SetFFTSettings(2048, FFTWindow::Type::Rectangular);
-        // No data is loaded in the audio buffer, so GetRows will return zeroed
-        // data.  Let's verify that assumption first.
-        SECTION("Verify zeroed data assumption")
-        {
-            const auto have = fixture.controller.GetRows(0, FramePosition{ 0 }, 10);
-            REQUIRE(have.size() == 10);
-            for (const auto& row : have) {
-                REQUIRE(row.size() == (fixture.settings.GetFFTSize() / 2) + 1);
-                for (const auto& value : row) {
-                    REQUIRE(value == 0.0f);
-                }
-            }
-        }
+        fixture.settings.SetApertureFloorDecibels(0);
+        fixture.settings.SetApertureCeilingDecibels(255);
+        fixture.audio_buffer.Reset(1, 44100);
+        fixture.settings.SetFFTSettings(8, FFTWindow::Type::Rectangular);
+        fixture.settings.SetWindowScale(1); // no overlap
+        fixture.settings.SetLiveMode(false);
+        fixture.view.UpdateScrollbarRange(FrameCount(32));
+        auto* scrollBar = fixture.view.findChild<QScrollBar*>("SpectrogramViewVerticalScrollBar");
+        REQUIRE(scrollBar != nullptr);
+        scrollBar->setValue(32); // Frame 0 at the top of the view
 
-        // Let's also see how fast GetRows is because it will affect the overall
-        // image generation time.
-        BENCHMARK("SpectrogramController::GetRows 1024 rows")
-        {
-            return fixture.controller.GetRows(0, FramePosition{ 0 }, 1024);
-        };
+        // One row, then a second completed by a later append
+        fixture.audio_buffer.AddSamples({ 1, 2, 3, 4, 5, 6, 7, 8 });
+        (void)fixture.view.GenerateSpectrogramImage(6, 4);
+        fixture.audio_buffer.AddSamples({ 9, 10, 11, 12, 13, 14, 15, 16 });
 
-        BENCHMARK("GenerateSpectrogramImage 800x600")
-        {
-            return fixture.view.GenerateSpectrogramImage(800, 600);
-        };
+        const std::string kHave = QImageToString(fixture.view.GenerateSpectrogramImage(6, 4));
+        const std::string kWant = "\n"
+                                  "010001 020002 030003 040004 050005 000000 \n"
+                                  "090009 0A000A 0B000B 0C000C 0D000D 000000 \n"
+                                  "000000 000000 000000 000000 000000 000000 \n"
+                                  "000000 000000 000000 000000 000000 000000 \n";
+        REQUIRE(kHave == kWant);
+    }
 
-        BENCHMARK("GenerateSpectrogramImage 1920x1080")
-        {
-            return fixture.view.GenerateSpectrogramImage(1920, 1080);
-        };
+    SECTION("scrolling reuses rows already rendered")
+    {
+        fixture.settings.SetApertureFloorDecibels(0);
+        fixture.settings.SetApertureCeilingDecibels(255);
+        fixture.audio_buffer.Reset(1, 44100);
+        fixture.audio_buffer.AddSamples({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+        fixture.settings.SetFFTSettings(8, FFTWindow::Type::Rectangular);
+        fixture.settings.SetWindowScale(1); // no overlap
+        fixture.settings.SetLiveMode(false);
+        fixture.view.UpdateScrollbarRange(FrameCount(32));
+        auto* scrollBar = fixture.view.findChild<QScrollBar*>("SpectrogramViewVerticalScrollBar");
+        REQUIRE(scrollBar != nullptr);
+
+        // Render with frame 0 one row down, then scroll it to the top
+        scrollBar->setValue(24);
+        (void)fixture.view.GenerateSpectrogramImage(6, 4);
+        scrollBar->setValue(32);
+
+        const std::string kHave = QImageToString(fixture.view.GenerateSpectrogramImage(6, 4));
+        const std::string kWant = "\n"
+                                  "010001 020002 030003 040004 050005 000000 \n"
+                                  "090009 0A000A 0B000B 0C000C 0D000D 000000 \n"
+                                  "000000 000000 000000 000000 000000 000000 \n"
+                                  "000000 000000 000000 000000 000000 000000 \n";
+        REQUIRE(kHave == kWant);
     }
 }
 
@@ -386,6 +415,118 @@ TEST_CASE("SpectrogramView::GetRenderConfig", "[spectrogram_view]")
     }
 }
 
+TEST_CASE("SpectrogramView::GetCompositedFrameEnd", "[spectrogram_view]")
+{
+    SpectrogramViewTestFixture fixture;
+    fixture.settings.SetFFTSettings(8, FFTWindow::Type::Hann);
+    fixture.settings.SetWindowScale(2); // stride = 4
+    constexpr size_t kHeight = 5;
+    fixture.audio_buffer.Reset(1, 44100);
+
+    SECTION("nothing is shown without a complete row")
+    {
+        fixture.view.UpdateScrollbarRange(FrameCount{ 0 });
+        CHECK(fixture.view.GetCompositedFrameEnd(kHeight) == FrameCount{ 0 });
+
+        fixture.audio_buffer.AddSamples(std::vector<float>(7, 0.0f));
+        fixture.view.UpdateScrollbarRange(FrameCount{ 7 });
+        CHECK(fixture.view.GetCompositedFrameEnd(kHeight) == FrameCount{ 0 });
+    }
+
+    SECTION("live view shows up to the newest complete row")
+    {
+        fixture.audio_buffer.AddSamples(std::vector<float>(30, 0.0f));
+        fixture.view.UpdateScrollbarRange(FrameCount{ 30 });
+
+        // The newest complete row starts at 20, the last stride below 30 - 8
+        CHECK(fixture.view.GetCompositedFrameEnd(kHeight) == FrameCount{ 28 });
+    }
+
+    SECTION("scrolled back, the bottom row is the newest shown")
+    {
+        fixture.audio_buffer.AddSamples(std::vector<float>(30, 0.0f));
+        fixture.view.UpdateScrollbarRange(FrameCount{ 30 });
+        fixture.settings.SetLiveMode(false);
+        auto* scrollBar = fixture.view.findChild<QScrollBar*>("SpectrogramViewVerticalScrollBar");
+        REQUIRE(scrollBar != nullptr);
+        scrollBar->setValue(20);
+
+        // The bottom row starts at 12
+        CHECK(fixture.view.GetCompositedFrameEnd(kHeight) == FrameCount{ 20 });
+    }
+}
+
+TEST_CASE("SpectrogramView scrubbing", "[spectrogram_view]")
+{
+    SpectrogramViewTestFixture fixture;
+    fixture.settings.SetFFTSettings(8, FFTWindow::Type::Hann);
+    fixture.settings.SetWindowScale(2); // stride = 4
+    fixture.audio_buffer.Reset(1, 44100);
+    fixture.audio_buffer.AddSamples(std::vector<float>(30, 0.0f));
+    fixture.view.viewport()->setFixedHeight(5);
+    fixture.view.UpdateScrollbarRange(FrameCount{ 30 });
+
+    QSignalSpy requested(&fixture.view, &SpectrogramView::ScrubRequested);
+    QSignalSpy finished(&fixture.view, &SpectrogramView::ScrubFinished);
+    const auto kSendMouse =
+      [&](QEvent::Type aType, int aY, Qt::MouseButton aButton, Qt::MouseButtons aButtons) {
+          const QPointF kPos(10, aY);
+          QMouseEvent event(aType,
+                            kPos,
+                            fixture.view.viewport()->mapToGlobal(kPos),
+                            aButton,
+                            aButtons,
+                            Qt::NoModifier);
+          QCoreApplication::sendEvent(fixture.view.viewport(), &event);
+      };
+
+    SECTION("dragging follows the row under the pointer")
+    {
+        // Live: the rows start at 4, 8, 12, 16 and 20
+        kSendMouse(QEvent::MouseButtonPress, 0, Qt::LeftButton, Qt::LeftButton);
+        REQUIRE(requested.count() == 1);
+        CHECK(requested.at(0).at(0).value<FrameIndex>() == FrameIndex{ 4 });
+
+        kSendMouse(QEvent::MouseMove, 4, Qt::NoButton, Qt::LeftButton);
+        REQUIRE(requested.count() == 2);
+        CHECK(requested.at(1).at(0).value<FrameIndex>() == FrameIndex{ 20 });
+
+        // Same row, no new request
+        kSendMouse(QEvent::MouseMove, 4, Qt::NoButton, Qt::LeftButton);
+        CHECK(requested.count() == 2);
+
+        kSendMouse(QEvent::MouseButtonRelease, 4, Qt::LeftButton, Qt::NoButton);
+        CHECK(finished.count() == 1);
+
+        // Released: moving no longer scrubs
+        kSendMouse(QEvent::MouseMove, 0, Qt::NoButton, Qt::NoButton);
+        CHECK(requested.count() == 2);
+    }
+
+    SECTION("rows outside the audio are clamped to it")
+    {
+        fixture.settings.SetLiveMode(false);
+        fixture.view.SetScrollPosition(FramePosition{ 0 });
+        kSendMouse(QEvent::MouseButtonPress, 0, Qt::LeftButton, Qt::LeftButton);
+        REQUIRE(requested.count() == 1);
+        CHECK(requested.at(0).at(0).value<FrameIndex>() == FrameIndex{ 0 });
+        kSendMouse(QEvent::MouseButtonRelease, 0, Qt::LeftButton, Qt::NoButton);
+
+        fixture.view.SetScrollPosition(FramePosition{ 1000 });
+        kSendMouse(QEvent::MouseButtonPress, 4, Qt::LeftButton, Qt::LeftButton);
+        REQUIRE(requested.count() == 2);
+        CHECK(requested.at(1).at(0).value<FrameIndex>() == FrameIndex{ 30 });
+    }
+
+    SECTION("other buttons don't scrub")
+    {
+        kSendMouse(QEvent::MouseButtonPress, 0, Qt::RightButton, Qt::RightButton);
+        kSendMouse(QEvent::MouseButtonRelease, 0, Qt::RightButton, Qt::NoButton);
+        CHECK(requested.isEmpty());
+        CHECK(finished.isEmpty());
+    }
+}
+
 TEST_CASE("SpectrogramView scrollbar integration", "[spectrogram_view]")
 {
     SpectrogramViewTestFixture fixture;
@@ -412,37 +553,52 @@ TEST_CASE("SpectrogramView scrollbar integration", "[spectrogram_view]")
         CHECK(scrollBar->value() == 0);
     }
 
-    SECTION("throws when pagestep would exceed int max")
+    SECTION("a page step beyond int max is scaled to fit")
     {
-        // Stride is 1024.
-        // Set viewport height to a large but valid value.
-        constexpr size_t kMaxAllowedHeight = (1 << 21) - 1;
-        fixture.view.viewport()->setFixedHeight(kMaxAllowedHeight);
+        // Stride is 1024, so this page step is 2**31 frames
+        fixture.view.viewport()->setFixedHeight(1 << 21);
+        REQUIRE_NOTHROW(fixture.view.UpdateScrollbarRange(FrameCount{ 1 }));
+        CHECK(scrollBar->maximum() <= SpectrogramView::KMaxScrollBarValue);
 
-        // This makes page step:
-        constexpr int kExpectedPageStep = (1LL << 31) - 1024;
+        // One frame of data: the page still covers it all
+        CHECK(scrollBar->maximum() - scrollBar->pageStep() <= 1);
+    }
 
-        REQUIRE_NOTHROW(fixture.view.UpdateScrollbarRange(FrameCount{ 1 }));
-        CHECK(scrollBar->pageStep() == kExpectedPageStep);
-
-        // Now increase height by 1 to cause overflow.
-        fixture.view.viewport()->setFixedHeight(kMaxAllowedHeight + 1);
-        REQUIRE_THROWS_MATCHES(
-          fixture.view.UpdateScrollbarRange(FrameCount{ 1 }),
-          std::overflow_error,
-          MessageMatches(Catch::Matchers::ContainsSubstring("scroll page step exceeds int max")));
+    SECTION("timelines beyond int max are scaled to fit the scrollbar")
+    {
+        // 72 hours at 48 kHz
+        constexpr int64_t kFrames = 72LL * 3600 * 48000;
+        fixture.settings.SetLiveMode(true);
+        REQUIRE_NOTHROW(fixture.view.UpdateScrollbarRange(FrameCount(kFrames)));
+        CHECK(fixture.view.GetScrollPosition() == FramePosition{ kFrames });
+        CHECK(scrollBar->maximum() <= SpectrogramView::KMaxScrollBarValue);
+        CHECK(scrollBar->value() >= scrollBar->maximum() - scrollBar->pageStep() - 1);
+
+        // Dragging to the end of the bar lands at the end of the timeline
+        scrollBar->setValue(scrollBar->maximum());
+        CHECK(fixture.view.GetScrollPosition().Get() > kFrames);
     }
 
-    SECTION("throws when overflowing scrollbar maximum")
+    SECTION("steps are exact beyond int max")
     {
-        const int64_t kMaxAllowed = (1LL << 31) - kPageStepFrames - 1;
-        REQUIRE_NOTHROW(fixture.view.UpdateScrollbarRange(FrameCount(kMaxAllowed)));
-
-        const int64_t kTooLarge = kMaxAllowed + 1;
-        REQUIRE_THROWS_MATCHES(
-          fixture.view.UpdateScrollbarRange(FrameCount(kTooLarge)),
-          std::overflow_error,
-          MessageMatches(Catch::Matchers::ContainsSubstring("Count(2147483648) exceeds int max")));
+        constexpr int64_t kFrames = 72LL * 3600 * 48000;
+        fixture.view.UpdateScrollbarRange(FrameCount(kFrames));
+        fixture.settings.SetLiveMode(false);
+        const FramePosition kStart{ (kFrames / 2) + 12345 };
+        fixture.view.SetScrollPosition(kStart);
+        REQUIRE(fixture.view.GetScrollPosition() == kStart);
+
+        scrollBar->triggerAction(QAbstractSlider::SliderSingleStepSub);
+        CHECK(fixture.view.GetScrollPosition() == kStart - FrameCount(10 * 1024));
+
+        scrollBar->triggerAction(QAbstractSlider::SliderPageStepAdd);
+        CHECK(fixture.view.GetScrollPosition() ==
+              kStart - FrameCount(10 * 1024) + FrameCount(kPageStepFrames));
+
+        // The rendered rows follow the exact position, not the scaled bar
+        const RenderConfig kConfig = fixture.view.GetRenderConfig(1);
+        CHECK(kConfig.top_frame.Get() % 1024 == 0);
+        CHECK(fixture.view.GetScrollPosition().Get() - kConfig.top_frame.Get() < 2048 + 1024);
     }
 
     SECTION("UpdateScrollbarRange updates scrollbar maximum")
@@ -497,58 +653,96 @@ TEST_CASE("SpectrogramView scrollbar integration", "[spectrogram_view]")
         REQUIRE(fixture.settings.IsLiveMode() == false);
     }
 
-    SECTION("UpdateScrollbarRange repaints view if current view includes new data")
+    SECTION("InvalidateRows repaints only the visible rows")
     {
         fixture.view.viewport()->setFixedHeight(256);
+        fixture.view.viewport()->setFixedWidth(300);
 
-        // Create a test spy to count viewport updates
-        size_t viewportUpdateCount = 0;
-        fixture.view.OverrideViewportUpdater(
-          [&viewportUpdateCount]() noexcept { viewportUpdateCount++; });
+        // Record the partial viewport updates
+        std::vector<QRect> rects;
+        fixture.view.OverrideViewportRectUpdater(
+          [&rects](const QRect& aRect) { rects.push_back(aRect); });
 
         // Height is 256, stride is 1024, so view shows 262144 frames.
         constexpr int kPageStepFrames = 1024 * 256;
-
-        // Set up initial data: almost one full page.
         fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames - 2048));
-
-        // Check our assumptions about PageStep
-        REQUIRE(scrollBar->pageStep() == kPageStepFrames);
-
-        // Clear live mode so we can test if updates happen in non-live mode.
-        // This has to happen after the first UpdateScrollbarRange call to set up
-        // the scrollbar.
         fixture.settings.SetLiveMode(false);
-        scrollBar->setValue(kPageStepFrames); // Frame 0 at top of view
-
-        CHECK(viewportUpdateCount == 0);
-
-        // Add new data that falls within current view
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames - 1024));
-        CHECK(viewportUpdateCount == 1); // update should have been called
-
-        // Add more data just shy of the edge of current view
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames - 1));
-        CHECK(viewportUpdateCount == 2); // another update should have been called
+        scrollBar->setValue(kPageStepFrames);
+        const FramePosition kTop = fixture.view.GetRenderConfig(256).top_frame;
+        const auto kRow = [kTop](size_t aY) { return kTop + FrameCount(1024 * aY); };
+
+        // Rows within the view
+        fixture.view.InvalidateRows(kRow(10), kRow(12));
+        REQUIRE(rects.size() == 1);
+        CHECK(rects.back() == QRect(0, 10, 300, 2));
+
+        // Straddling the bottom edge
+        fixture.view.InvalidateRows(kRow(255), kRow(257));
+        REQUIRE(rects.size() == 2);
+        CHECK(rects.back() == QRect(0, 255, 300, 1));
+
+        // Past the bottom edge, and an empty range
+        fixture.view.InvalidateRows(kRow(256), kRow(258));
+        fixture.view.InvalidateRows(kRow(20), kRow(20));
+        CHECK(rects.size() == 2);
+    }
 
-        // Add more data right at the edge of current view
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames));
-        CHECK(viewportUpdateCount == 3); // another update should have been called
+    SECTION("InvalidateRows repaints the crosshair where it was and where it is")
+    {
+        fixture.view.viewport()->setFixedHeight(256);
+        fixture.view.viewport()->setFixedWidth(300);
+        int crosshairX = 100;
+        fixture.view.OverrideCrosshairXGetter([&crosshairX] { return crosshairX; });
+        std::vector<QRect> rects;
+        fixture.view.OverrideViewportRectUpdater(
+          [&rects](const QRect& aRect) { rects.push_back(aRect); });
 
-        // Now add data that is outside current view
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames + 2048));
-        CHECK(viewportUpdateCount == 3); // no update should have been called
+        constexpr int kPageStepFrames = 1024 * 256;
+        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames - 2048));
+        fixture.settings.SetLiveMode(false);
+        scrollBar->setValue(kPageStepFrames);
+        const FramePosition kTop = fixture.view.GetRenderConfig(256).top_frame;
+        const auto kRow = [kTop](size_t aY) { return kTop + FrameCount(1024 * aY); };
+
+        // Paints the crosshair at 100
+        QImage image(fixture.view.size(), QImage::Format_ARGB32);
+        fixture.view.render(&image);
+
+        // Where it was painted, the repainted rows redraw it in full
+        fixture.view.InvalidateRows(kRow(10), kRow(12));
+        CHECK(rects == std::vector{ QRect(0, 10, 300, 2) });
+
+        // Moved, its old and new columns are repainted too
+        rects.clear();
+        crosshairX = 200;
+        fixture.view.InvalidateRows(kRow(10), kRow(12));
+        CHECK(rects ==
+              std::vector{ QRect(0, 10, 300, 2), QRect(99, 0, 3, 256), QRect(199, 0, 3, 256) });
+    }
 
-        // Go back, set the scrollbar back within the view
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames - 1024));
-        // no update because previous position was outside view.  The code
-        // doesn't expect backtracking so it's undefined whether it should
-        // actually repaint.  Currently it does not.
-        CHECK(viewportUpdateCount == 3);
+    SECTION("appended audio repaints the rows it completes")
+    {
+        fixture.view.viewport()->setFixedHeight(256);
+        std::vector<QRect> rects;
+        fixture.view.OverrideViewportRectUpdater(
+          [&rects](const QRect& aRect) { rects.push_back(aRect); });
 
-        // Now add data which will go past the end of the view.
-        fixture.view.UpdateScrollbarRange(FrameCount(kPageStepFrames + 4096));
-        CHECK(viewportUpdateCount == 4); // another update should have been called
+        fixture.audio_buffer.Reset(1, 44100);
+        fixture.settings.SetLiveMode(false);
+        fixture.view.UpdateScrollbarRange(FrameCount(0));
+        scrollBar->setValue(kPageStepFrames);
+        const FramePosition kTop = fixture.view.GetRenderConfig(256).top_frame;
+
+        // Not enough for a whole 2048-frame window
+        fixture.audio_buffer.AddSamples(std::vector<float>(2000, 0.0f));
+        CHECK(rects.empty());
+
+        // Completes the rows at 0 and 1024
+        fixture.audio_buffer.AddSamples(std::vector<float>(1100, 0.0f));
+        REQUIRE(rects.size() == 1);
+        const auto kFirstY = static_cast<int>(-kTop.Get() / 1024);
+        CHECK(rects.back().top() == kFirstY);
+        CHECK(rects.back().height() == 2);
     }
 
     SECTION("Scrollbar single step and page step are set correctly")
@@ -24,6 +24,7 @@
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_exception.hpp>
 #include <cstddef>
+#include <peak_tracker.h>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
@@ -44,6 +45,7 @@ class TestableSpectrumPlot : public SpectrumPlot
     // Expose private methods for testing
     using SpectrumPlot::CalculateDecibelScaleParameters;
     using SpectrumPlot::ComputeCrosshair;
+    using SpectrumPlot::ComputePeakMarkers;
     using SpectrumPlot::ComputePoints;
     using SpectrumPlot::GenerateDecibelScaleMarkers;
     using SpectrumPlot::GetDecibels;
@@ -163,6 +165,37 @@ TEST_CASE("SpectrumPlot::ComputePoints", "[spectrum_plot]")
     }
 }
 
+TEST_CASE("SpectrumPlot::ComputePeakMarkers", "[spectrum_plot]")
+{
+    SpectrumPlotTestFixture fixture;
+    fixture.settings.SetApertureFloorDecibels(-100.0f);
+    fixture.settings.SetApertureCeilingDecibels(100.0f);
+    const std::vector<PeakTracker::Track> kTracks = { { .bin = 2.5f, .decibels = 0.0f },
+                                                      { .bin = 7.0f, .decibels = 50.0f } };
+
+    SECTION("marks each track on the spectrum scale")
+    {
+        const QPolygonF have = fixture.plot.ComputePeakMarkers(kTracks, 10, 100);
+        REQUIRE(have.size() == 2);
+        CHECK(have[0] == QPointF(2.5f, 50.0f));
+        CHECK(have[1] == QPointF(7.0f, 25.0f));
+    }
+
+    SECTION("does not include tracks outside the given width")
+    {
+        const QPolygonF have = fixture.plot.ComputePeakMarkers(kTracks, 5, 100);
+        REQUIRE(have.size() == 1);
+        CHECK(have[0] == QPointF(2.5f, 50.0f));
+    }
+
+    SECTION("returns empty polygon if decibel range is zero")
+    {
+        fixture.settings.SetApertureFloorDecibels(-50.0f);
+        fixture.settings.SetApertureCeilingDecibels(-50.0f);
+        CHECK(fixture.plot.ComputePeakMarkers(kTracks, 10, 100).empty());
+    }
+}
+
 TEST_CASE("SpectrumPlot::ComputeDecibelScaleMarkers", "[spectrum_plot]")
 {
     SpectrumPlotTestFixture fixture;
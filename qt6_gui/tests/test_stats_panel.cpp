@@ -0,0 +1,103 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "views/stats_panel.h"
+#include <QLabel>
+#include <QPushButton>
+#include <catch2/catch_test_macros.hpp>
+#include <metrics.h>
+#include <string>
+
+TEST_CASE("StatsPanel constructor creates valid widget", "[stats_panel]")
+{
+    const StatsPanel kPanel;
+    REQUIRE(kPanel.objectName() == "StatsPanel");
+    REQUIRE(kPanel.GetSaveButton() != nullptr);
+    REQUIRE(kPanel.GetSaveButton()->objectName() == "StatsSaveButton");
+    for (const auto& [kRow, kName] : StatsPanel::RowNames) {
+        REQUIRE(kPanel.GetValueLabel(kRow) != nullptr);
+        REQUIRE(kPanel.GetValueLabel(kRow)->text() == "-");
+    }
+}
+
+TEST_CASE("StatsPanel shows rates from snapshot differences", "[stats_panel]")
+{
+    StatsPanel panel;
+
+    Metrics::Snapshot first;
+    first.counters[std::string(Metrics::KRowsComputed)] = 100;
+    first.counters[std::string(Metrics::KCacheHits)] = 10;
+    first.counters[std::string(Metrics::KCacheMisses)] = 10;
+    panel.Update(first, 0.0);
+
+    // No interval yet, so no rates
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::RowsPerSecond)->text() == "-");
+
+    Metrics::Snapshot second = first;
+    second.counters[std::string(Metrics::KRowsComputed)] = 300;
+    second.counters[std::string(Metrics::KCacheHits)] = 40;
+    second.counters[std::string(Metrics::KCacheMisses)] = 20;
+    second.counters[std::string(Metrics::KDroppedFrames)] = 7;
+    second.counters[std::string(Metrics::KCaptureOverruns)] = 3;
+    second.gauges[std::string(Metrics::KCacheRows)] = 250;
+    second.gauges[std::string(Metrics::KStreamQueueFrames)] = 512;
+    second.gauges[std::string(Metrics::KCaptureBufferFrames)] = 240;
+    panel.Update(second, 2.0);
+
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::RowsPerSecond)->text() == "100");
+    // 30 hits and 10 misses in the interval
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::CacheHitRate)->text() == "75.0%");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::CacheSize)->text() == "250 rows");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::StreamQueue)->text() == "512 frames");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::DroppedFrames)->text() == "7");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::CaptureBuffer)->text() == "240 frames");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::CaptureXruns)->text() == "3 over, 0 under");
+
+    // Nothing looked up in the next interval
+    panel.Update(second, 1.0);
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::RowsPerSecond)->text() == "0");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::CacheHitRate)->text() == "-");
+}
+
+TEST_CASE("StatsPanel shows histogram percentiles", "[stats_panel]")
+{
+    StatsPanel panel;
+
+    Metrics::Snapshot snapshot;
+    snapshot.histograms[std::string(Metrics::KFFTTime)] = {
+        .count = 10, .mean = 1500.0, .p50 = 1500, .p90 = 2000, .p99 = 2500000, .max = 3000000
+    };
+    panel.Update(snapshot, 0.0);
+
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::FFTTime)->text() == "1.5 µs (p99 2.50 ms)");
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::PaintTime)->text() == "-");
+}
+
+TEST_CASE("StatsPanel shows memory against the budget", "[stats_panel]")
+{
+    StatsPanel panel;
+
+    Metrics::Snapshot snapshot;
+    snapshot.gauges[std::string(Metrics::KMemoryTotal)] = 3 * 1024 * 1024;
+    panel.Update(snapshot, 0.0);
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::Memory)->text() == "3.00 MiB (no limit)");
+
+    snapshot.gauges[std::string(Metrics::KMemoryLimit)] = 4LL * 1024 * 1024 * 1024;
+    panel.Update(snapshot, 1.0);
+    REQUIRE(panel.GetValueLabel(StatsPanel::Row::Memory)->text() == "3.00 MiB of 4.00 GiB");
+}
+
+TEST_CASE("StatsPanel formats byte counts", "[stats_panel]")
+{
+    REQUIRE(StatsPanel::FormatBytes(512) == "512 B");
+    REQUIRE(StatsPanel::FormatBytes(12595) == "12.3 KiB");
+    REQUIRE(StatsPanel::FormatBytes(4781506) == "4.56 MiB");
+}
+
+TEST_CASE("StatsPanel formats durations", "[stats_panel]")
+{
+    REQUIRE(StatsPanel::FormatDuration(850) == "850 ns");
+    REQUIRE(StatsPanel::FormatDuration(12345) == "12.3 µs");
+    REQUIRE(StatsPanel::FormatDuration(4560000) == "4.56 ms");
+}
@@ -0,0 +1,102 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "models/audio_buffer.h"
+#include "views/waveform_view.h"
+#include <QColor>
+#include <QImage>
+#include <audio_types.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <waveform_pyramid.h>
+
+namespace {
+
+/// @brief Testable subclass of WaveformView that exposes protected members for testing
+class TestableWaveformView : public WaveformView
+{
+  public:
+    using WaveformView::WaveformView;
+    using WaveformView::ComputeColumns;
+};
+
+} // namespace
+
+TEST_CASE("WaveformView columns", "[waveform_view]")
+{
+    // Left is a square wave that jumps from 0.25 to 0.75 halfway through;
+    // right is silent
+    constexpr size_t kFrames = 48000;
+    AudioBuffer buffer;
+    buffer.Reset(2, 48000);
+    std::vector<float> interleaved(kFrames * 2, 0.0f);
+    for (size_t frame = 0; frame < kFrames; frame++) {
+        const float kLevel = frame < kFrames / 2 ? 0.25f : 0.75f;
+        interleaved[frame * 2] = frame % 2 == 0 ? kLevel : -kLevel;
+    }
+    buffer.AddSamples(interleaved);
+    const TestableWaveformView kView(buffer);
+
+    SECTION("Columns follow the level")
+    {
+        const std::vector<WaveformPyramid::Entry> kColumns =
+          kView.ComputeColumns(0, FrameCount(kFrames), 100);
+        REQUIRE(kColumns.size() == 100);
+        REQUIRE(kColumns.front().max == 0.25f);
+        REQUIRE(kColumns.front().min == -0.25f);
+        REQUIRE(kColumns.front().mean_square == 0.0625f);
+        REQUIRE(kColumns.back().max == 0.75f);
+        REQUIRE(kColumns.back().min == -0.75f);
+
+        const std::vector<WaveformPyramid::Entry> kSilent =
+          kView.ComputeColumns(1, FrameCount(kFrames), 100);
+        REQUIRE(kSilent.back().max == 0.0f);
+        REQUIRE(kSilent.back().mean_square == 0.0f);
+    }
+
+    SECTION("More columns than frames repeat frames")
+    {
+        const std::vector<WaveformPyramid::Entry> kColumns =
+          kView.ComputeColumns(0, FrameCount(4), 8);
+        REQUIRE(kColumns.size() == 8);
+        REQUIRE(kColumns[0].max == 0.25f);
+        REQUIRE(kColumns[1].max == 0.25f);
+        REQUIRE(kColumns[2].max == -0.25f);
+    }
+
+    SECTION("Nothing to draw")
+    {
+        REQUIRE(kView.ComputeColumns(0, FrameCount(0), 100).empty());
+        REQUIRE(kView.ComputeColumns(0, FrameCount(kFrames), 0).empty());
+    }
+
+    SECTION("Invalid channel throws")
+    {
+        REQUIRE_THROWS_AS(kView.ComputeColumns(2, FrameCount(kFrames), 100), std::out_of_range);
+    }
+}
+
+TEST_CASE("WaveformView paints lanes", "[waveform_view]")
+{
+    AudioBuffer buffer;
+    buffer.Reset(1, 48000);
+    std::vector<float> samples(48000, 0.5f);
+    for (size_t i = 1; i < samples.size(); i += 2) {
+        samples[i] = -0.5f;
+    }
+    buffer.AddSamples(samples);
+
+    WaveformView view(buffer);
+    view.resize(200, 100);
+    QImage image(view.size(), QImage::Format_RGB32);
+    view.render(&image);
+
+    // Half scale fills the middle half of the lane
+    REQUIRE(image.pixelColor(100, 30) != QColor(Qt::black));
+    REQUIRE(image.pixelColor(100, 70) != QColor(Qt::black));
+    REQUIRE(image.pixelColor(100, 10) == QColor(Qt::black));
+    REQUIRE(image.pixelColor(100, 90) == QColor(Qt::black));
+}
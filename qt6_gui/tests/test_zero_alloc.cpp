@@ -0,0 +1,103 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "alloc_counter.h"
+#include "audio_types.h"
+#include "controllers/audio_recorder.h"
+#include "impulse_train_device.h"
+#include "models/audio_buffer.h"
+#include "tests/spectrogram_controller_test_fixture.h"
+#include "views/spectrogram_view.h"
+#include <QImage>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Exposes GenerateSpectrogramImage for testing
+class TestableSpectrogramView : public SpectrogramView
+{
+  public:
+    using SpectrogramView::GenerateSpectrogramImage;
+    using SpectrogramView::InvalidateImage;
+    using SpectrogramView::SpectrogramView;
+};
+
+TEST_CASE("Steady-state capture ingest does not allocate", "[zero_alloc]")
+{
+    constexpr size_t kBlockFrames = 512;
+    constexpr size_t kBlocks = 16;
+
+    AudioBuffer buffer;
+    AudioRecorder recorder(buffer);
+    ImpulseTrainAudioDevice device;
+    ImpulseTrainIODevice input(2);
+    REQUIRE(recorder.Start(device, 2, 48000, &input));
+    buffer.Reserve(FrameCount{ kBlockFrames * (kBlocks + 1) });
+
+    // Warm up: sizes the read and deinterleave buffers, and looks up metrics
+    input.PushBlock(FrameCount{ kBlockFrames });
+
+    const AllocCounter kCounter;
+    for (size_t i = 0; i < kBlocks; i++) {
+        input.PushBlock(FrameCount{ kBlockFrames });
+    }
+    const size_t kAllocations = kCounter.GetCount();
+
+    REQUIRE(kAllocations == 0);
+    REQUIRE(buffer.GetFrameCount() == FrameCount{ kBlockFrames * (kBlocks + 1) });
+}
+
+TEST_CASE("Steady-state spectrogram image generation does not allocate", "[zero_alloc]")
+{
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.AddSamples(std::vector<float>(2 * 48000, 0.5f));
+    TestableSpectrogramView view(fixture.controller);
+
+    // Warm up: computes and caches the visible rows, and sizes the image
+    (void)view.GenerateSpectrogramImage(256, 64);
+
+    // Render every row again, not just the changed ones
+    view.InvalidateImage();
+    const AllocCounter kCounter;
+    (void)view.GenerateSpectrogramImage(256, 64);
+    const size_t kAllocations = kCounter.GetCount();
+    REQUIRE(kAllocations == 0);
+
+    SECTION("A copy held by the caller is not overwritten")
+    {
+        const QImage kCopy = view.GenerateSpectrogramImage(256, 64);
+        fixture.settings.SetApertureFloorDecibels(10.0f);
+        fixture.settings.SetApertureCeilingDecibels(10.0f); // Zero range: all black
+        const QImage& kBlack = view.GenerateSpectrogramImage(256, 64);
+        REQUIRE(kCopy != kBlack);
+    }
+}
+
+TEST_CASE("Computing rows for several channels allocates only their cache entries",
+          "[zero_alloc]")
+{
+    // Different channels, so neither is served from the other's rows
+    SpectrogramControllerTestFixture fixture;
+    fixture.audio_buffer.Reset(2, 48000);
+    std::vector<float> samples(2 * 48000);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = i % 2 == 0 ? 0.5f : -0.25f;
+    }
+    fixture.audio_buffer.AddSamples(samples);
+    TestableSpectrogramView view(fixture.controller);
+
+    // Warm up, then evict every row so the next render computes them all
+    // again, one channel on the engine's worker
+    (void)view.GenerateSpectrogramImage(256, 64);
+    (void)fixture.controller.GetRowCache().ReleaseMemory(SIZE_MAX);
+    view.InvalidateImage();
+
+    // A map node and a row of bins per row and channel, at most 64 rows
+    const AllocCounter kCounter;
+    (void)view.GenerateSpectrogramImage(256, 64);
+    const size_t kAllocations = kCounter.GetCount();
+    REQUIRE(kAllocations > 0);
+    REQUIRE(kAllocations <= 2 * 2 * 64);
+}
@@ -0,0 +1,27 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtGlobal>
+#include <functional>
+
+/// @brief Process events until a condition holds or two seconds pass
+/// @param aCondition Condition, polled on the calling thread
+/// @return Whether the condition holds
+inline bool
+WaitFor(const std::function<bool()>& aCondition)
+{
+    constexpr qint64 kTimeoutMs = 2000;
+    QElapsedTimer timer;
+    timer.start();
+    while (!aCondition() && timer.elapsed() < kTimeoutMs) {
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+    }
+    return aCondition();
+}
@@ -10,6 +10,7 @@
 #include "models/colormap.h"
 #include "models/settings.h"
 #include <QAudioDevice>
+#include <QCheckBox>
 #include <QComboBox>
 #include <QCoreApplication>
 #include <QFileDialog>
@@ -22,6 +23,7 @@
 #include <QMessageBox>
 #include <QObject>
 #include <QProgressDialog>
+#include <QSignalBlocker>
 #include <QSize>
 #include <QSlider>
 #include <QVBoxLayout>
@@ -266,9 +268,11 @@ SettingsPanel::CreateFFTControlsGroup()
     floorLayout->addWidget(mApertureFloorLabel);
     formLayout->addRow("Aperture Floor:", floorLayout);
 
+    // Moving either slider takes the aperture back from the automatic one
     connect(mApertureFloorSlider, &QSlider::valueChanged, this, [this](int aValue) {
         mApertureFloorLabel->setText(QString::number(aValue));
         mSettings.SetApertureFloorDecibels(static_cast<float>(aValue));
+        mSettings.SetAutoAperture(false);
     });
 
     // Aperture ceiling slider
@@ -289,8 +293,20 @@ SettingsPanel::CreateFFTControlsGroup()
     connect(mApertureCeilingSlider, &QSlider::valueChanged, this, [this](int aValue) {
         mApertureCeilingLabel->setText(QString::number(aValue));
         mSettings.SetApertureCeilingDecibels(static_cast<float>(aValue));
+        mSettings.SetAutoAperture(false);
     });
 
+    // Automatic aperture
+    mAutoApertureCheckBox = new QCheckBox("Follow levels", group);
+    mAutoApertureCheckBox->setObjectName("AutoApertureCheckBox");
+    mAutoApertureCheckBox->setChecked(mSettings.IsAutoAperture());
+    formLayout->addRow("Auto Aperture:", mAutoApertureCheckBox);
+
+    connect(mAutoApertureCheckBox, &QCheckBox::toggled, this, [this](bool aChecked) {
+        mSettings.SetAutoAperture(aChecked);
+    });
+    connect(&mSettings, &Settings::DisplaySettingsChanged, this, &SettingsPanel::SyncAperture);
+
     return group;
 }
 
@@ -335,6 +351,23 @@ SettingsPanel::CreateDisplayControlsGroup()
     return group;
 }
 
+void
+SettingsPanel::SyncAperture()
+{
+    // Only show the values, without setting them again
+    const QSignalBlocker kFloorBlocker(mApertureFloorSlider);
+    const QSignalBlocker kCeilingBlocker(mApertureCeilingSlider);
+    const QSignalBlocker kAutoBlocker(mAutoApertureCheckBox);
+
+    const auto kFloor = static_cast<int>(mSettings.GetApertureFloorDecibels());
+    const auto kCeiling = static_cast<int>(mSettings.GetApertureCeilingDecibels());
+    mApertureFloorSlider->setValue(kFloor);
+    mApertureFloorLabel->setText(QString::number(kFloor));
+    mApertureCeilingSlider->setValue(kCeiling);
+    mApertureCeilingLabel->setText(QString::number(kCeiling));
+    mAutoApertureCheckBox->setChecked(mSettings.IsAutoAperture());
+}
+
 void
 SettingsPanel::PopulateAudioDevices()
 {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "include/global_constants.h"
+#include <QCheckBox>
 #include <QComboBox>
 #include <QGroupBox>
 #include <QPushButton>
@@ -58,6 +59,7 @@ class SettingsPanel : public QWidget
     [[nodiscard]] QLabel* GetWindowScaleLabel() const { return mWindowScaleLabel; }
     [[nodiscard]] QLabel* GetApertureFloorLabel() const { return mApertureFloorLabel; }
     [[nodiscard]] QLabel* GetApertureCeilingLabel() const { return mApertureCeilingLabel; }
+    [[nodiscard]] QCheckBox* GetAutoApertureCheckBox() const { return mAutoApertureCheckBox; }
     [[nodiscard]] QPushButton* GetLiveModeButton() const { return mLiveModeButton; }
     [[nodiscard]] QComboBox* GetColorMapComboBox(ChannelCount aChannel) const;
 
@@ -74,6 +76,10 @@ class SettingsPanel : public QWidget
     /// @return Pointer to the created group box
     QGroupBox* CreateAudioControlsGroup();
 
+    /// @brief Show the aperture Settings holds, which SettingsController may
+    /// have set automatically
+    void SyncAperture();
+
     /// @brief Create the playback controls group box
     /// @return Pointer to the created group box
     QGroupBox* CreatePlaybackControlsGroup();
@@ -135,6 +141,7 @@ class SettingsPanel : public QWidget
     QLabel* mApertureFloorLabel = nullptr;
     QSlider* mApertureCeilingSlider = nullptr;
     QLabel* mApertureCeilingLabel = nullptr;
+    QCheckBox* mAutoApertureCheckBox = nullptr;
 
     // Color map controls
     QGroupBox* mColorMapControlsGroup = nullptr;
@@ -8,14 +8,19 @@
 #include "models/colormap.h"
 #include "models/settings.h"
 #include <QAbstractScrollArea>
+#include <QAbstractSlider>
+#include <QApplication>
 #include <QCursor>
 #include <QEvent>
 #include <QHBoxLayout>
 #include <QImage>
+#include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QRect>
 #include <QRgb>
 #include <QScrollBar>
+#include <QWheelEvent>
 #include <QWidget>
 #include <Qt>
 #include <algorithm>
@@ -23,15 +28,24 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <format>
+#include <latency_probe.h>
 #include <limits>
+#include <memory_budget.h>
+#include <metrics.h>
+#include <optional>
 #include <stdexcept>
+#include <trace.h>
+#include <utility>
 #include <vector>
 
 SpectrogramView::SpectrogramView(const SpectrogramController& aController, QWidget* parent)
   : QAbstractScrollArea(parent)
   , mController(aController)
   , mUpdateViewport([this]() { viewport()->update(); })
+  , mUpdateViewportRect([this](const QRect& aRect) { viewport()->update(aRect); })
+  , mGetCrosshairX([this]() { return mapFromGlobal(QCursor::pos()).x(); })
 {
     constexpr int kMinWidth = 400;
     constexpr int kMinHeight = 300;
@@ -46,6 +60,32 @@ SpectrogramView::SpectrogramView(const SpectrogramController& aController, QWidg
     // Repaint when scrollbar value changes, either due to user interaction or
     // when UpdateScrollbarRange is called.
     connect(verticalScrollBar(), &QScrollBar::valueChanged, this, qOverload<>(&QWidget::update));
+
+    // The scrollbar proxies mScrollPosition: steps are applied to the exact
+    // position, and anything else that moves the bar (dragging, setValue())
+    // moves the position to match
+    connect(verticalScrollBar(),
+            &QScrollBar::actionTriggered,
+            this,
+            &SpectrogramView::OnScrollBarAction);
+    connect(verticalScrollBar(),
+            &QScrollBar::valueChanged,
+            this,
+            &SpectrogramView::OnScrollBarValueChanged);
+
+    // New rows repaint just themselves.  A reset or a display change can alter
+    // any row, so the whole image is rendered again.
+    connect(&mController,
+            &SpectrogramController::RowsCompleted,
+            this,
+            &SpectrogramView::InvalidateRows);
+    connect(&mController, &SpectrogramController::RowsInvalidated, this, [this] {
+        InvalidateImage();
+        mUpdateViewport();
+    });
+    connect(&mController.GetSettings(), &Settings::DisplaySettingsChanged, this, [this] {
+        InvalidateImage();
+    });
 }
 
 void
@@ -53,63 +93,290 @@ SpectrogramView::UpdateScrollbarRange(FrameCount aAvailableFrames)
 {
     const FFTSize kStride = mController.GetSettings().GetWindowStride();
     const bool kIsLiveMode = mController.GetSettings().IsLiveMode();
+    const auto kHeight = static_cast<size_t>(std::max(viewport()->height(), 0));
+
+    mScrollSingleStep = FrameCount(kStride.Get() * 10); // 10 rows per step
+    mScrollPageStep = FrameCount(kStride.Get() * kHeight);
+
+    // The maximum is one page past the available frames, to allow scrolling
+    // the end of data all the way to the top of the view.
+    mScrollMaximum = aAvailableFrames + mScrollPageStep;
+
+    // If we are in live mode, put the end of the data at the bottom of the view.
+    // Otherwise, preserve the current scroll position (user is viewing history).
+    if (kIsLiveMode) {
+        SetScrollPosition(aAvailableFrames.AsPosition());
+    } else {
+        SetScrollPosition(mScrollPosition);
+    }
+}
+
+void
+SpectrogramView::SetScrollPosition(FramePosition aPosition)
+{
+    const FramePosition kPosition =
+      std::clamp(aPosition, FramePosition{ 0 }, mScrollMaximum.AsPosition());
+    const bool kMoved = kPosition != mScrollPosition;
+    mScrollPosition = kPosition;
+    SyncScrollBar();
 
-    // Safety check for overflow.  This would only happen with an absurdly large
-    // view height, but let's be safe.
-    if (viewport()->height() > std::numeric_limits<int>::max() / kStride.AsInt()) {
-        throw std::overflow_error("scroll page step exceeds int max");
+    // A move smaller than one scaled scrollbar step doesn't change its value
+    if (kMoved && mScrollBarScale > 1) {
+        mUpdateViewport();
     }
+}
 
-    const FrameCount kScrollSingleStep(kStride.Get() * 10); // 10 rows per step
-    const FrameCount kScrollPageStep(kStride.Get() * viewport()->height());
+void
+SpectrogramView::SyncScrollBar()
+{
+    // Frames per scrollbar step: the smallest that fits the range in the bar
+    const auto kMaximum = static_cast<int64_t>(mScrollMaximum.Get());
+    mScrollBarScale =
+      std::max<int64_t>(1, (kMaximum + KMaxScrollBarValue - 1) / KMaxScrollBarValue);
+    const auto kToBar = [this](int64_t aFrames) {
+        return static_cast<int>(aFrames / mScrollBarScale);
+    };
 
-    // The scrollbar's maximum is one page past the available frames, to allow
-    // scrolling the end of data all the way to the top of the view.
-    const FrameCount kScrollMaximum = aAvailableFrames + kScrollPageStep;
+    QScrollBar* const kScrollBar = verticalScrollBar();
+    mSyncingScrollBar = true;
+    kScrollBar->setMaximum(kToBar(kMaximum));
+    kScrollBar->setSingleStep(std::max(1, kToBar(mScrollSingleStep.AsPtrDiffT())));
+    kScrollBar->setPageStep(std::max(1, kToBar(mScrollPageStep.AsPtrDiffT())));
+    mSyncingScrollBar = false;
+    kScrollBar->setValue(kToBar(mScrollPosition.Get()));
+}
 
-    // Update scrollbar range
-    verticalScrollBar()->setMaximum(kScrollMaximum.ToIntChecked());
-    verticalScrollBar()->setSingleStep(kScrollSingleStep.ToIntChecked());
-    verticalScrollBar()->setPageStep(kScrollPageStep.ToIntChecked());
+void
+SpectrogramView::OnScrollBarAction(int aAction)
+{
+    // Qt has already moved the slider by its scaled step.  Apply the exact
+    // step to the position instead; SetScrollPosition() puts the slider where
+    // that lands.
+    FramePosition target = mScrollPosition;
+    switch (static_cast<QAbstractSlider::SliderAction>(aAction)) {
+        case QAbstractSlider::SliderSingleStepAdd:
+            target = mScrollPosition + mScrollSingleStep;
+            break;
+        case QAbstractSlider::SliderSingleStepSub:
+            target = mScrollPosition - mScrollSingleStep;
+            break;
+        case QAbstractSlider::SliderPageStepAdd:
+            target = mScrollPosition + mScrollPageStep;
+            break;
+        case QAbstractSlider::SliderPageStepSub:
+            target = mScrollPosition - mScrollPageStep;
+            break;
+        case QAbstractSlider::SliderToMinimum:
+            target = FramePosition{ 0 };
+            break;
+        case QAbstractSlider::SliderToMaximum:
+            target = mScrollMaximum.AsPosition();
+            break;
+        default:
+            return; // Dragging: OnScrollBarValueChanged() follows the slider
+    }
+    SetScrollPosition(target);
+}
 
-    // If we are in live mode, put the end of the data at the bottom of the view.
-    if (kIsLiveMode) {
-        verticalScrollBar()->setValue(aAvailableFrames.ToIntChecked());
+void
+SpectrogramView::OnScrollBarValueChanged(int aValue)
+{
+    // Ignore values that already proxy the position, so exact positions
+    // between scaled steps survive
+    if (mSyncingScrollBar || aValue == mScrollPosition.Get() / mScrollBarScale) {
+        return;
+    }
+    mScrollPosition = std::clamp(FramePosition{ aValue * mScrollBarScale },
+                                 FramePosition{ 0 },
+                                 mScrollMaximum.AsPosition());
+}
+
+void
+SpectrogramView::wheelEvent(QWheelEvent* aEvent)
+{
+    // Like QAbstractSlider, wheelScrollLines() single steps per notch, at most a
+    // page, but in exact frames
+    mWheelRemainder += aEvent->angleDelta().y();
+    const int kNotches = mWheelRemainder / QWheelEvent::DefaultDeltasPerStep;
+    mWheelRemainder -= kNotches * QWheelEvent::DefaultDeltasPerStep;
+    aEvent->accept();
+    if (kNotches == 0) {
+        return;
+    }
+
+    const std::ptrdiff_t kPage = mScrollPageStep.AsPtrDiffT();
+    const std::ptrdiff_t kFrames =
+      std::clamp<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(kNotches) *
+                                   QApplication::wheelScrollLines() *
+                                   mScrollSingleStep.AsPtrDiffT(),
+                                 -kPage,
+                                 kPage);
+
+    // Wheel up shows earlier audio.  Reported as a slider move, so listeners
+    // such as the live mode switch see it like any other scroll.
+    SetScrollPosition(FramePosition{ mScrollPosition.Get() - kFrames });
+    verticalScrollBar()->triggerAction(QAbstractSlider::SliderMove);
+}
+
+void
+SpectrogramView::mousePressEvent(QMouseEvent* aEvent)
+{
+    if (aEvent->button() != Qt::LeftButton) {
+        QAbstractScrollArea::mousePressEvent(aEvent);
+        return;
+    }
+    aEvent->accept();
+    mScrubFrame = GetFrameAt(static_cast<int>(aEvent->position().y()));
+    emit ScrubRequested(*mScrubFrame);
+}
+
+void
+SpectrogramView::mouseMoveEvent(QMouseEvent* aEvent)
+{
+    if (!mScrubFrame) {
+        QAbstractScrollArea::mouseMoveEvent(aEvent);
+        return;
+    }
+    aEvent->accept();
+    const FrameIndex kFrame = GetFrameAt(static_cast<int>(aEvent->position().y()));
+    if (kFrame != *mScrubFrame) {
+        mScrubFrame = kFrame;
+        emit ScrubRequested(kFrame);
+    }
+}
+
+void
+SpectrogramView::mouseReleaseEvent(QMouseEvent* aEvent)
+{
+    if (aEvent->button() != Qt::LeftButton || !mScrubFrame) {
+        QAbstractScrollArea::mouseReleaseEvent(aEvent);
+        return;
+    }
+    aEvent->accept();
+    mScrubFrame.reset();
+    emit ScrubFinished();
+}
+
+FrameIndex
+SpectrogramView::GetFrameAt(int aY) const
+{
+    const int kHeight = std::max(viewport()->height(), 1);
+    const RenderConfig kConfig = GetRenderConfig(static_cast<size_t>(kHeight));
+    const auto kY = static_cast<size_t>(std::clamp(aY, 0, kHeight - 1));
+    const FramePosition kRow = kConfig.top_frame + FrameCount{ kConfig.stride * kY };
+    const FramePosition kClamped = std::clamp(
+      kRow, FramePosition{ 0 }, mController.GetAvailableFrameCount().AsPosition());
+    return FrameIndex{ static_cast<size_t>(kClamped.Get()) };
+}
+
+void
+SpectrogramView::InvalidateRows(FramePosition aFirstRow, FramePosition aEndRow)
+{
+    if (aEndRow <= aFirstRow) {
+        return;
+    }
+
+    // Kept unclipped: the view may scroll before the next paint.  Appends
+    // arrive in order, so the union stays tight.
+    if (mDirtyEndRow <= mDirtyFirstRow) {
+        mDirtyFirstRow = aFirstRow;
+        mDirtyEndRow = aEndRow;
     } else {
-        // Otherwise, preserve the current scroll position (user is viewing
-        // history).  However, we may have new data which needs to be displayed.
-        const FramePosition kCurrentBottomFrame{ verticalScrollBar()->value() };
-        const FramePosition kCurrentTopFrame =
-          kCurrentBottomFrame - FrameCount{ kStride.Get() * viewport()->height() };
-
-        // Check if the mPreviousAvailableFrames is inside the current view, and if
-        // so, trigger a repaint - we added data that should be visible.
-        if (mPreviousAvailableFrames.AsPosition() >= kCurrentTopFrame &&
-            mPreviousAvailableFrames.AsPosition() < kCurrentBottomFrame) {
-            // Trigger a repaint to reflect any new data
-            mUpdateViewport();
-        }
+        mDirtyFirstRow = std::min(mDirtyFirstRow, aFirstRow);
+        mDirtyEndRow = std::max(mDirtyEndRow, aEndRow);
+    }
+
+    // Repaint the visible part, if any
+    const int kHeight = viewport()->height();
+    if (kHeight <= 0) {
+        return;
+    }
+    const RenderConfig kConfig = GetRenderConfig(kHeight);
+    const auto kStride = static_cast<std::ptrdiff_t>(kConfig.stride.Get());
+    const auto kRowY = [&](FramePosition aRow) {
+        // Rounded up, so a row starting mid-pixel counts from the next one
+        const std::ptrdiff_t kOffset = aRow.Get() - kConfig.top_frame.Get();
+        const std::ptrdiff_t kY =
+          kOffset >= 0 ? (kOffset + kStride - 1) / kStride : -(-kOffset / kStride);
+        return static_cast<int>(std::clamp<std::ptrdiff_t>(kY, 0, kHeight));
+    };
+    const int kFirstY = kRowY(aFirstRow);
+    const int kEndY = kRowY(aEndRow);
+    if (kFirstY < kEndY) {
+        mUpdateViewportRect(QRect(0, kFirstY, viewport()->width(), kEndY - kFirstY));
+        UpdateCrosshair();
+    }
+}
+
+void
+SpectrogramView::UpdateCrosshair()
+{
+    const int kX = mGetCrosshairX();
+    if (!mPaintedCrosshairX || *mPaintedCrosshairX == kX) {
+        return;
     }
 
-    mPreviousAvailableFrames = aAvailableFrames;
+    // The line is under a pixel wide, but antialiasing can touch the columns
+    // either side
+    const int kHeight = viewport()->height();
+    for (const int kColumn : { *mPaintedCrosshairX, kX }) {
+        mUpdateViewportRect(QRect(kColumn - 1, 0, 3, kHeight));
+    }
+}
+
+void
+SpectrogramView::InvalidateImage()
+{
+    mImageConfig.reset();
+    mDirtyFirstRow = FramePosition{ 0 };
+    mDirtyEndRow = FramePosition{ 0 };
 }
 
 void
 SpectrogramView::paintEvent(QPaintEvent* /*event*/)
 {
-    QImage image = GenerateSpectrogramImage(viewport()->width(), viewport()->height());
+    static Metrics::Histogram& paintTime = Metrics::GetHistogram(Metrics::KPaintTime);
+    static Metrics::Counter& framesPainted = Metrics::GetCounter(Metrics::KFramesPainted);
+    const Metrics::ScopedTimer kTimer(paintTime);
+    framesPainted.Add();
+
+    const QImage& kImage = GenerateSpectrogramImage(viewport()->width(), viewport()->height());
+
+    // Blit the spectrogram to the viewport
+    QPainter painter(viewport());
+    painter.drawImage(0, 0, kImage);
 
     // Overlay crosshair.  We don't need to provide any labels here, just a
-    // vertical line.  The measurements happen in the SpectrumPlot view.
-    QPainter painter(&image);
-    const auto kMousePos = mapFromGlobal(QCursor::pos());
+    // vertical line.  The measurements happen in the SpectrumPlot view.  It's
+    // drawn on the viewport rather than the image so the image isn't detached.
+    const int kCrosshairX = mGetCrosshairX();
     const float kCrosshairPenWidth = 0.5f;
     painter.setPen(QPen(Qt::yellow, kCrosshairPenWidth, Qt::DashLine));
-    painter.drawLine(kMousePos.x(), 0, kMousePos.x(), viewport()->height());
+    painter.drawLine(kCrosshairX, 0, kCrosshairX, viewport()->height());
+    mPaintedCrosshairX = kCrosshairX;
 
-    // Blit the result to the viewport
-    QPainter viewportPainter(viewport());
-    viewportPainter.drawImage(0, 0, image);
+    // The newest audio now on screen resolves pending latency tags
+    LatencyProbe& latencyProbe = LatencyProbe::Get();
+    if (latencyProbe.IsEnabled()) {
+        latencyProbe.MarkComposited(GetCompositedFrameEnd(viewport()->height()));
+    }
+}
+
+size_t
+SpectrogramView::GetMemoryBytes() const
+{
+    return static_cast<size_t>(mImage.sizeInBytes());
+}
+
+size_t
+SpectrogramView::ReleaseMemory(size_t /*aBytes*/)
+{
+    const size_t kFreed = GetMemoryBytes();
+    mImage = QImage();
+    InvalidateImage();
+    // The views point into the row cache, which may be evicted too
+    mRowViews = {};
+    return kFreed;
 }
 
 RenderConfig
@@ -128,7 +395,7 @@ SpectrogramView::GetRenderConfig(size_t aHeight) const
     // The scrollbar value represents the last visible frame + a partial stride.
     // Calculate the top frame by going back one full FFT window from that
     // point, align to stride, then back up by (height - 1) * stride.
-    const FramePosition kFirstPastEnd{ verticalScrollBar()->value() + 1 };
+    const FramePosition kFirstPastEnd = mScrollPosition + FrameCount{ 1 };
     const FramePosition kBottomFrameUnaligned = kFirstPastEnd - kSettings.GetFFTSize();
     const FramePosition kBottomFrame = mController.RoundToStride(kBottomFrameUnaligned);
     const FramePosition kTopFrame = kBottomFrame - FrameCount{ kStride * aHeight } + kStride;
@@ -150,11 +417,94 @@ SpectrogramView::GetRenderConfig(size_t aHeight) const
                          .aperture_range_inverse_decibels = kApertureRangeInverseDecibels };
 }
 
-QImage
+FrameCount
+SpectrogramView::GetCompositedFrameEnd(size_t aHeight) const
+{
+    if (aHeight == 0) {
+        return FrameCount{ 0 };
+    }
+
+    // Rows are only computed once their whole window is available.  Rows
+    // below the newest complete one are drawn black.
+    const RenderConfig kConfig = GetRenderConfig(aHeight);
+    const FFTSize kFFTSize = mController.GetSettings().GetFFTSize();
+    const FramePosition kBottomRow =
+      kConfig.top_frame + FrameCount{ kConfig.stride * (aHeight - 1) };
+    const FramePosition kLastCompleteRow =
+      mController.RoundToStride(mController.GetAvailableFrameCount().AsPosition() - kFFTSize);
+    const FramePosition kNewestRow = std::min(kBottomRow, kLastCompleteRow);
+    if (kNewestRow < kConfig.top_frame || kNewestRow < FramePosition{ 0 }) {
+        return FrameCount{ 0 };
+    }
+    return FrameCount{ static_cast<size_t>((kNewestRow + kFFTSize).Get()) };
+}
+
+std::pair<int, int>
+SpectrogramView::PrepareImage(const RenderConfig& aConfig, int aHeight)
+{
+    const std::optional<RenderConfig> kPrevious = std::exchange(mImageConfig, aConfig);
+    const FramePosition kDirtyFirstRow = std::exchange(mDirtyFirstRow, FramePosition{ 0 });
+    const FramePosition kDirtyEndRow = std::exchange(mDirtyEndRow, FramePosition{ 0 });
+    const bool kSameLayout =
+      kPrevious.has_value() && kPrevious->channels == aConfig.channels &&
+      kPrevious->stride == aConfig.stride &&
+      kPrevious->aperture_floor_decibels == aConfig.aperture_floor_decibels &&
+      kPrevious->aperture_ceiling_decibels == aConfig.aperture_ceiling_decibels;
+    const auto kStride = static_cast<std::ptrdiff_t>(aConfig.stride.Get());
+    const std::ptrdiff_t kShiftFrames =
+      kSameLayout ? aConfig.top_frame.Get() - kPrevious->top_frame.Get() : 0;
+    if (!kSameLayout || kShiftFrames % kStride != 0 ||
+        std::abs(kShiftFrames / kStride) >= aHeight) {
+        return { 0, aHeight };
+    }
+
+    // Scroll the rows still on screen into place.  A positive shift moves the
+    // image up and exposes rows at the bottom.
+    const auto kShiftRows = static_cast<int>(kShiftFrames / kStride);
+    const auto kBytesPerLine = static_cast<size_t>(mImage.bytesPerLine());
+    const auto kKeptBytes = kBytesPerLine * static_cast<size_t>(aHeight - std::abs(kShiftRows));
+    const auto kShiftBytes = kBytesPerLine * static_cast<size_t>(std::abs(kShiftRows));
+    int firstY = aHeight;
+    int endY = 0;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (kShiftRows > 0) {
+        uchar* const kBits = mImage.bits(); // Detaches first if a caller holds a copy
+        std::memmove(kBits, kBits + kShiftBytes, kKeptBytes);
+        firstY = aHeight - kShiftRows;
+        endY = aHeight;
+    } else if (kShiftRows < 0) {
+        uchar* const kBits = mImage.bits();
+        std::memmove(kBits + kShiftBytes, kBits, kKeptBytes);
+        firstY = 0;
+        endY = -kShiftRows;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    // Add the dirty rows that are on screen
+    if (kDirtyFirstRow < kDirtyEndRow) {
+        const std::ptrdiff_t kTop = aConfig.top_frame.Get();
+        const auto kDirtyFirstY = static_cast<int>(
+          std::clamp<std::ptrdiff_t>((kDirtyFirstRow.Get() - kTop) / kStride, 0, aHeight));
+        const auto kDirtyEndY = static_cast<int>(std::clamp<std::ptrdiff_t>(
+          (kDirtyEndRow.Get() - kTop + kStride - 1) / kStride, 0, aHeight));
+        if (kDirtyFirstY < kDirtyEndY) {
+            firstY = std::min(firstY, kDirtyFirstY);
+            endY = std::max(endY, kDirtyEndY);
+        }
+    }
+    return { firstY, std::max(firstY, endY) };
+}
+
+const QImage&
 SpectrogramView::GenerateSpectrogramImage(int aWidth, int aHeight)
 {
-    QImage image(aWidth, aHeight, QImage::Format_RGBA8888);
-    image.fill(Qt::black);
+    SPECTRO_TRACE_ZONE("SpectrogramView::GenerateSpectrogramImage");
+    // Only reallocate when the size changes.  If a caller still holds a copy
+    // of the last image, writing to it detaches rather than overwriting it.
+    if (mImage.width() != aWidth || mImage.height() != aHeight) {
+        mImage = QImage(aWidth, aHeight, QImage::Format_RGBA8888);
+        InvalidateImage();
+    }
 
     const auto renderConfig = GetRenderConfig(aHeight);
     const Settings::ColorMapLUTs& kColorMapLUTs = mController.GetSettings().GetColorMapLUTs();
@@ -163,25 +513,37 @@ SpectrogramView::GenerateSpectrogramImage(int aWidth, int aHeight)
     if (std::abs(renderConfig.aperture_range_decibels) < kImplausiblySmallDecibelRange) {
         // aperture_range_inverse_decibels is infinity.  We can't draw anything if the range is
         // zero.
-        return image;
+        mImage.fill(Qt::black);
+        InvalidateImage();
+        return mImage;
     }
 
-    // Store the magnitudes for all channels. Channel x Row x Frequency bins
-    std::vector<std::vector<std::vector<float>>> decibelsChannelRowBin(renderConfig.channels);
-
-    for (ChannelCount ch = 0; ch < renderConfig.channels; ch++) {
-        decibelsChannelRowBin[ch] = mController.GetRows(ch, renderConfig.top_frame, aHeight);
+    // Only the rows that changed, or scrolled into view, are rendered
+    const auto [kFirstY, kEndY] = PrepareImage(renderConfig, aHeight);
+    if (kFirstY >= kEndY) {
+        return mImage;
     }
+    const auto kRowCount = static_cast<size_t>(kEndY - kFirstY);
+
+    // Views of the magnitudes for all channels. Channel x Row x Frequency bins
+    mController.GetChannelRowViews(
+      renderConfig.top_frame + FrameCount{ renderConfig.stride * static_cast<size_t>(kFirstY) },
+      kRowCount,
+      mRowViews);
+    const SpectrogramEngine::RowViews& kDecibelsChannelRowBin = mRowViews;
 
     // Determine max X to render, lesser of view width or data width
-    const size_t kMaxX = std::min(static_cast<size_t>(aWidth), decibelsChannelRowBin[0][0].size());
+    const size_t kMaxX = std::min(static_cast<size_t>(aWidth), kDecibelsChannelRowBin[0][0].size());
 
     // Render spectrogram data into image
     // This is the hot path, so avoid branches and unnecessary allocations.
-    for (int y = 0; y < aHeight; y++) { // NOLINT(readability-identifier-length)
+    constexpr size_t kBytesPerRGBAPixel = 4;
+    constexpr int kMaxColorChannelValue = std::numeric_limits<uint8_t>::max();
+    for (size_t row = 0; row < kRowCount; row++) {
+        const int kY = kFirstY + static_cast<int>(row);
         // QImage::setPixel is slow, so we're going to access the framebuffer directly
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        auto* const kScanLine = reinterpret_cast<uint8_t*>(image.scanLine(y));
+        auto* const kScanLine = reinterpret_cast<uint8_t*>(mImage.scanLine(kY));
 
         // Scan the line.
         // This is the inner loop of the hot path, performance matters here.
@@ -194,7 +556,7 @@ SpectrogramView::GenerateSpectrogramImage(int aWidth, int aHeight)
             // NOLINTEND(readability-identifier-length)
             // Sum RGB values for each channel
             for (ChannelCount ch = 0; ch < renderConfig.channels; ch++) {
-                const float kDecibels = decibelsChannelRowBin[ch][y][x];
+                const float kDecibels = kDecibelsChannelRowBin[ch][row][x];
                 // Map to 0-255
                 auto colorMapIndex = (kDecibels - renderConfig.aperture_floor_decibels) *
                                      renderConfig.aperture_range_inverse_decibels;
@@ -214,14 +576,12 @@ SpectrogramView::GenerateSpectrogramImage(int aWidth, int aHeight)
             }
 
             // Clamp final RGB values to [0, 255]
-            constexpr int kMaxColorChannelValue = std::numeric_limits<uint8_t>::max();
             r = std::min(r, kMaxColorChannelValue);
             g = std::min(g, kMaxColorChannelValue);
             b = std::min(b, kMaxColorChannelValue);
 
             // As above, we're accessing the framebuffer directly for performance
             // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-            constexpr size_t kBytesPerRGBAPixel = 4;
             const size_t kScanLineIndex = x * kBytesPerRGBAPixel;
             kScanLine[kScanLineIndex + 0] = static_cast<uint8_t>(r); // R
             kScanLine[kScanLineIndex + 1] = static_cast<uint8_t>(g); // G
@@ -229,8 +589,19 @@ SpectrogramView::GenerateSpectrogramImage(int aWidth, int aHeight)
             kScanLine[kScanLineIndex + 3] = kMaxColorChannelValue;   // A
             // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         }
+
+        // Past the data, opaque black
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        for (size_t x = kMaxX; x < static_cast<size_t>(aWidth); x++) { // NOLINT
+            const size_t kScanLineIndex = x * kBytesPerRGBAPixel;
+            kScanLine[kScanLineIndex + 0] = 0;
+            kScanLine[kScanLineIndex + 1] = 0;
+            kScanLine[kScanLineIndex + 2] = 0;
+            kScanLine[kScanLineIndex + 3] = kMaxColorChannelValue;
+        }
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
-    return image;
+    return mImage;
 }
 
 void
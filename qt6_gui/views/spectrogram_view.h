@@ -7,12 +7,20 @@
 #include "models/settings.h"
 #include <QAbstractScrollArea>
 #include <QImage>
+#include <QMouseEvent>
+#include <QRect>
+#include <QWheelEvent>
 #include <QWidget>
 #include <audio_types.h>
 #include <cstddef>
+#include <cstdint>
 #include <format>
 #include <functional>
+#include <memory_budget.h>
+#include <optional>
+#include <spectrogram_engine.h>
 #include <string>
+#include <utility>
 
 // Forward declarations
 class SpectrogramController;
@@ -54,17 +62,29 @@ struct RenderConfig
 /// Displays a scrolling waterfall plot of the spectrogram with frequency on the
 /// horizontal axis and time on the vertical axis. Colors represent magnitude.
 ///
+/// Holding the left button scrubs: the view asks for playback from the row
+/// under the pointer, following it as it moves.
+///
 /// Future features:
-/// - Scrolling/scrubbing through time
 /// - Configurable color maps (viridis, plasma, grayscale)
 /// - Frequency and time axis labels
 /// - dB scale display
 /// - Zoom/pan controls
-class SpectrogramView : public QAbstractScrollArea
+class SpectrogramView
+  : public QAbstractScrollArea
+  , public IMemoryConsumer
 {
     Q_OBJECT
 
   public:
+    /// @brief Largest value the scrollbar is given
+    ///
+    /// The timeline is 64-bit; the scrollbar is a scaled proxy for it.  Up to
+    /// this many frames, one scrollbar step is one frame.  Beyond, each step
+    /// covers the fewest frames that fit the range, so dragging is coarse but
+    /// stepping, which is applied to the exact position, is not.
+    static constexpr int64_t KMaxScrollBarValue = int64_t{ 1 } << 30;
+
     /// @brief Function type for triggering viewport updates
     ///
     /// Used to request viewport repaints when data or scroll position changes.
@@ -73,6 +93,16 @@ class SpectrogramView : public QAbstractScrollArea
     /// different behaviors.
     using ViewportUpdater = std::function<void()>;
 
+    /// @brief Function type for triggering a repaint of part of the viewport
+    ///
+    /// Wraps viewport()->update(QRect) in production; overridden in tests.
+    using ViewportRectUpdater = std::function<void(const QRect&)>;
+
+    /// @brief Function type for getting the crosshair's x coordinate
+    ///
+    /// Follows the mouse cursor in production; overridden in tests.
+    using CrosshairXGetter = std::function<int()>;
+
     /// @brief Function type for getting a single viewport dimension in pixels
     ///
     /// Used to query the current viewport size (width or height) when
@@ -87,45 +117,165 @@ class SpectrogramView : public QAbstractScrollArea
     explicit SpectrogramView(const SpectrogramController& aController, QWidget* parent = nullptr);
     ~SpectrogramView() override = default;
 
+    /// @brief Get the bytes held by the rendered image
+    [[nodiscard]] size_t GetMemoryBytes() const override;
+
+    /// @brief Drop the rendered image; the next paint recreates it
+    /// @param aBytes Bytes the budget would like freed (ignored)
+    /// @return Bytes freed
+    size_t ReleaseMemory(size_t aBytes) override;
+
     /// @brief Update scrollbar range based on available audio data
     ///
     /// Called when new audio data arrives. Updates the scrollbar's maximum to
     /// reflect the total available frames. If the scrollbar is currently at its
     /// maximum (live mode), it will be updated to the new maximum to continue
     /// following live audio. Otherwise, the scroll position is preserved to
-    /// maintain the user's historical viewing position.  Repaints the view if
-    /// needed.
+    /// maintain the user's historical viewing position.  New rows in a view
+    /// that doesn't scroll are repainted by InvalidateRows().
     ///
     /// @param aAvailableFrames Total number of frames available in the buffer
     void UpdateScrollbarRange(FrameCount aAvailableFrames);
 
+    /// @brief Mark rows as changed, repainting the visible ones
+    ///
+    /// Connected to SpectrogramController::RowsCompleted.  Only the pixel rows
+    /// showing these spectrogram rows are rendered again at the next paint,
+    /// along with the crosshair's columns if the cursor has moved.
+    ///
+    /// @param aFirstRow First frame of the first changed row
+    /// @param aEndRow First frame of the row after the last changed one
+    void InvalidateRows(FramePosition aFirstRow, FramePosition aEndRow);
+
     /// @brief Update the QAbstractScrollArea viewport
     ///
     /// Trigger a viewport repaint in response to DisplaySettingsChanged.
     void UpdateViewport();
 
+    /// @brief Get the scroll position
+    /// @return The frame at the bottom of the view, which the scrollbar proxies
+    [[nodiscard]] FramePosition GetScrollPosition() const { return mScrollPosition; }
+
+    /// @brief Get the frames one page scrolls, the height of the view
+    [[nodiscard]] FrameCount GetPageStep() const { return mScrollPageStep; }
+
+    /// @brief Scroll to a position
+    /// @param aPosition Frame at the bottom of the view, clamped to the scroll range
+    void SetScrollPosition(FramePosition aPosition);
+
+  signals:
+    /// @brief Emitted while the left button is held, when the row under the
+    /// pointer changes
+    /// @param aFrame First frame of that row, clamped to the available audio
+    void ScrubRequested(FrameIndex aFrame);
+
+    /// @brief Emitted when the left button is released after scrubbing
+    void ScrubFinished();
+
   protected:
     void paintEvent(QPaintEvent* event) override;
 
+    /// @brief Scroll by whole single steps, exactly at any position
+    void wheelEvent(QWheelEvent* aEvent) override;
+
+    /// @brief Start scrubbing from the row under the pointer
+    void mousePressEvent(QMouseEvent* aEvent) override;
+
+    /// @brief Follow the pointer while scrubbing
+    void mouseMoveEvent(QMouseEvent* aEvent) override;
+
+    /// @brief Stop scrubbing
+    void mouseReleaseEvent(QMouseEvent* aEvent) override;
+
+    /// @brief Get the frame shown at a pixel row
+    /// @param aY Viewport y coordinate
+    /// @return First frame of the spectrogram row at aY, clamped to the
+    /// available audio
+    [[nodiscard]] FrameIndex GetFrameAt(int aY) const;
+
   private:
     const SpectrogramController& mController;
-    FrameCount mPreviousAvailableFrames{ 0 };
+
+    // The timeline position and range, in frames.  The scrollbar proxies them,
+    // each of its steps covering mScrollBarScale frames.
+    FramePosition mScrollPosition{ 0 };
+    FrameCount mScrollMaximum{ 0 };
+    FrameCount mScrollSingleStep{ 1 };
+    FrameCount mScrollPageStep{ 1 };
+    int64_t mScrollBarScale = 1;
+    bool mSyncingScrollBar = false;
+    int mWheelRemainder = 0; // Angle not yet scrolled, for high-resolution wheels
+
+    // Frame last asked for while scrubbing, if the left button is down
+    std::optional<FrameIndex> mScrubFrame;
 
     // These lambdas access the member functions of the QAbstractScrollArea's
     // viewport.  The defaults are used in production, but can be overridden in
     // tests via derived test fixture classes.
     ViewportUpdater mUpdateViewport;
+    ViewportRectUpdater mUpdateViewportRect;
+    CrosshairXGetter mGetCrosshairX;
+
+    // Where the last paint drew the crosshair, once something is painted
+    std::optional<int> mPaintedCrosshairX;
+
+    // Reused by GenerateSpectrogramImage(), so a steady-state repaint
+    // allocates nothing
+    QImage mImage;
+    SpectrogramEngine::RowViews mRowViews;
+
+    // What mImage shows, if it is still valid, and the rows changed since it
+    // was rendered.  An empty dirty range has mDirtyEndRow <= mDirtyFirstRow.
+    std::optional<RenderConfig> mImageConfig;
+    FramePosition mDirtyFirstRow{ 0 };
+    FramePosition mDirtyEndRow{ 0 };
+
+    /// @brief Make the next render redraw every row
+    void InvalidateImage();
+
+    /// @brief Repaint the crosshair's old and new columns if it has moved
+    ///
+    /// A partial repaint draws the crosshair only within the repainted rows,
+    /// so without this it would leave fragments at both positions.
+    void UpdateCrosshair();
+
+    /// @brief Set the scrollbar's scale, range, steps and value from the timeline
+    void SyncScrollBar();
+
+    /// @brief Apply a scrollbar step to the exact position
+    /// @param aAction A QAbstractSlider::SliderAction
+    void OnScrollBarAction(int aAction);
+
+    /// @brief Follow a scrollbar moved other than by a step, such as a drag
+    /// @param aValue New scrollbar value
+    void OnScrollBarValueChanged(int aValue);
+
+    /// @brief Reuse the rendered image for a new configuration, if possible
+    /// @param aConfig Configuration about to be rendered
+    /// @param aHeight Height in pixels
+    /// @return Range of pixel rows [first, end) that must be rendered
+    ///
+    /// If only the top frame moved, by whole rows, the image is scrolled and
+    /// just the exposed rows and the dirty rows are returned.
+    [[nodiscard]] std::pair<int, int> PrepareImage(const RenderConfig& aConfig, int aHeight);
 
     /// @brief Generate spectrogram image for given dimensions
     /// @param aWidth Width in pixels
     /// @param aHeight Height in pixels
-    /// @return Generated spectrogram image
-    QImage GenerateSpectrogramImage(int aWidth, int aHeight);
+    /// @return Generated spectrogram image, valid until the next call
+    /// @note Renders only the rows that changed since the last call
+    const QImage& GenerateSpectrogramImage(int aWidth, int aHeight);
 
     /// @brief Gather configuration needed for rendering
     /// @param aHeight Height in pixels (needed for topFrame calculation)
     /// @return RenderConfig struct with all settings and precomputed values
     [[nodiscard]] RenderConfig GetRenderConfig(size_t aHeight) const;
 
+    /// @brief Get the end of the newest audio shown in the view
+    /// @param aHeight Height in pixels
+    /// @return One past the last frame of the newest computed row, or 0 if no
+    /// computed row is visible
+    [[nodiscard]] FrameCount GetCompositedFrameEnd(size_t aHeight) const;
+
     friend class TestableSpectrogramView;
 };
@@ -10,7 +10,9 @@
 #include <QObject>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QPen>
 #include <QPoint>
+#include <QPointF>
 #include <QPolygonF>
 #include <QWidget>
 #include <Qt>
@@ -20,6 +22,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <peak_tracker.h>
 #include <vector>
 
 SpectrumPlot::SpectrumPlot(const SpectrogramController& aController, QWidget* parent)
@@ -70,6 +73,36 @@ SpectrumPlot::ComputePoints(const std::vector<float>& aDecibels,
     return points;
 }
 
+QPolygonF
+SpectrumPlot::ComputePeakMarkers(const std::vector<PeakTracker::Track>& aTracks,
+                                 const size_t aWidth,
+                                 const size_t aHeight) const
+{
+    QPolygonF points;
+    points.reserve(static_cast<qsizetype>(aTracks.size()));
+
+    const float kApertureFloorDecibels = mController.GetSettings().GetApertureFloorDecibels();
+    const float kApertureCeilingDecibels = mController.GetSettings().GetApertureCeilingDecibels();
+    const float kDecibelRange = kApertureCeilingDecibels - kApertureFloorDecibels;
+    const float kImplausiblySmallDecibelRange = 1e-6f;
+    if (std::abs(kDecibelRange) < kImplausiblySmallDecibelRange) {
+        return points;
+    }
+
+    // One pixel per bin, as in ComputePoints()
+    for (const PeakTracker::Track& kTrack : aTracks) {
+        if (kTrack.bin < 0.0f || kTrack.bin >= static_cast<float>(aWidth)) {
+            continue;
+        }
+        const float kNormalizedDecibels =
+          (kTrack.decibels - kApertureFloorDecibels) / kDecibelRange;
+        const float kYCoordinate =
+          static_cast<float>(aHeight) - (kNormalizedDecibels * static_cast<float>(aHeight));
+        points.emplace_back(kTrack.bin, kYCoordinate);
+    }
+    return points;
+}
+
 void
 SpectrumPlot::paintEvent(QPaintEvent* event)
 {
@@ -95,6 +128,20 @@ SpectrumPlot::paintEvent(QPaintEvent* event)
         const std::vector<float> kDecibels = GetDecibels(ch);
         const QPolygonF points = ComputePoints(kDecibels, width(), height());
         painter.drawPolyline(points);
+
+        // The estimated noise floor, dotted in the channel's color
+        const QPen kSpectrumPen = painter.pen();
+        QPen floorPen = kSpectrumPen;
+        floorPen.setStyle(Qt::DotLine);
+        painter.setPen(floorPen);
+        painter.drawPolyline(ComputePoints(mController.GetNoiseFloor(ch), width(), height()));
+        painter.setPen(kSpectrumPen);
+
+        constexpr qreal kPeakMarkerRadius = 3.0;
+        for (const QPointF& kPeak :
+             ComputePeakMarkers(mController.GetPeakTracks(ch), width(), height())) {
+            painter.drawEllipse(kPeak, kPeakMarkerRadius, kPeakMarkerRadius);
+        }
     }
 
     // Draw the decibel scale markers
@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <format>
 #include <ostream>
+#include <peak_tracker.h>
 #include <vector>
 
 class SpectrogramController;
@@ -21,13 +22,14 @@ class SpectrogramController;
 /// @brief Real-time frequency spectrum line plot widget
 ///
 /// Displays a line plot of the current frequency spectrum with frequency on the
-/// horizontal axis and magnitude on the vertical axis.
+/// horizontal axis and magnitude on the vertical axis.  Each peak tracked
+/// through the live input is marked with a small circle, and the estimated
+/// noise floor is drawn as a dotted line.
 ///
 /// Future features:
 /// - Real-time spectrum line plot
 /// - Frequency axis labels
 /// - dB scale on vertical axis
-/// - Peak markers
 /// - Grid lines
 class SpectrumPlot : public QWidget
 {
@@ -110,6 +112,17 @@ class SpectrumPlot : public QWidget
                                           size_t aWidth,
                                           size_t aHeight) const;
 
+    /// @brief Compute the marker positions for tracked peaks
+    /// @param aTracks Peak tracks, as from SpectrogramController::GetPeakTracks()
+    /// @param aWidth Width of the plot area in pixels
+    /// @param aHeight Height of the plot area in pixels
+    /// @return QPolygonF One point per track, on the scale of ComputePoints()
+    /// @note Tracks outside the given width are not included
+    /// @note If the decibel range is zero, an empty polygon is returned
+    [[nodiscard]] QPolygonF ComputePeakMarkers(const std::vector<PeakTracker::Track>& aTracks,
+                                               size_t aWidth,
+                                               size_t aHeight) const;
+
     /// @brief Calculate decibel scale parameters for the plot
     /// @param aHeight Height of the plot area in pixels
     /// @return DecibelScaleParameters Decibel scale parameters
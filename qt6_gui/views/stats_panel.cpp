@@ -0,0 +1,232 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "views/stats_panel.h"
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHideEvent>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QString>
+#include <QVBoxLayout>
+#include <QWidget>
+#include <Qt>
+#include <cstddef>
+#include <cstdint>
+#include <metrics.h>
+#include <string_view>
+
+namespace {
+constexpr int KPanelMargin = 8;
+constexpr int KPanelSpacing = 8;
+
+/// @brief Get a counter from a snapshot, or 0 if it hasn't been created yet
+uint64_t
+CounterValue(const Metrics::Snapshot& aSnapshot, std::string_view aName)
+{
+    const auto kIt = aSnapshot.counters.find(aName);
+    return kIt == aSnapshot.counters.end() ? 0 : kIt->second;
+}
+
+/// @brief Get a gauge from a snapshot, or 0 if it hasn't been created yet
+int64_t
+GaugeValue(const Metrics::Snapshot& aSnapshot, std::string_view aName)
+{
+    const auto kIt = aSnapshot.gauges.find(aName);
+    return kIt == aSnapshot.gauges.end() ? 0 : kIt->second;
+}
+
+/// @brief Get a histogram summary from a snapshot, or an empty one
+Metrics::Histogram::Summary
+HistogramValue(const Metrics::Snapshot& aSnapshot, std::string_view aName)
+{
+    const auto kIt = aSnapshot.histograms.find(aName);
+    return kIt == aSnapshot.histograms.end() ? Metrics::Histogram::Summary{} : kIt->second;
+}
+
+} // namespace
+
+StatsPanel::StatsPanel(QWidget* aParent)
+  : QWidget(aParent)
+  , mSaveButton(new QPushButton("Save...", this))
+{
+    setObjectName("StatsPanel");
+
+    auto* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(KPanelMargin, KPanelMargin, KPanelMargin, KPanelMargin);
+    mainLayout->setSpacing(KPanelSpacing);
+
+    auto* formLayout = new QFormLayout();
+    for (size_t i = 0; i < RowNames.size(); i++) {
+        mValueLabels.at(i) = new QLabel("-", this);
+        mValueLabels.at(i)->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        formLayout->addRow(QString::fromUtf8(RowNames.at(i).second), mValueLabels.at(i));
+    }
+    mainLayout->addLayout(formLayout);
+
+    mSaveButton->setObjectName("StatsSaveButton");
+    mSaveButton->setToolTip("Write every metric to a JSON file");
+    connect(mSaveButton, &QPushButton::clicked, this, &StatsPanel::SaveToFile);
+    mainLayout->addWidget(mSaveButton);
+    mainLayout->addStretch();
+
+    mRefreshTimer.setInterval(KRefreshIntervalMs);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &StatsPanel::Refresh);
+}
+
+void
+StatsPanel::Refresh()
+{
+    constexpr double kMillisecondsPerSecond = 1000.0;
+    const double kElapsedSeconds =
+      mSinceLastRefresh.isValid()
+        ? static_cast<double>(mSinceLastRefresh.restart()) / kMillisecondsPerSecond
+        : 0.0;
+    if (!mSinceLastRefresh.isValid()) {
+        mSinceLastRefresh.start();
+    }
+    Update(Metrics::TakeSnapshot(), kElapsedSeconds);
+}
+
+void
+StatsPanel::Update(const Metrics::Snapshot& aSnapshot, double aElapsedSeconds)
+{
+    auto setRow = [this](Row aRow, const QString& aText) {
+        mValueLabels.at(static_cast<size_t>(aRow))->setText(aText);
+    };
+    // Rate of a counter over the interval, or "-" on the first refresh
+    auto rate = [&](std::string_view aName) {
+        if (aElapsedSeconds <= 0) {
+            return QString("-");
+        }
+        const uint64_t kDelta = CounterValue(aSnapshot, aName) - CounterValue(mLastSnapshot, aName);
+        return QString::number(static_cast<double>(kDelta) / aElapsedSeconds, 'f', 0);
+    };
+    auto percentiles = [&](std::string_view aName) {
+        const auto kSummary = HistogramValue(aSnapshot, aName);
+        if (kSummary.count == 0) {
+            return QString("-");
+        }
+        return QString("%1 (p99 %2)")
+          .arg(FormatDuration(kSummary.p50), FormatDuration(kSummary.p99));
+    };
+
+    setRow(Row::RowsPerSecond, rate(Metrics::KRowsComputed));
+
+    // Hit rate over the interval, so it reflects what the view is doing now
+    const uint64_t kHits = CounterValue(aSnapshot, Metrics::KCacheHits) -
+                           CounterValue(mLastSnapshot, Metrics::KCacheHits);
+    const uint64_t kMisses = CounterValue(aSnapshot, Metrics::KCacheMisses) -
+                             CounterValue(mLastSnapshot, Metrics::KCacheMisses);
+    constexpr double kPercent = 100.0;
+    setRow(Row::CacheHitRate,
+           kHits + kMisses == 0
+             ? QString("-")
+             : QString("%1%").arg(kPercent * static_cast<double>(kHits) /
+                                    static_cast<double>(kHits + kMisses),
+                                  0,
+                                  'f',
+                                  1));
+
+    setRow(Row::CacheSize, QString("%1 rows").arg(GaugeValue(aSnapshot, Metrics::KCacheRows)));
+    setRow(Row::FFTTime, percentiles(Metrics::KFFTTime));
+    setRow(Row::PaintTime, percentiles(Metrics::KPaintTime));
+    setRow(Row::FramesPerSecond, rate(Metrics::KFramesPainted));
+    setRow(Row::IngestRate, rate(Metrics::KFramesIngested) + " frames/s");
+    setRow(Row::CaptureQueue,
+           QString("%1 frames").arg(GaugeValue(aSnapshot, Metrics::KCaptureQueueFrames)));
+    setRow(Row::CaptureBuffer,
+           QString("%1 frames").arg(GaugeValue(aSnapshot, Metrics::KCaptureBufferFrames)));
+    setRow(Row::CaptureXruns,
+           QString("%1 over, %2 under")
+             .arg(CounterValue(aSnapshot, Metrics::KCaptureOverruns))
+             .arg(CounterValue(aSnapshot, Metrics::KCaptureUnderruns)));
+    setRow(Row::StreamQueue,
+           QString("%1 frames").arg(GaugeValue(aSnapshot, Metrics::KStreamQueueFrames)));
+    setRow(Row::DroppedFrames,
+           QString::number(CounterValue(aSnapshot, Metrics::KDroppedFrames)));
+    setRow(Row::Latency, percentiles(Metrics::KCaptureToPixel));
+
+    const int64_t kMemoryLimit = GaugeValue(aSnapshot, Metrics::KMemoryLimit);
+    const QString kMemory = FormatBytes(GaugeValue(aSnapshot, Metrics::KMemoryTotal));
+    setRow(Row::Memory,
+           kMemoryLimit == 0 ? kMemory + " (no limit)"
+                             : QString("%1 of %2").arg(kMemory, FormatBytes(kMemoryLimit)));
+
+    mLastSnapshot = aSnapshot;
+}
+
+void
+StatsPanel::SaveToFile()
+{
+    const QString kPath = QFileDialog::getSaveFileName(
+      this, "Save Performance Statistics", "spectro-metrics.json", "JSON (*.json)");
+    if (kPath.isEmpty()) {
+        return;
+    }
+    const auto kResult = Metrics::WriteJsonFile(kPath.toStdString());
+    if (!kResult) {
+        QMessageBox::warning(
+          this, "Save Performance Statistics", QString::fromStdString(kResult.error()));
+    }
+}
+
+QString
+StatsPanel::FormatDuration(uint64_t aNanoseconds)
+{
+    constexpr double kMicrosecond = 1e3;
+    constexpr double kMillisecond = 1e6;
+    const auto kValue = static_cast<double>(aNanoseconds);
+    if (kValue >= kMillisecond) {
+        return QString("%1 ms").arg(kValue / kMillisecond, 0, 'f', 2);
+    }
+    if (kValue >= kMicrosecond) {
+        return QString("%1 µs").arg(kValue / kMicrosecond, 0, 'f', 1);
+    }
+    return QString("%1 ns").arg(aNanoseconds);
+}
+
+QString
+StatsPanel::FormatBytes(int64_t aBytes)
+{
+    constexpr double kKibibyte = 1024.0;
+    constexpr double kMebibyte = kKibibyte * 1024.0;
+    constexpr double kGibibyte = kMebibyte * 1024.0;
+    const auto kValue = static_cast<double>(aBytes);
+    if (kValue >= kGibibyte) {
+        return QString("%1 GiB").arg(kValue / kGibibyte, 0, 'f', 2);
+    }
+    if (kValue >= kMebibyte) {
+        return QString("%1 MiB").arg(kValue / kMebibyte, 0, 'f', 2);
+    }
+    if (kValue >= kKibibyte) {
+        return QString("%1 KiB").arg(kValue / kKibibyte, 0, 'f', 1);
+    }
+    return QString("%1 B").arg(aBytes);
+}
+
+QLabel*
+StatsPanel::GetValueLabel(Row aRow) const
+{
+    return mValueLabels.at(static_cast<size_t>(aRow));
+}
+
+void
+StatsPanel::showEvent(QShowEvent* aEvent)
+{
+    QWidget::showEvent(aEvent);
+    Refresh();
+    mRefreshTimer.start();
+}
+
+void
+StatsPanel::hideEvent(QHideEvent* aEvent)
+{
+    QWidget::hideEvent(aEvent);
+    mRefreshTimer.stop();
+    // Rates restart from the next show rather than averaging over the gap
+    mSinceLastRefresh.invalidate();
+}
@@ -0,0 +1,114 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#include <QWidget>
+#include <array>
+#include <cstdint>
+#include <metrics.h>
+#include <string_view>
+
+class QHideEvent;
+class QLabel;
+class QPushButton;
+class QShowEvent;
+
+/// @brief Live view of the process-wide Metrics registry
+///
+/// Shows throughput (rows computed, frames painted and ingested per second),
+/// cache hit rate and size, FFT and paint time percentiles, queue depths,
+/// capture buffer size, overruns and underruns, dropped frames, memory against
+/// the MemoryBudget limit and, with --latency, capture-to-pixel latency.  Rates
+/// are computed from the difference between successive snapshots, so they
+/// cover the last refresh interval.  Refreshes only while visible.  The Save
+/// button dumps every metric to a JSON file.
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    /// @brief Rows shown in the panel, in display order
+    enum class Row
+    {
+        RowsPerSecond,
+        CacheHitRate,
+        CacheSize,
+        FFTTime,
+        PaintTime,
+        FramesPerSecond,
+        IngestRate,
+        CaptureQueue,
+        CaptureBuffer,
+        CaptureXruns,
+        StreamQueue,
+        DroppedFrames,
+        Latency,
+        Memory,
+    };
+
+    static constexpr std::array<std::pair<Row, std::string_view>, 14> RowNames{ {
+      { Row::RowsPerSecond, "Rows computed/s:" },
+      { Row::CacheHitRate, "Cache hit rate:" },
+      { Row::CacheSize, "Cache size:" },
+      { Row::FFTTime, "FFT time/row:" },
+      { Row::PaintTime, "Paint time/frame:" },
+      { Row::FramesPerSecond, "Frames painted/s:" },
+      { Row::IngestRate, "Ingest rate:" },
+      { Row::CaptureQueue, "Capture queue:" },
+      { Row::CaptureBuffer, "Capture buffer:" },
+      { Row::CaptureXruns, "Capture xruns:" },
+      { Row::StreamQueue, "Stream queue:" },
+      { Row::DroppedFrames, "Dropped frames:" },
+      { Row::Latency, "Capture to pixel:" },
+      { Row::Memory, "Memory:" },
+    } };
+
+    /// @brief Refresh interval while visible
+    static constexpr int KRefreshIntervalMs = 500;
+
+    /// @brief Constructor
+    /// @param aParent Qt parent widget (optional)
+    explicit StatsPanel(QWidget* aParent = nullptr);
+    ~StatsPanel() override = default;
+
+    /// @brief Take a snapshot of the metrics and update the display
+    void Refresh();
+
+    /// @brief Update the display from a snapshot
+    /// @param aSnapshot Current metrics
+    /// @param aElapsedSeconds Time since the previous snapshot, for rates
+    void Update(const Metrics::Snapshot& aSnapshot, double aElapsedSeconds);
+
+    /// @brief Prompt for a file name and write every metric to it as JSON
+    void SaveToFile();
+
+    /// @brief Format a duration for display
+    /// @param aNanoseconds Duration in nanoseconds
+    /// @return e.g. "850 ns", "12.3 µs", "4.56 ms"
+    [[nodiscard]] static QString FormatDuration(uint64_t aNanoseconds);
+
+    /// @brief Format a byte count for display
+    /// @param aBytes Size in bytes
+    /// @return e.g. "512 B", "12.3 KiB", "4.56 MiB", "1.23 GiB"
+    [[nodiscard]] static QString FormatBytes(int64_t aBytes);
+
+    // Test accessors
+    [[nodiscard]] QLabel* GetValueLabel(Row aRow) const;
+    [[nodiscard]] QPushButton* GetSaveButton() const { return mSaveButton; }
+
+  protected:
+    void showEvent(QShowEvent* aEvent) override;
+    void hideEvent(QHideEvent* aEvent) override;
+
+  private:
+    QTimer mRefreshTimer;
+    QElapsedTimer mSinceLastRefresh;
+    Metrics::Snapshot mLastSnapshot;
+    std::array<QLabel*, RowNames.size()> mValueLabels{};
+    QPushButton* mSaveButton;
+};
@@ -0,0 +1,95 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#include "waveform_view.h"
+#include "models/audio_buffer.h"
+#include <QColor>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QWidget>
+#include <Qt>
+#include <algorithm>
+#include <audio_types.h>
+#include <cmath>
+#include <cstddef>
+#include <sample_buffer.h>
+#include <trace.h>
+#include <vector>
+#include <waveform_pyramid.h>
+
+WaveformView::WaveformView(const AudioBuffer& aAudioBuffer, QWidget* aParent)
+  : QWidget(aParent)
+  , mAudioBuffer(aAudioBuffer)
+{
+    constexpr int kMinHeight = 60;
+    setMinimumHeight(kMinHeight);
+}
+
+std::vector<WaveformPyramid::Entry>
+WaveformView::ComputeColumns(ChannelCount aChannel, FrameCount aFrameCount, int aWidth) const
+{
+    std::vector<WaveformPyramid::Entry> columns;
+    if (aFrameCount.Get() == 0 || aWidth <= 0) {
+        return columns;
+    }
+
+    const SampleBuffer& kBuffer = mAudioBuffer.GetChannelBuffer(aChannel);
+    const auto kWidth = static_cast<size_t>(aWidth);
+    columns.reserve(kWidth);
+    for (size_t x = 0; x < kWidth; x++) { // NOLINT(readability-identifier-length)
+        // Spread the frames evenly; when zoomed in past one frame per column,
+        // neighbouring columns repeat a frame
+        const size_t kFirst = x * aFrameCount.Get() / kWidth;
+        const size_t kEnd = std::max(((x + 1) * aFrameCount.Get()) / kWidth, kFirst + 1);
+        columns.push_back(kBuffer.Summarize(SampleIndex{ kFirst }, SampleCount{ kEnd - kFirst }));
+    }
+    return columns;
+}
+
+void
+WaveformView::paintEvent(QPaintEvent* aEvent)
+{
+    SPECTRO_TRACE_ZONE("WaveformView::paintEvent");
+    QPainter painter(this);
+    painter.fillRect(aEvent->rect(), Qt::black);
+
+    const ChannelCount kChannels = mAudioBuffer.GetChannelCount();
+    const FrameCount kFrames = mAudioBuffer.GetFrameCount();
+    if (kChannels == 0 || kFrames.Get() == 0) {
+        return;
+    }
+
+    constexpr QColor kPeakColor(40, 110, 160);
+    constexpr QColor kRmsColor(120, 200, 255);
+    constexpr QColor kLaneColor(60, 60, 60);
+    const double kLaneHeight = static_cast<double>(height()) / kChannels;
+    for (ChannelCount ch = 0; ch < kChannels; ch++) {
+        // Full scale spans the lane, with zero on its centre line
+        const double kCenter = kLaneHeight * (ch + 0.5);
+        const double kHalfHeight = kLaneHeight * 0.5;
+        const auto kToY = [&](float aLevel) {
+            const double kLevel = std::clamp(aLevel, -1.0f, 1.0f);
+            return static_cast<int>(std::lround(kCenter - (kLevel * kHalfHeight)));
+        };
+
+        painter.setPen(kLaneColor);
+        painter.drawLine(0, kToY(0.0f), width(), kToY(0.0f));
+
+        const std::vector<WaveformPyramid::Entry> kColumns = ComputeColumns(ch, kFrames, width());
+        for (size_t x = 0; x < kColumns.size(); x++) { // NOLINT(readability-identifier-length)
+            const WaveformPyramid::Entry& kColumn = kColumns[x];
+            const int kX = static_cast<int>(x);
+            painter.setPen(kPeakColor);
+            painter.drawLine(kX, kToY(kColumn.max), kX, kToY(kColumn.min));
+
+            // The RMS band, kept inside the peaks for offset signals
+            const float kRms = std::sqrt(kColumn.mean_square);
+            painter.setPen(kRmsColor);
+            painter.drawLine(kX,
+                             kToY(std::min(kRms, kColumn.max)),
+                             kX,
+                             kToY(std::max(-kRms, kColumn.min)));
+        }
+    }
+}
@@ -0,0 +1,44 @@
+// Spectro-v3 -- Real-time spectrum analyzer
+// SPDX-License-Identifier: GPL-3.0-only
+// Copyright (C) 2025-2026 Chris "Kai" Frederick
+
+#pragma once
+
+#include "audio_types.h"
+#include <QWidget>
+#include <vector>
+#include <waveform_pyramid.h>
+
+class AudioBuffer;
+class QPaintEvent;
+
+/// @brief Overview of the whole recording's waveform
+///
+/// One lane per channel.  Each pixel column shows the min to max of its span
+/// of the recording, with the RMS level drawn brighter inside it.  Columns are
+/// read from each channel's WaveformPyramid at the level matching the zoom,
+/// so a paint reads a few values per column however long the recording is.
+class WaveformView : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit WaveformView(const AudioBuffer& aAudioBuffer, QWidget* aParent = nullptr);
+    ~WaveformView() override = default;
+
+  protected:
+    void paintEvent(QPaintEvent* aEvent) override;
+
+    /// @brief Summarize a channel into pixel columns
+    /// @param aChannel Channel index (0-based)
+    /// @param aFrameCount Frames to spread across the columns, from the start
+    /// @param aWidth Number of columns
+    /// @return One entry per column; empty if aFrameCount or aWidth is zero
+    /// @throws std::out_of_range if aChannel is out of range
+    [[nodiscard]] std::vector<WaveformPyramid::Entry> ComputeColumns(ChannelCount aChannel,
+                                                                     FrameCount aFrameCount,
+                                                                     int aWidth) const;
+
+  private:
+    const AudioBuffer& mAudioBuffer;
+};